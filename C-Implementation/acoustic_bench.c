@@ -0,0 +1,144 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <math.h>
+#include "acoustic_stream.h"
+
+// Benchmark for the streaming acoustic stage:
+//  1. level accuracy for tones recorded through the simulated mic response, against
+//     the IEC 61672 A-weighting within class 1 tolerance at each tone
+//  2. throughput for 64 concurrent 48 kHz channels on one core
+
+#define BENCH_CHANNELS 64
+#define BENCH_SECONDS 10
+#define BENCH_BLOCK 480  // 10 ms blocks
+#define BENCH_TONES 4
+
+double now_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Simulated mic: high-pass at MIC_LOW_FREQ plus the resonance peak
+void mic_record_tone(int16_t *pcm, int frames, double freq, double db_spl, float pa_per_count) {
+    double w0 = 2.0 * M_PI * MIC_LOW_FREQ;
+    Biquad hp = biquad_from_analog(1, 0, 0, 1, sqrt(2.0) * w0, w0 * w0, PCM_SAMPLE_RATE);
+    Biquad peak = biquad_peaking(MIC_RESONANT_FREQ, MIC_RESONANCE_Q, MIC_RESONANCE_GAIN, PCM_SAMPLE_RATE);
+    Biquad chain[2] = {hp, peak};
+    float z1[2] = {0}, z2[2] = {0};
+    double amplitude = dbspl_to_pascal(db_spl) * sqrt(2.0);
+
+    for (int i = 0; i < frames; i++) {
+        float x = (float)(amplitude * sin(2.0 * M_PI * freq * i / PCM_SAMPLE_RATE));
+        for (int s = 0; s < 2; s++) {
+            float y = chain[s].b0 * x + z1[s];
+            z1[s] = chain[s].b1 * x - chain[s].a1 * y + z2[s];
+            z2[s] = chain[s].b2 * x - chain[s].a2 * y;
+            x = y;
+        }
+        double counts = x / pa_per_count;
+        if (counts > PCM_FULL_SCALE) counts = PCM_FULL_SCALE;
+        if (counts < -PCM_FULL_SCALE) counts = -PCM_FULL_SCALE;
+        pcm[i] = (int16_t)lrint(counts);
+    }
+}
+
+// IEC 61672 A-weighting in dB, from the analog poles
+double a_weighting_db(double f) {
+    double f2 = f * f;
+    double ra = (WEIGHT_F4 * WEIGHT_F4 * f2 * f2) /
+                ((f2 + WEIGHT_F1 * WEIGHT_F1) * sqrt((f2 + WEIGHT_F2 * WEIGHT_F2) * (f2 + WEIGHT_F3 * WEIGHT_F3)) *
+                 (f2 + WEIGHT_F4 * WEIGHT_F4));
+    return 20.0 * log10(ra) + 2.00;
+}
+
+// Returns the number of tones outside tolerance
+int bench_accuracy() {
+    AcousticBank bank;
+    int frames = (int)PCM_SAMPLE_RATE * 2;
+    int16_t *pcm = malloc(frames * sizeof(int16_t));
+    double freqs[BENCH_TONES] = {100.0, 1000.0, 4000.0, 10000.0};
+    double tolerance[BENCH_TONES] = {1.0, 0.7, 1.0, 2.0};  // Class 1, dB (10 kHz: +2.0/-3.0)
+    int failures = 0;
+
+    acoustic_bank_init(&bank, 1, PCM_SAMPLE_RATE);
+    printf("Tone at 94 dB SPL   LAeq    LCeq   LCpeak   IEC LAeq\n");
+    for (int i = 0; i < BENCH_TONES; i++) {
+        mic_record_tone(pcm, frames, freqs[i], 94.0, bank.coeffs.pa_per_count);
+        acoustic_reset_channel(&bank, 0);
+        // Skip the first second so filters have settled
+        acoustic_process_channel(&bank, 0, pcm, frames / 2);
+        acoustic_read_levels(&bank, 0, 1);
+        acoustic_process_channel(&bank, 0, pcm + frames / 2, frames / 2);
+        AcousticLevels l = acoustic_read_levels(&bank, 0, 1);
+        double expected = 94.0 + a_weighting_db(freqs[i]);
+        printf("%7.0f Hz         %6.1f  %6.1f  %6.1f   %6.1f\n", freqs[i], l.leq_a, l.leq_c, l.peak_c, expected);
+        if (fabs(l.leq_a - expected) > tolerance[i]) {
+            printf("  FAIL: LAeq off by %.1f dB, class 1 allows %.1f\n", l.leq_a - expected, tolerance[i]);
+            failures++;
+        }
+    }
+    printf("\n");
+
+    acoustic_bank_free(&bank);
+    free(pcm);
+    return failures;
+}
+
+void bench_throughput() {
+    AcousticBank bank;
+    int frames = (int)PCM_SAMPLE_RATE * BENCH_SECONDS;
+    int16_t *pcm = malloc((size_t)frames * BENCH_CHANNELS * sizeof(int16_t));
+    uint32_t seed = 12345;
+
+    // Broadband noise at a different level per channel
+    for (size_t i = 0; i < (size_t)frames * BENCH_CHANNELS; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        int level = 2000 + 200 * (int)(i % BENCH_CHANNELS);
+        pcm[i] = (int16_t)((int)(seed >> 16) % (2 * level) - level);
+    }
+
+    acoustic_bank_init(&bank, BENCH_CHANNELS, PCM_SAMPLE_RATE);
+    double start = now_seconds();
+    for (int f = 0; f < frames; f += BENCH_BLOCK) {
+        acoustic_process_interleaved(&bank, pcm + (size_t)f * BENCH_CHANNELS, BENCH_BLOCK);
+    }
+    double interleaved = now_seconds() - start;
+
+    AcousticLevels l = acoustic_read_levels(&bank, BENCH_CHANNELS - 1, 1);
+    double audio_seconds = (double)BENCH_SECONDS * BENCH_CHANNELS;
+    printf("%d channels x %d s of 48 kHz audio (channel %d: %.1f dB(A), %.1f dB(C))\n",
+           BENCH_CHANNELS, BENCH_SECONDS, BENCH_CHANNELS - 1, l.leq_a, l.leq_c);
+    printf("Interleaved SoA: %.3f s, %.1fx real time, ~%.0f channels per core\n",
+           interleaved, BENCH_SECONDS / interleaved, audio_seconds / interleaved);
+
+    // Same audio one channel at a time, as the sensor module sees it per suit
+    int16_t *mono = malloc(BENCH_BLOCK * sizeof(int16_t));
+    start = now_seconds();
+    for (int f = 0; f < frames; f += BENCH_BLOCK) {
+        for (int ch = 0; ch < BENCH_CHANNELS; ch++) {
+            for (int i = 0; i < BENCH_BLOCK; i++) {
+                mono[i] = pcm[(size_t)(f + i) * BENCH_CHANNELS + ch];
+            }
+            acoustic_process_channel(&bank, ch, mono, BENCH_BLOCK);
+        }
+    }
+    double per_channel = now_seconds() - start;
+    printf("Per channel:     %.3f s, %.1fx real time, ~%.0f channels per core\n",
+           per_channel, BENCH_SECONDS / per_channel, audio_seconds / per_channel);
+
+    acoustic_bank_free(&bank);
+    free(mono);
+    free(pcm);
+}
+
+int main() {
+    printf("Smart Suit - Acoustic Stream Benchmark\n");
+    printf("--------------------------------------\n");
+    int failures = bench_accuracy();
+    bench_throughput();
+    return (failures > 0) ? 1 : 0;
+}
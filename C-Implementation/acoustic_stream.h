@@ -0,0 +1,292 @@
+#ifndef ACOUSTIC_STREAM_H
+#define ACOUSTIC_STREAM_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include "acoustic_sensor.h"
+
+// Streaming A/C-weighted level analysis on raw 16-bit microphone PCM
+#define PCM_SAMPLE_RATE 48000.0  // Hz
+#define PCM_FULL_SCALE 32767.0
+#define PCM_MAX_BLOCK 4800  // Frames per block (100 ms)
+#define MIC_RESONANCE_GAIN 1.5  // Peak of the mic response at MIC_RESONANT_FREQ
+// The peak rises from MIC_HIGH_FREQ, so its half bandwidth is the distance between the two
+#define MIC_RESONANCE_Q (MIC_RESONANT_FREQ / (2.0 * (MIC_RESONANT_FREQ - MIC_HIGH_FREQ)))
+#define MIC_EXTENDED_LOW_FREQ (MIC_LOW_FREQ / 4.0)  // Corner after low-frequency correction
+
+// IEC 61672 weighting poles in Hz
+#define WEIGHT_F1 20.598997
+#define WEIGHT_F2 107.65265
+#define WEIGHT_F3 737.86223
+#define WEIGHT_F4 12194.217
+
+// Filter chain per channel: mic resonance and low-frequency correction, then the
+// pole pairs shared by both curves (C = F1 high-pass and F4 low-pass, A = C plus F2/F3)
+#define STAGE_MIC 0
+#define STAGE_MIC_LOW 1
+#define STAGE_HP 2
+#define STAGE_LP 3
+#define STAGE_A 4
+#define ACOUSTIC_STAGES 5
+
+typedef struct {
+    float b0, b1, b2, a1, a2;
+} Biquad;
+
+typedef struct {
+    Biquad stage[ACOUSTIC_STAGES];
+    float gain_a;  // Normalizes A-weighting to 0 dB at 1 kHz
+    float gain_c;  // Normalizes C-weighting to 0 dB at 1 kHz
+    float pa_per_count;  // Pascal per PCM count
+} AcousticCoeffs;
+
+typedef struct {
+    double leq_a;  // dB(A)
+    double leq_c;  // dB(C)
+    double peak_c;  // dB(C) peak
+    double peak_z;  // Unweighted peak
+    long samples;
+} AcousticLevels;
+
+// Structure-of-arrays state so the per-sample loop runs across channels
+typedef struct {
+    int channels;
+    AcousticCoeffs coeffs;
+    float *z1[ACOUSTIC_STAGES];  // Transposed direct form II state per channel
+    float *z2[ACOUSTIC_STAGES];
+    double *sumsq_a;
+    double *sumsq_c;
+    float *peak_c;
+    float *peak_z;
+    long *samples;
+} AcousticBank;
+
+// Bilinear transform of (n2 s² + n1 s + n0) / (d2 s² + d1 s + d0)
+Biquad biquad_from_analog(double n2, double n1, double n0,
+                          double d2, double d1, double d0, double sample_rate) {
+    double k = 2.0 * sample_rate;
+    double k2 = k * k;
+    double a0 = d2 * k2 + d1 * k + d0;
+    Biquad bq;
+    bq.b0 = (float)((n2 * k2 + n1 * k + n0) / a0);
+    bq.b1 = (float)(2.0 * (n0 - n2 * k2) / a0);
+    bq.b2 = (float)((n2 * k2 - n1 * k + n0) / a0);
+    bq.a1 = (float)(2.0 * (d0 - d2 * k2) / a0);
+    bq.a2 = (float)((d2 * k2 - d1 * k + d0) / a0);
+    return bq;
+}
+
+// Peaking filter (RBJ cookbook), gain < 1 cuts
+Biquad biquad_peaking(double freq, double q, double gain, double sample_rate) {
+    double a = sqrt(gain);
+    double w0 = 2.0 * M_PI * freq / sample_rate;
+    double alpha = sin(w0) / (2.0 * q);
+    double a0 = 1.0 + alpha / a;
+    Biquad bq;
+    bq.b0 = (float)((1.0 + alpha * a) / a0);
+    bq.b1 = (float)(-2.0 * cos(w0) / a0);
+    bq.b2 = (float)((1.0 - alpha * a) / a0);
+    bq.a1 = (float)(-2.0 * cos(w0) / a0);
+    bq.a2 = (float)((1.0 - alpha / a) / a0);
+    return bq;
+}
+
+// Magnitude response of a biquad at a frequency
+double biquad_magnitude(const Biquad *bq, double freq, double sample_rate) {
+    double w = 2.0 * M_PI * freq / sample_rate;
+    double c1 = cos(w), s1 = sin(w), c2 = cos(2 * w), s2 = sin(2 * w);
+    double nr = bq->b0 + bq->b1 * c1 + bq->b2 * c2, ni = -(bq->b1 * s1 + bq->b2 * s2);
+    double dr = 1.0 + bq->a1 * c1 + bq->a2 * c2, di = -(bq->a1 * s1 + bq->a2 * s2);
+    return sqrt((nr * nr + ni * ni) / (dr * dr + di * di));
+}
+
+void acoustic_design(AcousticCoeffs *c, double sample_rate) {
+    double w1 = 2.0 * M_PI * WEIGHT_F1, w2 = 2.0 * M_PI * WEIGHT_F2;
+    double w3 = 2.0 * M_PI * WEIGHT_F3;
+    // F4 is close enough to Nyquist that the bilinear transform needs prewarping
+    double w4 = 2.0 * sample_rate * tan(M_PI * WEIGHT_F4 / sample_rate);
+
+    // Undo the resonance peak the mic adds between MIC_HIGH_FREQ and MIC_RESONANT_FREQ
+    c->stage[STAGE_MIC] = biquad_peaking(MIC_RESONANT_FREQ, MIC_RESONANCE_Q,
+                                         1.0 / MIC_RESONANCE_GAIN, sample_rate);
+    // Swap the mic's second-order roll-off at MIC_LOW_FREQ for one two octaves lower.
+    // Inverting it outright would boost wind and handling noise without limit; this
+    // way the boost stops at 24 dB, where the C curve is already falling.
+    double wl = 2.0 * M_PI * MIC_LOW_FREQ, we = 2.0 * M_PI * MIC_EXTENDED_LOW_FREQ;
+    c->stage[STAGE_MIC_LOW] = biquad_from_analog(1, sqrt(2.0) * wl, wl * wl,
+                                                 1, sqrt(2.0) * we, we * we, sample_rate);
+    c->stage[STAGE_HP] = biquad_from_analog(1, 0, 0, 1, 2 * w1, w1 * w1, sample_rate);
+    c->stage[STAGE_LP] = biquad_from_analog(0, 0, 1, 1, 2 * w4, w4 * w4, sample_rate);
+    c->stage[STAGE_A] = biquad_from_analog(1, 0, 0, 1, w2 + w3, w2 * w3, sample_rate);
+
+    double hp = biquad_magnitude(&c->stage[STAGE_HP], 1000.0, sample_rate);
+    double lp = biquad_magnitude(&c->stage[STAGE_LP], 1000.0, sample_rate);
+    double a = biquad_magnitude(&c->stage[STAGE_A], 1000.0, sample_rate);
+    c->gain_c = (float)(1.0 / (hp * lp));
+    c->gain_a = (float)(1.0 / (hp * lp * a));
+
+    // A full-scale sine reads as the acoustic overload point
+    c->pa_per_count = (float)(dbspl_to_pascal(MIC_RANGE) * sqrt(2.0) / PCM_FULL_SCALE);
+}
+
+int acoustic_bank_init(AcousticBank *bank, int channels, double sample_rate) {
+    memset(bank, 0, sizeof(*bank));
+    bank->channels = channels;
+    acoustic_design(&bank->coeffs, sample_rate);
+
+    for (int s = 0; s < ACOUSTIC_STAGES; s++) {
+        bank->z1[s] = calloc(channels, sizeof(float));
+        bank->z2[s] = calloc(channels, sizeof(float));
+        if (bank->z1[s] == NULL || bank->z2[s] == NULL) return -1;
+    }
+    bank->sumsq_a = calloc(channels, sizeof(double));
+    bank->sumsq_c = calloc(channels, sizeof(double));
+    bank->peak_c = calloc(channels, sizeof(float));
+    bank->peak_z = calloc(channels, sizeof(float));
+    bank->samples = calloc(channels, sizeof(long));
+    if (!bank->sumsq_a || !bank->sumsq_c || !bank->peak_c || !bank->peak_z || !bank->samples) {
+        return -1;
+    }
+    return 0;
+}
+
+void acoustic_bank_free(AcousticBank *bank) {
+    for (int s = 0; s < ACOUSTIC_STAGES; s++) {
+        free(bank->z1[s]);
+        free(bank->z2[s]);
+    }
+    free(bank->sumsq_a);
+    free(bank->sumsq_c);
+    free(bank->peak_c);
+    free(bank->peak_z);
+    free(bank->samples);
+    memset(bank, 0, sizeof(*bank));
+}
+
+// Clear one channel's filters and accumulators (e.g. a new suit takes the slot)
+void acoustic_reset_channel(AcousticBank *bank, int ch) {
+    for (int s = 0; s < ACOUSTIC_STAGES; s++) {
+        bank->z1[s][ch] = 0.0f;
+        bank->z2[s][ch] = 0.0f;
+    }
+    bank->sumsq_a[ch] = bank->sumsq_c[ch] = 0.0;
+    bank->peak_c[ch] = bank->peak_z[ch] = 0.0f;
+    bank->samples[ch] = 0;
+}
+
+// Run one biquad stage over a vector of channels
+static inline void biquad_stage(const Biquad *bq, float *restrict x,
+                                float *restrict z1, float *restrict z2, int n) {
+    for (int c = 0; c < n; c++) {
+        float y = bq->b0 * x[c] + z1[c];
+        z1[c] = bq->b1 * x[c] - bq->a1 * y + z2[c];
+        z2[c] = bq->b2 * x[c] - bq->a2 * y;
+        x[c] = y;
+    }
+}
+
+// Process interleaved frames (one sample per channel per frame). Each stage
+// loops over the channels of a frame, which the compiler vectorizes.
+void acoustic_process_interleaved(AcousticBank *bank, const int16_t *pcm, int frames) {
+    int n = bank->channels;
+    const AcousticCoeffs *c = &bank->coeffs;
+    float x[n];  // VLA, bank sizes are small (tens of channels)
+
+    for (int f = 0; f < frames; f++) {
+        const int16_t *frame = pcm + (size_t)f * n;
+        for (int ch = 0; ch < n; ch++) {
+            x[ch] = frame[ch] * c->pa_per_count;
+            float mag = fabsf(x[ch]);
+            if (mag > bank->peak_z[ch]) bank->peak_z[ch] = mag;
+        }
+
+        biquad_stage(&c->stage[STAGE_MIC], x, bank->z1[STAGE_MIC], bank->z2[STAGE_MIC], n);
+        biquad_stage(&c->stage[STAGE_MIC_LOW], x, bank->z1[STAGE_MIC_LOW], bank->z2[STAGE_MIC_LOW], n);
+        biquad_stage(&c->stage[STAGE_HP], x, bank->z1[STAGE_HP], bank->z2[STAGE_HP], n);
+        biquad_stage(&c->stage[STAGE_LP], x, bank->z1[STAGE_LP], bank->z2[STAGE_LP], n);
+        for (int ch = 0; ch < n; ch++) {
+            float yc = x[ch] * c->gain_c;
+            float mag = fabsf(yc);
+            bank->sumsq_c[ch] += yc * yc;
+            if (mag > bank->peak_c[ch]) bank->peak_c[ch] = mag;
+        }
+
+        biquad_stage(&c->stage[STAGE_A], x, bank->z1[STAGE_A], bank->z2[STAGE_A], n);
+        for (int ch = 0; ch < n; ch++) {
+            float ya = x[ch] * c->gain_a;
+            bank->sumsq_a[ch] += ya * ya;
+        }
+    }
+
+    for (int ch = 0; ch < n; ch++) bank->samples[ch] += frames;
+}
+
+// Process a mono block for a single channel (one suit's recording)
+void acoustic_process_channel(AcousticBank *bank, int ch, const int16_t *pcm, int frames) {
+    const AcousticCoeffs *c = &bank->coeffs;
+    float z1[ACOUSTIC_STAGES], z2[ACOUSTIC_STAGES];
+    double sumsq_a = 0.0, sumsq_c = 0.0;
+    float peak_c = bank->peak_c[ch], peak_z = bank->peak_z[ch];
+
+    for (int s = 0; s < ACOUSTIC_STAGES; s++) {
+        z1[s] = bank->z1[s][ch];
+        z2[s] = bank->z2[s][ch];
+    }
+
+    for (int f = 0; f < frames; f++) {
+        float x = pcm[f] * c->pa_per_count;
+        if (fabsf(x) > peak_z) peak_z = fabsf(x);
+        for (int s = 0; s < ACOUSTIC_STAGES; s++) {
+            const Biquad *bq = &c->stage[s];
+            float y = bq->b0 * x + z1[s];
+            z1[s] = bq->b1 * x - bq->a1 * y + z2[s];
+            z2[s] = bq->b2 * x - bq->a2 * y;
+            x = y;
+            if (s == STAGE_LP) {
+                float yc = x * c->gain_c;
+                sumsq_c += yc * yc;
+                if (fabsf(yc) > peak_c) peak_c = fabsf(yc);
+            }
+        }
+        float ya = x * c->gain_a;
+        sumsq_a += ya * ya;
+    }
+
+    for (int s = 0; s < ACOUSTIC_STAGES; s++) {
+        bank->z1[s][ch] = z1[s];
+        bank->z2[s][ch] = z2[s];
+    }
+    bank->sumsq_a[ch] += sumsq_a;
+    bank->sumsq_c[ch] += sumsq_c;
+    bank->peak_c[ch] = peak_c;
+    bank->peak_z[ch] = peak_z;
+    bank->samples[ch] += frames;
+}
+
+double pascal_to_dbspl(double pascal) {
+    return (pascal > 0.0) ? 20.0 * log10(pascal / 20e-6) : 0.0;
+}
+
+// Levels since the last reset; reset = 1 starts a new integration period
+AcousticLevels acoustic_read_levels(AcousticBank *bank, int ch, int reset) {
+    AcousticLevels levels = {0};
+    long n = bank->samples[ch];
+    if (n > 0) {
+        levels.leq_a = pascal_to_dbspl(sqrt(bank->sumsq_a[ch] / n));
+        levels.leq_c = pascal_to_dbspl(sqrt(bank->sumsq_c[ch] / n));
+        levels.peak_c = pascal_to_dbspl(bank->peak_c[ch]);
+        levels.peak_z = pascal_to_dbspl(bank->peak_z[ch]);
+        levels.samples = n;
+    }
+    if (reset) {
+        bank->sumsq_a[ch] = bank->sumsq_c[ch] = 0.0;
+        bank->peak_c[ch] = bank->peak_z[ch] = 0.0f;
+        bank->samples[ch] = 0;
+    }
+    return levels;
+}
+
+#endif
@@ -1,173 +1,284 @@
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include <time.h>
-#include <winsock2.h>
-#include <ws2tcpip.h>
-
-#pragma comment(lib, "ws2_32.lib")
-
-#define PORT_ACTUATOR 8082
-#define BUFFER_SIZE 1024
-
-// Actuator response codes
-#define COOLING_ON 101
-#define HEATING_ON 102
-#define RADIATION_ALARM 201
-#define CHEMICAL_ALARM 301
-#define OXYGEN_ALARM 401
-#define NOISE_PROTECTION 501
-#define VOLTAGE_WARNING 601
-
-// Acknowledgment codes
-#define ACK_SUCCESS 1
-#define ACK_FAILURE 0
-
-void activate_actuator(int response_code, int value) {
-    // This function would control the physical actuators in a real system
-    // For simulation, we just print messages
-    
-    time_t now;
-    struct tm *local_time;
-    char timestamp[26];
-    
-    // Get current time
-    time(&now);
-    local_time = localtime(&now);
-    strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", local_time);
-    
-    printf("\n[%s] ACTUATOR ACTIVATED: ", timestamp);
-    
-    switch(response_code) {
-        case COOLING_ON:
-            printf("Cooling system activated. Temperature: %d°C\n", value);
-            printf("Action: Activating cooling elements in suit to reduce temperature.\n");
-            break;
-        case HEATING_ON:
-            printf("Heating system activated. Temperature: %d°C\n", value);
-            printf("Action: Activating heating elements in suit to increase temperature.\n");
-            break;
-        case RADIATION_ALARM:
-            printf("RADIATION ALERT! Level: %d μSv/h\n", value);
-            printf("Action: Activating radiation shield and haptic warning system.\n");
-            printf("Warning: Evacuate area immediately!\n");
-            break;
-        case CHEMICAL_ALARM:
-            printf("CHEMICAL HAZARD ALERT! Concentration: %d ppm\n", value);
-            printf("Action: Sealing suit interfaces and activating filtration system.\n");
-            printf("Warning: Hazardous chemical detected, evacuate area!\n");
-            break;
-        case OXYGEN_ALARM:
-            printf("LOW OXYGEN ALERT! Level: %d%%\n", value);
-            printf("Action: Activating emergency oxygen supply.\n");
-            printf("Warning: Oxygen levels dangerously low, evacuate area!\n");
-            break;
-        case NOISE_PROTECTION:
-            printf("HIGH NOISE LEVEL! %d dB detected\n", value);
-            printf("Action: Activating acoustic dampening system.\n");
-            printf("Warning: Prolonged exposure may cause hearing damage.\n");
-            break;
-        case VOLTAGE_WARNING:
-            printf("HIGH VOLTAGE FIELD! %d V/m detected\n", value);
-            printf("Action: Activating electrical insulation layer.\n");
-            printf("Warning: High voltage field detected, maintain safe distance from sources.\n");
-            break;
-        default:
-            printf("Unknown response code: %d\n", response_code);
-    }
-}
-
-const char* get_response_name(int code) {
-    switch(code) {
-        case COOLING_ON: return "Cooling System Activation";
-        case HEATING_ON: return "Heating System Activation";
-        case RADIATION_ALARM: return "Radiation Alarm";
-        case CHEMICAL_ALARM: return "Chemical Hazard Alarm";
-        case OXYGEN_ALARM: return "Oxygen Level Alarm";
-        case NOISE_PROTECTION: return "Noise Protection";
-        case VOLTAGE_WARNING: return "Electrical Field Warning";
-        default: return "Unknown Response";
-    }
-}
-
-int main() {
-    WSADATA wsaData;
-    SOCKET server_fd = INVALID_SOCKET, new_socket = INVALID_SOCKET;
-    struct sockaddr_in address;
-    int addrlen = sizeof(address);
-    
-    // Initialize Winsock
-    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
-        printf("WSAStartup failed: %d\n", WSAGetLastError());
-        return 1;
-    }
-    
-    // Creating socket
-    if ((server_fd = socket(AF_INET, SOCK_STREAM, 0)) == INVALID_SOCKET) {
-        printf("Socket creation error: %d\n", WSAGetLastError());
-        WSACleanup();
-        return 1;
-    }
-    
-    // Setup socket options to allow address reuse
-    int opt = 1;
-    if (setsockopt(server_fd, SOL_SOCKET, SO_REUSEADDR, (char*)&opt, sizeof(opt)) == SOCKET_ERROR) {
-        printf("Setsockopt error: %d\n", WSAGetLastError());
-        closesocket(server_fd);
-        WSACleanup();
-        return 1;
-    }
-    
-    address.sin_family = AF_INET;
-    address.sin_addr.s_addr = INADDR_ANY;
-    address.sin_port = htons(PORT_ACTUATOR);
-    
-    // Bind the socket to the port
-    if (bind(server_fd, (struct sockaddr *)&address, sizeof(address)) == SOCKET_ERROR) {
-        printf("Bind failed: %d\n", WSAGetLastError());
-        closesocket(server_fd);
-        WSACleanup();
-        return 1;
-    }
-    
-    if (listen(server_fd, 3) == SOCKET_ERROR) {
-        printf("Listen error: %d\n", WSAGetLastError());
-        closesocket(server_fd);
-        WSACleanup();
-        return 1;
-    }
-    
-    printf("Actuator module started. Listening on port %d...\n", PORT_ACTUATOR);
-    
-    while (1) {
-        if ((new_socket = accept(server_fd, (struct sockaddr *)&address, &addrlen)) == INVALID_SOCKET) {
-            printf("Accept error: %d\n", WSAGetLastError());
-            continue;
-        }
-        
-        int data[2];
-        int valread = recv(new_socket, (char*)data, sizeof(data), 0);
-        
-        if (valread > 0) {
-            int response_code = data[0];
-            int value = data[1];
-            
-            printf("Received from control: Response Code %d (%s), Value %d\n", 
-                   response_code, get_response_name(response_code), value);
-            
-            // Activate the appropriate actuator
-            activate_actuator(response_code, value);
-            
-            // Send acknowledgment back to control
-            int ack = ACK_SUCCESS;
-            send(new_socket, (char*)&ack, sizeof(ack), 0);
-            printf("Acknowledgment sent to control: %d\n", ack);
-        }
-        
-        closesocket(new_socket);
-    }
-    
-    closesocket(server_fd);
-    WSACleanup();
-    return 0;
-}
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "net_compat.h"
+#include "metrics.h"
+#include "listen_workers.h"
+#include "traffic_capture.h"
+
+#define PORT_ACTUATOR 8082
+#define BUFFER_SIZE 1024
+
+// Actuator response codes
+#define COOLING_ON 101
+#define HEATING_ON 102
+#define THERMAL_DUTY 103  // Thermal loop output, % of full power: > 0 cooling, < 0 heating, 0 off
+#define RADIATION_ALARM 201
+#define CHEMICAL_ALARM 301
+#define OXYGEN_ALARM 401
+#define NOISE_PROTECTION 501
+#define VOLTAGE_WARNING 601
+#define ARC_FLASH_ALARM 602
+#define OVERCURRENT_WARNING 603
+#define MAGNETIC_WARNING 701
+#define COLLISION_WARNING 801
+#define EARLY_WARNING 901
+#define MAN_DOWN_ALARM 1001
+#define HAZARD_WARNING 1101  // The value is the combined hazard severity: 1 advisory, 2 warning, 3 danger
+
+// Acknowledgment codes
+#define ACK_SUCCESS 1
+#define ACK_FAILURE 0
+
+// Metric family IDs; commands are labelled by hazard group (response code / 100)
+int metric_commands, metric_unknown_commands, metric_activation;
+
+void init_metrics() {
+    metrics_init("smartsuit_actuator");
+    metric_commands = metrics_register("commands_total", "Commands received from control",
+                                       METRIC_COUNTER, "group", 16);
+    metric_unknown_commands = metrics_register("unknown_commands_total", "Commands with an unknown response code",
+                                               METRIC_COUNTER, NULL, 1);
+    metric_activation = metrics_register("activation_seconds", "Time from command receipt to acknowledgment",
+                                         METRIC_HISTOGRAM, NULL, 1);
+}
+
+void activate_actuator(int response_code, int value) {
+    // This function would control the physical actuators in a real system
+    // For simulation, we just print messages
+    
+    time_t now;
+    struct tm *local_time;
+    char timestamp[26];
+    
+    // Get current time
+    time(&now);
+    local_time = localtime(&now);
+    strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", local_time);
+    
+    printf("\n[%s] ACTUATOR ACTIVATED: ", timestamp);
+    
+    switch(response_code) {
+        case COOLING_ON:
+            printf("Cooling system activated. Temperature: %d°C\n", value);
+            printf("Action: Activating cooling elements in suit to reduce temperature.\n");
+            break;
+        case HEATING_ON:
+            printf("Heating system activated. Temperature: %d°C\n", value);
+            printf("Action: Activating heating elements in suit to increase temperature.\n");
+            break;
+        case THERMAL_DUTY:
+            if (value > 0) {
+                printf("Thermal control: cooling at %d%% duty\n", value);
+            } else if (value < 0) {
+                printf("Thermal control: heating at %d%% duty\n", -value);
+            } else {
+                printf("Thermal control: cooling and heating off\n");
+            }
+            break;
+        case RADIATION_ALARM:
+            printf("RADIATION ALERT! Level: %d μSv/h\n", value);
+            printf("Action: Activating radiation shield and haptic warning system.\n");
+            printf("Warning: Evacuate area immediately!\n");
+            break;
+        case CHEMICAL_ALARM:
+            printf("CHEMICAL HAZARD ALERT! Concentration: %d ppm\n", value);
+            printf("Action: Sealing suit interfaces and activating filtration system.\n");
+            printf("Warning: Hazardous chemical detected, evacuate area!\n");
+            break;
+        case OXYGEN_ALARM:
+            printf("LOW OXYGEN ALERT! Level: %d%%\n", value);
+            printf("Action: Activating emergency oxygen supply.\n");
+            printf("Warning: Oxygen levels dangerously low, evacuate area!\n");
+            break;
+        case NOISE_PROTECTION:
+            printf("HIGH NOISE LEVEL! %d dB detected\n", value);
+            printf("Action: Activating acoustic dampening system.\n");
+            printf("Warning: Prolonged exposure may cause hearing damage.\n");
+            break;
+        case VOLTAGE_WARNING:
+            printf("HIGH VOLTAGE FIELD! %d V/m detected\n", value);
+            printf("Action: Activating electrical insulation layer.\n");
+            printf("Warning: High voltage field detected, maintain safe distance from sources.\n");
+            break;
+        case ARC_FLASH_ALARM:
+            printf("ARC FLASH DETECTED! Peak current %d A\n", value);
+            printf("Action: Lowering face shield and activating haptic evacuation alarm.\n");
+            printf("Warning: Arcing fault on the circuit, step back and de-energize!\n");
+            break;
+        case OVERCURRENT_WARNING:
+            printf("OVERCURRENT! %d A RMS on the monitored circuit\n", value);
+            printf("Action: Activating haptic warning system.\n");
+            printf("Warning: Circuit overloaded, stop work and isolate the supply.\n");
+            break;
+        case MAGNETIC_WARNING:
+            printf("STRONG MAGNETIC FIELD! %d μT detected\n", value);
+            printf("Action: Activating haptic warning system.\n");
+            printf("Warning: Field may affect medical implants and loose ferrous tools, back away from the source.\n");
+            break;
+        case COLLISION_WARNING:
+            printf("COLLISION WARNING! Object approaching at %d cm\n", value);
+            printf("Action: Activating strobe and haptic collision alarm.\n");
+            printf("Warning: Vehicle or machinery approaching, move clear immediately!\n");
+            break;
+        case EARLY_WARNING:
+            printf("EARLY WARNING! Hazard threshold predicted in %d s\n", value);
+            printf("Action: Activating haptic pre-alarm.\n");
+            printf("Warning: Conditions are deteriorating, prepare to leave the area.\n");
+            break;
+        case MAN_DOWN_ALARM:
+            printf("MAN DOWN! Suit silent for %d s\n", value);
+            printf("Action: Sounding area alarm and dispatching the rescue team to the last known position.\n");
+            printf("Warning: Worker may be incapacitated, check on them immediately!\n");
+            break;
+        case HAZARD_WARNING:
+            printf("COMBINED HAZARD! Severity %d of 3\n", value);
+            if (value >= 3) {
+                printf("Action: Activating emergency oxygen supply and haptic evacuation alarm.\n");
+                printf("Warning: Several hazards together are beyond safe limits, evacuate area!\n");
+            } else if (value == 2) {
+                printf("Action: Activating haptic warning system.\n");
+                printf("Warning: Combined exposure is at its limit, leave the area.\n");
+            } else {
+                printf("Action: Activating haptic pre-alarm.\n");
+                printf("Warning: Several hazards are building up, limit time in the area.\n");
+            }
+            break;
+        default:
+            printf("Unknown response code: %d\n", response_code);
+            metric_inc(metric_unknown_commands, 0);
+    }
+}
+
+const char* get_response_name(int code) {
+    switch(code) {
+        case COOLING_ON: return "Cooling System Activation";
+        case HEATING_ON: return "Heating System Activation";
+        case THERMAL_DUTY: return "Thermal Duty Cycle";
+        case RADIATION_ALARM: return "Radiation Alarm";
+        case CHEMICAL_ALARM: return "Chemical Hazard Alarm";
+        case OXYGEN_ALARM: return "Oxygen Level Alarm";
+        case NOISE_PROTECTION: return "Noise Protection";
+        case VOLTAGE_WARNING: return "Electrical Field Warning";
+        case ARC_FLASH_ALARM: return "Arc Flash Alarm";
+        case OVERCURRENT_WARNING: return "Overcurrent Warning";
+        case MAGNETIC_WARNING: return "Magnetic Field Warning";
+        case COLLISION_WARNING: return "Collision Warning";
+        case EARLY_WARNING: return "Early Hazard Warning";
+        case MAN_DOWN_ALARM: return "Man-Down Alarm";
+        case HAZARD_WARNING: return "Combined Hazard Warning";
+        default: return "Unknown Response";
+    }
+}
+
+int main() {
+    WSADATA wsaData;
+    SOCKET server_fd = INVALID_SOCKET, new_socket = INVALID_SOCKET;
+    struct sockaddr_in address;
+    socklen_t addrlen = sizeof(address);
+    
+    // With LISTEN_WORKERS set this process only supervises, workers continue from here
+    listen_workers_start("Actuator", LISTEN_MAX_WORKERS);
+    
+    // Initialize Winsock
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+        printf("WSAStartup failed: %d\n", WSAGetLastError());
+        return 1;
+    }
+    
+    // Creating socket
+    if ((server_fd = socket(AF_INET, SOCK_STREAM, 0)) == INVALID_SOCKET) {
+        printf("Socket creation error: %d\n", WSAGetLastError());
+        WSACleanup();
+        return 1;
+    }
+    
+    // Setup socket options to allow address reuse
+    int opt = 1;
+    if (setsockopt(server_fd, SOL_SOCKET, SO_REUSEADDR, (char*)&opt, sizeof(opt)) == SOCKET_ERROR) {
+        printf("Setsockopt error: %d\n", WSAGetLastError());
+        closesocket(server_fd);
+        WSACleanup();
+        return 1;
+    }
+    
+    // Workers share the port, the kernel balances connections between them
+    if (listen_workers_configure(server_fd) != 0) {
+        printf("SO_REUSEPORT error: %d\n", WSAGetLastError());
+        closesocket(server_fd);
+        WSACleanup();
+        return 1;
+    }
+    
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = INADDR_ANY;
+    address.sin_port = htons(PORT_ACTUATOR);
+    
+    // Bind the socket to the port
+    if (bind(server_fd, (struct sockaddr *)&address, sizeof(address)) == SOCKET_ERROR) {
+        printf("Bind failed: %d\n", WSAGetLastError());
+        closesocket(server_fd);
+        WSACleanup();
+        return 1;
+    }
+    
+    if (listen(server_fd, LISTEN_BACKLOG) == SOCKET_ERROR) {
+        printf("Listen error: %d\n", WSAGetLastError());
+        closesocket(server_fd);
+        WSACleanup();
+        return 1;
+    }
+    
+    printf("Actuator module started. Listening on port %d...\n", PORT_ACTUATOR);
+    init_metrics();
+    metrics_start_server(PORT_ACTUATOR + METRICS_PORT_OFFSET + listen_workers.index * LISTEN_METRICS_STRIDE);
+    if (capture_open(PORT_ACTUATOR, listen_workers.count > 0 ? listen_workers.index : -1, 0) != 0) {
+        printf("Capture file %s cannot be written\n", capture.path);
+        closesocket(server_fd);
+        WSACleanup();
+        return 1;
+    }
+    if (capture.file != NULL) printf("Capturing received traffic to %s\n", capture.path);
+    
+    listen_workers_ready();
+    while (1) {
+        if ((new_socket = listen_workers_accept(server_fd, (struct sockaddr *)&address, &addrlen)) == INVALID_SOCKET) {
+            if (listen_workers.drained) break;  // Drain requested and the queue is empty
+            printf("Accept error: %d\n", WSAGetLastError());
+            continue;
+        }
+        capture_begin(new_socket);
+        
+        int data[3];
+        int valread = recv(new_socket, (char*)data, sizeof(data), 0);
+        capture_received(new_socket, data, valread);
+        
+        if (valread >= (int)(2 * sizeof(int))) {
+            int response_code = data[0];
+            int value = data[1];
+            int suit_id = (valread >= (int)sizeof(data)) ? data[2] : 0;
+            double start = metrics_now();
+            metric_inc(metric_commands, response_code / 100);
+            
+            printf("Received from control: Suit %d, Response Code %d (%s), Value %d\n", 
+                   suit_id, response_code, get_response_name(response_code), value);
+            
+            // Activate the appropriate actuator
+            activate_actuator(response_code, value);
+            
+            // Send acknowledgment back to control
+            int ack = ACK_SUCCESS;
+            send(new_socket, (char*)&ack, sizeof(ack), 0);
+            printf("Acknowledgment sent to control: %d\n", ack);
+            metric_observe(metric_activation, metrics_now() - start);
+        }
+        
+        closesocket(new_socket);
+    }
+    
+    capture_close();
+    closesocket(server_fd);
+    WSACleanup();
+    return 0;
+}
@@ -0,0 +1,354 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+
+// Monte Carlo evaluation of false-alarm and missed-detection rates.
+// Synthetic readings at fixed true levels around each alarm threshold, spaced
+// finer than the wire's whole units where the sensor noise is small, go through
+// the sensor module's path: the suit's device model with its noise, the per-suit
+// Kalman filter and the rounded threshold comparison. Histograms of the filtered
+// values give the alarm rate for any decision threshold, so one run yields
+// operating curves (alarm rate against true level) and ROC curves.
+//
+// Work is split into blocks of trials and spread over worker threads with work
+// stealing: each worker splits its tasks in half and keeps the halves on its own
+// deque, idle workers steal the oldest (largest) task from a random peer. Every
+// block seeds its own random stream from its position, so results do not depend
+// on the number of threads or on who ran which block.
+//
+// Usage: alarm_montecarlo [million readings, default 1000] [threads, default all CPUs] [device models, e.g. pt1000,ec4]
+
+// The sensor models draw their noise from rand(); give each thread its own stream
+static _Thread_local uint64_t mc_stream;
+
+static inline int mc_rand(void) {
+    // xorshift64*
+    mc_stream ^= mc_stream >> 12;
+    mc_stream ^= mc_stream << 25;
+    mc_stream ^= mc_stream >> 27;
+    return (int)((mc_stream * 0x2545F4914F6CDD1DULL) >> 33);
+}
+
+#define rand() mc_rand()
+#include "sensor_models.h"
+#include "radiation_sensor.h"
+#include "optical_sensor.h"
+#include "sensor_filter.h"
+#include "report_policy.h"
+#undef rand
+
+#define TEMPERATURE 1
+#define RADIATION 2
+#define CHEMICAL 3
+#define PROXIMITY 8
+
+#define MC_LEVELS 9  // True levels per parameter, centred on the threshold
+#define MC_TRIAL_READINGS 32  // Readings per trial, from a fresh filter
+#define MC_WARMUP 8  // Readings per trial before the filter counts as settled
+#define MC_GRAIN 4096  // Trials per block, the unit of seeding and of the smallest task
+#define MC_HIST_BINS 256  // Rounded filtered values, threshold - 128 .. threshold + 127
+#define MC_MAX_THREADS 64
+#define MC_DEQUE_SIZE 256
+#define MC_YEARS_IN_SERVICE 2  // Sensor's DEFAULT_YEARS_IN_SERVICE
+#define MC_AMBIENT_TEMP 25.0  // Sensor's DEFAULT_AMBIENT_TEMP
+#define MC_RAD_INTEGRATION_S 10.0  // Detector integration time
+#define MC_SEED 0x5eed2025ULL
+#define MC_CSV "alarm_roc.csv"
+
+// Parameters with a noise model in the sensor path
+typedef struct {
+    int code;
+    const char *name;
+    const char *unit;
+    double step;  // Spacing of the true levels, finer than the wire's whole units
+} McParam;
+
+const McParam params[] = {
+    {TEMPERATURE, "Temperature", "°C", 0.25},
+    {RADIATION, "Radiation", "μSv/h", 2.0},
+    {CHEMICAL, "Chemical", "ppm", 0.5},
+    {PROXIMITY, "Proximity", "cm", 0.5},
+};
+#define MC_PARAMS ((int)(sizeof(params) / sizeof(params[0])))
+
+typedef struct {
+    int param;  // Index into params
+    int level;  // Index of the true level
+    long first;  // First trial, a multiple of MC_GRAIN
+    long trials;
+} McTask;
+
+// Task deque of one worker: the owner pushes and pops at the bottom, thieves take from the top
+typedef struct {
+    pthread_mutex_t lock;
+    McTask tasks[MC_DEQUE_SIZE];
+    long top, bottom;
+} McDeque;
+
+typedef struct {
+    int index;
+    McDeque deque;
+    uint64_t hist[MC_PARAMS][MC_LEVELS][MC_HIST_BINS];  // Settled readings by rounded filtered value
+    long readings;
+    long steals;
+    long blocks;
+} McWorker;
+
+McWorker *workers;
+int worker_count;
+SuitDevices devices;
+atomic_long trials_left;
+
+static double true_level(int p, int level) {
+    const ReportPolicy *policy = &report_policies[params[p].code - 1];
+    return policy->threshold + (level - MC_LEVELS / 2) * params[p].step;
+}
+
+static uint64_t splitmix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// One reading through the sensor module's model for the parameter, before filtering
+static double measure(int code, double raw) {
+    switch (code) {
+        case TEMPERATURE: {
+            double reading = devices.rtd->read(raw, MC_YEARS_IN_SERVICE);
+            return devices.rtd->compensate(reading, devices.rtd->drift_rate * MC_YEARS_IN_SERVICE);
+        }
+        case RADIATION: {
+            // Dose rate from the detector's counts over the integration time
+            int counts = simulate_radiation_counts(raw, MC_RAD_INTEGRATION_S);
+            return counts / (RAD_SENSITIVITY * MC_RAD_INTEGRATION_S / 3600.0);
+        }
+        case CHEMICAL: {
+            double interfering[7] = {0};
+            double current = devices.ec->current(GAS_CO, raw, interfering);
+            return apply_temperature_effect(devices.ec->concentration(current, GAS_CO), MC_AMBIENT_TEMP);
+        }
+        case PROXIMITY:
+            return read_proximity(raw / 100.0) * 100.0;
+    }
+    return raw;
+}
+
+// Run the trials of one task, which lies within a single block
+static void run_block(McWorker *w, const McTask *t, FilterBank *bank) {
+    int code = params[t->param].code;
+    double raw = true_level(t->param, t->level);
+    int base = (int)report_policies[code - 1].threshold - MC_HIST_BINS / 2;
+    uint64_t *hist = w->hist[t->param][t->level];
+
+    mc_stream = splitmix64(MC_SEED ^ ((uint64_t)t->param << 56) ^ ((uint64_t)t->level << 48) ^
+                           (uint64_t)(t->first / MC_GRAIN)) | 1;
+    for (long trial = 0; trial < t->trials; trial++) {
+        memset(&bank->suits[0], 0, sizeof(SuitFilters));
+        for (int r = 0; r < MC_TRIAL_READINGS; r++) {
+            FilterOutput out = filter_update(bank, 0, code, measure(code, raw));
+            if (r < MC_WARMUP) continue;
+            long bin = lround(out.value) - base;
+            if (bin < 0) bin = 0;
+            if (bin >= MC_HIST_BINS) bin = MC_HIST_BINS - 1;
+            hist[bin]++;
+        }
+    }
+    w->readings += t->trials * MC_TRIAL_READINGS;
+    w->blocks++;
+}
+
+static void deque_push(McDeque *d, const McTask *t) {
+    pthread_mutex_lock(&d->lock);
+    d->tasks[d->bottom++ % MC_DEQUE_SIZE] = *t;
+    pthread_mutex_unlock(&d->lock);
+}
+
+static int deque_pop(McDeque *d, McTask *t) {
+    int found = 0;
+    pthread_mutex_lock(&d->lock);
+    if (d->bottom > d->top) {
+        *t = d->tasks[--d->bottom % MC_DEQUE_SIZE];
+        found = 1;
+    }
+    pthread_mutex_unlock(&d->lock);
+    return found;
+}
+
+static int deque_steal(McDeque *d, McTask *t) {
+    int found = 0;
+    pthread_mutex_lock(&d->lock);
+    if (d->bottom > d->top) {
+        *t = d->tasks[d->top++ % MC_DEQUE_SIZE];
+        found = 1;
+    }
+    pthread_mutex_unlock(&d->lock);
+    return found;
+}
+
+static void *worker_main(void *arg) {
+    McWorker *w = arg;
+    FilterBank bank;
+    uint32_t victim_seed = 7u + (uint32_t)w->index;
+    McTask t;
+
+    if (filter_bank_init(&bank, 1) != 0) return NULL;
+    while (atomic_load(&trials_left) > 0) {
+        if (!deque_pop(&w->deque, &t)) {
+            // Idle: take the oldest task of a random peer
+            victim_seed = victim_seed * 1664525u + 1013904223u;
+            McWorker *victim = &workers[(victim_seed >> 8) % (uint32_t)worker_count];
+            if (victim == w || !deque_steal(&victim->deque, &t)) {
+                sched_yield();
+                continue;
+            }
+            w->steals++;
+        }
+        // Keep half, leave the other half where others can steal it
+        while (t.trials > MC_GRAIN) {
+            long keep = (t.trials / MC_GRAIN / 2) * MC_GRAIN;
+            McTask rest = {t.param, t.level, t.first + keep, t.trials - keep};
+            deque_push(&w->deque, &rest);
+            t.trials = keep;
+        }
+        run_block(w, &t, &bank);
+        atomic_fetch_sub(&trials_left, t.trials);
+    }
+    filter_bank_free(&bank);
+    return NULL;
+}
+
+// Share of settled readings that alarm with decision threshold `threshold`
+static double alarm_rate(const uint64_t *hist, int base, int threshold, int direction) {
+    uint64_t alarms = 0, total = 0;
+    for (int b = 0; b < MC_HIST_BINS; b++) {
+        int value = base + b;
+        total += hist[b];
+        if (direction == REPORT_ABOVE ? value > threshold : value < threshold) alarms += hist[b];
+    }
+    return total ? (double)alarms / total : 0.0;
+}
+
+int main(int argc, char *argv[]) {
+    double millions = (argc > 1) ? atof(argv[1]) : 1000.0;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    worker_count = (argc > 2 && atoi(argv[2]) > 0) ? atoi(argv[2]) : (int)cpus;
+    if (worker_count > MC_MAX_THREADS) worker_count = MC_MAX_THREADS;
+    int profile = (argc > 3) ? device_profile_parse(argv[3]) : DEVICE_PROFILE_DEFAULT;
+    if (profile < 0) {
+        printf("Unknown sensor model in \"%s\"\n", argv[3]);
+        return 1;
+    }
+    DeviceRegistry registry;
+    if (device_registry_init(&registry, 1) != 0) return 1;
+    device_profile_set(&registry, 0, profile);
+    devices = device_models(&registry, 0);
+    device_registry_free(&registry);
+
+    // Trials per true level, rounded up to whole blocks
+    long per_level = (long)(millions * 1e6 / (MC_PARAMS * MC_LEVELS * MC_TRIAL_READINGS));
+    per_level = (per_level + MC_GRAIN - 1) / MC_GRAIN * MC_GRAIN;
+    if (per_level < MC_GRAIN) per_level = MC_GRAIN;
+
+    printf("Smart Suit - Alarm Monte Carlo\n");
+    printf("------------------------------\n");
+    printf("Devices: %s, %s; %d thread(s) on %ld CPU(s)\n", devices.rtd->name, devices.ec->name, worker_count, cpus);
+    printf("%d parameters x %d true levels x %ld trials of %d readings (%d settled) = %.2f billion readings\n",
+           MC_PARAMS, MC_LEVELS, per_level, MC_TRIAL_READINGS, MC_TRIAL_READINGS - MC_WARMUP,
+           (double)MC_PARAMS * MC_LEVELS * per_level * MC_TRIAL_READINGS / 1e9);
+
+    workers = calloc((size_t)worker_count, sizeof(McWorker));
+    if (workers == NULL) {
+        printf("Allocation failed\n");
+        return 1;
+    }
+    for (int i = 0; i < worker_count; i++) {
+        workers[i].index = i;
+        pthread_mutex_init(&workers[i].deque.lock, NULL);
+    }
+    // Whole curve points dealt round-robin, stealing evens out the rest
+    int next = 0;
+    for (int p = 0; p < MC_PARAMS; p++) {
+        for (int l = 0; l < MC_LEVELS; l++) {
+            McTask t = {p, l, 0, per_level};
+            deque_push(&workers[next++ % worker_count].deque, &t);
+        }
+    }
+    atomic_store(&trials_left, (long)MC_PARAMS * MC_LEVELS * per_level);
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    pthread_t threads[MC_MAX_THREADS];
+    for (int i = 0; i < worker_count; i++) pthread_create(&threads[i], NULL, worker_main, &workers[i]);
+    for (int i = 0; i < worker_count; i++) pthread_join(threads[i], NULL);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double elapsed = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+    // Merge the per-worker histograms into the first
+    long readings = 0, steals = 0, blocks = 0;
+    for (int i = 0; i < worker_count; i++) {
+        readings += workers[i].readings;
+        steals += workers[i].steals;
+        blocks += workers[i].blocks;
+        if (i == 0) continue;
+        for (int p = 0; p < MC_PARAMS; p++)
+            for (int l = 0; l < MC_LEVELS; l++)
+                for (int b = 0; b < MC_HIST_BINS; b++) workers[0].hist[p][l][b] += workers[i].hist[p][l][b];
+    }
+    printf("%.1f s, %.1f M readings/s, %ld blocks, %ld steals\n", elapsed, readings / elapsed / 1e6, blocks, steals);
+    for (int i = 0; i < worker_count && worker_count > 1; i++) {
+        printf("  thread %d: %.1f%% of the readings\n", i, 100.0 * workers[i].readings / readings);
+    }
+
+    FILE *csv = fopen(MC_CSV, "w");
+    if (csv) fprintf(csv, "param,true_level,decision_threshold,alarm_rate\n");
+    for (int p = 0; p < MC_PARAMS; p++) {
+        const ReportPolicy *policy = &report_policies[params[p].code - 1];
+        int threshold = (int)policy->threshold;
+        int base = threshold - MC_HIST_BINS / 2;
+        uint64_t (*hist)[MC_HIST_BINS] = workers[0].hist[p];
+
+        printf("\n%s, alarm %s %d %s\n", params[p].name, policy->direction == REPORT_ABOVE ? "above" : "below",
+               threshold, params[p].unit);
+        printf("  True level   Alarm rate   (false alarms on the safe side, 1 - rate missed on the hazard side)\n");
+        for (int l = 0; l < MC_LEVELS; l++) {
+            double level = true_level(p, l);
+            int hazard = policy->direction == REPORT_ABOVE ? level > threshold : level < threshold;
+            double rate = alarm_rate(hist[l], base, threshold, policy->direction);
+            printf("  %10.2f   %10.3e   %s\n", level, rate, level == threshold ? "at threshold" :
+                   hazard ? "hazard" : "safe");
+        }
+
+        // ROC between a safe and a hazardous level two steps either side of the threshold
+        int safe = MC_LEVELS / 2 + (policy->direction == REPORT_ABOVE ? -2 : 2);
+        int danger = MC_LEVELS - 1 - safe;
+        printf("  ROC, true %.2f (safe) against %.2f (hazard):\n", true_level(p, safe), true_level(p, danger));
+        printf("  Decision   False alarm   Detection\n");
+        int span = 3 * (int)ceil(params[p].step);
+        for (int d = threshold - span; d <= threshold + span; d++) {
+            printf("  %8d   %11.3e   %9.6f%s\n", d, alarm_rate(hist[safe], base, d, policy->direction),
+                   alarm_rate(hist[danger], base, d, policy->direction), d == threshold ? "   <- configured" : "");
+        }
+
+        if (csv) {
+            for (int l = 0; l < MC_LEVELS; l++) {
+                for (int d = base + 1; d < base + MC_HIST_BINS - 1; d++) {
+                    fprintf(csv, "%s,%g,%d,%.9g\n", params[p].name, true_level(p, l), d,
+                            alarm_rate(hist[l], base, d, policy->direction));
+                }
+            }
+        }
+    }
+    if (csv) {
+        fclose(csv);
+        printf("\nFull curves written to %s\n", MC_CSV);
+    }
+    free(workers);
+    return 0;
+}
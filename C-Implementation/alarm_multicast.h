@@ -0,0 +1,392 @@
+#ifndef ALARM_MULTICAST_H
+#define ALARM_MULTICAST_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include "net_compat.h"
+
+// Alarm distribution over UDP multicast. A publisher sends each alarm once to
+// the group, whatever the number of subscribers (standby controllers, area
+// sirens, supervisor consoles). Alarms carry a per-publisher sequence number.
+//
+// A subscriber delivers every alarm the first time it arrives and drops repeats.
+// It picks a publisher's stream up at the first alarm or heartbeat it sees; what
+// was sent before it joined is history, never NACKed or delivered as live.
+// A gap in the sequence, or a heartbeat announcing alarms it never saw, makes
+// it NACK the missing range to the publisher. The publisher multicasts repairs
+// from a ring of its latest alarms, so one repair serves every subscriber that
+// missed the alarm, and the NACKs of the others arriving just after it are not
+// answered again. A gap still open after ALARM_NACK_TRIES NACKs is given up and
+// counted lost. Heartbeats while idle expose a lost tail alarm within
+// ALARM_HEARTBEAT_MS.
+//
+// The group is configured as "group:port", optionally "@interface address";
+// multicast loopback is on, so publisher and subscribers can share a host.
+#define ALARM_MULTICAST_ENV "ALARM_MULTICAST"
+#define ALARM_MAGIC 0x4d524c41u  // "ALRM"
+#define ALARM_RING 1024  // Alarms kept for repair, power of two
+#define ALARM_NACK_RUNS 16  // Missing ranges reported per NACK round
+#define ALARM_MAX_SOURCES 64  // Publishers tracked by one subscriber
+#define ALARM_HEARTBEAT_MS 1000
+#define ALARM_NACK_DELAY_MS 5  // Lets reordered alarms arrive before asking
+#define ALARM_NACK_RETRY_MS 50
+#define ALARM_REPAIR_HOLDOFF_MS 20  // An alarm is repaired at most once in this time
+#define ALARM_NACK_TRIES 5
+#define ALARM_TTL 1  // Stay on the site network
+
+typedef enum {
+    ALARM_DATA = 1,
+    ALARM_REPAIR,  // Resent to the group on a NACK
+    ALARM_HEARTBEAT,  // seq = latest alarm sent
+    ALARM_NACK  // seq = first missing, count = length of the range
+} AlarmPacketType;
+
+// 40 bytes on the wire, host byte order like the TCP messages
+typedef struct {
+    uint32_t magic;
+    uint32_t type;
+    uint32_t source;  // Publisher instance, a restart starts a new stream
+    uint32_t seq;
+    uint32_t count;
+    int32_t suit_id;
+    int32_t param_code;
+    int32_t value;
+    int64_t sent_us;  // Publisher wall clock, for fan-out latency
+} AlarmPacket;
+
+typedef struct {
+    SOCKET sock;
+    struct sockaddr_in group;
+    uint32_t source;
+    uint32_t next_seq;
+    AlarmPacket ring[ALARM_RING];  // Indexed by seq
+    double repaired_at[ALARM_RING];
+    double last_send;
+    long published;
+    long repaired;
+    long nacks;
+} AlarmPublisher;
+
+// One publisher's stream as seen by a subscriber
+typedef struct {
+    uint32_t source;
+    struct sockaddr_in addr;  // Where NACKs go
+    uint32_t next;  // Lowest seq not received yet
+    uint32_t highest;  // Highest seq known to exist
+    uint64_t received[ALARM_RING / 64];  // Bit seq % ALARM_RING, for seqs after next within the ring
+    int gap;  // Alarms between next and highest are missing
+    double nack_at;
+    uint32_t nack_first;  // First missing alarm the tries count for
+    int nack_tries;
+} AlarmStream;
+
+typedef struct {
+    SOCKET sock;
+    AlarmStream streams[ALARM_MAX_SOURCES];
+    int count;
+    int drop_per_mille;  // Testing: discard this share of received packets
+    long delivered;
+    long duplicates;
+    long repaired;  // Delivered from a repair
+    long lost;
+    long nacks;
+} AlarmSubscriber;
+
+static double alarm_now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int64_t alarm_wall_us() {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+// Parse "group:port[@interface]"; returns -1 on a malformed spec
+static int alarm_parse(const char *spec, struct sockaddr_in *group, struct in_addr *iface) {
+    char host[64];
+    int port = 0;
+    const char *colon = strchr(spec, ':');
+    if (colon == NULL || colon - spec >= (int)sizeof(host)) return -1;
+    memcpy(host, spec, colon - spec);
+    host[colon - spec] = '\0';
+    port = atoi(colon + 1);
+    if (port <= 0 || port > 65535) return -1;
+
+    memset(group, 0, sizeof(*group));
+    group->sin_family = AF_INET;
+    group->sin_port = htons(port);
+    if (inet_pton(AF_INET, host, &group->sin_addr) <= 0) return -1;
+    if ((ntohl(group->sin_addr.s_addr) >> 28) != 14) return -1;  // Not 224.0.0.0/4
+
+    iface->s_addr = htonl(INADDR_ANY);
+    const char *at = strchr(colon, '@');
+    if (at != NULL && inet_pton(AF_INET, at + 1, iface) <= 0) return -1;
+    return 0;
+}
+
+static int alarm_wait(SOCKET sock, int timeout_ms) {
+    fd_set readable;
+    struct timeval wait = {timeout_ms / 1000, (timeout_ms % 1000) * 1000};
+    FD_ZERO(&readable);
+    FD_SET(sock, &readable);
+    return select((int)sock + 1, &readable, NULL, NULL, &wait) > 0;
+}
+
+int alarm_publisher_open(AlarmPublisher *p, const char *spec) {
+    struct in_addr iface;
+    int ttl = ALARM_TTL, loop = 1;
+
+    memset(p, 0, sizeof(*p));
+    p->sock = INVALID_SOCKET;
+    if (alarm_parse(spec, &p->group, &iface) != 0) return -1;
+    if ((p->sock = socket(AF_INET, SOCK_DGRAM, 0)) == INVALID_SOCKET) return -1;
+    setsockopt(p->sock, IPPROTO_IP, IP_MULTICAST_TTL, (char*)&ttl, sizeof(ttl));
+    setsockopt(p->sock, IPPROTO_IP, IP_MULTICAST_LOOP, (char*)&loop, sizeof(loop));
+    if (iface.s_addr != htonl(INADDR_ANY)) {
+        setsockopt(p->sock, IPPROTO_IP, IP_MULTICAST_IF, (char*)&iface, sizeof(iface));
+    }
+    p->source = (uint32_t)alarm_wall_us() ^ ((uint32_t)rand() << 16);
+    p->next_seq = 1;
+    p->last_send = alarm_now();
+    return 0;
+}
+
+void alarm_publisher_close(AlarmPublisher *p) {
+    if (p->sock != INVALID_SOCKET) closesocket(p->sock);
+    p->sock = INVALID_SOCKET;
+}
+
+// Send one alarm to the group, returns its sequence number
+uint32_t alarm_publish(AlarmPublisher *p, int suit_id, int param_code, int value) {
+    uint32_t seq = p->next_seq++;
+    AlarmPacket *packet = &p->ring[seq & (ALARM_RING - 1)];
+    *packet = (AlarmPacket){ALARM_MAGIC, ALARM_DATA, p->source, seq, 0, suit_id, param_code, value, alarm_wall_us()};
+    p->repaired_at[seq & (ALARM_RING - 1)] = 0.0;
+    sendto(p->sock, (char*)packet, sizeof(*packet), 0, (struct sockaddr *)&p->group, sizeof(p->group));
+    p->published++;
+    p->last_send = alarm_now();
+    return seq;
+}
+
+// Answer NACKs and keep the heartbeat going; call whenever the caller is idle
+void alarm_publisher_service(AlarmPublisher *p) {
+    AlarmPacket nack;
+    struct sockaddr_in from;
+    socklen_t fromlen = sizeof(from);
+
+    if (p->sock == INVALID_SOCKET) return;
+    while (alarm_wait(p->sock, 0)) {
+        int n = recvfrom(p->sock, (char*)&nack, sizeof(nack), 0, (struct sockaddr *)&from, &fromlen);
+        fromlen = sizeof(from);
+        if (n != (int)sizeof(nack) || nack.magic != ALARM_MAGIC || nack.type != ALARM_NACK ||
+            nack.source != p->source) continue;
+        p->nacks++;
+        // Repairs for what is still in the ring, anything older is gone
+        double now = alarm_now();
+        uint32_t count = (nack.count < ALARM_RING) ? nack.count : ALARM_RING;
+        for (uint32_t i = 0; i < count; i++) {
+            uint32_t seq = nack.seq + i;
+            AlarmPacket repair = p->ring[seq & (ALARM_RING - 1)];
+            double *repaired_at = &p->repaired_at[seq & (ALARM_RING - 1)];
+            if (repair.seq != seq || repair.magic != ALARM_MAGIC) continue;
+            if ((now - *repaired_at) * 1000.0 < ALARM_REPAIR_HOLDOFF_MS) continue;
+            repair.type = ALARM_REPAIR;
+            sendto(p->sock, (char*)&repair, sizeof(repair), 0, (struct sockaddr *)&p->group, sizeof(p->group));
+            *repaired_at = now;
+            p->repaired++;
+        }
+    }
+    if ((alarm_now() - p->last_send) * 1000.0 >= ALARM_HEARTBEAT_MS && p->next_seq > 1) {
+        AlarmPacket heartbeat = {ALARM_MAGIC, ALARM_HEARTBEAT, p->source, p->next_seq - 1, 0, 0, 0, 0, alarm_wall_us()};
+        sendto(p->sock, (char*)&heartbeat, sizeof(heartbeat), 0, (struct sockaddr *)&p->group, sizeof(p->group));
+        p->last_send = alarm_now();
+    }
+}
+
+int alarm_subscriber_open(AlarmSubscriber *s, const char *spec) {
+    struct sockaddr_in group, bind_addr;
+    struct in_addr iface;
+    struct ip_mreq membership;
+    int opt = 1;
+
+    memset(s, 0, sizeof(*s));
+    s->sock = INVALID_SOCKET;
+    if (alarm_parse(spec, &group, &iface) != 0) return -1;
+    if ((s->sock = socket(AF_INET, SOCK_DGRAM, 0)) == INVALID_SOCKET) return -1;
+    // Several subscribers on one host share the port
+    setsockopt(s->sock, SOL_SOCKET, SO_REUSEADDR, (char*)&opt, sizeof(opt));
+    setsockopt(s->sock, IPPROTO_IP, IP_MULTICAST_LOOP, (char*)&opt, sizeof(opt));
+
+    memset(&bind_addr, 0, sizeof(bind_addr));
+    bind_addr.sin_family = AF_INET;
+    bind_addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    bind_addr.sin_port = group.sin_port;
+    membership.imr_multiaddr = group.sin_addr;
+    membership.imr_interface = iface;
+    if (bind(s->sock, (struct sockaddr *)&bind_addr, sizeof(bind_addr)) == SOCKET_ERROR ||
+        setsockopt(s->sock, IPPROTO_IP, IP_ADD_MEMBERSHIP, (char*)&membership, sizeof(membership)) == SOCKET_ERROR) {
+        closesocket(s->sock);
+        s->sock = INVALID_SOCKET;
+        return -1;
+    }
+    return 0;
+}
+
+void alarm_subscriber_close(AlarmSubscriber *s) {
+    if (s->sock != INVALID_SOCKET) closesocket(s->sock);
+    s->sock = INVALID_SOCKET;
+}
+
+static AlarmStream *alarm_stream(AlarmSubscriber *s, const AlarmPacket *packet, const struct sockaddr_in *from) {
+    for (int i = 0; i < s->count; i++) {
+        if (s->streams[i].source == packet->source) return &s->streams[i];
+    }
+    // A new publisher: start from what it sends now, its history is not ours to recover.
+    // A heartbeat or another subscriber's repair only tells where the stream stands.
+    AlarmStream *stream = &s->streams[(s->count < ALARM_MAX_SOURCES) ? s->count++ : ALARM_MAX_SOURCES - 1];
+    memset(stream, 0, sizeof(*stream));
+    stream->source = packet->source;
+    stream->next = (packet->type == ALARM_DATA) ? packet->seq : packet->seq + 1;
+    stream->highest = stream->next - 1;
+    stream->addr = *from;
+    return stream;
+}
+
+static inline int alarm_received(const AlarmStream *stream, uint32_t seq) {
+    return (stream->received[(seq % ALARM_RING) / 64] >> (seq % 64)) & 1;
+}
+
+static inline void alarm_mark(AlarmStream *stream, uint32_t seq, int received) {
+    uint64_t bit = (uint64_t)1 << (seq % 64);
+    uint64_t *word = &stream->received[(seq % ALARM_RING) / 64];
+    *word = received ? (*word | bit) : (*word & ~bit);
+}
+
+// Step next past itself (just received or given up) and the alarms received after it
+static void alarm_advance(AlarmStream *stream) {
+    do {
+        alarm_mark(stream, stream->next, 0);
+        stream->next++;
+    } while (alarm_received(stream, stream->next));
+}
+
+static void alarm_check_gap(AlarmStream *stream, double now) {
+    int gap = (int32_t)(stream->highest - stream->next) >= 0;
+    if (gap && !stream->gap) {
+        stream->nack_at = now + ALARM_NACK_DELAY_MS / 1000.0;
+        stream->nack_tries = 0;
+    }
+    stream->gap = gap;
+}
+
+// Mark seq received; returns 1 if it is new
+static int alarm_accept(AlarmSubscriber *s, AlarmStream *stream, uint32_t seq, double now) {
+    int32_t ahead = (int32_t)(seq - stream->next);
+    if (ahead < 0) return 0;
+    // Beyond what the publisher can still repair: the oldest missing alarms are lost
+    while ((int32_t)(seq - stream->next) >= ALARM_RING) {
+        s->lost++;
+        alarm_advance(stream);
+    }
+    if ((int32_t)(seq - stream->highest) > 0) stream->highest = seq;
+    if (seq == stream->next) {
+        alarm_advance(stream);
+    } else {
+        if (alarm_received(stream, seq)) return 0;
+        alarm_mark(stream, seq, 1);
+    }
+    alarm_check_gap(stream, now);
+    return 1;
+}
+
+// NACK the missing ranges of open gaps that are due. After ALARM_NACK_TRIES
+// rounds the first missing range is given up and the rest start over.
+static void alarm_send_nacks(AlarmSubscriber *s, double now) {
+    for (int i = 0; i < s->count; i++) {
+        AlarmStream *stream = &s->streams[i];
+        if (!stream->gap || now < stream->nack_at) continue;
+        if (stream->next != stream->nack_first) {
+            stream->nack_first = stream->next;
+            stream->nack_tries = 0;
+        }
+        if (stream->nack_tries >= ALARM_NACK_TRIES) {
+            while (!alarm_received(stream, stream->next) && (int32_t)(stream->next - stream->highest) <= 0) {
+                s->lost++;
+                stream->next++;
+            }
+            if (alarm_received(stream, stream->next)) alarm_advance(stream);
+            stream->gap = 0;
+            alarm_check_gap(stream, now);
+            continue;
+        }
+        int runs = 0;
+        uint32_t seq = stream->next;
+        while ((int32_t)(seq - stream->highest) <= 0 && runs < ALARM_NACK_RUNS) {
+            if (alarm_received(stream, seq)) {
+                seq++;
+                continue;
+            }
+            uint32_t first = seq;
+            while ((int32_t)(seq - stream->highest) <= 0 && !alarm_received(stream, seq)) seq++;
+            AlarmPacket nack = {ALARM_MAGIC, ALARM_NACK, stream->source, first, seq - first, 0, 0, 0, alarm_wall_us()};
+            sendto(s->sock, (char*)&nack, sizeof(nack), 0, (struct sockaddr *)&stream->addr, sizeof(stream->addr));
+            s->nacks++;
+            runs++;
+        }
+        stream->nack_tries++;
+        stream->nack_at = now + ALARM_NACK_RETRY_MS / 1000.0;
+    }
+}
+
+// Wait up to timeout_ms for the next new alarm. Returns 1 with the alarm in out,
+// 0 on timeout. Repeats, heartbeats and repairs of alarms already seen are absorbed.
+int alarm_subscriber_poll(AlarmSubscriber *s, AlarmPacket *out, int timeout_ms) {
+    double deadline = alarm_now() + timeout_ms / 1000.0;
+    struct sockaddr_in from;
+    socklen_t fromlen;
+
+    while (1) {
+        double now = alarm_now();
+        alarm_send_nacks(s, now);
+
+        // Wake for the earliest NACK due, if before the deadline
+        double wake = deadline;
+        for (int i = 0; i < s->count; i++) {
+            if (s->streams[i].gap && s->streams[i].nack_at < wake) wake = s->streams[i].nack_at;
+        }
+        int wait_ms = (wake > now) ? (int)((wake - now) * 1000.0 + 0.999) : 0;
+        if (!alarm_wait(s->sock, wait_ms)) {
+            if (alarm_now() >= deadline) return 0;
+            continue;
+        }
+
+        fromlen = sizeof(from);
+        int n = recvfrom(s->sock, (char*)out, sizeof(*out), 0, (struct sockaddr *)&from, &fromlen);
+        if (n != (int)sizeof(*out) || out->magic != ALARM_MAGIC) continue;
+        if (out->type != ALARM_DATA && out->type != ALARM_REPAIR && out->type != ALARM_HEARTBEAT) continue;
+        if (s->drop_per_mille > 0 && rand() % 1000 < s->drop_per_mille) continue;
+
+        now = alarm_now();
+        AlarmStream *stream = alarm_stream(s, out, &from);
+        if (out->type == ALARM_HEARTBEAT) {
+            if ((int32_t)(out->seq - stream->highest) > 0) stream->highest = out->seq;
+            alarm_check_gap(stream, now);
+            continue;
+        }
+        if (!alarm_accept(s, stream, out->seq, now)) {
+            s->duplicates++;
+            continue;
+        }
+        s->delivered++;
+        if (out->type == ALARM_REPAIR) s->repaired++;
+        return 1;
+    }
+}
+
+#endif
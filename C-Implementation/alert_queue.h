@@ -0,0 +1,182 @@
+#ifndef ALERT_QUEUE_H
+#define ALERT_QUEUE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+// Bounded outbound alert queue with priority load shedding, plus a circuit
+// breaker, one of each per control shard.
+//
+// A repeat alert for a suit and parameter that is still queued is merged into
+// the queued one (latest value wins), so a stalled shard holds one entry per
+// condition rather than one per reading. When the queue passes the shedding
+// mark, routine alerts are refused on arrival to keep room for critical ones;
+// when it is full, the oldest alert of the lowest priority present makes way
+// for anything at least as important. Alerts leave highest priority first.
+#define ALERT_QUEUE_SIZE 256  // Per control shard
+#define ALERT_CONGESTED_PERCENT 50  // Upstream is asked to slow down from here
+#define ALERT_SHEDDING_PERCENT 90  // Routine alerts are refused from here
+#define ALERT_BREAKER_FAILURES 3  // Consecutive failures that open the breaker
+#define ALERT_BACKOFF_MIN_MS 500
+#define ALERT_BACKOFF_MAX_MS 30000
+
+typedef enum {
+    ALERT_ROUTINE,  // Temperature, noise
+    ALERT_ELEVATED,  // Voltage, magnetic, proximity, early warnings of critical parameters
+    ALERT_CRITICAL,  // Oxygen, radiation, chemical, arc flash
+    ALERT_PRIORITIES
+} AlertPriority;
+
+// Backpressure level reported upstream
+typedef enum {
+    PRESSURE_OK,
+    PRESSURE_CONGESTED,
+    PRESSURE_SHEDDING
+} QueuePressure;
+
+typedef enum {
+    BREAKER_CLOSED,  // Sending normally
+    BREAKER_OPEN,  // Not trying until retry_ms
+    BREAKER_HALF_OPEN  // One probe allowed, its result decides
+} BreakerState;
+
+typedef enum {
+    ALERT_QUEUED,
+    ALERT_MERGED,
+    ALERT_EVICTED,  // Queued, a less important alert was dropped for it
+    ALERT_DROPPED
+} QueueResult;
+
+typedef struct {
+    int suit_id;
+    int param_code;
+    int value;
+    int priority;
+    int merged;  // Repeats folded into this entry
+    uint32_t seq;  // Arrival order
+    uint32_t queued_ms;
+} QueuedAlert;
+
+typedef struct {
+    QueuedAlert items[ALERT_QUEUE_SIZE];  // Unordered, the first `count` are in use
+    int count;
+    uint32_t next_seq;
+    long dropped[ALERT_PRIORITIES];
+    long merged;
+
+    BreakerState breaker;
+    int failures;
+    uint32_t backoff_ms;
+    uint32_t retry_ms;
+} AlertQueue;
+
+void alert_queue_init(AlertQueue *q) {
+    memset(q, 0, sizeof(*q));
+    q->breaker = BREAKER_CLOSED;
+}
+
+QueuePressure alert_queue_pressure(const AlertQueue *q) {
+    int percent = q->count * 100 / ALERT_QUEUE_SIZE;
+    if (percent >= ALERT_SHEDDING_PERCENT) return PRESSURE_SHEDDING;
+    if (percent >= ALERT_CONGESTED_PERCENT || q->breaker == BREAKER_OPEN) return PRESSURE_CONGESTED;
+    return PRESSURE_OK;
+}
+
+QueueResult alert_queue_push(AlertQueue *q, int suit_id, int param_code, int value, int priority, uint32_t now_ms) {
+    QueuedAlert *slot = NULL;
+    QueueResult result = ALERT_QUEUED;
+
+    for (int i = 0; i < q->count; i++) {
+        QueuedAlert *a = &q->items[i];
+        if (a->suit_id == suit_id && a->param_code == param_code) {
+            a->value = value;
+            a->merged++;
+            q->merged++;
+            return ALERT_MERGED;
+        }
+    }
+
+    if (priority == ALERT_ROUTINE && alert_queue_pressure(q) == PRESSURE_SHEDDING) {
+        q->dropped[priority]++;
+        return ALERT_DROPPED;
+    }
+
+    if (q->count < ALERT_QUEUE_SIZE) {
+        slot = &q->items[q->count++];
+    } else {
+        // Full: the oldest of the least important alerts gives way, if it is not above this one
+        QueuedAlert *victim = &q->items[0];
+        for (int i = 1; i < q->count; i++) {
+            QueuedAlert *a = &q->items[i];
+            if (a->priority < victim->priority ||
+                (a->priority == victim->priority && (int32_t)(a->seq - victim->seq) < 0)) {
+                victim = a;
+            }
+        }
+        if (victim->priority > priority) {
+            q->dropped[priority]++;
+            return ALERT_DROPPED;
+        }
+        q->dropped[victim->priority]++;
+        slot = victim;
+        result = ALERT_EVICTED;
+    }
+
+    slot->suit_id = suit_id;
+    slot->param_code = param_code;
+    slot->value = value;
+    slot->priority = priority;
+    slot->merged = 0;
+    slot->seq = q->next_seq++;
+    slot->queued_ms = now_ms;
+    return result;
+}
+
+// Most important alert, oldest first within a priority; NULL when empty
+QueuedAlert *alert_queue_next(AlertQueue *q) {
+    QueuedAlert *best = NULL;
+    for (int i = 0; i < q->count; i++) {
+        QueuedAlert *a = &q->items[i];
+        if (best == NULL || a->priority > best->priority ||
+            (a->priority == best->priority && (int32_t)(a->seq - best->seq) < 0)) {
+            best = a;
+        }
+    }
+    return best;
+}
+
+void alert_queue_remove(AlertQueue *q, QueuedAlert *a) {
+    *a = q->items[--q->count];
+}
+
+// May a send be attempted now? An open breaker lets one probe through after its backoff.
+int breaker_allow(AlertQueue *q, uint32_t now_ms) {
+    if (q->breaker == BREAKER_OPEN) {
+        if ((int32_t)(now_ms - q->retry_ms) < 0) return 0;
+        q->breaker = BREAKER_HALF_OPEN;
+    }
+    return 1;
+}
+
+void breaker_success(AlertQueue *q) {
+    q->breaker = BREAKER_CLOSED;
+    q->failures = 0;
+    q->backoff_ms = 0;
+}
+
+// Returns 1 when this failure opened the breaker
+int breaker_failure(AlertQueue *q, uint32_t now_ms) {
+    q->failures++;
+    if (q->breaker != BREAKER_HALF_OPEN && q->failures < ALERT_BREAKER_FAILURES) return 0;
+
+    // Exponential backoff between probes
+    q->backoff_ms = q->backoff_ms ? q->backoff_ms * 2 : ALERT_BACKOFF_MIN_MS;
+    if (q->backoff_ms > ALERT_BACKOFF_MAX_MS) q->backoff_ms = ALERT_BACKOFF_MAX_MS;
+    q->retry_ms = now_ms + q->backoff_ms;
+    q->breaker = BREAKER_OPEN;
+    return 1;
+}
+
+#endif
@@ -0,0 +1,106 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "net_compat.h"
+#include "metrics.h"
+#include "alarm_multicast.h"
+
+// Area siren / supervisor console: subscribes to the critical alarm group and
+// announces every alarm once, recovering missed ones from the publisher.
+//
+//   annunciator [group:port[@interface]] [metrics port]
+//
+// The group defaults to ALARM_MULTICAST, then ALARM_MULTICAST_DEFAULT. Any number
+// of annunciators can run, on one host or many; the publisher's cost does not change.
+#define ALARM_MULTICAST_DEFAULT "239.255.70.1:9500"
+
+// Parameter codes carried by critical alarms
+#define RADIATION 2
+#define CHEMICAL 3
+#define OXYGEN 4
+#define ARC_FLASH 9
+#define MAN_DOWN 13
+
+int metric_alarms, metric_duplicates, metric_repairs, metric_lost, metric_nacks, metric_fanout;
+
+void init_metrics() {
+    metrics_init("smartsuit_annunciator");
+    metric_alarms = metrics_register("alarms_received_total", "Alarms announced, each once", METRIC_COUNTER, "param", 16);
+    metric_duplicates = metrics_register("alarm_duplicates_total", "Repeats of alarms already announced",
+                                         METRIC_COUNTER, NULL, 1);
+    metric_repairs = metrics_register("alarm_repairs_total", "Alarms recovered after a NACK", METRIC_COUNTER, NULL, 1);
+    metric_lost = metrics_register("alarms_lost_total", "Alarms given up after repeated NACKs", METRIC_COUNTER, NULL, 1);
+    metric_nacks = metrics_register("alarm_nacks_sent_total", "Gap reports sent to publishers", METRIC_COUNTER, NULL, 1);
+    metric_fanout = metrics_register("alarm_fanout_seconds", "Publish to announcement time (publisher clock)",
+                                     METRIC_HISTOGRAM, NULL, 1);
+}
+
+const char* get_param_name(int code) {
+    switch(code) {
+        case RADIATION: return "Radiation";
+        case CHEMICAL: return "Chemical";
+        case OXYGEN: return "Oxygen";
+        case ARC_FLASH: return "Arc Flash";
+        case MAN_DOWN: return "Man Down";
+        default: return "Unknown";
+    }
+}
+
+int main(int argc, char *argv[]) {
+    WSADATA wsaData;
+    AlarmSubscriber subscriber;
+    AlarmPacket alarm;
+
+    const char *group = (argc > 1) ? argv[1] : getenv(ALARM_MULTICAST_ENV);
+    if (group == NULL || *group == '\0') group = ALARM_MULTICAST_DEFAULT;
+
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+        printf("WSAStartup failed: %d\n", WSAGetLastError());
+        return 1;
+    }
+    if (alarm_subscriber_open(&subscriber, group) != 0) {
+        printf("Cannot join alarm multicast group %s: %d\n", group, WSAGetLastError());
+        WSACleanup();
+        return 1;
+    }
+
+    printf("Annunciator started. Listening for alarms on %s...\n", group);
+    init_metrics();
+    // Several annunciators may share a host, each needs its own metrics port
+    if (argc > 2) metrics_start_server(atoi(argv[2]));
+
+    long lost = 0, repairs = 0, nacks = 0, duplicates = 0;
+    while (1) {
+        int received = alarm_subscriber_poll(&subscriber, &alarm, ALARM_HEARTBEAT_MS);
+
+        metric_add(metric_duplicates, 0, (uint64_t)(subscriber.duplicates - duplicates));
+        metric_add(metric_repairs, 0, (uint64_t)(subscriber.repaired - repairs));
+        metric_add(metric_nacks, 0, (uint64_t)(subscriber.nacks - nacks));
+        metric_add(metric_lost, 0, (uint64_t)(subscriber.lost - lost));
+        if (subscriber.lost > lost) {
+            printf("WARNING: %ld alarm(s) could not be recovered from the publisher\n", subscriber.lost - lost);
+        }
+        duplicates = subscriber.duplicates;
+        repairs = subscriber.repaired;
+        nacks = subscriber.nacks;
+        lost = subscriber.lost;
+        if (!received) continue;
+
+        double fanout = (alarm_wall_us() - alarm.sent_us) / 1e6;
+        metric_inc(metric_alarms, alarm.param_code);
+        metric_observe(metric_fanout, fanout);
+
+        time_t now = time(NULL);
+        char timestamp[26];
+        strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", localtime(&now));
+        printf("[%s] ALARM: Suit %d, %s, value %d", timestamp, alarm.suit_id, get_param_name(alarm.param_code),
+               alarm.value);
+        printf(" (seq %u, %.2f ms%s)\n", alarm.seq, fanout * 1000.0,
+               (alarm.type == ALARM_REPAIR) ? ", recovered" : "");
+    }
+
+    alarm_subscriber_close(&subscriber);
+    WSACleanup();
+    return 0;
+}
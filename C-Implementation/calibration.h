@@ -0,0 +1,331 @@
+#ifndef CALIBRATION_H
+#define CALIBRATION_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+// Per-suit, per-channel calibration and device metadata, loaded from a CSV file:
+//
+//   suit_id,channel,offset,gain,install_date,cell_date,bump_date
+//   7,1,-0.20,1.000,2023-04-11,,
+//   7,3,0.0,1.040,2024-01-02,2024-01-02,2025-02-27
+//
+// channel is the parameter code, dates are YYYY-MM-DD and may be left empty.
+// A row may go on with a 3D magnetometer's hard-iron offset and soft-iron matrix,
+// both in the sensor's units: x,y,z then the nine elements row by row, so that
+// calibrated = S * (raw - offset). They are kept per suit, apart from the table:
+//
+//   7,7,0.0,1.000,2023-04-11,,,0.12,-0.05,0.02,1.02,0,0,0,0.98,0,0,0,1.00
+//
+// The table is flat open addressing with 32-byte entries aligned so an entry never
+// straddles a cache line; at half load most lookups touch a single line.
+// Updates build a new table and swap the pointer, so readers never lock.
+#define CAL_DEFAULT_FILE "calibration.csv"
+#define CAL_CHANNELS 16  // Channel part of the key
+#define CAL_RELOAD_SECONDS 5  // How often the reloader checks the file
+#define CAL_BUMP_INTERVAL_DAYS 1  // Gas channels should be bump tested before each day's use
+#define CAL_CELL_SENSITIVITY_LOSS 0.02  // Fraction of EC sensitivity lost per year of cell age
+#define CAL_FIELDS 7  // Up to the bump date
+#define CAL_MAG_FIELDS 12  // Magnetometer offset and soft-iron matrix after the dates
+
+typedef struct {
+    _Alignas(32) uint32_t key;  // suit_id * CAL_CHANNELS + channel + 1, 0 = empty slot
+    float offset;  // Added after the gain
+    float gain;
+    int32_t install_day;  // Days since 1970-01-01, 0 = unknown
+    int32_t cell_day;  // EC or O2 cell fitted
+    int32_t bump_day;  // Last bump test
+    int32_t reserved[2];
+} CalibrationEntry;
+
+typedef struct {
+    int suit_id;
+    float offset[3];
+    float soft[9];  // Row-major
+} MagnetometerEntry;
+
+typedef struct {
+    CalibrationEntry *entries;
+    uint32_t mask;  // Capacity - 1, capacity is a power of two
+    uint32_t shift;  // 32 - log2(capacity)
+    uint32_t count;
+    MagnetometerEntry *magnetometers;  // In file order, a later row for a suit wins
+    uint32_t magnetometer_count;
+} CalibrationTable;
+
+typedef struct {
+    _Atomic(CalibrationTable *) current;
+    CalibrationTable *retired;  // Freed on the next swap, CAL_RELOAD_SECONDS or more later
+    _Atomic uint32_t generation;  // Bumped on every swap
+    const char *path;
+    time_t loaded_mtime;
+} CalibrationRegistry;
+
+// Days since 1970-01-01 of a civil date (proleptic Gregorian)
+int32_t calibration_day(int year, int month, int day) {
+    year -= month <= 2;
+    int era = (year >= 0 ? year : year - 399) / 400;
+    int yoe = year - era * 400;
+    int doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+int32_t calibration_today() {
+    return (int32_t)(time(NULL) / 86400);
+}
+
+// Years between a recorded day and today, or -1 when the date is unknown
+double calibration_years(int32_t day, int32_t today) {
+    return day ? (today - day) / 365.25 : -1.0;
+}
+
+static inline uint32_t calibration_key(int suit_id, int channel) {
+    return (uint32_t)suit_id * CAL_CHANNELS + (uint32_t)channel + 1;
+}
+
+// Fibonacci hashing: the top bits of the product spread the dense runs of suit IDs
+static inline uint32_t calibration_hash(uint32_t key, const CalibrationTable *table) {
+    return (key * 2654435761u) >> table->shift;
+}
+
+void calibration_table_free(CalibrationTable *table) {
+    if (table == NULL) return;
+#ifdef _WIN32
+    _aligned_free(table->entries);
+#else
+    free(table->entries);
+#endif
+    free(table->magnetometers);
+    free(table);
+}
+
+// Empty table sized for at least `expected` entries at no more than half load
+CalibrationTable *calibration_table_new(uint32_t expected) {
+    uint32_t capacity = 64, shift = 26;
+    while (capacity < expected * 2) {
+        capacity <<= 1;
+        shift--;
+    }
+
+    CalibrationTable *table = malloc(sizeof(CalibrationTable));
+    if (table == NULL) return NULL;
+    size_t bytes = (size_t)capacity * sizeof(CalibrationEntry);
+#ifdef _WIN32
+    table->entries = _aligned_malloc(bytes, 64);
+#else
+    table->entries = aligned_alloc(64, bytes);
+#endif
+    if (table->entries == NULL) {
+        free(table);
+        return NULL;
+    }
+    memset(table->entries, 0, bytes);
+    table->mask = capacity - 1;
+    table->shift = shift;
+    table->count = 0;
+    table->magnetometers = NULL;
+    table->magnetometer_count = 0;
+    return table;
+}
+
+// Insert or replace, returns -1 when the table is full
+int calibration_table_put(CalibrationTable *table, int suit_id, int channel, const CalibrationEntry *entry) {
+    uint32_t key = calibration_key(suit_id, channel);
+    for (uint32_t i = calibration_hash(key, table), n = 0; n <= table->mask; i = (i + 1) & table->mask, n++) {
+        CalibrationEntry *slot = &table->entries[i];
+        if (slot->key == 0 || slot->key == key) {
+            if (slot->key == 0) table->count++;
+            *slot = *entry;
+            slot->key = key;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+// "YYYY-MM-DD" to a day number, empty or malformed gives 0 (unknown)
+static int32_t calibration_parse_date(const char *text) {
+    int year, month, day;
+    if (sscanf(text, "%d-%d-%d", &year, &month, &day) != 3) return 0;
+    if (month < 1 || month > 12 || day < 1 || day > 31) return 0;
+    return calibration_day(year, month, day);
+}
+
+// Magnetometer fields of a row into the table's list. Returns -1 when malformed.
+static int calibration_put_magnetometer(CalibrationTable *table, int suit_id, char **field, uint32_t *capacity) {
+    MagnetometerEntry mag;
+    mag.suit_id = suit_id;
+    for (int k = 0; k < CAL_MAG_FIELDS; k++) {
+        float *to = (k < 3) ? &mag.offset[k] : &mag.soft[k - 3];
+        if (sscanf(field[k], "%f", to) != 1) return -1;
+    }
+    if (table->magnetometer_count == *capacity) {
+        uint32_t grown = *capacity ? *capacity * 2 : 16;
+        MagnetometerEntry *list = realloc(table->magnetometers, grown * sizeof(MagnetometerEntry));
+        if (list == NULL) return -1;
+        table->magnetometers = list;
+        *capacity = grown;
+    }
+    table->magnetometers[table->magnetometer_count++] = mag;
+    return 0;
+}
+
+// Load a calibration file into a new table. Returns NULL when the file cannot be
+// read or memory runs out; malformed lines are skipped and counted in *skipped.
+CalibrationTable *calibration_load(const char *path, int *skipped) {
+    FILE *fp = fopen(path, "r");
+    char line[256];
+    uint32_t lines = 0, magnetometers = 0;
+
+    *skipped = 0;
+    if (fp == NULL) return NULL;
+    while (fgets(line, sizeof(line), fp)) lines++;
+    rewind(fp);
+
+    CalibrationTable *table = calibration_table_new(lines);
+    if (table == NULL) {
+        fclose(fp);
+        return NULL;
+    }
+
+    while (fgets(line, sizeof(line), fp)) {
+        if (line[0] == '#' || line[0] == '\n' || line[0] == '\r' || strncmp(line, "suit_id", 7) == 0) continue;
+
+        // Split on commas by hand, strtok would merge the empty date fields
+        char *field[CAL_FIELDS + CAL_MAG_FIELDS] = {0};
+        int fields = 0;
+        for (char *p = line; fields < CAL_FIELDS + CAL_MAG_FIELDS; fields++) {
+            field[fields] = p;
+            p += strcspn(p, ",\r\n");
+            if (*p != ',') {
+                *p = '\0';
+                fields++;
+                break;
+            }
+            *p++ = '\0';
+        }
+
+        CalibrationEntry entry = {0};
+        int suit_id, channel;
+        if (fields < 4 || sscanf(field[0], "%d", &suit_id) != 1 || sscanf(field[1], "%d", &channel) != 1 ||
+            sscanf(field[2], "%f", &entry.offset) != 1 || sscanf(field[3], "%f", &entry.gain) != 1 ||
+            suit_id < 0 || channel < 0 || channel >= CAL_CHANNELS ||
+            (fields > CAL_FIELDS && fields < CAL_FIELDS + CAL_MAG_FIELDS)) {
+            (*skipped)++;
+            continue;
+        }
+        if (fields == CAL_FIELDS + CAL_MAG_FIELDS &&
+            calibration_put_magnetometer(table, suit_id, field + CAL_FIELDS, &magnetometers) != 0) {
+            (*skipped)++;
+            continue;
+        }
+        if (fields > 4) entry.install_day = calibration_parse_date(field[4]);
+        if (fields > 5) entry.cell_day = calibration_parse_date(field[5]);
+        if (fields > 6) entry.bump_day = calibration_parse_date(field[6]);
+        calibration_table_put(table, suit_id, channel, &entry);
+    }
+    fclose(fp);
+    return table;
+}
+
+// Lock-free lookup. Copies the entry out so the caller never holds a table pointer;
+// returns 0 and an identity calibration when the suit has no entry for the channel.
+static inline int calibration_lookup(CalibrationRegistry *reg, int suit_id, int channel, CalibrationEntry *out) {
+    CalibrationTable *table = atomic_load_explicit(&reg->current, memory_order_acquire);
+    if (table != NULL && suit_id >= 0 && channel >= 0 && channel < CAL_CHANNELS) {
+        uint32_t key = calibration_key(suit_id, channel);
+        for (uint32_t i = calibration_hash(key, table);; i = (i + 1) & table->mask) {
+            const CalibrationEntry *slot = &table->entries[i];
+            if (slot->key == key) {
+                *out = *slot;
+                return 1;
+            }
+            if (slot->key == 0) break;  // Load is at most half, so an empty slot always ends the probe
+        }
+    }
+    memset(out, 0, sizeof(*out));
+    out->gain = 1.0f;
+    return 0;
+}
+
+static inline double calibration_apply(const CalibrationEntry *cal, double value) {
+    return value * cal->gain + cal->offset;
+}
+
+// Make a new table visible to readers. The table it replaces is kept until the next
+// swap: a reader holds a table only for the length of one lookup, far shorter than
+// the interval between reloads, so it is free of readers by then.
+void calibration_publish(CalibrationRegistry *reg, CalibrationTable *table) {
+    CalibrationTable *old = atomic_exchange_explicit(&reg->current, table, memory_order_acq_rel);
+    atomic_fetch_add_explicit(&reg->generation, 1, memory_order_release);
+    calibration_table_free(reg->retired);
+    reg->retired = old;
+}
+
+// Reload when the file has changed. Returns the number of entries loaded,
+// 0 when unchanged, -1 when the file cannot be loaded (the old table stays).
+int calibration_reload(CalibrationRegistry *reg) {
+    struct stat st;
+    int skipped;
+
+    if (stat(reg->path, &st) != 0) return -1;
+    if (st.st_mtime == reg->loaded_mtime && atomic_load(&reg->current) != NULL) return 0;
+
+    CalibrationTable *table = calibration_load(reg->path, &skipped);
+    if (table == NULL) return -1;
+    if (skipped > 0) printf("Calibration: skipped %d malformed line(s) in %s\n", skipped, reg->path);
+    reg->loaded_mtime = st.st_mtime;
+    calibration_publish(reg, table);
+    return (int)table->count;
+}
+
+// Starts empty (identity calibration for every suit), then loads the file if present
+void calibration_registry_init(CalibrationRegistry *reg, const char *path) {
+    atomic_init(&reg->current, NULL);
+    atomic_init(&reg->generation, 0);
+    reg->retired = NULL;
+    reg->path = path;
+    reg->loaded_mtime = 0;
+    calibration_reload(reg);
+}
+
+void calibration_registry_free(CalibrationRegistry *reg) {
+    calibration_table_free(atomic_exchange(&reg->current, NULL));
+    calibration_table_free(reg->retired);
+    reg->retired = NULL;
+}
+
+static void *calibration_watch(void *arg) {
+    CalibrationRegistry *reg = arg;
+    while (1) {
+#ifdef _WIN32
+        Sleep(CAL_RELOAD_SECONDS * 1000);
+#else
+        struct timespec ts = {CAL_RELOAD_SECONDS, 0};
+        nanosleep(&ts, NULL);
+#endif
+        int loaded = calibration_reload(reg);
+        if (loaded > 0) printf("Calibration reloaded: %d entries from %s\n", loaded, reg->path);
+    }
+    return NULL;
+}
+
+// Pick up edits to the calibration file from a background thread, returns -1 on failure
+int calibration_start_reloader(CalibrationRegistry *reg) {
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, calibration_watch, reg) != 0) return -1;
+    pthread_detach(thread);
+    return 0;
+}
+
+#endif
@@ -0,0 +1,176 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "calibration.h"
+
+// Benchmark for the calibration registry at fleet size:
+//  1. cache lines a lookup touches, from the probe lengths of every key
+//  2. dependent random lookup latency against one DRAM miss (pointer chase)
+//  3. reader throughput while a writer keeps publishing new tables
+
+#define BENCH_SUITS 100000
+#define BENCH_CHANNELS 8  // Parameter codes 1-8
+#define BENCH_LOOKUPS 20000000L
+#define BENCH_CHASE_SLOTS (1 << 24)  // 128 MB of pointers, far beyond the last-level cache
+#define BENCH_READERS 4
+#define BENCH_SWAP_MS 100  // Writer publishes a new table this often
+#define BENCH_SWAP_SECONDS 2
+
+CalibrationRegistry registry;
+atomic_int stop_readers;
+
+double now_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+CalibrationTable *build_table(float gain) {
+    CalibrationTable *table = calibration_table_new(BENCH_SUITS * BENCH_CHANNELS);
+    CalibrationEntry entry = {0};
+    entry.gain = gain;
+    entry.install_day = calibration_day(2023, 4, 11);
+    for (int suit = 0; suit < BENCH_SUITS; suit++) {
+        for (int channel = 1; channel <= BENCH_CHANNELS; channel++) {
+            entry.offset = (float)(suit % 7) * 0.1f;
+            calibration_table_put(table, suit, channel, &entry);
+        }
+    }
+    return table;
+}
+
+// Lines touched when looking up every key once, from the slots each probe walks
+double lines_per_lookup(const CalibrationTable *table, int *longest) {
+    long lines = 0, keys = 0;
+    *longest = 0;
+    for (int suit = 0; suit < BENCH_SUITS; suit++) {
+        for (int channel = 1; channel <= BENCH_CHANNELS; channel++) {
+            uint32_t key = calibration_key(suit, channel);
+            uint32_t i = calibration_hash(key, table);
+            int probes = 1, touched = 1;
+            while (table->entries[i].key != key) {
+                uint32_t next = (i + 1) & table->mask;
+                if ((uintptr_t)&table->entries[next] / 64 != (uintptr_t)&table->entries[i] / 64) touched++;
+                i = next;
+                probes++;
+            }
+            if (probes > *longest) *longest = probes;
+            lines += touched;
+            keys++;
+        }
+    }
+    return (double)lines / keys;
+}
+
+double lookup_ns(uint32_t seed) {
+    CalibrationEntry cal = {0};
+    double sink = 0.0;
+    double start = now_seconds();
+    for (long i = 0; i < BENCH_LOOKUPS; i++) {
+        // The next key depends on this entry, so lookups cannot overlap like the chase below
+        seed = seed * 1664525u + 1013904223u + cal.key;
+        calibration_lookup(&registry, (seed >> 8) % BENCH_SUITS, 1 + (seed & 7), &cal);
+        sink += cal.offset;
+    }
+    double elapsed = now_seconds() - start;
+    if (sink < 0) printf("%f\n", sink);
+    return elapsed * 1e9 / BENCH_LOOKUPS;
+}
+
+// One random dependent load per step, the cost of a single cache miss
+double miss_ns() {
+    uint32_t *next = malloc(sizeof(uint32_t) * BENCH_CHASE_SLOTS);
+    for (uint32_t i = 0; i < BENCH_CHASE_SLOTS; i++) next[i] = i;
+    for (uint32_t i = BENCH_CHASE_SLOTS - 1; i > 0; i--) {  // Sattolo: one cycle through all slots
+        uint32_t j = (uint32_t)(((uint64_t)rand() * RAND_MAX + rand()) % i);
+        uint32_t t = next[i];
+        next[i] = next[j];
+        next[j] = t;
+    }
+    uint32_t p = 0;
+    long steps = BENCH_LOOKUPS / 4;
+    double start = now_seconds();
+    for (long i = 0; i < steps; i++) p = next[p];
+    double elapsed = now_seconds() - start;
+    if (p == 0xffffffffu) printf("%u\n", p);
+    free(next);
+    return elapsed * 1e9 / steps;
+}
+
+typedef struct {
+    uint32_t seed;
+    long lookups;
+    long torn;  // Entries whose fields came from different tables
+} ReaderArgs;
+
+static void *reader(void *arg) {
+    ReaderArgs *args = arg;
+    CalibrationEntry cal;
+    uint32_t seed = args->seed;
+    while (!atomic_load_explicit(&stop_readers, memory_order_relaxed)) {
+        for (int i = 0; i < 1024; i++) {
+            seed = seed * 1664525u + 1013904223u;
+            int suit = (seed >> 8) % BENCH_SUITS;
+            calibration_lookup(&registry, suit, 1 + (seed & 7), &cal);
+            if (cal.offset != (float)(suit % 7) * 0.1f || (cal.gain != 1.0f && cal.gain != 1.5f)) args->torn++;
+        }
+        args->lookups += 1024;
+    }
+    return NULL;
+}
+
+int main() {
+    printf("Smart Suit - Calibration Registry Benchmark\n");
+    printf("-------------------------------------------\n");
+
+    CalibrationTable *tables[2] = {build_table(1.0f), build_table(1.5f)};
+    int longest;
+    double lines = lines_per_lookup(tables[0], &longest);
+    printf("%d suits x %d channels: %u entries in %u slots (%.1f MB), %.3f lines/lookup, longest probe %d\n",
+           BENCH_SUITS, BENCH_CHANNELS, tables[0]->count, tables[0]->mask + 1,
+           (tables[0]->mask + 1) * sizeof(CalibrationEntry) / 1048576.0, lines, longest);
+
+    atomic_init(&registry.current, tables[0]);
+    double lookup = lookup_ns(7);
+    double miss = miss_ns();
+    printf("Random lookup: %.1f ns, one DRAM miss: %.1f ns (%.2f misses per lookup)\n", lookup, miss, lookup / miss);
+
+    // Readers run flat out while the writer swaps tables; a reader never waits on it
+    pthread_t threads[BENCH_READERS];
+    ReaderArgs args[BENCH_READERS];
+    for (int phase = 0; phase < 2; phase++) {
+        memset(args, 0, sizeof(args));
+        atomic_store(&stop_readers, 0);
+        for (int t = 0; t < BENCH_READERS; t++) {
+            args[t].seed = 11 + t;
+            pthread_create(&threads[t], NULL, reader, &args[t]);
+        }
+        int swaps = 0;
+        double start = now_seconds();
+        while (now_seconds() - start < BENCH_SWAP_SECONDS) {
+            struct timespec ts = {0, BENCH_SWAP_MS * 1000000L};
+            nanosleep(&ts, NULL);
+            if (phase == 1) {
+                // Swap back and forth without freeing, the bench owns both tables
+                atomic_store_explicit(&registry.current, tables[++swaps & 1], memory_order_release);
+            }
+        }
+        atomic_store(&stop_readers, 1);
+        long total = 0, torn = 0;
+        for (int t = 0; t < BENCH_READERS; t++) {
+            pthread_join(threads[t], NULL);
+            total += args[t].lookups;
+            torn += args[t].torn;
+        }
+        printf("%d readers, %-17s %.1f M lookups/s, %ld torn entries\n", BENCH_READERS,
+               phase ? "swapping tables:" : "no updates:", total / (now_seconds() - start) / 1e6, torn);
+        if (phase) printf("Tables published: %d\n", swaps);
+    }
+
+    calibration_table_free(tables[0]);
+    calibration_table_free(tables[1]);
+    return 0;
+}
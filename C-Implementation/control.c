@@ -1,197 +1,651 @@
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include <time.h>
-#include <winsock2.h>
-#include <ws2tcpip.h>
-
-#pragma comment(lib, "ws2_32.lib")
-
-#define PORT_CONTROL 8081
-#define PORT_ACTUATOR 8082
-#define BUFFER_SIZE 1024
-
-// Parameter codes
-#define TEMPERATURE 1
-#define RADIATION 2
-#define CHEMICAL 3
-#define OXYGEN 4
-#define NOISE 5
-#define VOLTAGE 6
-
-// Actuator response codes
-#define COOLING_ON 101
-#define HEATING_ON 102
-#define RADIATION_ALARM 201
-#define CHEMICAL_ALARM 301
-#define OXYGEN_ALARM 401
-#define NOISE_PROTECTION 501
-#define VOLTAGE_WARNING 601
-
-void send_to_actuator(int response_code, int value) {
-    SOCKET sock = INVALID_SOCKET;
-    struct sockaddr_in serv_addr;
-    
-    // Create socket
-    if ((sock = socket(AF_INET, SOCK_STREAM, 0)) == INVALID_SOCKET) {
-        printf("Socket creation error: %d\n", WSAGetLastError());
-        return;
-    }
-    
-    serv_addr.sin_family = AF_INET;
-    serv_addr.sin_port = htons(PORT_ACTUATOR);
-    
-    // Convert IPv4 address from text to binary form
-    if (inet_pton(AF_INET, "127.0.0.1", &serv_addr.sin_addr) <= 0) {
-        printf("Invalid address/ Address not supported\n");
-        closesocket(sock);
-        return;
-    }
-    
-    if (connect(sock, (struct sockaddr *)&serv_addr, sizeof(serv_addr)) < 0) {
-        printf("Connection Failed to Actuator Module: %d\n", WSAGetLastError());
-        closesocket(sock);
-        return;
-    }
-    
-    // Send data as integers
-    int data[2] = {response_code, value};
-    send(sock, (char*)data, sizeof(data), 0);
-    printf("Command sent to actuator: Response Code %d, Value %d\n", response_code, value);
-    
-    // Wait for acknowledgment
-    int ack;
-    recv(sock, (char*)&ack, sizeof(ack), 0);
-    printf("Received acknowledgment from actuator: %d\n", ack);
-    
-    closesocket(sock);
-}
-
-int determine_response(int param_code, int value) {
-    switch(param_code) {
-        case TEMPERATURE:
-            return (value > 30) ? COOLING_ON : HEATING_ON;
-        case RADIATION:
-            return RADIATION_ALARM;
-        case CHEMICAL:
-            return CHEMICAL_ALARM;
-        case OXYGEN:
-            return OXYGEN_ALARM;
-        case NOISE:
-            return NOISE_PROTECTION;
-        case VOLTAGE:
-            return VOLTAGE_WARNING;
-        default:
-            return 0;
-    }
-}
-
-const char* get_param_name(int code) {
-    switch(code) {
-        case TEMPERATURE: return "Temperature";
-        case RADIATION: return "Radiation";
-        case CHEMICAL: return "Chemical";
-        case OXYGEN: return "Oxygen";
-        case NOISE: return "Noise";
-        case VOLTAGE: return "Voltage";
-        default: return "Unknown";
-    }
-}
-
-const char* get_response_name(int code) {
-    switch(code) {
-        case COOLING_ON: return "Cooling System Activation";
-        case HEATING_ON: return "Heating System Activation";
-        case RADIATION_ALARM: return "Radiation Alarm";
-        case CHEMICAL_ALARM: return "Chemical Hazard Alarm";
-        case OXYGEN_ALARM: return "Oxygen Level Alarm";
-        case NOISE_PROTECTION: return "Noise Protection";
-        case VOLTAGE_WARNING: return "Electrical Field Warning";
-        default: return "Unknown Response";
-    }
-}
-
-int main() {
-    WSADATA wsaData;
-    SOCKET server_fd = INVALID_SOCKET, new_socket = INVALID_SOCKET;
-    struct sockaddr_in address;
-    int addrlen = sizeof(address);
-    
-    // Initialize Winsock
-    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
-        printf("WSAStartup failed: %d\n", WSAGetLastError());
-        return 1;
-    }
-    
-    // Creating socket
-    if ((server_fd = socket(AF_INET, SOCK_STREAM, 0)) == INVALID_SOCKET) {
-        printf("Socket creation error: %d\n", WSAGetLastError());
-        WSACleanup();
-        return 1;
-    }
-    
-    // Setup socket options to allow address reuse
-    int opt = 1;
-    if (setsockopt(server_fd, SOL_SOCKET, SO_REUSEADDR, (char*)&opt, sizeof(opt)) == SOCKET_ERROR) {
-        printf("Setsockopt error: %d\n", WSAGetLastError());
-        closesocket(server_fd);
-        WSACleanup();
-        return 1;
-    }
-    
-    address.sin_family = AF_INET;
-    address.sin_addr.s_addr = INADDR_ANY;
-    address.sin_port = htons(PORT_CONTROL);
-    
-    // Bind the socket to the port
-    if (bind(server_fd, (struct sockaddr *)&address, sizeof(address)) == SOCKET_ERROR) {
-        printf("Bind failed: %d\n", WSAGetLastError());
-        closesocket(server_fd);
-        WSACleanup();
-        return 1;
-    }
-    
-    if (listen(server_fd, 3) == SOCKET_ERROR) {
-        printf("Listen error: %d\n", WSAGetLastError());
-        closesocket(server_fd);
-        WSACleanup();
-        return 1;
-    }
-    
-    printf("Control module started. Listening on port %d...\n", PORT_CONTROL);
-    
-    while (1) {
-        if ((new_socket = accept(server_fd, (struct sockaddr *)&address, &addrlen)) == INVALID_SOCKET) {
-            printf("Accept error: %d\n", WSAGetLastError());
-            continue;
-        }
-        
-        int data[2];
-        int valread = recv(new_socket, (char*)data, sizeof(data), 0);
-        
-        if (valread > 0) {
-            int param_code = data[0];
-            int value = data[1];
-            
-            printf("Received alert from sensor: Parameter Code %d (%s), Value %d\n", 
-                   param_code, get_param_name(param_code), value);
-            
-            // Determine appropriate response
-            int response_code = determine_response(param_code, value);
-            
-            if (response_code > 0) {
-                printf("Determined response: %d (%s)\n", 
-                       response_code, get_response_name(response_code));
-                
-                // Send command to actuator
-                send_to_actuator(response_code, value);
-            }
-        }
-        
-        closesocket(new_socket);
-    }
-    
-    closesocket(server_fd);
-    WSACleanup();
-    return 0;
-}
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "net_compat.h"
+#include "metrics.h"
+#include "listen_workers.h"
+#include "control_wal.h"
+#include "thermal_control.h"
+#include "traffic_capture.h"
+#include "ingest_memory.h"
+
+#define PORT_CONTROL 8081
+#define PORT_ACTUATOR 8082
+#define BUFFER_SIZE 1024
+
+// Parameter codes
+#define TEMPERATURE 1
+#define RADIATION 2
+#define CHEMICAL 3
+#define OXYGEN 4
+#define NOISE 5
+#define VOLTAGE 6
+#define MAGNETIC 7
+#define PROXIMITY 8
+#define ARC_FLASH 9
+#define OVERCURRENT 10
+#define MAN_DOWN 13  // Suit stopped transmitting, the value is the seconds since it was heard
+#define THERMAL_SAMPLE 14  // Filtered suit temperature for the thermal loop, in hundredths of a °C
+#define HAZARD_INDEX 15  // Combined hazard severity changed: 0 clear, 1 advisory, 2 warning, 3 danger
+
+// Predicted threshold crossing, the value is the seconds until it happens
+#define EARLY_WARNING_FLAG 0x100
+
+// THERMAL_SAMPLE batch from the sensor module: the value is the sample count and the
+// header is followed by that many (suit ID, hundredths of a °C) pairs
+#define SAMPLE_BLOCK_FLAG 0x200
+#define THERMAL_BATCH_MAX 256
+
+// Actuator response codes
+#define COOLING_ON 101
+#define HEATING_ON 102
+#define THERMAL_DUTY 103  // Thermal loop output, % of full power: > 0 cooling, < 0 heating, 0 off
+#define RADIATION_ALARM 201
+#define CHEMICAL_ALARM 301
+#define OXYGEN_ALARM 401
+#define NOISE_PROTECTION 501
+#define VOLTAGE_WARNING 601
+#define ARC_FLASH_ALARM 602
+#define OVERCURRENT_WARNING 603
+#define MAGNETIC_WARNING 701
+#define COLLISION_WARNING 801
+#define EARLY_WARNING 901
+#define MAN_DOWN_ALARM 1001
+#define HAZARD_WARNING 1101  // The value is the combined hazard severity
+
+#define WAL_GROUP_MAX 64  // Alerts made durable by one log sync
+#define THERMAL_COMMANDS_MAX 1024  // Duty commands sent per tick, the rest wait for the next one
+
+// Per-connection memory (ingest_memory.h): an alert is three integers, a batch is one group commit
+#define CONTROL_HEADER_BYTES (3 * (int)sizeof(int))
+#define CONTROL_RECEIVE_BUFFERS 4
+#define CONTROL_ARENA_BYTES (16 * 1024)
+
+// Command waiting for the group commit before it goes to the actuator
+typedef struct {
+    int suit_id;
+    int param_code;
+    int value;
+    int response_code;
+    uint64_t command_seq;
+} PendingCommand;
+
+// Alerts, commands and acknowledgments, with the active alarms they imply
+ControlWal control_wal;
+
+// Per-suit PI loops for suits that report their temperature
+ThermalScheduler thermal;
+
+// Receive buffers and group commit scratch, so handling alerts never touches the heap
+IngestMemory ingest;
+
+// Metric family IDs; commands are labelled by hazard group (response code / 100)
+int metric_alerts, metric_early_warnings, metric_commands;
+int metric_connect_failures, metric_ack_failures, metric_ack_latency;
+int metric_wal_commit, metric_replayed, metric_untracked, metric_abandoned, metric_active_alarms;
+int metric_thermal_samples, metric_thermal_commands, metric_thermal_loops;
+int metric_thermal_lateness, metric_thermal_tick, metric_thermal_misses;
+int metric_heap_allocations, metric_receive_exhausted;
+
+void init_metrics() {
+    metrics_init("smartsuit_control");
+    metric_alerts = metrics_register("alerts_received_total", "Threshold alerts received from sensors",
+                                     METRIC_COUNTER, "param", 16);
+    metric_early_warnings = metrics_register("early_warnings_received_total",
+                                             "Predicted crossings received from sensors",
+                                             METRIC_COUNTER, "param", 16);
+    metric_commands = metrics_register("actuator_commands_total", "Commands sent to the actuator",
+                                       METRIC_COUNTER, "group", 16);
+    metric_connect_failures = metrics_register("actuator_connect_failures_total",
+                                               "Failed connections to the actuator", METRIC_COUNTER, NULL, 1);
+    metric_ack_failures = metrics_register("actuator_ack_failures_total",
+                                           "Commands without a successful acknowledgment", METRIC_COUNTER, NULL, 1);
+    metric_ack_latency = metrics_register("actuator_ack_seconds", "Command send to acknowledgment time",
+                                          METRIC_HISTOGRAM, NULL, 1);
+    metric_wal_commit = metrics_register("wal_commit_seconds", "Write-ahead log group commit time",
+                                         METRIC_HISTOGRAM, NULL, 1);
+    metric_replayed = metrics_register("replayed_commands_total", "Unacknowledged commands resent after restart",
+                                       METRIC_COUNTER, NULL, 1);
+    metric_untracked = metrics_register("untracked_alarms_total",
+                                        "Alerts the full alarm table could not hold (commands still sent)",
+                                        METRIC_COUNTER, "param", 16);
+    metric_abandoned = metrics_register("abandoned_commands_total",
+                                        "Unacknowledged commands expired after an hour quiet",
+                                        METRIC_COUNTER, NULL, 1);
+    metric_active_alarms = metrics_register("active_alarms", "Alarms in the write-ahead log's table",
+                                            METRIC_GAUGE, NULL, 1);
+    metric_thermal_samples = metrics_register("thermal_samples_total", "Suit temperatures received for the thermal loop",
+                                              METRIC_COUNTER, NULL, 1);
+    metric_thermal_commands = metrics_register("thermal_commands_total",
+                                               "Thermal duty commands by mode (0 off, 1 cooling, 2 heating)",
+                                               METRIC_COUNTER, "mode", 3);
+    metric_thermal_loops = metrics_register("thermal_loops", "Suits under closed-loop thermal control",
+                                            METRIC_GAUGE, NULL, 1);
+    metric_thermal_lateness = metrics_register("thermal_tick_lateness_seconds",
+                                               "Thermal tick start after its due time (jitter)",
+                                               METRIC_HISTOGRAM, NULL, 1);
+    metric_thermal_tick = metrics_register("thermal_tick_seconds", "Thermal tick compute time for all loops",
+                                           METRIC_HISTOGRAM, NULL, 1);
+    metric_thermal_misses = metrics_register("thermal_deadline_misses_total",
+                                             "Thermal ticks skipped because the previous one ran a period late",
+                                             METRIC_COUNTER, NULL, 1);
+    metric_heap_allocations = metrics_register("ingest_heap_allocations_total",
+                                               "Heap allocations made while handling alert batches (counted with INGEST_ALLOC_TRACKING)",
+                                               METRIC_COUNTER, NULL, 1);
+    metric_receive_exhausted = metrics_register("receive_buffers_exhausted_total",
+                                                "Connections dropped with every receive buffer in use",
+                                                METRIC_COUNTER, NULL, 1);
+}
+
+// Returns 1 when the actuator acknowledged the command
+int send_to_actuator(int suit_id, int response_code, int value) {
+    SOCKET sock = INVALID_SOCKET;
+    struct sockaddr_in serv_addr;
+    double start = metrics_now();
+    
+    // Create socket
+    if ((sock = socket(AF_INET, SOCK_STREAM, 0)) == INVALID_SOCKET) {
+        printf("Socket creation error: %d\n", WSAGetLastError());
+        return 0;
+    }
+    
+    serv_addr.sin_family = AF_INET;
+    serv_addr.sin_port = htons(PORT_ACTUATOR);
+    
+    // Convert IPv4 address from text to binary form
+    if (inet_pton(AF_INET, "127.0.0.1", &serv_addr.sin_addr) <= 0) {
+        printf("Invalid address/ Address not supported\n");
+        closesocket(sock);
+        return 0;
+    }
+    
+    if (connect(sock, (struct sockaddr *)&serv_addr, sizeof(serv_addr)) < 0) {
+        printf("Connection Failed to Actuator Module: %d\n", WSAGetLastError());
+        metric_inc(metric_connect_failures, 0);
+        closesocket(sock);
+        return 0;
+    }
+    
+    // Send data as integers
+    int data[3] = {response_code, value, suit_id};
+    send(sock, (char*)data, sizeof(data), 0);
+    printf("Command sent to actuator: Suit %d, Response Code %d, Value %d\n", suit_id, response_code, value);
+    
+    // Wait for acknowledgment
+    int ack = 0;
+    int acked = recv(sock, (char*)&ack, sizeof(ack), 0) == (int)sizeof(ack) && ack;
+    printf("Received acknowledgment from actuator: %d\n", ack);
+    metric_observe(metric_ack_latency, metrics_now() - start);
+    metric_inc(metric_commands, response_code / 100);
+    if (!acked) metric_inc(metric_ack_failures, 0);
+    
+    closesocket(sock);
+    return acked;
+}
+
+int determine_response(int param_code, int value) {
+    if (param_code & EARLY_WARNING_FLAG) {
+        return EARLY_WARNING;
+    }
+    
+    switch(param_code) {
+        case TEMPERATURE:
+            return (value > 30) ? COOLING_ON : HEATING_ON;
+        case RADIATION:
+            return RADIATION_ALARM;
+        case CHEMICAL:
+            return CHEMICAL_ALARM;
+        case OXYGEN:
+            return OXYGEN_ALARM;
+        case NOISE:
+            return NOISE_PROTECTION;
+        case VOLTAGE:
+            return VOLTAGE_WARNING;
+        case MAGNETIC:
+            return MAGNETIC_WARNING;
+        case PROXIMITY:
+            return COLLISION_WARNING;
+        case ARC_FLASH:
+            return ARC_FLASH_ALARM;
+        case OVERCURRENT:
+            return OVERCURRENT_WARNING;
+        case MAN_DOWN:
+            return MAN_DOWN_ALARM;
+        case HAZARD_INDEX:
+            return (value > 0) ? HAZARD_WARNING : 0;  // Back to clear needs no action
+        default:
+            return 0;
+    }
+}
+
+const char* get_param_name(int code) {
+    switch(code) {
+        case TEMPERATURE: return "Temperature";
+        case RADIATION: return "Radiation";
+        case CHEMICAL: return "Chemical";
+        case OXYGEN: return "Oxygen";
+        case NOISE: return "Noise";
+        case VOLTAGE: return "Voltage";
+        case MAGNETIC: return "Magnetic";
+        case PROXIMITY: return "Proximity";
+        case ARC_FLASH: return "Arc Flash";
+        case OVERCURRENT: return "Overcurrent";
+        case MAN_DOWN: return "Man Down";
+        case THERMAL_SAMPLE: return "Thermal Sample";
+        case HAZARD_INDEX: return "Hazard Index";
+        default: return "Unknown";
+    }
+}
+
+const char* get_response_name(int code) {
+    switch(code) {
+        case COOLING_ON: return "Cooling System Activation";
+        case HEATING_ON: return "Heating System Activation";
+        case THERMAL_DUTY: return "Thermal Duty Cycle";
+        case RADIATION_ALARM: return "Radiation Alarm";
+        case CHEMICAL_ALARM: return "Chemical Hazard Alarm";
+        case OXYGEN_ALARM: return "Oxygen Level Alarm";
+        case NOISE_PROTECTION: return "Noise Protection";
+        case VOLTAGE_WARNING: return "Electrical Field Warning";
+        case ARC_FLASH_ALARM: return "Arc Flash Alarm";
+        case OVERCURRENT_WARNING: return "Overcurrent Warning";
+        case MAGNETIC_WARNING: return "Magnetic Field Warning";
+        case COLLISION_WARNING: return "Collision Warning";
+        case EARLY_WARNING: return "Early Hazard Warning";
+        case MAN_DOWN_ALARM: return "Man-Down Alarm";
+        case HAZARD_WARNING: return "Combined Hazard Warning";
+        default: return "Unknown Response";
+    }
+}
+
+// Expiry runs with each snapshot; count what it gave up on since the last call
+void report_alarm_table() {
+    static long reported = 0;
+    if (control_wal.abandoned > reported) {
+        printf("Gave up on %ld unacknowledged command(s) quiet for over %d min\n",
+               control_wal.abandoned - reported, WAL_ALARM_STALE_MS / 60000);
+        metric_add(metric_abandoned, 0, (uint64_t)(control_wal.abandoned - reported));
+        reported = control_wal.abandoned;
+    }
+    metric_set(metric_active_alarms, 0, (uint64_t)control_wal.alarm_count);
+}
+
+// The alarm table is at its limit: say so every time, the alarm is in the log but not tracked
+void report_untracked(long before, int suit_id, int param_code) {
+    if (control_wal.untracked == before) return;
+    fprintf(stderr, "ALARM TABLE FULL (%d alarms): %s for suit %d is not tracked, its command is still sent\n",
+            control_wal.alarm_count, get_param_name(param_code & ~EARLY_WARNING_FLAG), suit_id);
+    metric_inc(metric_untracked, (param_code & ~EARLY_WARNING_FLAG) & 15);
+}
+
+int recv_all(SOCKET sock, char *buffer, int length) {
+    int received = 0;
+    while (received < length) {
+        int n = recv(sock, buffer + received, length - received, 0);
+        capture_received(sock, buffer + received, n);
+        if (n <= 0) return -1;
+        received += n;
+    }
+    return received;
+}
+
+// Hand a batch of thermal samples to the loops, without a loop they are read and dropped
+void receive_thermal_batch(SOCKET sock, int count) {
+    int32_t samples[32][2];
+    
+    if (count <= 0 || count > THERMAL_BATCH_MAX) {
+        printf("Invalid thermal sample batch: %d samples\n", count);
+        return;
+    }
+    while (count > 0) {
+        int chunk = count < 32 ? count : 32;
+        if (recv_all(sock, (char*)samples, chunk * (int)sizeof(samples[0])) < 0) {
+            printf("Thermal sample batch cut short\n");
+            return;
+        }
+        if (thermal.loops != NULL) {
+            uint32_t now_ms = (uint32_t)(metrics_now() * 1000.0);
+            for (int i = 0; i < chunk; i++) {
+                thermal_sample(&thermal, samples[i][0], samples[i][1] / 100.0, now_ms);
+            }
+            metric_add(metric_thermal_samples, 0, (uint64_t)chunk);
+        }
+        count -= chunk;
+    }
+}
+
+// Read one alert into buffer and log it with the command it calls for; returns 1 if a command is pending
+int receive_alert(SOCKET sock, PendingCommand *cmd, char *buffer) {
+    int *data = (int *)buffer;
+    capture_begin(sock);
+    int valread = recv(sock, (char*)data, CONTROL_HEADER_BYTES, 0);
+    capture_received(sock, data, valread);
+    
+    if (valread < (int)(2 * sizeof(int))) return 0;
+    
+    int param_code = data[0];
+    int value = data[1];
+    int suit_id = (valread >= CONTROL_HEADER_BYTES) ? data[2] : 0;
+    
+    // Loop input, not an alert: the next tick acts on it. Without a loop (listener
+    // workers, or no memory for it) the sample is dropped, never logged as an alert.
+    if (param_code == THERMAL_SAMPLE) {
+        if (thermal.loops != NULL) {
+            thermal_sample(&thermal, suit_id, value / 100.0, (uint32_t)(metrics_now() * 1000.0));
+            metric_inc(metric_thermal_samples, 0);
+        }
+        return 0;
+    }
+    if (param_code == (THERMAL_SAMPLE | SAMPLE_BLOCK_FLAG)) {
+        receive_thermal_batch(sock, value);
+        return 0;
+    }
+    
+    if (param_code & EARLY_WARNING_FLAG) {
+        metric_inc(metric_early_warnings, param_code & ~EARLY_WARNING_FLAG);
+        printf("Received early warning from sensor: Suit %d, %s threshold predicted in %d s\n",
+               suit_id, get_param_name(param_code & ~EARLY_WARNING_FLAG), value);
+    } else {
+        metric_inc(metric_alerts, param_code);
+        printf("Received alert from sensor: Suit %d, Parameter Code %d (%s), Value %d\n", 
+               suit_id, param_code, get_param_name(param_code), value);
+    }
+    long untracked = control_wal.untracked;
+    wal_log(&control_wal, WAL_RECORD_ALERT, suit_id, param_code, value, 0, 0);
+    report_untracked(untracked, suit_id, param_code);
+    
+    // Determine appropriate response
+    int response_code = determine_response(param_code, value);
+    if (response_code <= 0) return 0;
+    
+    // The suit's thermal loop already drives cooling and heating
+    if (param_code == TEMPERATURE && thermal_active(&thermal, suit_id)) {
+        printf("Suit %d is under thermal loop control, no on/off command\n", suit_id);
+        return 0;
+    }
+    
+    printf("Determined response: %d (%s)\n", 
+           response_code, get_response_name(response_code));
+    cmd->suit_id = suit_id;
+    cmd->param_code = param_code;
+    cmd->value = value;
+    cmd->response_code = response_code;
+    untracked = control_wal.untracked;
+    cmd->command_seq = wal_log(&control_wal, WAL_RECORD_COMMAND, suit_id, param_code, value, response_code, 0);
+    report_untracked(untracked, suit_id, param_code);
+    return 1;
+}
+
+// Receive one alert in a buffer from the pool, then close the connection
+int receive_connection(SOCKET sock, PendingCommand *cmd) {
+    char *buffer = buffer_pool_acquire(&ingest.receive);
+    int pending = 0;
+    if (buffer == NULL) {
+        printf("No receive buffer free, connection dropped\n");
+        metric_inc(metric_receive_exhausted, 0);
+    } else {
+        pending = receive_alert(sock, cmd, buffer);
+        buffer_pool_release(&ingest.receive, buffer);
+    }
+    closesocket(sock);
+    return pending;
+}
+
+// Send a logged command and record the acknowledgment
+void dispatch_command(const PendingCommand *cmd) {
+    if (send_to_actuator(cmd->suit_id, cmd->response_code, cmd->value)) {
+        wal_log(&control_wal, WAL_RECORD_ACK, cmd->suit_id, cmd->param_code,
+                cmd->value, cmd->response_code, cmd->command_seq);
+    }
+}
+
+// Check for a queued connection, waiting up to timeout_ms for one (0 does not wait)
+int connection_waiting(SOCKET server_fd, int timeout_ms) {
+    fd_set readable;
+    struct timeval wait = {timeout_ms / 1000, (timeout_ms % 1000) * 1000};
+    FD_ZERO(&readable);
+    FD_SET(server_fd, &readable);
+    return select((int)server_fd + 1, &readable, NULL, NULL, &wait) > 0;
+}
+
+// Run the thermal tick if it is due and send the duty commands it produced.
+// Duty commands are not logged: each one supersedes the last, and a lost one is
+// corrected by the next change of output.
+void run_thermal_tick() {
+    static ThermalCommand commands[THERMAL_COMMANDS_MAX];
+    ThermalTick tick;
+    double start = metrics_now();
+    
+    if (!thermal_poll(&thermal, start, (uint32_t)(start * 1000.0), commands, THERMAL_COMMANDS_MAX, &tick)) return;
+    metric_observe(metric_thermal_tick, metrics_now() - start);
+    metric_observe(metric_thermal_lateness, tick.lateness);
+    metric_set(metric_thermal_loops, 0, thermal.count);
+    if (tick.missed > 0) {
+        metric_add(metric_thermal_misses, 0, tick.missed);
+        printf("Thermal tick %.1f ms late, %d tick(s) skipped\n", tick.lateness * 1000.0, tick.missed);
+    }
+    if (tick.released > 0) {
+        printf("Released %d suit(s) from thermal control, no temperature for %d s\n",
+               tick.released, THERMAL_STALE_MS / 1000);
+    }
+    
+    for (int i = 0; i < tick.commands; i++) {
+        int duty = commands[i].duty;
+        metric_inc(metric_thermal_commands, (duty > 0) ? 1 : (duty < 0) ? 2 : 0);
+        send_to_actuator(commands[i].suit_id, THERMAL_DUTY, duty);
+    }
+}
+
+// Rebuild alarm state from the log and resend commands the actuator never acknowledged
+int recover_control_state(int port) {
+    char name[32];
+    WalRecovery recovery;
+    
+    // Workers each keep their own log, a roll drains a worker before its replacement opens it
+    if (listen_workers.count > 0) {
+        snprintf(name, sizeof(name), "control_%d_w%d", port, listen_workers.index);
+    } else {
+        snprintf(name, sizeof(name), "control_%d", port);
+    }
+    double start = metrics_now();
+    if (wal_open(&control_wal, name, &recovery) != 0) {
+        printf("Write-ahead log %s.wal cannot be written\n", name);
+        return -1;
+    }
+    printf("Recovered %d active alarm(s) from %s%s, %ld log record(s) replayed in %.1f ms%s\n",
+           recovery.alarms, recovery.snapshot_loaded ? "snapshot + " : "", control_wal.log_path,
+           recovery.records, (metrics_now() - start) * 1000.0,
+           recovery.torn_tail ? " (torn tail dropped)" : "");
+    
+    report_alarm_table();
+    if (recovery.pending > 0) {
+        printf("Resending %d unacknowledged command(s)\n", recovery.pending);
+    }
+    for (uint32_t i = 0; i < control_wal.capacity; i++) {
+        ActiveAlarm *a = &control_wal.alarms[i];
+        if (a->param_code == 0 || a->command_seq == 0 || a->acked) continue;
+        if (a->retries >= WAL_COMMAND_RETRIES) {
+            // Stays in the table until it goes stale, but is not resent again
+            printf("Not resending %s for suit %d, unacknowledged after %d resends\n",
+                   get_response_name(a->response_code), a->suit_id, a->retries);
+            continue;
+        }
+        // The actuator commands are idempotent, a repeat only re-asserts the response.
+        // The resend is counted durably first, so a crash loop cannot resend forever.
+        PendingCommand cmd = {a->suit_id, a->param_code, a->value, a->response_code, a->command_seq};
+        wal_log(&control_wal, WAL_RECORD_RETRY, a->suit_id, a->param_code, a->value, a->response_code, a->command_seq);
+        wal_commit(&control_wal);
+        dispatch_command(&cmd);
+        metric_inc(metric_replayed, 0);
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    WSADATA wsaData;
+    SOCKET server_fd = INVALID_SOCKET, new_socket = INVALID_SOCKET;
+    struct sockaddr_in address;
+    socklen_t addrlen = sizeof(address);
+    
+    // Each control shard listens on its own port
+    int port = (argc > 1) ? atoi(argv[1]) : PORT_CONTROL;
+    if (port <= 0 || port > 65535) {
+        printf("Invalid port: %s\n", argv[1]);
+        return 1;
+    }
+    
+    // With LISTEN_WORKERS set this process only supervises, workers continue from here
+    listen_workers_start("Control", LISTEN_MAX_WORKERS);
+    
+    // Initialize Winsock
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+        printf("WSAStartup failed: %d\n", WSAGetLastError());
+        return 1;
+    }
+    
+    // Creating socket
+    if ((server_fd = socket(AF_INET, SOCK_STREAM, 0)) == INVALID_SOCKET) {
+        printf("Socket creation error: %d\n", WSAGetLastError());
+        WSACleanup();
+        return 1;
+    }
+    
+    // Setup socket options to allow address reuse
+    int opt = 1;
+    if (setsockopt(server_fd, SOL_SOCKET, SO_REUSEADDR, (char*)&opt, sizeof(opt)) == SOCKET_ERROR) {
+        printf("Setsockopt error: %d\n", WSAGetLastError());
+        closesocket(server_fd);
+        WSACleanup();
+        return 1;
+    }
+    
+    // Workers share the port, the kernel balances connections between them
+    if (listen_workers_configure(server_fd) != 0) {
+        printf("SO_REUSEPORT error: %d\n", WSAGetLastError());
+        closesocket(server_fd);
+        WSACleanup();
+        return 1;
+    }
+    
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = INADDR_ANY;
+    address.sin_port = htons(port);
+    
+    // Bind the socket to the port
+    if (bind(server_fd, (struct sockaddr *)&address, sizeof(address)) == SOCKET_ERROR) {
+        printf("Bind failed: %d\n", WSAGetLastError());
+        closesocket(server_fd);
+        WSACleanup();
+        return 1;
+    }
+    
+    if (listen(server_fd, LISTEN_BACKLOG) == SOCKET_ERROR) {
+        printf("Listen error: %d\n", WSAGetLastError());
+        closesocket(server_fd);
+        WSACleanup();
+        return 1;
+    }
+    
+    printf("Control module started. Listening on port %d...\n", port);
+    init_metrics();
+    metrics_start_server(port + METRICS_PORT_OFFSET + listen_workers.index * LISTEN_METRICS_STRIDE);
+    if (recover_control_state(port) != 0) {
+        closesocket(server_fd);
+        WSACleanup();
+        return 1;
+    }
+    
+    // Control draws no model noise, the seed is recorded as 0
+    if (capture_open(port, listen_workers.count > 0 ? listen_workers.index : -1, 0) != 0) {
+        printf("Capture file %s cannot be written\n", capture.path);
+        closesocket(server_fd);
+        WSACleanup();
+        return 1;
+    }
+    if (capture.file != NULL) printf("Capturing received traffic to %s\n", capture.path);
+    
+    if (ingest_memory_init(&ingest, CONTROL_RECEIVE_BUFFERS, CONTROL_HEADER_BYTES, CONTROL_ARENA_BYTES) != 0) {
+        printf("Receive buffers cannot be allocated\n");
+        closesocket(server_fd);
+        WSACleanup();
+        return 1;
+    }
+    if (ingest_alloc_tracking()) printf("Counting heap allocations while handling alerts\n");
+    
+    // Workers would each see only part of a suit's samples, so they keep on/off control
+    if (listen_workers.count > 0) {
+        printf("Thermal loop control disabled with listener workers\n");
+    } else if (thermal_init(&thermal, THERMAL_MAX_SUITS, metrics_now()) != 0) {
+        printf("Thermal loop table cannot be allocated, using on/off temperature control\n");
+    } else {
+        printf("Thermal loop control at %d Hz, setpoint %.1f °C\n", 1000 / THERMAL_TICK_MS, THERMAL_SETPOINT);
+    }
+    
+    listen_workers_ready();
+    while (1) {
+        PendingCommand single;
+        int pending = 0;
+        int group_max = WAL_GROUP_MAX;
+        
+        // Keep the loops on schedule while no alert is waiting
+        while (thermal.count > 0 && !connection_waiting(server_fd, thermal_wait_ms(&thermal, metrics_now()))) {
+            run_thermal_tick();
+        }
+        
+        if ((new_socket = listen_workers_accept(server_fd, (struct sockaddr *)&address, &addrlen)) == INVALID_SOCKET) {
+            if (listen_workers.drained) break;  // Drain requested and the queue is empty
+            printf("Accept error: %d\n", WSAGetLastError());
+            continue;
+        }
+        ingest_batch_begin(&ingest);
+        PendingCommand *batch = batch_arena_alloc(&ingest.arena, WAL_GROUP_MAX * sizeof(PendingCommand));
+        if (batch == NULL) {
+            // No room for a group: this alert is committed on its own
+            printf("No arena space for a commit group, handling one alert\n");
+            batch = &single;
+            group_max = 1;
+        }
+        pending += receive_connection(new_socket, &batch[pending]);
+        
+        // Group commit: take the alerts already queued, then sync the log once for all of them
+        while (pending < group_max && connection_waiting(server_fd, 0)) {
+            if ((new_socket = accept(server_fd, (struct sockaddr *)&address, &addrlen)) == INVALID_SOCKET) break;
+            pending += receive_connection(new_socket, &batch[pending]);
+        }
+        double commit_start = metrics_now();
+        wal_commit(&control_wal);
+        metric_observe(metric_wal_commit, metrics_now() - commit_start);
+        metric_set(metric_active_alarms, 0, (uint64_t)control_wal.alarm_count);
+        
+        // Commands go out only once they are durable
+        for (int i = 0; i < pending; i++) {
+            dispatch_command(&batch[i]);
+        }
+        // ACK records ride on the next commit; if one is lost the command is resent on restart
+        if (control_wal.log != NULL) fflush(control_wal.log);
+        
+        // Snapshots and thermal ticks run between batches
+        int allocations = ingest_batch_end(&ingest);
+        if (allocations > 0) {
+            printf("Alert batch made %d heap allocation(s)\n", allocations);
+            metric_add(metric_heap_allocations, 0, (uint64_t)allocations);
+        }
+        
+        if (control_wal.since_snapshot >= WAL_SNAPSHOT_RECORDS) {
+            wal_snapshot(&control_wal);
+            report_alarm_table();
+        }
+        
+        // A steady stream of alerts must not starve the loops
+        run_thermal_tick();
+    }
+    
+    thermal_free(&thermal);
+    ingest_memory_free(&ingest);
+    capture_close();
+    wal_close(&control_wal);
+    closesocket(server_fd);
+    WSACleanup();
+    return 0;
+}
@@ -0,0 +1,424 @@
+#ifndef CONTROL_WAL_H
+#define CONTROL_WAL_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+// Write-ahead log of control decisions: alerts received, commands issued and
+// actuator acknowledgments. Records are fixed size and CRC-32 protected; a torn
+// or corrupt tail ends replay. Appends are buffered and made durable by
+// wal_commit, which the caller runs once per batch (group commit).
+//
+// Every record is applied to the active-alarm table through wal_apply, both
+// live and on replay, so recovery rebuilds exactly the state the log implies.
+// Periodic snapshots of the table let the log be truncated, which bounds replay.
+//
+// Alarms leave the table at snapshot time once quiet: acknowledged and command-less
+// ones after WAL_ALARM_HOLD_MS, ones whose command was never acknowledged after
+// WAL_ALARM_STALE_MS. The table doubles when three quarters full; an alarm it
+// cannot hold is counted in `untracked` for the caller to report, never dropped quietly.
+#define WAL_RECORD_ALERT 1
+#define WAL_RECORD_COMMAND 2
+#define WAL_RECORD_ACK 3
+#define WAL_RECORD_RETRY 4  // Command resent after a restart, ref is its seq
+#define WAL_INITIAL_ALARMS (1 << 18)  // Slots at start, power of two: two alarms per suit at 100k suits
+#define WAL_ALARMS_LIMIT (1 << 22)  // Largest table, 160 MB
+#define WAL_SNAPSHOT_RECORDS 20000  // Snapshot and truncate after this many appends
+#define WAL_ALARM_HOLD_MS (10 * 60 * 1000)  // Acknowledged alarms drop out after 10 min quiet
+#define WAL_ALARM_STALE_MS (60 * 60 * 1000)  // Unacknowledged ones after an hour
+#define WAL_COMMAND_RETRIES 3  // Resends of an unacknowledged command across restarts
+#define WAL_SNAPSHOT_MAGIC 0x534e4150u  // "SNAP"
+#define WAL_PATH_LEN 64
+#define WAL_LOG_BUFFER 8192  // stdio buffer for the log, held in the struct so appends never allocate
+
+typedef struct {
+    uint32_t crc;  // CRC-32 of the bytes after this field
+    uint32_t type;
+    uint64_t seq;
+    uint64_t ref;  // ACK: seq of the command it acknowledges
+    int64_t time_ms;  // Wall clock, so alarm age survives restarts
+    int32_t suit_id;
+    int32_t param_code;
+    int32_t value;
+    int32_t response_code;
+} WalRecord;
+
+// One active alarm per suit and parameter code (early warnings keep their flag)
+typedef struct {
+    int32_t suit_id;
+    int32_t param_code;  // 0 = empty slot
+    int32_t value;
+    int32_t response_code;
+    uint64_t command_seq;  // Latest command issued for this alarm
+    int64_t time_ms;  // Latest alert
+    int32_t acked;  // Latest command acknowledged by the actuator
+    int32_t retries;  // Resends of the latest command
+} ActiveAlarm;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t crc;  // CRC-32 of the alarm entries
+    uint64_t last_seq;
+    uint32_t count;
+    uint32_t pad;
+} SnapshotHeader;
+
+typedef struct {
+    FILE *log;
+    char log_path[WAL_PATH_LEN];
+    char snap_path[WAL_PATH_LEN];
+    uint64_t next_seq;
+    int dirty;  // Appended since the last commit
+    int since_snapshot;
+    char log_buffer[WAL_LOG_BUFFER];
+    ActiveAlarm *alarms;
+    uint32_t capacity;  // Slots, power of two
+    int alarm_count;
+    long untracked;  // Alerts and commands the table had no room for
+    long abandoned;  // Unacknowledged commands expired by age
+} ControlWal;
+
+typedef struct {
+    long records;  // Log records replayed
+    int alarms;
+    int pending;  // Commands without an acknowledgment, still to be resent
+    int snapshot_loaded;
+    int torn_tail;  // Replay stopped on a bad record
+} WalRecovery;
+
+static uint32_t wal_crc_table[256];
+
+static void wal_crc_init() {
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; k++) c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+        wal_crc_table[i] = c;
+    }
+}
+
+uint32_t wal_crc32(const void *data, size_t len) {
+    const unsigned char *p = data;
+    uint32_t c = 0xffffffffu;
+    for (size_t i = 0; i < len; i++) c = wal_crc_table[(c ^ p[i]) & 0xff] ^ (c >> 8);
+    return c ^ 0xffffffffu;
+}
+
+static uint32_t wal_record_crc(const WalRecord *r) {
+    return wal_crc32((const char *)r + sizeof(r->crc), sizeof(*r) - sizeof(r->crc));
+}
+
+int64_t wal_time_ms() {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static int wal_sync(FILE *fp) {
+    if (fflush(fp) != 0) return -1;
+#ifdef _WIN32
+    return _commit(_fileno(fp));
+#else
+    return fsync(fileno(fp));
+#endif
+}
+
+static uint32_t wal_alarm_hash(const ControlWal *wal, int32_t suit_id, int32_t param_code) {
+    uint32_t h = (uint32_t)suit_id * 0x9e3779b1u ^ (uint32_t)param_code * 0x85ebca6bu;
+    h ^= h >> 15;
+    return h & (wal->capacity - 1);
+}
+
+// Linear probing; returns the slot holding the key, or the empty slot where it belongs
+static ActiveAlarm *wal_alarm_slot(ControlWal *wal, int32_t suit_id, int32_t param_code) {
+    uint32_t i = wal_alarm_hash(wal, suit_id, param_code);
+    while (wal->alarms[i].param_code != 0 &&
+           (wal->alarms[i].suit_id != suit_id || wal->alarms[i].param_code != param_code)) {
+        i = (i + 1) & (wal->capacity - 1);
+    }
+    return &wal->alarms[i];
+}
+
+// Rehash into a table of twice the size; -1 at WAL_ALARMS_LIMIT or when allocation fails
+static int wal_alarm_grow(ControlWal *wal) {
+    uint32_t old_capacity = wal->capacity;
+    ActiveAlarm *old = wal->alarms;
+    if (old_capacity * 2 > WAL_ALARMS_LIMIT) return -1;
+    ActiveAlarm *alarms = calloc((size_t)old_capacity * 2, sizeof(ActiveAlarm));
+    if (alarms == NULL) return -1;
+    wal->alarms = alarms;
+    wal->capacity = old_capacity * 2;
+    for (uint32_t i = 0; i < old_capacity; i++) {
+        if (old[i].param_code != 0) *wal_alarm_slot(wal, old[i].suit_id, old[i].param_code) = old[i];
+    }
+    free(old);
+    return 0;
+}
+
+// Slot for a new alarm, growing the table first if it is getting full. NULL when
+// there is no room: one slot always stays free so probing ends.
+static ActiveAlarm *wal_alarm_insert(ControlWal *wal, int32_t suit_id, int32_t param_code) {
+    if ((uint64_t)(wal->alarm_count + 1) * 4 > (uint64_t)wal->capacity * 3) wal_alarm_grow(wal);
+    if ((uint32_t)wal->alarm_count >= wal->capacity - 1) {
+        wal->untracked++;
+        return NULL;
+    }
+    ActiveAlarm *a = wal_alarm_slot(wal, suit_id, param_code);
+    a->suit_id = suit_id;
+    a->param_code = param_code;
+    wal->alarm_count++;
+    return a;
+}
+
+// Backward-shift deletion keeps probe chains intact without tombstones
+static void wal_alarm_remove(ControlWal *wal, ActiveAlarm *slot) {
+    uint32_t i = (uint32_t)(slot - wal->alarms);
+    uint32_t j = i;
+    while (1) {
+        j = (j + 1) & (wal->capacity - 1);
+        if (wal->alarms[j].param_code == 0) break;
+        uint32_t home = wal_alarm_hash(wal, wal->alarms[j].suit_id, wal->alarms[j].param_code);
+        // Move j back into the hole unless its home lies cyclically in (i, j]
+        if ((j > i && (home <= i || home > j)) || (j < i && (home <= i && home > j))) {
+            wal->alarms[i] = wal->alarms[j];
+            i = j;
+        }
+    }
+    memset(&wal->alarms[i], 0, sizeof(wal->alarms[i]));
+    wal->alarm_count--;
+}
+
+// Apply one record to the alarm table. Replaying a record twice leaves the same state.
+// Returns -1 when the record needed a new alarm and the table had no room for it.
+int wal_apply(ControlWal *wal, const WalRecord *r) {
+    if (r->seq >= wal->next_seq) wal->next_seq = r->seq + 1;
+
+    ActiveAlarm *a = wal_alarm_slot(wal, r->suit_id, r->param_code);
+    if (a->param_code == 0) {
+        if (r->type == WAL_RECORD_ACK || r->type == WAL_RECORD_RETRY) return 0;  // Alarm already expired
+        a = wal_alarm_insert(wal, r->suit_id, r->param_code);
+        if (a == NULL) return -1;
+    }
+
+    switch (r->type) {
+        case WAL_RECORD_ALERT:
+            a->value = r->value;
+            a->time_ms = r->time_ms;
+            break;
+        case WAL_RECORD_COMMAND:
+            a->response_code = r->response_code;
+            a->value = r->value;
+            a->command_seq = r->seq;
+            a->acked = 0;
+            a->retries = 0;
+            break;
+        case WAL_RECORD_ACK:
+            // A late ACK for an older command does not clear a newer one
+            if (r->ref == a->command_seq) a->acked = 1;
+            break;
+        case WAL_RECORD_RETRY:
+            if (r->ref == a->command_seq) a->retries++;
+            break;
+    }
+    return 0;
+}
+
+// Append a record and apply it; returns its sequence number. Not durable until wal_commit.
+uint64_t wal_log(ControlWal *wal, uint32_t type, int suit_id, int param_code,
+                 int value, int response_code, uint64_t ref) {
+    WalRecord r;
+    memset(&r, 0, sizeof(r));
+    r.type = type;
+    r.seq = wal->next_seq;
+    r.ref = ref;
+    r.time_ms = wal_time_ms();
+    r.suit_id = suit_id;
+    r.param_code = param_code;
+    r.value = value;
+    r.response_code = response_code;
+    r.crc = wal_record_crc(&r);
+
+    if (wal->log != NULL && fwrite(&r, sizeof(r), 1, wal->log) == 1) {
+        wal->dirty = 1;
+        wal->since_snapshot++;
+    }
+    wal_apply(wal, &r);
+    return r.seq;
+}
+
+// Make everything appended so far durable with a single sync
+int wal_commit(ControlWal *wal) {
+    if (!wal->dirty || wal->log == NULL) return 0;
+    wal->dirty = 0;
+    return wal_sync(wal->log);
+}
+
+static int wal_alarm_expired(const ActiveAlarm *a, int64_t now_ms) {
+    int64_t quiet = now_ms - a->time_ms;
+    if (a->command_seq == 0 || a->acked) return quiet > WAL_ALARM_HOLD_MS;
+    return quiet > WAL_ALARM_STALE_MS;
+}
+
+static void wal_expire(ControlWal *wal, int64_t now_ms) {
+    for (uint32_t i = 0; i < wal->capacity; i++) {
+        ActiveAlarm *a = &wal->alarms[i];
+        // Removal can shift a later entry into i, so check the slot again
+        while (a->param_code != 0 && wal_alarm_expired(a, now_ms)) {
+            if (a->command_seq != 0 && !a->acked) wal->abandoned++;
+            wal_alarm_remove(wal, a);
+        }
+    }
+}
+
+// Write the alarm table to a new snapshot, then start an empty log
+int wal_snapshot(ControlWal *wal) {
+    char tmp_path[WAL_PATH_LEN + 4];
+    SnapshotHeader header;
+    ActiveAlarm *entries;
+    FILE *fp;
+
+    wal_commit(wal);
+    wal_expire(wal, wal_time_ms());
+
+    entries = malloc((size_t)(wal->alarm_count + 1) * sizeof(ActiveAlarm));
+    if (entries == NULL) return -1;
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < wal->capacity; i++) {
+        if (wal->alarms[i].param_code != 0) entries[count++] = wal->alarms[i];
+    }
+
+    memset(&header, 0, sizeof(header));
+    header.magic = WAL_SNAPSHOT_MAGIC;
+    header.last_seq = wal->next_seq - 1;
+    header.count = count;
+    header.crc = wal_crc32(entries, count * sizeof(ActiveAlarm));
+
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", wal->snap_path);
+    fp = fopen(tmp_path, "wb");
+    if (fp == NULL) {
+        free(entries);
+        return -1;
+    }
+    int ok = fwrite(&header, sizeof(header), 1, fp) == 1 &&
+             fwrite(entries, sizeof(ActiveAlarm), count, fp) == count &&
+             wal_sync(fp) == 0;
+    fclose(fp);
+    free(entries);
+    if (!ok) {
+        remove(tmp_path);
+        return -1;
+    }
+
+    // rename() will not replace an existing file on Windows. If we stop between
+    // these two calls, recovery falls back to the .tmp snapshot.
+    remove(wal->snap_path);
+    if (rename(tmp_path, wal->snap_path) != 0) return -1;
+
+    // Records up to last_seq are in the snapshot, the log can start over
+    if (wal->log != NULL) fclose(wal->log);
+    wal->log = fopen(wal->log_path, "wb");
+    if (wal->log != NULL) setvbuf(wal->log, wal->log_buffer, _IOFBF, sizeof(wal->log_buffer));
+    wal->since_snapshot = 0;
+    wal->dirty = 0;
+    return wal->log != NULL ? 0 : -1;
+}
+
+static int wal_load_snapshot(ControlWal *wal, const char *path, uint64_t *last_seq) {
+    SnapshotHeader header;
+    FILE *fp = fopen(path, "rb");
+    if (fp == NULL) return -1;
+
+    int ok = fread(&header, sizeof(header), 1, fp) == 1 &&
+             header.magic == WAL_SNAPSHOT_MAGIC && header.count < WAL_ALARMS_LIMIT / 2;
+    ActiveAlarm *entries = ok ? malloc((size_t)(header.count + 1) * sizeof(ActiveAlarm)) : NULL;
+    ok = ok && entries != NULL &&
+         fread(entries, sizeof(ActiveAlarm), header.count, fp) == header.count &&
+         wal_crc32(entries, header.count * sizeof(ActiveAlarm)) == header.crc;
+    fclose(fp);
+
+    if (ok) {
+        for (uint32_t i = 0; i < header.count; i++) {
+            ActiveAlarm *slot = wal_alarm_slot(wal, entries[i].suit_id, entries[i].param_code);
+            if (slot->param_code == 0) slot = wal_alarm_insert(wal, entries[i].suit_id, entries[i].param_code);
+            if (slot != NULL) *slot = entries[i];
+        }
+        *last_seq = header.last_seq;
+        wal->next_seq = header.last_seq + 1;
+    }
+    free(entries);
+    return ok ? 0 : -1;
+}
+
+// Open the log for a control instance, rebuilding alarm state from the last
+// snapshot plus the log tail. Afterwards a fresh snapshot is taken, which also
+// drops any torn tail. Returns -1 if the log cannot be written.
+int wal_open(ControlWal *wal, const char *name, WalRecovery *recovery) {
+    char tmp_path[WAL_PATH_LEN + 4];
+    uint64_t last_seq = 0;
+    WalRecord r;
+    FILE *fp;
+
+    memset(wal, 0, sizeof(*wal));
+    memset(recovery, 0, sizeof(*recovery));
+    wal->alarms = calloc(WAL_INITIAL_ALARMS, sizeof(ActiveAlarm));
+    if (wal->alarms == NULL) return -1;
+    wal->capacity = WAL_INITIAL_ALARMS;
+    wal_crc_init();
+    wal->next_seq = 1;
+    snprintf(wal->log_path, sizeof(wal->log_path), "%s.wal", name);
+    snprintf(wal->snap_path, sizeof(wal->snap_path), "%s.snap", name);
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", wal->snap_path);
+
+    if (wal_load_snapshot(wal, wal->snap_path, &last_seq) == 0 ||
+        wal_load_snapshot(wal, tmp_path, &last_seq) == 0) {
+        recovery->snapshot_loaded = 1;
+    }
+
+    fp = fopen(wal->log_path, "rb");
+    if (fp != NULL) {
+        static char buffer[1 << 16];
+        setvbuf(fp, buffer, _IOFBF, sizeof(buffer));
+        size_t got;
+        while ((got = fread(&r, 1, sizeof(r), fp)) > 0) {
+            if (got < sizeof(r) || r.crc != wal_record_crc(&r)) {
+                recovery->torn_tail = 1;
+                break;
+            }
+            // Already covered by the snapshot when we stopped before truncating
+            if (r.seq <= last_seq) continue;
+            wal_apply(wal, &r);
+            recovery->records++;
+        }
+        fclose(fp);
+    }
+
+    // The snapshot expires what went quiet while we were down, then count what is left
+    int status = wal_snapshot(wal);
+    for (uint32_t i = 0; i < wal->capacity; i++) {
+        const ActiveAlarm *a = &wal->alarms[i];
+        if (a->param_code != 0 && a->command_seq != 0 && !a->acked && a->retries < WAL_COMMAND_RETRIES) {
+            recovery->pending++;
+        }
+    }
+    recovery->alarms = wal->alarm_count;
+    return status;
+}
+
+void wal_close(ControlWal *wal) {
+    wal_commit(wal);
+    if (wal->log != NULL) fclose(wal->log);
+    wal->log = NULL;
+    free(wal->alarms);
+    wal->alarms = NULL;
+    wal->capacity = 0;
+    wal->alarm_count = 0;
+}
+
+#endif
@@ -0,0 +1,125 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include "current_waveform.h"
+
+// Benchmark for the current waveform stage: many Hall channels streamed in
+// 10 ms blocks at 10, 20 and 50 kHz. Reports how many channels one core keeps
+// up with in real time, arc-flash detection delay in mains cycles, and false alarms.
+
+#define BENCH_CHANNELS 256
+#define BENCH_SECONDS 1
+#define BENCH_BLOCK_MS 10
+#define BENCH_ARC_EVERY 8  // Every 8th channel develops an arc
+#define BENCH_OVERLOAD_EVERY 16  // Every 16th (offset by 4) carries an overload
+#define BENCH_MAX_REPORTS 16
+
+double now_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+double uniform(double lo, double hi) {
+    return lo + (hi - lo) * (rand() / (double)RAND_MAX);
+}
+
+void run(double rate) {
+    int samples = (int)(BENCH_SECONDS * rate);
+    int block = (int)(rate * BENCH_BLOCK_MS / 1000.0);
+    int16_t *adc = malloc((size_t)samples * BENCH_CHANNELS * sizeof(int16_t));
+    double *arc_onset = malloc(BENCH_CHANNELS * sizeof(double));
+    double *detected_at = malloc(BENCH_CHANNELS * sizeof(double));
+    int *overload = calloc(BENCH_CHANNELS, sizeof(int));
+    int *overload_seen = calloc(BENCH_CHANNELS, sizeof(int));
+    WaveformChannel *channels = malloc(BENCH_CHANNELS * sizeof(WaveformChannel));
+    CycleReport reports[BENCH_MAX_REPORTS];
+
+    // Channel-major recordings, so each block is contiguous like a received message
+    srand(11);
+    for (int c = 0; c < BENCH_CHANNELS; c++) {
+        double load = uniform(3.0, 30.0) * sqrt(2.0);
+        int arcs = (c % BENCH_ARC_EVERY) == 0;
+        overload[c] = (c % BENCH_OVERLOAD_EVERY) == 4;
+        if (overload[c]) load = 60.0 * sqrt(2.0);
+        arc_onset[c] = arcs ? uniform(0.2, 0.8) : -1.0;
+        detected_at[c] = -1.0;
+
+        for (int s = 0; s < samples; s++) {
+            double t = s / rate;
+            double phase = sin(2.0 * M_PI * MAINS_FREQ * t + c);
+            double amps = load * phase;
+            if (arcs && t >= arc_onset[c]) {
+                if (fabs(phase) < 0.15) amps = 0.0;
+                if (rand() % 100 < 3) amps += load * uniform(-1.0, 1.0);
+            }
+            adc[(size_t)c * samples + s] = hall_voltage_to_adc(hall_effect_output(amps * CURRENT_AMPS_PER_MT));
+        }
+        waveform_init(&channels[c], rate);
+    }
+
+    int false_arcs = 0;
+    double start = now_seconds();
+    for (int b = 0; b + block <= samples; b += block) {
+        for (int c = 0; c < BENCH_CHANNELS; c++) {
+            int done = waveform_process(&channels[c], adc + (size_t)c * samples + b, block,
+                                        reports, BENCH_MAX_REPORTS);
+            for (int r = 0; r < done; r++) {
+                if (reports[r].overcurrent) overload_seen[c] = 1;
+                if (!reports[r].arc) continue;
+                if (arc_onset[c] < 0) {
+                    false_arcs++;
+                } else if (detected_at[c] < 0) {
+                    detected_at[c] = (b + block) / rate;
+                }
+            }
+        }
+    }
+    double elapsed = now_seconds() - start;
+
+    int arcing = 0, detected = 0, within_cycle = 0, overloads = 0, overloads_seen = 0;
+    double delay_sum = 0.0, worst_delay = 0.0;
+    for (int c = 0; c < BENCH_CHANNELS; c++) {
+        overloads += overload[c];
+        overloads_seen += overload[c] && overload_seen[c];
+        if (arc_onset[c] < 0) continue;
+        arcing++;
+        if (detected_at[c] < 0) continue;
+        detected++;
+        // Decisions are made at cycle ends; block delivery adds up to one block
+        double cycles = (detected_at[c] - arc_onset[c]) * MAINS_FREQ - BENCH_BLOCK_MS * MAINS_FREQ / 1000.0;
+        if (cycles <= 1.0) within_cycle++;
+        delay_sum += cycles;
+        if (cycles > worst_delay) worst_delay = cycles;
+    }
+
+    double total = (double)samples * BENCH_CHANNELS;
+    printf("%5.0f kHz: %5.2f ns/sample, ~%5.0f channels per core in real time (%.1f%% of one core for %d)\n",
+           rate / 1000.0, elapsed * 1e9 / total, total / elapsed / rate,
+           elapsed / BENCH_SECONDS * 100.0, BENCH_CHANNELS);
+    printf("           arcs detected %d/%d, %d within one cycle (mean %.2f, worst %.2f cycles), "
+           "%d false, overloads %d/%d\n",
+           detected, arcing, within_cycle, detected ? delay_sum / detected : 0.0, worst_delay,
+           false_arcs, overloads_seen, overloads);
+
+    free(adc);
+    free(arc_onset);
+    free(detected_at);
+    free(overload);
+    free(overload_seen);
+    free(channels);
+}
+
+int main() {
+    printf("Smart Suit - Current Waveform Benchmark\n");
+    printf("---------------------------------------\n");
+    printf("%d channels, %d ms blocks, %.0f Hz mains, %d s simulated per rate\n",
+           BENCH_CHANNELS, BENCH_BLOCK_MS, MAINS_FREQ, BENCH_SECONDS);
+
+    run(10000.0);
+    run(20000.0);
+    run(50000.0);
+    return 0;
+}
@@ -0,0 +1,178 @@
+#ifndef CURRENT_WAVEFORM_H
+#define CURRENT_WAVEFORM_H
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include "electrical_sensor.h"
+
+// Streaming analysis of sampled Hall-sensor current waveforms.
+// Samples are signed 16-bit ADC counts centred on HALL_OFFSET spanning ±HALL_OFFSET volts.
+// Statistics are kept per half cycle and reported every half cycle over the
+// last full mains cycle: true RMS, peak, crest factor and peak di/dt. Arcing
+// is recognised from repeated di/dt spikes and broadband energy in that window,
+// so an arc is flagged within about one cycle of striking.
+#define MAINS_FREQ 50.0  // Hz
+#define CURRENT_SAMPLE_RATE 20000.0  // Hz (10-50 kHz supported)
+#define CURRENT_AMPS_PER_MT 5.0  // Field per amp at the conductor, as in measure_current_hall
+#define WAVEFORM_CHUNK 512  // Samples processed per kernel call
+#define OVERCURRENT_RMS_A 40.0  // True RMS limit
+#define ARC_STEP_FACTOR 8.0  // Spike: sample step this many times the steepest step of a clean sine
+#define ARC_NOISE_STEP_A 1.0  // Spike steps must also clear the sensor noise
+#define ARC_MIN_SPIKES 3  // Spikes within one cycle
+#define ARC_MIN_RMS_A 1.0  // An arc needs current to flow
+#define ARC_HF_RATIO 0.05  // Second-difference energy relative to signal energy
+
+typedef struct {
+    double rms;  // A
+    double peak;  // A
+    double crest;  // Peak / RMS (1.414 for a clean sine)
+    double max_didt;  // A/s
+    double hf_ratio;
+    int spikes;
+    int arc;
+    int overcurrent;
+} CycleReport;
+
+// Accumulators for one half cycle, in ADC counts
+typedef struct {
+    int64_t sumsq;
+    int64_t hf;
+    int32_t peak;
+    int32_t max_step;
+    int32_t spikes;
+} HalfCycle;
+
+typedef struct {
+    int samples_per_half;
+    double sample_rate;
+    double amps_per_count;
+    int32_t noise_step;  // Counts, floor for the spike threshold
+    int32_t spike_step;  // Counts, current spike threshold (follows the load)
+    HalfCycle previous;
+    HalfCycle current;
+    int filled;  // Samples in the current half
+    int halves;  // Completed halves, a report needs two
+    int16_t prev;  // Last two samples, so differences run across blocks
+    int16_t prev2;
+    int primed;
+} WaveformChannel;
+
+void waveform_init(WaveformChannel *ch, double sample_rate) {
+    memset(ch, 0, sizeof(*ch));
+    ch->sample_rate = sample_rate;
+    ch->samples_per_half = (int)lround(sample_rate / MAINS_FREQ / 2.0);
+    // Volts per count, then amps per volt from the Hall chain
+    double volts_per_count = HALL_OFFSET / 32768.0;
+    double volts_per_amp = HALL_SENSITIVITY * CURRENT_AMPS_PER_MT / 1000.0;
+    ch->amps_per_count = volts_per_count / volts_per_amp;
+    ch->noise_step = (int32_t)ceil(ARC_NOISE_STEP_A / ch->amps_per_count);
+    ch->spike_step = ch->noise_step;
+}
+
+// Hall voltage to ADC count, the inverse of the scaling above
+int16_t hall_voltage_to_adc(double volts) {
+    double counts = (volts - HALL_OFFSET) / HALL_OFFSET * 32768.0;
+    if (counts > 32767.0) counts = 32767.0;
+    if (counts < -32768.0) counts = -32768.0;
+    return (int16_t)lrint(counts);
+}
+
+// Integer kernel over part of one half cycle. All reductions are on integers so
+// the compiler can vectorize them without relaxing floating-point rules.
+static inline void waveform_kernel(WaveformChannel *ch, const int16_t *restrict adc, int n) {
+    int32_t x[WAVEFORM_CHUNK + 2];
+    HalfCycle *h = &ch->current;
+    int64_t sumsq = 0, hf = 0;
+    int32_t peak = h->peak, max_step = h->max_step, spikes = 0;
+    const int32_t spike = ch->spike_step;
+
+    x[0] = ch->prev2;
+    x[1] = ch->prev;
+    for (int i = 0; i < n; i++) x[i + 2] = adc[i];
+
+    for (int i = 0; i < n; i++) {
+        int32_t cur = x[i + 2];
+        int32_t d1 = x[i + 2] - x[i + 1];
+        int32_t d0 = x[i + 1] - x[i];
+        int32_t dd = d1 - d0;
+        int32_t mag = cur < 0 ? -cur : cur;
+        int32_t step = d1 < 0 ? -d1 : d1;
+        sumsq += (int64_t)cur * cur;
+        hf += (int64_t)dd * dd;
+        peak = mag > peak ? mag : peak;
+        max_step = step > max_step ? step : max_step;
+        spikes += step > spike;
+    }
+
+    h->sumsq += sumsq;
+    h->hf += hf;
+    h->peak = peak;
+    h->max_step = max_step;
+    h->spikes += spikes;
+    ch->filled += n;
+    ch->prev2 = (int16_t)x[n];
+    ch->prev = (int16_t)x[n + 1];
+}
+
+// Close the current half cycle and classify the full cycle ending here
+static void waveform_finish_half(WaveformChannel *ch, CycleReport *r) {
+    const HalfCycle *a = &ch->previous, *b = &ch->current;
+    double n = 2.0 * ch->samples_per_half;
+    double k = ch->amps_per_count;
+    int64_t sumsq = a->sumsq + b->sumsq;
+    int32_t peak = a->peak > b->peak ? a->peak : b->peak;
+    int32_t max_step = a->max_step > b->max_step ? a->max_step : b->max_step;
+
+    r->rms = sqrt(sumsq / n) * k;
+    r->peak = peak * k;
+    r->crest = (r->rms > 0.0) ? r->peak / r->rms : 0.0;
+    r->max_didt = max_step * k * ch->sample_rate;
+    r->hf_ratio = (sumsq > 0) ? (double)(a->hf + b->hf) / sumsq : 0.0;
+    r->spikes = a->spikes + b->spikes;
+    r->overcurrent = r->rms > OVERCURRENT_RMS_A;
+    r->arc = r->spikes >= ARC_MIN_SPIKES && r->rms > ARC_MIN_RMS_A && r->hf_ratio > ARC_HF_RATIO;
+
+    // The steepest step of a clean sine at this RMS sets the next spike level
+    double sine_step = sqrt(2.0) * sqrt(sumsq / n) * 2.0 * M_PI * MAINS_FREQ / ch->sample_rate;
+    int32_t step = (int32_t)(ARC_STEP_FACTOR * sine_step);
+    ch->spike_step = step > ch->noise_step ? step : ch->noise_step;
+
+    ch->previous = ch->current;
+    memset(&ch->current, 0, sizeof(ch->current));
+    ch->filled = 0;
+}
+
+// Feed a block of samples; writes one report per completed half cycle, each
+// covering the last full cycle. Returns the number of reports written (at most max_reports).
+int waveform_process(WaveformChannel *ch, const int16_t *adc, int n,
+                     CycleReport *reports, int max_reports) {
+    int done = 0;
+
+    if (!ch->primed && n > 0) {
+        // No step into the first sample
+        ch->prev = ch->prev2 = adc[0];
+        ch->primed = 1;
+    }
+
+    while (n > 0) {
+        int room = ch->samples_per_half - ch->filled;
+        int take = n < room ? n : room;
+        if (take > WAVEFORM_CHUNK) take = WAVEFORM_CHUNK;
+
+        waveform_kernel(ch, adc, take);
+        adc += take;
+        n -= take;
+
+        if (ch->filled == ch->samples_per_half) {
+            CycleReport dropped;
+            CycleReport *r = (ch->halves >= 1 && done < max_reports) ? &reports[done++] : &dropped;
+            waveform_finish_half(ch, r);
+            ch->halves++;
+        }
+    }
+    return done;
+}
+
+#endif
@@ -0,0 +1,124 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <math.h>
+#include "sensor_filter.h"
+
+// Benchmark and check for online RTD drift estimation (sensor_filter.h):
+//  1. suits whose probes age at 0.2-0.8% a year, against the 0.5% a year the
+//     prior assumes, with a weekly dock reference over three years. The drift
+//     estimate must follow every probe closely enough that a compensated body
+//     temperature stays within a third of TEMP_ACCURACY
+//  2. a new install date (probe replaced) drops what was learned and starts
+//     again from the prior
+//  3. cost of one reference update
+
+#define BENCH_SUITS 1000
+#define BENCH_WEEKS (3 * 52)
+#define BENCH_START_YEARS 2  // Service age at the first reference
+#define BENCH_BODY_TEMP 37.0  // Where the compensation error is scored
+#define BENCH_MAX_ERROR (TEMP_ACCURACY / 3.0)
+#define BENCH_UPDATES 10000000L
+
+FilterBank bank;
+double true_rate[BENCH_SUITS];
+uint32_t rng = 2024;
+
+double now_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+uint32_t next_random() {
+    rng = rng * 1664525u + 1013904223u;
+    return rng >> 8;
+}
+
+double uniform(double low, double high) {
+    return low + (high - low) * (next_random() / 16777216.0);
+}
+
+// What an RTD with multiplicative drift k reads at temperature t, with read_rtd_temperature's noise
+double drifted_reading(double t, double k) {
+    double resistance = calculate_rtd_resistance(t) * (1.0 + k) + uniform(-0.1, 0.1) * SENSOR_ERROR;
+    return (resistance / RO - 1.0) / ALPHA;
+}
+
+// Compensation error at body temperature with drift estimate k_est for a probe at k
+double body_error(double k, double k_est) {
+    double measured = BENCH_BODY_TEMP * (1.0 + k) + k / ALPHA;
+    return fabs(compensate_rtd_drift(measured, k_est) - BENCH_BODY_TEMP);
+}
+
+int main() {
+    int failures = 0;
+
+    printf("Smart Suit - RTD Drift Estimation Benchmark\n");
+    printf("-------------------------------------------\n");
+    if (filter_bank_init(&bank, BENCH_SUITS) != 0) {
+        printf("Allocation failed\n");
+        return 1;
+    }
+    int32_t install_day = 19000;
+
+    // 1. Weekly references on drifting probes
+    for (int s = 0; s < BENCH_SUITS; s++) {
+        true_rate[s] = uniform(0.002, 0.008);
+        filter_rtd_drift(&bank, s, DRIFT_RATE, BENCH_START_YEARS, install_day);
+    }
+    double prior_sq = 0.0, est_sq = 0.0, worst = 0.0, first_year_worst = 0.0;
+    int scored = 0;
+    for (int week = 0; week < BENCH_WEEKS; week++) {
+        double years = BENCH_START_YEARS + week / 52.0;
+        for (int s = 0; s < BENCH_SUITS; s++) {
+            double k = true_rate[s] * years;
+            double reference = uniform(15.0, 35.0);
+            double est = filter_rtd_reference(&bank, s, drifted_reading(reference, k), reference, DRIFT_RATE,
+                                              (int)lround(years), install_day);
+            double error = body_error(k, est);
+            if (week < 52 && error > first_year_worst) first_year_worst = error;
+            // Scored after the first month, once a few references are in
+            if (week < 4) continue;
+            double prior = body_error(k, DRIFT_RATE * years);
+            prior_sq += prior * prior;
+            est_sq += error * error;
+            if (error > worst) worst = error;
+            scored++;
+        }
+    }
+    double prior_rms = sqrt(prior_sq / scored), est_rms = sqrt(est_sq / scored);
+    printf("%d suits, %d weekly references, true drift 0.2-0.8%%/year, prior %.1f%%/year:\n",
+           BENCH_SUITS, BENCH_WEEKS, DRIFT_RATE * 100.0);
+    printf("  error at %.0f °C: prior only RMS %.3f °C, estimated RMS %.3f °C, worst %.3f °C "
+           "(worst in the first year %.3f °C)\n", BENCH_BODY_TEMP, prior_rms, est_rms, worst, first_year_worst);
+    if (worst > BENCH_MAX_ERROR || est_rms >= prior_rms) {
+        printf("  FAIL: the estimate must stay within %.2f °C and beat the prior\n", BENCH_MAX_ERROR);
+        failures++;
+    }
+
+    // 2. Suit 0 gets a new probe
+    double learned = filter_rtd_drift(&bank, 0, DRIFT_RATE, BENCH_START_YEARS + 3, install_day);
+    double reseeded = filter_rtd_drift(&bank, 0, DRIFT_RATE, 0, install_day + 1100);
+    printf("\nProbe replaced: drift estimate %.3f%% before, %.3f%% after (prior for a new probe 0%%)\n",
+           learned * 100.0, reseeded * 100.0);
+    if (reseeded != 0.0 || bank.rtd[0].drift_variance != (float)FILTER_DRIFT_VARIANCE) {
+        printf("  FAIL: a new install date must seed the prior again\n");
+        failures++;
+    }
+
+    // 3. Update cost
+    double sink = 0.0;
+    double start = now_seconds();
+    for (long i = 0; i < BENCH_UPDATES; i++) {
+        int s = (int)(i % BENCH_SUITS);
+        sink += filter_rtd_reference(&bank, s, 20.0 + (i & 7) * 0.01, 20.0, DRIFT_RATE, 5, install_day);
+    }
+    double elapsed = now_seconds() - start;
+    printf("\nReference update: %.1f ns (checksum %.1f)\n", elapsed / BENCH_UPDATES * 1e9, sink);
+
+    filter_bank_free(&bank);
+    return (failures > 0) ? 1 : 0;
+}
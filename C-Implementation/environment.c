@@ -1,113 +1,542 @@
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include <time.h>
-#include <winsock2.h>
-#include <ws2tcpip.h>
-
-#pragma comment(lib, "ws2_32.lib")
-
-#define PORT_SENSOR 8080
-#define BUFFER_SIZE 1024
-
-// Parameter codes
-#define TEMPERATURE 1
-#define RADIATION 2
-#define CHEMICAL 3
-#define OXYGEN 4
-#define NOISE 5
-#define VOLTAGE 6
-
-void send_to_sensor(int param_code, int value) {
-    SOCKET sock = INVALID_SOCKET;
-    struct sockaddr_in serv_addr;
-    
-    // Create socket
-    if ((sock = socket(AF_INET, SOCK_STREAM, 0)) == INVALID_SOCKET) {
-        printf("Socket creation error: %d\n", WSAGetLastError());
-        return;
-    }
-    
-    serv_addr.sin_family = AF_INET;
-    serv_addr.sin_port = htons(PORT_SENSOR);
-    
-    // Convert IPv4 address from text to binary form
-    if (inet_pton(AF_INET, "127.0.0.1", &serv_addr.sin_addr) <= 0) {
-        printf("Invalid address/ Address not supported\n");
-        closesocket(sock);
-        return;
-    }
-    
-    if (connect(sock, (struct sockaddr *)&serv_addr, sizeof(serv_addr)) < 0) {
-        printf("Connection Failed: %d\n", WSAGetLastError());
-        closesocket(sock);
-        return;
-    }
-    
-    // Send data as integers
-    int data[2] = {param_code, value};
-    send(sock, (char*)data, sizeof(data), 0);
-    printf("Sent to sensor: Parameter Code %d, Value %d\n", param_code, value);
-    
-    closesocket(sock);
-}
-
-void display_menu() {
-    printf("\n===== Environment Simulation Menu =====\n");
-    printf("1. Change Temperature (°C)\n");
-    printf("2. Change Radiation Level (μSv/h)\n");
-    printf("3. Change Chemical Concentration (ppm)\n");
-    printf("4. Change Oxygen Level (%%)\n");
-    printf("5. Change Noise Level (dB)\n");
-    printf("6. Change Electrical Field (V/m)\n");
-    printf("0. Exit\n");
-    printf("Enter your choice: ");
-}
-
-const char* get_param_name(int code) {
-    switch(code) {
-        case TEMPERATURE: return "Temperature";
-        case RADIATION: return "Radiation";
-        case CHEMICAL: return "Chemical";
-        case OXYGEN: return "Oxygen";
-        case NOISE: return "Noise";
-        case VOLTAGE: return "Voltage";
-        default: return "Unknown";
-    }
-}
-
-int main() {
-    WSADATA wsaData;
-    int choice, value;
-    
-    // Initialize Winsock
-    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
-        printf("WSAStartup failed: %d\n", WSAGetLastError());
-        return 1;
-    }
-    
-    printf("Smart Suit for Industrial Workers - Environment Simulation\n");
-    printf("--------------------------------------------------------\n");
-    
-    while (1) {
-        display_menu();
-        scanf("%d", &choice);
-        
-        if (choice == 0) {
-            printf("Exiting environment simulation...\n");
-            break;
-        }
-        
-        if (choice >= 1 && choice <= 6) {
-            printf("Enter new %s value: ", get_param_name(choice));
-            scanf("%d", &value);
-            send_to_sensor(choice, value);
-        } else {
-            printf("Invalid choice. Please try again.\n");
-        }
-    }
-    
-    // Cleanup Winsock
-    WSACleanup();
-    return 0;
-}
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <stdint.h>
+#include "net_compat.h"
+#include "acoustic_stream.h"
+#include "proximity_stream.h"
+#include "current_waveform.h"
+#include "metrics.h"
+#include "sensor_models.h"
+#include "report_policy.h"
+
+#define PORT_SENSOR 8080
+#define PORT_METRICS 9083  // No service port of its own, so not PORT_SENSOR + METRICS_PORT_OFFSET
+#define BUFFER_SIZE 1024
+
+// Parameter codes
+#define TEMPERATURE 1
+#define RADIATION 2
+#define CHEMICAL 3
+#define OXYGEN 4
+#define NOISE 5
+#define VOLTAGE 6
+#define MAGNETIC 7
+#define PROXIMITY 8
+#define DEVICE_PROFILE 11  // Value is the packed device profile
+#define HEARTBEAT 12  // Value is the man-down deadline in ms, 0 signs off
+
+// Raw sample block follows the header, the value is the frame count
+#define SAMPLE_BLOCK_FLAG 0x200
+// Temperature taken in the dock at a known temperature, the value is that temperature
+#define REFERENCE_FLAG 0x400
+#define NOISE_RECORDING 10  // Menu entries
+#define VEHICLE_APPROACH 11
+#define ARC_FAULT 12
+#define STREAM_READINGS 13
+#define MAN_DOWN_TEST 14
+#define DOCK_REFERENCE 15
+#define MAGNETOMETER_TURN 16
+#define MAG_BLOCK_FRAMES 100  // 1 s at 100 Hz
+#define MAG_TURN_DEGREES 90.0
+#define MAG_HARD_IRON_NT 4000  // Field of the suit's own steel on its x axis
+#define CURRENT_BLOCK_MS 100
+#define CURRENT_MAX_BLOCK_FRAMES 5000  // 100 ms at 50 kHz, the highest ADC rate
+
+// Backpressure the sensor returns after a reading: 0 ok, 1 congested, 2 shedding
+#define PRESSURE_CONGESTED 1
+#define PRESSURE_SHEDDING 2
+#define SENSOR_REPLY_TIMEOUT_MS 500
+
+// Metric family IDs, labelled by parameter code
+int metric_readings, metric_sample_blocks, metric_connect_failures, metric_send, metric_backpressure;
+int metric_suppressed;
+
+double current_rate = CURRENT_SAMPLE_RATE;  // Hall ADC rate from the announced device profile
+
+void init_metrics() {
+    metrics_init("smartsuit_environment");
+    metric_readings = metrics_register("readings_sent_total", "Readings sent to the sensor module",
+                                       METRIC_COUNTER, "param", 16);
+    metric_sample_blocks = metrics_register("sample_blocks_sent_total", "Raw sample blocks sent to the sensor module",
+                                            METRIC_COUNTER, "param", 16);
+    metric_connect_failures = metrics_register("sensor_connect_failures_total",
+                                               "Failed connections to the sensor module", METRIC_COUNTER, NULL, 1);
+    metric_send = metrics_register("send_seconds", "Connect and send time per message",
+                                   METRIC_HISTOGRAM, NULL, 1);
+    metric_backpressure = metrics_register("backpressure_replies_total", "Readings answered with a backed up alert queue",
+                                           METRIC_COUNTER, "level", 3);
+    metric_suppressed = metrics_register("readings_suppressed_total", "Samples held back by the reporting deadband",
+                                         METRIC_COUNTER, "param", 16);
+}
+
+// True when the peer has sent something (or closed) within timeout_ms
+int reply_waiting(SOCKET sock, int timeout_ms) {
+    fd_set readable;
+    struct timeval timeout = {timeout_ms / 1000, (timeout_ms % 1000) * 1000};
+    FD_ZERO(&readable);
+    FD_SET(sock, &readable);
+    return select((int)sock + 1, &readable, NULL, NULL, &timeout) > 0;
+}
+
+void send_to_sensor(int suit_id, int param_code, int value) {
+    SOCKET sock = INVALID_SOCKET;
+    struct sockaddr_in serv_addr;
+    double start = metrics_now();
+    
+    // Create socket
+    if ((sock = socket(AF_INET, SOCK_STREAM, 0)) == INVALID_SOCKET) {
+        printf("Socket creation error: %d\n", WSAGetLastError());
+        return;
+    }
+    
+    serv_addr.sin_family = AF_INET;
+    serv_addr.sin_port = htons(PORT_SENSOR);
+    
+    // Convert IPv4 address from text to binary form
+    if (inet_pton(AF_INET, "127.0.0.1", &serv_addr.sin_addr) <= 0) {
+        printf("Invalid address/ Address not supported\n");
+        closesocket(sock);
+        return;
+    }
+    
+    if (connect(sock, (struct sockaddr *)&serv_addr, sizeof(serv_addr)) < 0) {
+        printf("Connection Failed: %d\n", WSAGetLastError());
+        metric_inc(metric_connect_failures, 0);
+        closesocket(sock);
+        return;
+    }
+    
+    // Send data as integers
+    int data[3] = {param_code, value, suit_id};
+    send(sock, (char*)data, sizeof(data), 0);
+    printf("Sent to sensor: Suit %d, Parameter Code %d, Value %d\n", suit_id, param_code, value);
+    
+    // The sensor answers with its alert backlog toward control, older sensors just close
+    int pressure = 0;
+    if (reply_waiting(sock, SENSOR_REPLY_TIMEOUT_MS) &&
+        recv(sock, (char*)&pressure, sizeof(pressure), 0) == sizeof(pressure) && pressure > 0) {
+        printf("Sensor reports control backed up (%s): routine readings are merged or shed\n",
+               pressure >= PRESSURE_SHEDDING ? "shedding" : "congested");
+        metric_inc(metric_backpressure, pressure);
+    }
+    
+    closesocket(sock);
+    metric_observe(metric_send, metrics_now() - start);
+    metric_inc(metric_readings, param_code & ~REFERENCE_FLAG);
+}
+
+// Simulate a 100 ms mic recording: a 1 kHz tone plus broadband noise 10 dB below it
+void send_noise_recording(int suit_id, int db_spl) {
+    SOCKET sock = INVALID_SOCKET;
+    struct sockaddr_in serv_addr;
+    double start = metrics_now();
+    int16_t pcm[PCM_MAX_BLOCK];
+    double pa_per_count = dbspl_to_pascal(MIC_RANGE) * sqrt(2.0) / PCM_FULL_SCALE;
+    double tone = dbspl_to_pascal(db_spl) * sqrt(2.0) / pa_per_count;
+    double noise = dbspl_to_pascal(db_spl - 10) * sqrt(3.0) / pa_per_count;
+    
+    for (int i = 0; i < PCM_MAX_BLOCK; i++) {
+        double sample = tone * sin(2.0 * M_PI * 1000.0 * i / PCM_SAMPLE_RATE)
+                      + noise * ((rand() % 2001) - 1000) / 1000.0;
+        if (sample > PCM_FULL_SCALE) sample = PCM_FULL_SCALE;
+        if (sample < -PCM_FULL_SCALE) sample = -PCM_FULL_SCALE;
+        pcm[i] = (int16_t)sample;
+    }
+    
+    if ((sock = socket(AF_INET, SOCK_STREAM, 0)) == INVALID_SOCKET) {
+        printf("Socket creation error: %d\n", WSAGetLastError());
+        return;
+    }
+    
+    serv_addr.sin_family = AF_INET;
+    serv_addr.sin_port = htons(PORT_SENSOR);
+    
+    if (inet_pton(AF_INET, "127.0.0.1", &serv_addr.sin_addr) <= 0) {
+        printf("Invalid address/ Address not supported\n");
+        closesocket(sock);
+        return;
+    }
+    
+    if (connect(sock, (struct sockaddr *)&serv_addr, sizeof(serv_addr)) < 0) {
+        printf("Connection Failed: %d\n", WSAGetLastError());
+        metric_inc(metric_connect_failures, 0);
+        closesocket(sock);
+        return;
+    }
+    
+    // Header, then the PCM frames
+    int data[3] = {NOISE | SAMPLE_BLOCK_FLAG, PCM_MAX_BLOCK, suit_id};
+    send(sock, (char*)data, sizeof(data), 0);
+    send(sock, (char*)pcm, sizeof(pcm), 0);
+    printf("Sent %d PCM frames to sensor: Suit %d, %d dB SPL\n", PCM_MAX_BLOCK, suit_id, db_spl);
+    
+    closesocket(sock);
+    metric_observe(metric_send, metrics_now() - start);
+    metric_inc(metric_sample_blocks, NOISE);
+}
+
+// Send one block of 1 kHz proximity samples: distance (mm) and ambient light (lux)
+int send_proximity_block(int suit_id, int32_t samples[][2], int frames) {
+    SOCKET sock = INVALID_SOCKET;
+    struct sockaddr_in serv_addr;
+    double start = metrics_now();
+    
+    if ((sock = socket(AF_INET, SOCK_STREAM, 0)) == INVALID_SOCKET) {
+        printf("Socket creation error: %d\n", WSAGetLastError());
+        return -1;
+    }
+    
+    serv_addr.sin_family = AF_INET;
+    serv_addr.sin_port = htons(PORT_SENSOR);
+    
+    if (inet_pton(AF_INET, "127.0.0.1", &serv_addr.sin_addr) <= 0) {
+        printf("Invalid address/ Address not supported\n");
+        closesocket(sock);
+        return -1;
+    }
+    
+    if (connect(sock, (struct sockaddr *)&serv_addr, sizeof(serv_addr)) < 0) {
+        printf("Connection Failed: %d\n", WSAGetLastError());
+        metric_inc(metric_connect_failures, 0);
+        closesocket(sock);
+        return -1;
+    }
+    
+    int data[3] = {PROXIMITY | SAMPLE_BLOCK_FLAG, frames, suit_id};
+    send(sock, (char*)data, sizeof(data), 0);
+    send(sock, (char*)samples, frames * (int)sizeof(samples[0]), 0);
+    
+    closesocket(sock);
+    metric_observe(metric_send, metrics_now() - start);
+    metric_inc(metric_sample_blocks, PROXIMITY);
+    return 0;
+}
+
+// Stream proximity blocks in real time while a vehicle closes in from max range
+void simulate_vehicle_approach(int suit_id, double speed_mps) {
+    int32_t block[PROX_BLOCK][2];
+    double distance = PROX_MAX_DISTANCE;
+    int blocks = 0;
+    
+    while (distance > PROX_MIN_DISTANCE) {
+        for (int i = 0; i < PROX_BLOCK; i++) {
+            distance -= speed_mps / PROX_RATE_HZ;
+            block[i][0] = (int32_t)(read_proximity(distance) * 1000.0);
+            block[i][1] = 500;  // Indoor lighting
+        }
+        if (send_proximity_block(suit_id, block, PROX_BLOCK) < 0) return;
+        blocks++;
+        Sleep(1000 * PROX_BLOCK / PROX_RATE_HZ);
+    }
+    printf("Streamed %d proximity blocks for suit %d at %.1f m/s\n", blocks, suit_id, speed_mps);
+}
+
+// Send one block of 3D magnetometer samples: x, y, z in nT
+int send_magnetometer_block(int suit_id, int32_t samples[][3], int frames) {
+    SOCKET sock = INVALID_SOCKET;
+    struct sockaddr_in serv_addr;
+    double start = metrics_now();
+    
+    if ((sock = socket(AF_INET, SOCK_STREAM, 0)) == INVALID_SOCKET) {
+        printf("Socket creation error: %d\n", WSAGetLastError());
+        return -1;
+    }
+    
+    serv_addr.sin_family = AF_INET;
+    serv_addr.sin_port = htons(PORT_SENSOR);
+    
+    if (inet_pton(AF_INET, "127.0.0.1", &serv_addr.sin_addr) <= 0) {
+        printf("Invalid address/ Address not supported\n");
+        closesocket(sock);
+        return -1;
+    }
+    
+    if (connect(sock, (struct sockaddr *)&serv_addr, sizeof(serv_addr)) < 0) {
+        printf("Connection Failed: %d\n", WSAGetLastError());
+        metric_inc(metric_connect_failures, 0);
+        closesocket(sock);
+        return -1;
+    }
+    
+    int data[3] = {MAGNETIC | SAMPLE_BLOCK_FLAG, frames, suit_id};
+    send(sock, (char*)data, sizeof(data), 0);
+    send(sock, (char*)samples, frames * (int)sizeof(samples[0]), 0);
+    
+    closesocket(sock);
+    metric_observe(metric_send, metrics_now() - start);
+    metric_inc(metric_sample_blocks, MAGNETIC);
+    return 0;
+}
+
+// One second of a worker turning from north through east in a level field, as the
+// suit's magnetometer sees it: its own hard-iron field is added on the x axis
+void simulate_magnetometer_turn(int suit_id, double field_ut) {
+    int32_t block[MAG_BLOCK_FRAMES][3];
+    
+    for (int i = 0; i < MAG_BLOCK_FRAMES; i++) {
+        double heading = MAG_TURN_DEGREES * i / (MAG_BLOCK_FRAMES - 1) * M_PI / 180.0;
+        block[i][0] = (int32_t)lround(field_ut * 1000.0 * cos(heading)) + MAG_HARD_IRON_NT;
+        block[i][1] = (int32_t)lround(-field_ut * 1000.0 * sin(heading));
+        block[i][2] = 0;
+    }
+    if (send_magnetometer_block(suit_id, block, MAG_BLOCK_FRAMES) < 0) return;
+    printf("Sent a %.0f° turn in a %.0f μT field for suit %d (hard iron %d nT on x)\n",
+           MAG_TURN_DEGREES, field_ut, suit_id, MAG_HARD_IRON_NT);
+}
+
+// Send one block of Hall current-sensor ADC samples
+int send_current_block(int suit_id, int16_t *samples, int frames) {
+    SOCKET sock = INVALID_SOCKET;
+    struct sockaddr_in serv_addr;
+    double start = metrics_now();
+    
+    if ((sock = socket(AF_INET, SOCK_STREAM, 0)) == INVALID_SOCKET) {
+        printf("Socket creation error: %d\n", WSAGetLastError());
+        return -1;
+    }
+    
+    serv_addr.sin_family = AF_INET;
+    serv_addr.sin_port = htons(PORT_SENSOR);
+    
+    if (inet_pton(AF_INET, "127.0.0.1", &serv_addr.sin_addr) <= 0) {
+        printf("Invalid address/ Address not supported\n");
+        closesocket(sock);
+        return -1;
+    }
+    
+    if (connect(sock, (struct sockaddr *)&serv_addr, sizeof(serv_addr)) < 0) {
+        printf("Connection Failed: %d\n", WSAGetLastError());
+        metric_inc(metric_connect_failures, 0);
+        closesocket(sock);
+        return -1;
+    }
+    
+    int data[3] = {VOLTAGE | SAMPLE_BLOCK_FLAG, frames, suit_id};
+    send(sock, (char*)data, sizeof(data), 0);
+    send(sock, (char*)samples, frames * (int)sizeof(int16_t), 0);
+    
+    closesocket(sock);
+    metric_observe(metric_send, metrics_now() - start);
+    metric_inc(metric_sample_blocks, VOLTAGE);
+    return 0;
+}
+
+// Stream 0.5 s of a clean mains load followed by 0.5 s of arcing on the same circuit.
+// The arc extinguishes around each zero crossing and restrikes with sharp current steps.
+void simulate_arc_fault(int suit_id, double load_amps) {
+    int16_t block[CURRENT_MAX_BLOCK_FRAMES];
+    int frames = (int)(current_rate * CURRENT_BLOCK_MS / 1000.0);
+    double peak = load_amps * sqrt(2.0);
+    long n = 0;
+    
+    for (int b = 0; b < 10; b++) {
+        int arcing = b >= 5;
+        for (int i = 0; i < frames; i++, n++) {
+            double phase = sin(2.0 * M_PI * MAINS_FREQ * n / current_rate);
+            double amps = peak * phase;
+            if (arcing) {
+                if (fabs(phase) < 0.15) amps = 0.0;
+                if (rand() % 100 < 3) amps += peak * ((rand() % 2001) - 1000) / 1000.0;
+            }
+            block[i] = hall_voltage_to_adc(hall_effect_output(amps * CURRENT_AMPS_PER_MT));
+        }
+        if (send_current_block(suit_id, block, frames) < 0) return;
+        Sleep(CURRENT_BLOCK_MS);
+    }
+    printf("Streamed 1 s of current waveform for suit %d at %.0f A and %.0f kHz, arcing from 0.5 s\n",
+           suit_id, load_amps, current_rate / 1000.0);
+}
+
+// Standard normal sample (Box-Muller)
+double gaussian() {
+    double u1 = (rand() + 1.0) / (RAND_MAX + 2.0);
+    double u2 = (rand() + 1.0) / (RAND_MAX + 2.0);
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+// Stream every parameter as a suit would on shift: sample each on its own
+// schedule and report only what the deadband policy lets through. Without
+// sign_off the suit goes silent at the end, as if its wearer collapsed.
+void simulate_shift(int suit_id, int seconds, int sign_off) {
+    // Typical plant levels and sensor noise, in the units sent on the wire
+    const double nominal[REPORT_CHANNELS] = {25.0, 1.0, 5.0, 20.9, 70.0, 50.0, 60.0, 200.0};
+    const double noise[REPORT_CHANNELS] = {0.3, 1.0, 0.5, 0.2, 2.0, 10.0, 1.4, 1.0};
+    ReportChannel channels[REPORT_CHANNELS];
+    double level[REPORT_CHANNELS];
+    uint32_t next_ms[REPORT_CHANNELS];
+    long samples = 0, reports[REPORT_REASONS] = {0};
+    uint32_t start = (uint32_t)(metrics_now() * 1000.0), now = start, last_sent = start;
+    long keepalives = 0;
+    
+    memset(channels, 0, sizeof(channels));
+    for (int c = 0; c < REPORT_CHANNELS; c++) {
+        level[c] = nominal[c];
+        next_ms[c] = start;
+    }
+    send_to_sensor(suit_id, HEARTBEAT, REPORT_DEADMAN_MS);
+    
+    while ((uint32_t)(now - start) < (uint32_t)seconds * 1000u) {
+        for (int c = 0; c < REPORT_CHANNELS; c++) {
+            if ((int32_t)(now - next_ms[c]) < 0) continue;
+            const ReportPolicy *policy = &report_policies[c];
+            level[c] += noise[c] * 0.05 * gaussian() - 0.01 * (level[c] - nominal[c]);  // Slow wander of the true level
+            int value = (int)lround(level[c] + noise[c] * gaussian());
+            ReportReason reason = report_decide(policy, &channels[c], value, now);
+            samples++;
+            reports[reason]++;
+            if (reason == REPORT_NONE) {
+                metric_inc(metric_suppressed, c + 1);
+            } else {
+                send_to_sensor(suit_id, c + 1, value);
+                last_sent = now;
+            }
+            next_ms[c] += report_sample_ms(policy, value);
+        }
+        if ((uint32_t)(now - last_sent) >= REPORT_KEEPALIVE_MS) {
+            send_to_sensor(suit_id, HEARTBEAT, REPORT_DEADMAN_MS);
+            last_sent = now;
+            keepalives++;
+        }
+        
+        uint32_t wake = next_ms[0];
+        for (int c = 1; c < REPORT_CHANNELS; c++) {
+            if ((int32_t)(next_ms[c] - wake) < 0) wake = next_ms[c];
+        }
+        now = (uint32_t)(metrics_now() * 1000.0);
+        if ((int32_t)(wake - now) > 0) {
+            Sleep(wake - now);
+            now = (uint32_t)(metrics_now() * 1000.0);
+        }
+    }
+    
+    long sent = samples - reports[REPORT_NONE];
+    printf("Suit %d streamed %ld samples in %d s, sent %ld (%.1fx fewer): "
+           "%ld changed, %ld heartbeat, %ld near threshold; %ld keepalive(s)\n",
+           suit_id, samples, seconds, sent, sent ? (double)samples / sent : 0.0,
+           reports[REPORT_CHANGED], reports[REPORT_HEARTBEAT], reports[REPORT_APPROACH], keepalives);
+    if (sign_off) {
+        send_to_sensor(suit_id, HEARTBEAT, 0);
+    } else {
+        printf("Suit %d stopped transmitting without signing off\n", suit_id);
+    }
+}
+
+void display_menu() {
+    printf("\n===== Environment Simulation Menu =====\n");
+    printf("1. Change Temperature (°C)\n");
+    printf("2. Change Radiation Level (μSv/h)\n");
+    printf("3. Change Chemical Concentration (ppm)\n");
+    printf("4. Change Oxygen Level (%%)\n");
+    printf("5. Change Noise Level (dB)\n");
+    printf("6. Change Electrical Field (V/m)\n");
+    printf("7. Change Magnetic Field (μT)\n");
+    printf("8. Change Proximity (cm)\n");
+    printf("10. Send Noise Recording (dB SPL, 100 ms PCM)\n");
+    printf("11. Simulate Approaching Vehicle (m/s)\n");
+    printf("12. Simulate Arc Fault (load A RMS)\n");
+    printf("13. Stream Readings with Deadband (seconds)\n");
+    printf("14. Stream, then Go Silent / Man Down (seconds)\n");
+    printf("15. Dock Reference Check (°C)\n");
+    printf("16. Turn 90° with the Magnetometer (field μT)\n");
+    printf("0. Exit\n");
+    printf("Enter your choice: ");
+}
+
+const char* get_param_name(int code) {
+    switch(code) {
+        case TEMPERATURE: return "Temperature";
+        case RADIATION: return "Radiation";
+        case CHEMICAL: return "Chemical";
+        case OXYGEN: return "Oxygen";
+        case NOISE: return "Noise";
+        case VOLTAGE: return "Voltage";
+        case MAGNETIC: return "Magnetic";
+        case PROXIMITY: return "Proximity";
+        default: return "Unknown";
+    }
+}
+
+int main(int argc, char *argv[]) {
+    WSADATA wsaData;
+    int choice, value;
+    int suit_id = (argc > 1) ? atoi(argv[1]) : 1;  // Suit being simulated
+    const char *models = (argc > 2) ? argv[2] : NULL;  // Sensor variants, e.g. "pt1000,ec70"
+    
+    // Initialize Winsock
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+        printf("WSAStartup failed: %d\n", WSAGetLastError());
+        return 1;
+    }
+    
+    printf("Smart Suit for Industrial Workers - Environment Simulation\n");
+    printf("--------------------------------------------------------\n");
+    printf("Simulating suit %d\n", suit_id);
+    init_metrics();
+    metrics_start_server(PORT_METRICS);
+    if (report_policy_configure(getenv(REPORT_DEADBAND_ENV)) < 0) {
+        printf("Malformed %s, expected code:deadband pairs\n", REPORT_DEADBAND_ENV);
+    }
+    
+    // Announce the suit's sensor hardware as it connects
+    if (models != NULL) {
+        int profile = device_profile_parse(models);
+        if (profile < 0) {
+            printf("Unknown sensor model in \"%s\", using default sensors\n", models);
+        } else {
+            send_to_sensor(suit_id, DEVICE_PROFILE, profile);
+            current_rate = ADC_RATES[PROFILE_ADC(profile)].rate;
+        }
+    }
+    
+    while (1) {
+        display_menu();
+        scanf("%d", &choice);
+        
+        if (choice == 0) {
+            printf("Exiting environment simulation...\n");
+            break;
+        }
+        
+        if (choice >= 1 && choice <= PROXIMITY) {
+            printf("Enter new %s value: ", get_param_name(choice));
+            scanf("%d", &value);
+            send_to_sensor(suit_id, choice, value);
+        } else if (choice == NOISE_RECORDING) {
+            printf("Enter noise level for recording: ");
+            scanf("%d", &value);
+            send_noise_recording(suit_id, value);
+        } else if (choice == VEHICLE_APPROACH) {
+            printf("Enter vehicle speed: ");
+            scanf("%d", &value);
+            simulate_vehicle_approach(suit_id, value);
+        } else if (choice == ARC_FAULT) {
+            printf("Enter circuit load current: ");
+            scanf("%d", &value);
+            simulate_arc_fault(suit_id, value);
+        } else if (choice == STREAM_READINGS) {
+            printf("Enter streaming duration: ");
+            scanf("%d", &value);
+            simulate_shift(suit_id, value, 1);
+        } else if (choice == MAN_DOWN_TEST) {
+            printf("Enter seconds before the suit goes silent: ");
+            scanf("%d", &value);
+            simulate_shift(suit_id, value, 0);
+        } else if (choice == DOCK_REFERENCE) {
+            printf("Enter dock reference temperature: ");
+            scanf("%d", &value);
+            send_to_sensor(suit_id, TEMPERATURE | REFERENCE_FLAG, value);
+        } else if (choice == MAGNETOMETER_TURN) {
+            printf("Enter field strength: ");
+            scanf("%d", &value);
+            simulate_magnetometer_turn(suit_id, value);
+        } else {
+            printf("Invalid choice. Please try again.\n");
+        }
+    }
+    
+    // Cleanup Winsock
+    WSACleanup();
+    return 0;
+}
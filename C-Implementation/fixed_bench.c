@@ -0,0 +1,330 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#define FX_COUNT_OPS
+#include "sensor_models.h"
+#include "radiation_sensor.h"
+
+// Check of the fixed-point sensor models (sensor_fixed.h) against the double models:
+//  1. error bounds over each model's input range, every variant, draw for draw
+//     (both versions see the same rand() sequence, so only the arithmetic differs)
+//  2. cost per call: host cycles for both versions (perf_event_open cycle counter
+//     on Linux, else the time stamp counter or the clock), and an estimate for the
+//     suit's AVR from the fixed-point operations each call performs
+// Exits with status 1 when a bound is exceeded.
+
+#define BENCH_SEED 7
+#define BENCH_FLIP_SHARE 0.01  // Quantized outputs may differ by one step on this share of inputs
+#define BENCH_CALLS 2000000L
+#define AVR_MHZ 16.0  // ATmega328P on the suit board
+// Rough AVR costs with hardware MUL and avr-gcc -O2
+#define AVR_MUL_CYCLES 110  // Widening 32 x 32 multiply through libgcc, rounding and shift
+#define AVR_LOOKUP_CYCLES 12  // 4-byte table entry from flash
+#define AVR_SQRT_CYCLES 520  // 16 rounds of 32-bit compare, subtract and shift
+#define AVR_CALL_CYCLES 80  // Call, argument moves and the 32-bit adds around the multiplies
+
+#define ERROR_ABSOLUTE 0
+#define ERROR_RELATIVE 1  // |error| / |reference|
+#define ERROR_DB 2  // |20 log10(fixed / reference)|
+
+typedef struct {
+    const char *name;
+    double bound;  // For quantized outputs, the step
+    int kind;
+    int quantized;
+    double max_error;
+    double worst_input;
+    long samples;
+    long over;
+} Check;
+
+int failed = 0;
+
+static void check_value(Check *c, double input, double reference, double fixed) {
+    double error = fabs(fixed - reference);
+    if (c->kind == ERROR_RELATIVE) error /= fmax(fabs(reference), 1e-12);
+    if (c->kind == ERROR_DB) error = fabs(20.0 * log10(fabs(fixed) / fabs(reference)));
+    if (error > c->max_error) {
+        c->max_error = error;
+        c->worst_input = input;
+    }
+    if (error > (c->quantized ? c->bound / 2 : c->bound)) c->over++;
+    c->samples++;
+}
+
+// Quantized outputs (resolution steps, counts) may land one step apart when the
+// value sits on a rounding edge; bound the size and share of such flips
+static void report(Check *c) {
+    const char *kinds[] = {"absolute", "relative", "dB"};
+    double share = (double)c->over / c->samples;
+    int ok = c->quantized ? c->max_error <= c->bound * 1.01 && share <= BENCH_FLIP_SHARE : c->over == 0;
+    printf("  %-28s max %-8s error %9.3e (at %9.3f), bound %.0e", c->name, kinds[c->kind],
+           c->max_error, c->worst_input, c->bound);
+    if (c->quantized) printf(", one step off for %.3f%%", share * 100.0);
+    printf("  %s\n", ok ? "ok" : "FAIL");
+    if (!ok) failed = 1;
+}
+
+// ---- Cycle counter ----
+int perf_fd = -1;
+
+static void cycles_open(void) {
+#ifdef __linux__
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_CPU_CYCLES;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    perf_fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    if (perf_fd >= 0) ioctl(perf_fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+}
+
+static const char *cycles_source(void) {
+    if (perf_fd >= 0) return "perf_event_open CPU cycles";
+#if defined(__x86_64__) || defined(__i386__)
+    return "time stamp counter (no perf events)";
+#else
+    return "nanoseconds (no cycle counter)";
+#endif
+}
+
+static uint64_t cycles_now(void) {
+#ifdef __linux__
+    uint64_t count;
+    if (perf_fd >= 0 && read(perf_fd, &count, sizeof(count)) == (ssize_t)sizeof(count)) return count;
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+volatile double sink;
+volatile int32_t fixed_sink;
+
+typedef struct {
+    const char *name;
+    double double_cycles;
+    double fixed_cycles;
+    FxOps ops;  // Per BENCH_CALLS calls
+    long draws;  // Calls that draw simulated noise
+} Cost;
+
+#define TIME_LOOP(result, body)                                \
+    do {                                                       \
+        srand(BENCH_SEED);                                     \
+        uint64_t start_ = cycles_now();                        \
+        for (long i = 0; i < BENCH_CALLS; i++) { body; }       \
+        (result) = (double)(cycles_now() - start_) / BENCH_CALLS; \
+    } while (0)
+
+static void cost_fixed_ops(Cost *c) {
+    c->ops = fx_ops;
+    memset(&fx_ops, 0, sizeof(fx_ops));
+}
+
+static void print_cost(const Cost *c) {
+    double mul = (double)c->ops.mul / BENCH_CALLS, lookup = (double)c->ops.lookup / BENCH_CALLS;
+    double sqrt_ops = (double)c->ops.sqrt / BENCH_CALLS;
+    double avr = AVR_CALL_CYCLES + mul * AVR_MUL_CYCLES + lookup * AVR_LOOKUP_CYCLES + sqrt_ops * AVR_SQRT_CYCLES;
+    printf("  %-24s %8.1f %8.1f   %4.1f mul %4.1f lookup %3.1f sqrt  %6.0f cycles %6.1f us%s\n", c->name,
+           c->double_cycles, c->fixed_cycles, mul, lookup, sqrt_ops, avr, avr / AVR_MHZ,
+           c->draws ? " +rand()" : "");
+}
+
+int main() {
+    printf("Smart Suit - Fixed-Point Sensor Model Check\n");
+    printf("-------------------------------------------\n");
+
+    // 1. Error bounds
+    printf("\nError against the double models, same noise draws:\n");
+    for (int v = 0; v < MODEL_COUNT(RTD_MODELS); v++) {
+        const RtdModel *m = RTD_MODELS[v];
+        Check resistance = {.name = "resistance (Ω)", .bound = 1e-3, .kind = ERROR_ABSOLUTE};
+        Check read = {.name = "read -200..850 °C", .bound = 0.01, .kind = ERROR_ABSOLUTE};
+        Check compensate = {.name = "compensate (°C)", .bound = 0.01, .kind = ERROR_ABSOLUTE};
+        for (int i = 0; i <= 105000; i++) {
+            double t = -200.0 + i * 0.01;
+            int years = i % 11;
+            check_value(&resistance, t, m->resistance(t), fx_to_double(fx_rtd_resistance(m->fixed, fx_from_double(t, 16)), 16));
+            srand(i);
+            double reference = m->read(t, years);
+            srand(i);
+            check_value(&read, t, reference, fx_to_double(fx_rtd_read(m->fixed, fx_from_double(t, 16), years), 16));
+            double drift = m->drift_rate * years;
+            check_value(&compensate, t, m->compensate(reference, drift),
+                        fx_to_double(fx_rtd_compensate(m->fixed, fx_from_double(reference, 16), fx_from_double(drift, 24)), 16));
+        }
+        printf(" RTD %s\n", m->name);
+        report(&resistance);
+        report(&read);
+        report(&compensate);
+    }
+
+    for (int v = 0; v < MODEL_COUNT(EC_MODELS); v++) {
+        const EcModel *m = EC_MODELS[v];
+        Check current = {.name = "current 0..1000 ppm (nA)", .bound = 0.02, .kind = ERROR_ABSOLUTE};
+        Check concentration = {.name = "concentration (ppm)", .bound = m->resolution, .kind = ERROR_ABSOLUTE, .quantized = 1};
+        double interfering[7] = {0, 10.0, 0, 5.0, 0, 0, 0};  // H2S and NO2 present
+        q16_t interfering_fixed[7];
+        for (int g = 0; g < 7; g++) interfering_fixed[g] = fx_from_double(interfering[g], 16);
+        for (int i = 0; i <= 200000; i++) {
+            double ppm = i * 0.005;
+            srand(i);
+            double reference = m->current(GAS_CO, ppm, interfering);
+            srand(i);
+            q12_t fixed = fx_ec_current(m->fixed, GAS_CO, fx_from_double(ppm, 16), interfering_fixed);
+            check_value(&current, ppm, reference, fx_to_double(fixed, 12));
+            // Same current into both conversions, so only quantization edges differ
+            check_value(&concentration, ppm, m->concentration(reference, GAS_CO),
+                        fx_to_double(fx_ec_concentration(m->fixed, fx_from_double(reference, 12)), 16));
+        }
+        printf(" EC cell %s\n", m->name);
+        report(&current);
+        report(&concentration);
+    }
+
+    Check effect = {.name = "temperature effect", .bound = 1e-5, .kind = ERROR_RELATIVE};
+    for (int i = 0; i <= 100000; i++) {
+        double ppm = (i % 1001) * 1.0, t = -20.0 + (i / 1001) * 0.8;
+        check_value(&effect, ppm, apply_temperature_effect(ppm, t),
+                    fx_to_double(fx_temperature_effect(fx_from_double(ppm, 16), fx_from_double(t, 16)), 16));
+    }
+    report(&effect);
+
+    Check pascal = {.name = "dB SPL to Pa, 30..148 dB", .bound = 0.01, .kind = ERROR_DB};
+    for (int i = 0; i <= 110000; i++) {
+        double db = 30.0 + i * 0.001 * 118.0 / 110.0;
+        check_value(&pascal, db, dbspl_to_pascal(db), fx_to_double(fx_dbspl_to_pascal(fx_from_double(db, 16)), 22));
+    }
+    report(&pascal);
+
+    for (int v = 0; v < MODEL_COUNT(MIC_MODELS); v++) {
+        const MicModel *m = MIC_MODELS[v];
+        Check output = {.name = "output 30..120 dB", .bound = 0.01, .kind = ERROR_DB};
+        Check response = {.name = "response 20..30000 Hz", .bound = 1e-4, .kind = ERROR_ABSOLUTE};  // Of the normalized output
+        for (int i = 0; i <= 90000; i++) {
+            double db = 30.0 + i * 0.001;  // Up to MIC_RANGE, the overload point
+            double pa = dbspl_to_pascal(db);
+            srand(i);
+            double reference = m->output(pa);
+            srand(i);
+            check_value(&output, db, reference, fx_to_double(fx_mic_output(m->fixed, fx_from_double(pa, 22)), 28));
+        }
+        for (int f = 20; f <= 30000; f++) {
+            check_value(&response, f, m->frequency_response(1.0, f),
+                        fx_to_double(fx_mic_frequency_response(m->fixed, FX_ONE(28), f), 28));
+        }
+        printf(" Microphone %s\n", m->name);
+        report(&output);
+        report(&response);
+    }
+
+    for (int v = 0; v < MODEL_COUNT(HALL_MODELS); v++) {
+        const HallModel *m = HALL_MODELS[v];
+        Check output = {.name = "output -100..2500 mT (V)", .bound = 1e-4, .kind = ERROR_ABSOLUTE};
+        for (int i = 0; i <= 260000; i++) {
+            double mt = -100.0 + i * 0.01;
+            srand(i);
+            double reference = m->output(mt);
+            srand(i);
+            check_value(&output, mt, reference, fx_to_double(fx_hall_output(m->fixed, fx_from_double(mt, 16)), 16));
+        }
+        printf(" Hall %s\n", m->name);
+        report(&output);
+    }
+
+    Check counts = {.name = "counts 0..1000 μSv/h, 10 s", .bound = 1.0, .kind = ERROR_ABSOLUTE, .quantized = 1};
+    for (int i = 0; i <= 100000; i++) {
+        double level = i * 0.01;
+        srand(i);
+        int reference = simulate_radiation_counts(level, 10.0);
+        srand(i);
+        check_value(&counts, level, reference, fx_radiation_counts(fx_from_double(level, 16), 10));
+    }
+    printf(" Radiation detector\n");
+    report(&counts);
+
+    // 2. Cost per call
+    cycles_open();
+    memset(&fx_ops, 0, sizeof(fx_ops));
+    const RtdModel *rtd = RTD_MODELS[0];
+    const EcModel *ec = EC_MODELS[0];
+    const MicModel *mic = MIC_MODELS[0];
+    const HallModel *hall = HALL_MODELS[0];
+    double no_interference[7] = {0};
+    q16_t no_interference_fixed[7] = {0};
+    Cost costs[8];
+    int n = 0;
+
+    costs[n] = (Cost){"RTD read", 0, 0, {0}, 1};
+    TIME_LOOP(costs[n].double_cycles, sink = rtd->read(20.0 + (i & 63), 2));
+    memset(&fx_ops, 0, sizeof(fx_ops));
+    TIME_LOOP(costs[n].fixed_cycles, fixed_sink = fx_rtd_read(rtd->fixed, FX_Q16(20.0) + ((i & 63) << 16), 2));
+    cost_fixed_ops(&costs[n++]);
+
+    costs[n] = (Cost){"RTD compensate", 0, 0, {0}, 0};
+    TIME_LOOP(costs[n].double_cycles, sink = rtd->compensate(20.0 + (i & 63), 0.01));
+    TIME_LOOP(costs[n].fixed_cycles, fixed_sink = fx_rtd_compensate(rtd->fixed, FX_Q16(20.0) + ((i & 63) << 16), FX_Q24(0.01)));
+    cost_fixed_ops(&costs[n++]);
+
+    costs[n] = (Cost){"EC current", 0, 0, {0}, 1};
+    TIME_LOOP(costs[n].double_cycles, sink = ec->current(GAS_CO, (double)(i & 127), no_interference));
+    TIME_LOOP(costs[n].fixed_cycles, fixed_sink = fx_ec_current(ec->fixed, GAS_CO, (i & 127) << 16, no_interference_fixed));
+    cost_fixed_ops(&costs[n++]);
+
+    costs[n] = (Cost){"EC concentration", 0, 0, {0}, 0};
+    TIME_LOOP(costs[n].double_cycles, sink = ec->concentration(5.0 + (i & 1023), GAS_CO));
+    TIME_LOOP(costs[n].fixed_cycles, fixed_sink = fx_ec_concentration(ec->fixed, FX_Q(5.0, 12) + ((i & 1023) << 12)));
+    cost_fixed_ops(&costs[n++]);
+
+    costs[n] = (Cost){"dB SPL to Pa", 0, 0, {0}, 0};
+    TIME_LOOP(costs[n].double_cycles, sink = dbspl_to_pascal(40.0 + (i & 63)));
+    TIME_LOOP(costs[n].fixed_cycles, fixed_sink = fx_dbspl_to_pascal(FX_Q16(40.0) + ((i & 63) << 16)));
+    cost_fixed_ops(&costs[n++]);
+
+    costs[n] = (Cost){"microphone output", 0, 0, {0}, 1};
+    TIME_LOOP(costs[n].double_cycles, sink = mic->output(0.02 * (1 + (i & 63))));
+    TIME_LOOP(costs[n].fixed_cycles, fixed_sink = fx_mic_output(mic->fixed, FX_Q(0.02, 22) * (1 + (i & 63))));
+    cost_fixed_ops(&costs[n++]);
+
+    costs[n] = (Cost){"Hall output", 0, 0, {0}, 1};
+    TIME_LOOP(costs[n].double_cycles, sink = hall->output((double)(i & 1023)));
+    TIME_LOOP(costs[n].fixed_cycles, fixed_sink = fx_hall_output(hall->fixed, (i & 1023) << 16));
+    cost_fixed_ops(&costs[n++]);
+
+    costs[n] = (Cost){"radiation counts", 0, 0, {0}, 1};
+    TIME_LOOP(costs[n].double_cycles, sink = simulate_radiation_counts((double)(1 + (i & 255)), 10.0));
+    TIME_LOOP(costs[n].fixed_cycles, fixed_sink = fx_radiation_counts((1 + (i & 255)) << 16, 10));
+    cost_fixed_ops(&costs[n++]);
+
+    printf("\nCost per call, host cycles from the %s; AVR estimate at %.0f MHz\n", cycles_source(), AVR_MHZ);
+    printf("  %-24s %8s %8s   %-33s %s\n", "", "double", "fixed", "fixed-point operations", "AVR, fixed");
+    for (int i = 0; i < n; i++) print_cost(&costs[i]);
+    printf("  Host fixed-point cycles include the operation counting. The AVR estimate leaves out\n");
+    printf("  the simulated noise draw (+rand()), which the suit gets from the real sensor.\n");
+#ifdef __linux__
+    if (perf_fd >= 0) close(perf_fd);
+#endif
+
+    printf("\n%s\n", failed ? "Error bounds exceeded" : "All error bounds met");
+    return failed;
+}
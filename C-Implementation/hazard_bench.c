@@ -0,0 +1,169 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include "oxygen_sensor.h"
+#include "hazard_index.h"
+
+// Benchmark and check for the galvanic oxygen cell model and the combined hazard index:
+//  1. O2 cell read back through o2_cell_percent over temperature and cell age
+//  2. incremental index update against rescoring all components on every reading,
+//     over a fleet of suits, and the number of severity changes sent to control
+//  3. a suit with every hazard below its own threshold that still adds up to a warning
+
+#define BENCH_SUITS 100000
+#define BENCH_READINGS 10000000
+#define BENCH_O2_DRAWS 100000
+#define BENCH_O2_MAX_ERROR 0.5  // % O2
+
+HazardBank bank;
+float latest[BENCH_SUITS][HAZARD_COMPONENTS];  // For rescoring from scratch
+
+typedef struct {
+    int suit_id;
+    int component;
+    float value;
+} BenchReading;
+
+double now_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+double uniform(double low, double high) {
+    return low + (high - low) * (rand() / (double)RAND_MAX);
+}
+
+// Readings wander around safe levels with the odd excursion
+double bench_value(int component) {
+    int excursion = (rand() % 50 == 0);
+    switch (component) {
+        case HAZARD_HEAT: return excursion ? uniform(35.0, 45.0) : uniform(22.0, 32.0);
+        case HAZARD_OXYGEN: return excursion ? uniform(17.0, 19.5) : uniform(20.5, 20.9);
+        case HAZARD_TOXIC: return excursion ? uniform(20.0, 80.0) : uniform(0.0, 10.0);
+        default: return excursion ? uniform(5.0, 30.0) : uniform(0.1, 1.0);
+    }
+}
+
+// The index computed from nothing, as a reader without running state would
+int rescore(int suit_id, int *dominant) {
+    int index = 0, best = -1;
+    for (int c = 0; c < HAZARD_COMPONENTS; c++) {
+        int score = hazard_score(c, latest[suit_id][c]);
+        index += score;
+        if (score > best) {
+            best = score;
+            *dominant = c;
+        }
+    }
+    return index;
+}
+
+int main() {
+    int failures = 0;
+
+    printf("Smart Suit - Oxygen Cell and Hazard Index Benchmark\n");
+    printf("---------------------------------------------------\n");
+
+    // 1. Cell model: what the sensor module reports against the true level
+    srand(7);
+    double worst = 0.0, sum = 0.0;
+    for (int i = 0; i < BENCH_O2_DRAWS; i++) {
+        double o2 = uniform(10.0, 23.0), temp = uniform(0.0, 45.0), years = uniform(0.0, 3.0);
+        double output = o2_cell_output(o2, temp, O2_CELL_REFERENCE_PRESSURE, years);
+        double error = fabs(o2_cell_percent(output, temp, O2_CELL_REFERENCE_PRESSURE, years) - o2);
+        sum += error;
+        if (error > worst) worst = error;
+    }
+    printf("O2 cell, %d draws over 0-45 °C and 0-3 years: mean error %.3f%%, max %.3f%% O2\n",
+           BENCH_O2_DRAWS, sum / BENCH_O2_DRAWS, worst);
+    printf("  output in air: %.2f mV new, %.2f mV at end of life (%.1f years)\n",
+           O2_CELL_OFFSET + O2_CELL_SENSITIVITY * O2_AIR_PERCENT,
+           O2_CELL_OFFSET + O2_CELL_SENSITIVITY * O2_AIR_PERCENT * O2_CELL_END_OF_LIFE, O2_CELL_LIFE_YEARS);
+    if (worst > BENCH_O2_MAX_ERROR) {
+        printf("  FAIL: error above %.1f%% O2\n", BENCH_O2_MAX_ERROR);
+        failures++;
+    }
+
+    // 2. Fleet: the same readings through the running index and through a full rescore
+    BenchReading *readings = malloc(sizeof(BenchReading) * BENCH_READINGS);
+    if (readings == NULL || hazard_bank_init(&bank, BENCH_SUITS) != 0) {
+        printf("Allocation failed\n");
+        return 1;
+    }
+    for (int i = 0; i < BENCH_READINGS; i++) {
+        readings[i].component = rand() % HAZARD_COMPONENTS;
+        readings[i].value = (float)bench_value(readings[i].component);
+    }
+
+    // Small fleet first: in cache, the arithmetic shows
+    HazardChange change;
+    printf("\n%d readings (ns per reading):\n", BENCH_READINGS);
+    printf("  suits    incremental   rescore all parts\n");
+    for (int suits = BENCH_SUITS / 100; suits <= BENCH_SUITS; suits *= 100) {
+        for (int i = 0; i < BENCH_READINGS; i++) readings[i].suit_id = rand() % suits;
+        hazard_bank_free(&bank);
+        hazard_bank_init(&bank, suits);
+        for (int s = 0; s < suits; s++) {
+            for (int c = 0; c < HAZARD_COMPONENTS; c++) latest[s][c] = 0.0f;
+            latest[s][HAZARD_OXYGEN] = (float)HAZARD_O2_ONSET;  // Not reported yet, scores 0
+        }
+
+        long changes = 0;
+        double start = now_seconds();
+        for (int i = 0; i < BENCH_READINGS; i++) {
+            changes += hazard_update(&bank, readings[i].suit_id, readings[i].component, readings[i].value, &change);
+        }
+        double incremental = now_seconds() - start;
+
+        long checksum = 0;
+        start = now_seconds();
+        for (int i = 0; i < BENCH_READINGS; i++) {
+            int dominant = 0;
+            latest[readings[i].suit_id][readings[i].component] = readings[i].value;
+            checksum += rescore(readings[i].suit_id, &dominant) + dominant;
+        }
+        double full = now_seconds() - start;
+        printf("  %6d   %8.1f      %8.1f (checksum %ld)\n", suits, incremental / BENCH_READINGS * 1e9,
+               full / BENCH_READINGS * 1e9, checksum);
+        if (suits == BENCH_SUITS) {
+            printf("  severity changes sent to control: %ld (%.2f%% of readings)\n",
+                   changes, 100.0 * changes / BENCH_READINGS);
+        }
+    }
+
+    long mismatches = 0;
+    for (int s = 0; s < BENCH_SUITS; s++) {
+        int dominant = 0, index = rescore(s, &dominant);
+        const SuitHazard *h = &bank.suits[s];
+        if (h->index != index || h->score[h->dominant] != h->score[dominant]) mismatches++;
+    }
+    printf("  suits by severity:");
+    for (int level = 0; level < HAZARD_LEVELS; level++) {
+        printf(" %s %ld", hazard_severity_name(level), bank.at_severity[level]);
+    }
+    printf("\n  %ld suit(s) whose running index differs from a rescore\n", mismatches);
+    if (mismatches > 0) failures++;
+    free(readings);
+
+    // 3. Nothing over its own threshold, together over the limit
+    HazardBank one;
+    hazard_bank_init(&one, 1);
+    hazard_update(&one, 0, HAZARD_HEAT, 36.0, &change);
+    int raised = hazard_update(&one, 0, HAZARD_OXYGEN, 19.8, &change);
+    printf("\nSuit at 36 °C (threshold 40) and 19.8%% O2 (threshold 19): index %.2f, %s\n",
+           one.suits[0].index / 1000.0, hazard_severity_name(one.suits[0].severity));
+    if (!raised || change.severity != HAZARD_WARNING) {
+        printf("  FAIL: expected a change to warning\n");
+        failures++;
+    }
+    hazard_update(&one, 0, HAZARD_HEAT, 35.5, &change);
+    printf("  cooled to 35.5 °C: index %.2f, still %s (hysteresis)\n",
+           one.suits[0].index / 1000.0, hazard_severity_name(one.suits[0].severity));
+    hazard_bank_free(&one);
+    hazard_bank_free(&bank);
+
+    return (failures > 0) ? 1 : 0;
+}
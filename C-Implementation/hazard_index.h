@@ -0,0 +1,167 @@
+#ifndef HAZARD_INDEX_H
+#define HAZARD_INDEX_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+// Combined hazard index per suit, kept up to date as any of its channels changes.
+// Each component is scored as a share of its limit in per mille (1000 = at the
+// limit, the same level as the channel's own alarm threshold), and the index is
+// the sum of the shares, like the additive rule for gas mixtures: two hazards at
+// 60% of their limits together count as over the limit. A reading replaces its
+// component's share and moves the running sum by the difference, so an update
+// costs the same however many channels the suit reports.
+#define HAZARD_MAX_SUITS 100000
+
+// Components
+#define HAZARD_HEAT 0  // Temperature, heat stress
+#define HAZARD_OXYGEN 1  // O2 deficiency
+#define HAZARD_TOXIC 2  // Toxic gas load
+#define HAZARD_DOSE 3  // Radiation dose rate
+#define HAZARD_COMPONENTS 4
+
+// Zero and full share of each component
+#define HAZARD_HEAT_ONSET 30.0  // °C
+#define HAZARD_HEAT_LIMIT 40.0
+#define HAZARD_O2_ONSET 20.9  // % by volume, normal air
+#define HAZARD_O2_LIMIT 19.0
+#define HAZARD_TOXIC_LIMIT 50.0  // ppm
+#define HAZARD_DOSE_ONSET 0.2  // μSv/h, background
+#define HAZARD_DOSE_LIMIT 20.0
+#define HAZARD_SCORE_MAX 4000  // A single component counts up to 4x its limit
+
+// Severity levels from the index (per mille), published to control
+#define HAZARD_CLEAR 0
+#define HAZARD_ADVISORY 1
+#define HAZARD_WARNING 2
+#define HAZARD_DANGER 3
+#define HAZARD_LEVELS 4
+#define HAZARD_ADVISORY_AT 500
+#define HAZARD_WARNING_AT 1000
+#define HAZARD_DANGER_AT 2000
+#define HAZARD_HYSTERESIS 100  // A level is left only this far below where it starts
+
+// 12 bytes per suit
+typedef struct {
+    uint16_t score[HAZARD_COMPONENTS];  // Per mille of the component's limit
+    uint16_t index;  // Sum of the scores
+    uint8_t severity;  // Last severity published
+    uint8_t dominant;  // Component with the highest score
+} SuitHazard;
+
+typedef struct {
+    SuitHazard *suits;  // Indexed by suit ID
+    int suit_count;
+    long at_severity[HAZARD_LEVELS];  // Suits per severity, suits never scored count as clear
+} HazardBank;
+
+typedef struct {
+    int severity;
+    int previous;
+    int index;  // Per mille
+    int dominant;
+} HazardChange;
+
+static const int hazard_level_start[HAZARD_LEVELS] = {0, HAZARD_ADVISORY_AT, HAZARD_WARNING_AT, HAZARD_DANGER_AT};
+
+int hazard_bank_init(HazardBank *bank, int suit_count) {
+    memset(bank, 0, sizeof(*bank));
+    bank->suits = calloc((size_t)suit_count, sizeof(SuitHazard));
+    if (bank->suits == NULL) return -1;
+    bank->suit_count = suit_count;
+    bank->at_severity[HAZARD_CLEAR] = suit_count;
+    return 0;
+}
+
+void hazard_bank_free(HazardBank *bank) {
+    free(bank->suits);
+    bank->suits = NULL;
+    bank->suit_count = 0;
+}
+
+const char* hazard_component_name(int component) {
+    switch (component) {
+        case HAZARD_HEAT: return "heat stress";
+        case HAZARD_OXYGEN: return "oxygen deficiency";
+        case HAZARD_TOXIC: return "toxic gas";
+        case HAZARD_DOSE: return "dose rate";
+        default: return "unknown";
+    }
+}
+
+const char* hazard_severity_name(int severity) {
+    switch (severity) {
+        case HAZARD_CLEAR: return "clear";
+        case HAZARD_ADVISORY: return "advisory";
+        case HAZARD_WARNING: return "warning";
+        case HAZARD_DANGER: return "danger";
+        default: return "unknown";
+    }
+}
+
+// Share of the component's limit in per mille for a reading
+int hazard_score(int component, double value) {
+    double share;
+    switch (component) {
+        case HAZARD_HEAT:
+            share = (value - HAZARD_HEAT_ONSET) / (HAZARD_HEAT_LIMIT - HAZARD_HEAT_ONSET);
+            break;
+        case HAZARD_OXYGEN:
+            share = (HAZARD_O2_ONSET - value) / (HAZARD_O2_ONSET - HAZARD_O2_LIMIT);
+            break;
+        case HAZARD_TOXIC:
+            share = value / HAZARD_TOXIC_LIMIT;
+            break;
+        case HAZARD_DOSE:
+            share = (value - HAZARD_DOSE_ONSET) / (HAZARD_DOSE_LIMIT - HAZARD_DOSE_ONSET);
+            break;
+        default:
+            return 0;
+    }
+    if (!(share > 0.0)) return 0;
+    return (share * 1000.0 < HAZARD_SCORE_MAX) ? (int)(share * 1000.0 + 0.5) : HAZARD_SCORE_MAX;
+}
+
+// Severity for an index, holding the current level until the index is clearly below it
+static inline int hazard_severity(int index, int current) {
+    int level = HAZARD_DANGER;
+    while (level > HAZARD_CLEAR && index < hazard_level_start[level]) level--;
+    if (level < current && index >= hazard_level_start[current] - HAZARD_HYSTERESIS) level = current;
+    return level;
+}
+
+// Fold a reading into the suit's index. Returns 1 when its severity changed
+// (change describes the new state), 0 otherwise or for a suit out of range.
+int hazard_update(HazardBank *bank, int suit_id, int component, double value, HazardChange *change) {
+    if (suit_id < 0 || suit_id >= bank->suit_count) return 0;
+    if (component < 0 || component >= HAZARD_COMPONENTS) return 0;
+    SuitHazard *h = &bank->suits[suit_id];
+    int score = hazard_score(component, value);
+
+    int fell_back = (component == h->dominant && score < h->score[component]);
+    h->index = (uint16_t)(h->index - h->score[component] + score);
+    h->score[component] = (uint16_t)score;
+    if (fell_back) {
+        // The leader dropped, the highest of the fixed few components takes over
+        for (int c = 0; c < HAZARD_COMPONENTS; c++) {
+            if (h->score[c] > h->score[h->dominant]) h->dominant = (uint8_t)c;
+        }
+    } else if (score >= h->score[h->dominant]) {
+        h->dominant = (uint8_t)component;
+    }
+
+    int severity = hazard_severity(h->index, h->severity);
+    if (severity == h->severity) return 0;
+    bank->at_severity[h->severity]--;
+    bank->at_severity[severity]++;
+    change->previous = h->severity;
+    change->severity = severity;
+    change->index = h->index;
+    change->dominant = h->dominant;
+    h->severity = (uint8_t)severity;
+    return 1;
+}
+
+#endif
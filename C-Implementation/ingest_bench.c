@@ -0,0 +1,181 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <math.h>
+#include "ingest_memory.h"
+#include "suit_state.h"
+#include "sensor_filter.h"
+#include "trend_predictor.h"
+#include "hazard_index.h"
+#include "acoustic_stream.h"
+#include "alert_queue.h"
+
+// Benchmark and check for the zero-allocation ingestion path:
+//  1. batches shaped like sensor connections (a header and a PCM block in a pooled
+//     receive buffer, arena scratch, then the per-reading state updates) must make no
+//     heap allocation once warmed up
+//  2. a batch that does call malloc must be caught, so a clean result means something
+//  3. arena scratch against malloc/free for the same requests
+// The allocation checks need a glibc build with -DINGEST_ALLOC_TRACKING and are
+// skipped otherwise; the timing runs either way.
+
+#define BENCH_SUITS 1000
+#define BENCH_WARMUP 1000  // Batches before counting
+#define BENCH_BATCHES 100000
+#define BENCH_FRAMES 480  // 10 ms PCM blocks
+#define BENCH_SCRATCH 6  // Arena requests per batch
+#define BENCH_HEADER_BYTES (3 * (int)sizeof(int))
+#define BENCH_RECEIVE_BYTES (BENCH_HEADER_BYTES + PCM_MAX_BLOCK * (int)sizeof(int16_t))
+
+IngestMemory mem;
+SuitStateTable states;
+FilterBank filters;
+TrendBank trends;
+HazardBank hazards;
+AcousticBank noise;
+AlertQueue queue;
+
+static const size_t scratch_sizes[BENCH_SCRATCH] = {256, 1920, 64, 4096, 512, 1024};
+
+double now_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// One connection: receive, scratch, model state. Returns the heap allocations it made.
+int run_batch(int n, double *checksum) {
+    int suit_id = n % BENCH_SUITS;
+    int param_code = 1 + n % SUIT_STATE_PARAMS;
+    uint32_t now_ms = (uint32_t)n * 10;
+
+    ingest_batch_begin(&mem);
+    char *buffer = buffer_pool_acquire(&mem.receive);
+    if (buffer == NULL) return ingest_batch_end(&mem);
+
+    // What recv would have put in the buffer
+    int *header = (int *)buffer;
+    int16_t *pcm = (int16_t *)(buffer + BENCH_HEADER_BYTES);
+    header[0] = param_code;
+    header[1] = 20 + n % 30;
+    header[2] = suit_id;
+    for (int i = 0; i < BENCH_FRAMES; i++) pcm[i] = (int16_t)(((n + i) * 7919) % 20000 - 10000);
+
+    for (int i = 0; i < BENCH_SCRATCH; i++) {
+        float *scratch = batch_arena_alloc(&mem.arena, scratch_sizes[i]);
+        if (scratch != NULL) scratch[0] = (float)i;
+    }
+
+    double value = header[1];
+    FilterOutput out = filter_update(&filters, suit_id, param_code, value);
+    suit_state_update(&states, suit_id, param_code, out.value, now_ms, 0);
+    TrendState *trend = trend_channel(&trends, suit_id, param_code);
+    if (trend != NULL) {
+        trend_update(trend, now_ms, out.value);
+        *checksum += trend_predict(trend, 40.0, 1).level;
+    }
+    HazardChange change;
+    hazard_update(&hazards, suit_id, HAZARD_HEAT, out.value, &change);
+
+    int slot = suit_id % noise.channels;
+    acoustic_process_channel(&noise, slot, pcm, BENCH_FRAMES);
+    *checksum += acoustic_read_levels(&noise, slot, 1).leq_a;
+
+    if (alert_queue_push(&queue, suit_id, param_code, header[1], ALERT_ROUTINE, now_ms) != ALERT_DROPPED) {
+        alert_queue_remove(&queue, alert_queue_next(&queue));
+    }
+
+    buffer_pool_release(&mem.receive, buffer);
+    return ingest_batch_end(&mem);
+}
+
+int main() {
+    int failures = 0;
+    double checksum = 0.0;
+
+    printf("Smart Suit - Zero-Allocation Ingestion Benchmark\n");
+    printf("------------------------------------------------\n");
+
+    if (ingest_memory_init(&mem, 4, BENCH_RECEIVE_BYTES, 64 * 1024) != 0 ||
+        suit_state_init(&states, BENCH_SUITS) != 0 ||
+        filter_bank_init(&filters, BENCH_SUITS) != 0 ||
+        trend_bank_init(&trends, BENCH_SUITS) != 0 ||
+        hazard_bank_init(&hazards, BENCH_SUITS) != 0 ||
+        acoustic_bank_init(&noise, 64, PCM_SAMPLE_RATE) != 0) {
+        printf("Allocation failed\n");
+        return 1;
+    }
+    alert_queue_init(&queue);
+
+    // 1. Steady state
+    for (int n = 0; n < BENCH_WARMUP; n++) run_batch(n, &checksum);
+    long allocations = 0, allocating = 0;
+    double start = now_seconds();
+    for (int n = BENCH_WARMUP; n < BENCH_WARMUP + BENCH_BATCHES; n++) {
+        int made = run_batch(n, &checksum);
+        allocations += made;
+        allocating += (made > 0);
+    }
+    double elapsed = now_seconds() - start;
+    printf("%d batches after %d warm-up: %.2f us per batch (checksum %.1f)\n",
+           BENCH_BATCHES, BENCH_WARMUP, elapsed / BENCH_BATCHES * 1e6, checksum);
+    printf("  arena high water %zu of %zu bytes, %ld overflow(s); at least %d receive buffer(s) always free\n",
+           mem.arena.high_water, mem.arena.size, mem.arena.overflows, mem.receive.low_water);
+
+    if (!ingest_alloc_tracking()) {
+        printf("  allocation tracking not built in (glibc with -DINGEST_ALLOC_TRACKING), checks skipped\n");
+    } else {
+        printf("  heap allocations: %ld in %ld batch(es)\n", allocations, allocating);
+        if (allocations > 0) {
+            printf("  FAIL: the ingestion path allocated\n");
+            failures++;
+        }
+
+        // 2. The tracker sees an allocation made inside a batch
+        ingest_batch_begin(&mem);
+        void *volatile leak = malloc(64);
+        free(leak);
+        int caught = ingest_batch_end(&mem);
+        printf("  control batch calling malloc once: %d allocation(s) counted\n", caught);
+        if (caught != 1) {
+            printf("  FAIL: expected exactly 1\n");
+            failures++;
+        }
+    }
+
+    // 3. The same scratch requests from the arena and from malloc
+    start = now_seconds();
+    for (int n = 0; n < BENCH_BATCHES; n++) {
+        for (int i = 0; i < BENCH_SCRATCH; i++) {
+            char *volatile p = batch_arena_alloc(&mem.arena, scratch_sizes[i]);
+            p[0] = (char)n;
+        }
+        batch_arena_reset(&mem.arena);
+    }
+    double arena = now_seconds() - start;
+
+    void *held[BENCH_SCRATCH];
+    start = now_seconds();
+    for (int n = 0; n < BENCH_BATCHES; n++) {
+        for (int i = 0; i < BENCH_SCRATCH; i++) {
+            char *volatile p = malloc(scratch_sizes[i]);
+            p[0] = (char)n;
+            held[i] = p;
+        }
+        for (int i = 0; i < BENCH_SCRATCH; i++) free(held[i]);
+    }
+    double heap = now_seconds() - start;
+    printf("\nScratch for one batch (%d requests): arena %.1f ns, malloc/free %.1f ns\n",
+           BENCH_SCRATCH, arena / BENCH_BATCHES * 1e9, heap / BENCH_BATCHES * 1e9);
+
+    acoustic_bank_free(&noise);
+    hazard_bank_free(&hazards);
+    trend_bank_free(&trends);
+    filter_bank_free(&filters);
+    suit_state_free(&states);
+    ingest_memory_free(&mem);
+
+    return (failures > 0) ? 1 : 0;
+}
@@ -0,0 +1,212 @@
+#ifndef INGEST_MEMORY_H
+#define INGEST_MEMORY_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+// Memory for the ingestion path of the sensor and control modules, so that nothing
+// between accepting a connection and finishing its batch touches the heap once the
+// module is running:
+//  - each open connection takes a receive buffer from a fixed pool, sized for the
+//    largest message the module accepts, and returns it on close;
+//  - scratch for one batch (a sensor connection, or one group commit in control)
+//    is bump-allocated from an arena that is reset when the batch completes.
+// Both are allocated once at start. A request beyond their size fails and is
+// counted; it never falls back to the heap.
+//
+// Built with INGEST_ALLOC_TRACKING on glibc, malloc and its relatives are wrapped to
+// count the calls made by the calling thread, libc's own included (fopen, for one).
+// Every batch then records the allocations made while it was open; other threads,
+// like the metrics server, are not counted. ingest_bench.c fails if any appear.
+#define INGEST_ALIGN 16
+
+typedef struct {
+    char *memory;  // count * buffer_size bytes
+    int *free_list;  // Indexes of free buffers, a stack
+    int buffer_size;
+    int count;
+    int available;
+    int low_water;  // Fewest buffers free at any time
+    long acquired;
+    long exhausted;  // Requests refused with every buffer in use
+} BufferPool;
+
+typedef struct {
+    char *memory;
+    size_t size;
+    size_t used;
+    size_t high_water;  // Most used by one batch
+    long overflows;  // Requests refused for lack of room
+} BatchArena;
+
+typedef struct {
+    BufferPool receive;
+    BatchArena arena;
+    long batches;
+    long heap_allocations;  // Made inside batches, always 0 without tracking
+    long allocating_batches;
+    long batch_start;  // Thread allocation count when the open batch began
+} IngestMemory;
+
+#if defined(INGEST_ALLOC_TRACKING) && defined(__GLIBC__)
+// Replacements for the allocator entry points, counting per thread on top of glibc's own
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void *__libc_memalign(size_t alignment, size_t size);
+extern void __libc_free(void *ptr);
+
+static _Thread_local long ingest_thread_allocs;
+
+void *malloc(size_t size) {
+    ingest_thread_allocs++;
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) {
+    ingest_thread_allocs++;
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size) {
+    ingest_thread_allocs++;
+    return __libc_realloc(ptr, size);
+}
+
+void *aligned_alloc(size_t alignment, size_t size) {
+    ingest_thread_allocs++;
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void **out, size_t alignment, size_t size) {
+    ingest_thread_allocs++;
+    *out = __libc_memalign(alignment, size);
+    return (*out != NULL || size == 0) ? 0 : 12;  // ENOMEM
+}
+
+void free(void *ptr) {
+    __libc_free(ptr);
+}
+
+// 1 when allocations are counted in this build
+static inline int ingest_alloc_tracking() { return 1; }
+static inline long ingest_thread_allocations() { return ingest_thread_allocs; }
+#else
+static inline int ingest_alloc_tracking() { return 0; }
+static inline long ingest_thread_allocations() { return 0; }
+#endif
+
+// Returns 0, or -1 when allocation fails
+int buffer_pool_init(BufferPool *pool, int count, int buffer_size) {
+    memset(pool, 0, sizeof(*pool));
+    buffer_size = (buffer_size + INGEST_ALIGN - 1) & ~(INGEST_ALIGN - 1);
+    pool->memory = malloc((size_t)count * buffer_size);
+    pool->free_list = malloc((size_t)count * sizeof(int));
+    if (pool->memory == NULL || pool->free_list == NULL) {
+        free(pool->memory);
+        free(pool->free_list);
+        pool->memory = NULL;
+        pool->free_list = NULL;
+        return -1;
+    }
+    // Buffer 0 on top, so a module with one connection at a time always reuses it
+    for (int i = 0; i < count; i++) pool->free_list[i] = count - 1 - i;
+    pool->buffer_size = buffer_size;
+    pool->count = count;
+    pool->available = count;
+    pool->low_water = count;
+    return 0;
+}
+
+void buffer_pool_free(BufferPool *pool) {
+    free(pool->memory);
+    free(pool->free_list);
+    pool->memory = NULL;
+    pool->free_list = NULL;
+    pool->count = 0;
+    pool->available = 0;
+}
+
+// A free buffer of buffer_size bytes, NULL when all are in use
+char *buffer_pool_acquire(BufferPool *pool) {
+    if (pool->available == 0) {
+        pool->exhausted++;
+        return NULL;
+    }
+    int index = pool->free_list[--pool->available];
+    if (pool->available < pool->low_water) pool->low_water = pool->available;
+    pool->acquired++;
+    return pool->memory + (size_t)index * pool->buffer_size;
+}
+
+void buffer_pool_release(BufferPool *pool, char *buffer) {
+    if (buffer == NULL) return;
+    pool->free_list[pool->available++] = (int)((buffer - pool->memory) / pool->buffer_size);
+}
+
+int batch_arena_init(BatchArena *arena, size_t size) {
+    memset(arena, 0, sizeof(*arena));
+    arena->memory = malloc(size);
+    if (arena->memory == NULL) return -1;
+    arena->size = size;
+    return 0;
+}
+
+void batch_arena_free(BatchArena *arena) {
+    free(arena->memory);
+    arena->memory = NULL;
+    arena->size = 0;
+    arena->used = 0;
+}
+
+// Bytes for the current batch, aligned to INGEST_ALIGN; NULL when the arena is full
+void *batch_arena_alloc(BatchArena *arena, size_t bytes) {
+    size_t start = (arena->used + INGEST_ALIGN - 1) & ~(size_t)(INGEST_ALIGN - 1);
+    if (start + bytes > arena->size) {
+        arena->overflows++;
+        return NULL;
+    }
+    arena->used = start + bytes;
+    if (arena->used > arena->high_water) arena->high_water = arena->used;
+    return arena->memory + start;
+}
+
+// Drop everything the batch allocated
+static inline void batch_arena_reset(BatchArena *arena) {
+    arena->used = 0;
+}
+
+int ingest_memory_init(IngestMemory *mem, int buffers, int buffer_size, size_t arena_size) {
+    memset(mem, 0, sizeof(*mem));
+    if (buffer_pool_init(&mem->receive, buffers, buffer_size) != 0) return -1;
+    if (batch_arena_init(&mem->arena, arena_size) != 0) {
+        buffer_pool_free(&mem->receive);
+        return -1;
+    }
+    return 0;
+}
+
+void ingest_memory_free(IngestMemory *mem) {
+    batch_arena_free(&mem->arena);
+    buffer_pool_free(&mem->receive);
+}
+
+static inline void ingest_batch_begin(IngestMemory *mem) {
+    mem->batch_start = ingest_thread_allocations();
+}
+
+// Close the batch: reset the arena and return the heap allocations made while it was open
+int ingest_batch_end(IngestMemory *mem) {
+    long allocations = ingest_thread_allocations() - mem->batch_start;
+    batch_arena_reset(&mem->arena);
+    mem->batches++;
+    if (allocations > 0) {
+        mem->heap_allocations += allocations;
+        mem->allocating_batches++;
+    }
+    return (int)allocations;
+}
+
+#endif
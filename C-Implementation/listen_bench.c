@@ -0,0 +1,199 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "net_compat.h"
+#include "listen_workers.h"
+
+// Benchmark for SO_REUSEPORT listener workers (Linux):
+//  1. accepted connections and readings per second with 1, 2, 4 and 8 workers
+//  2. failed connections while all workers are rolled under load
+// Each worker runs the module accept loop against a stand-in reading path: a
+// little CPU for the sensor models and filter, then a wait for the control round
+// trip, which is where a single-threaded module spends most of each reading.
+
+#define BENCH_PORT 18080
+#define BENCH_CLIENTS 32
+#define BENCH_SECONDS 2
+#define BENCH_CPU_US 20  // Model, filter and log work per reading
+#define BENCH_ROUNDTRIP_US 300  // Alert round trip to control
+#define BENCH_ROLL_SECONDS 4
+
+atomic_int stop_clients;
+
+typedef struct {
+    long connected;
+    long readings;
+    long failed;
+} ClientStats;
+
+double now_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+#ifdef __linux__
+// What a module worker does, with the reading path replaced by fixed costs
+int run_server() {
+    SOCKET server_fd, new_socket;
+    struct sockaddr_in address;
+    socklen_t addrlen = sizeof(address);
+    int opt = 1;
+
+    listen_workers_start("Bench", LISTEN_MAX_WORKERS);
+    server_fd = socket(AF_INET, SOCK_STREAM, 0);
+    setsockopt(server_fd, SOL_SOCKET, SO_REUSEADDR, (char*)&opt, sizeof(opt));
+    listen_workers_configure(server_fd);
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(BENCH_PORT);
+    if (bind(server_fd, (struct sockaddr *)&address, sizeof(address)) == SOCKET_ERROR ||
+        listen(server_fd, LISTEN_BACKLOG) == SOCKET_ERROR) {
+        perror("Bench listener");
+        return 1;
+    }
+    listen_workers_ready();
+
+    while (1) {
+        if ((new_socket = listen_workers_accept(server_fd, (struct sockaddr *)&address, &addrlen)) == INVALID_SOCKET) {
+            if (listen_workers.drained) break;
+            continue;
+        }
+        int data[3];
+        if (recv(new_socket, (char*)data, sizeof(data), 0) > 0) {
+            double until = now_seconds() + BENCH_CPU_US / 1e6;
+            while (now_seconds() < until) {}
+            struct timespec ts = {0, BENCH_ROUNDTRIP_US * 1000L};
+            nanosleep(&ts, NULL);
+            send(new_socket, (char*)data, sizeof(int), 0);
+        }
+        closesocket(new_socket);
+    }
+    closesocket(server_fd);
+    return 0;
+}
+
+static void *client(void *arg) {
+    ClientStats *stats = arg;
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(BENCH_PORT);
+
+    while (!atomic_load_explicit(&stop_clients, memory_order_relaxed)) {
+        SOCKET s = socket(AF_INET, SOCK_STREAM, 0);
+        struct linger hard = {1, 0};  // Reset on close so TIME_WAIT does not use up local ports
+        setsockopt(s, SOL_SOCKET, SO_LINGER, (char*)&hard, sizeof(hard));
+        int data[3] = {1, 30, 7}, ack;
+        if (connect(s, (struct sockaddr *)&address, sizeof(address)) != 0) {
+            stats->failed++;
+        } else {
+            stats->connected++;
+            if (send(s, (char*)data, sizeof(data), 0) == sizeof(data) && recv(s, (char*)&ack, sizeof(ack), 0) == sizeof(ack)) {
+                stats->readings++;
+            } else {
+                stats->failed++;
+            }
+        }
+        closesocket(s);
+    }
+    return NULL;
+}
+
+// Start a supervisor with `workers` workers, load it for `seconds`, optionally rolling it once
+void run(int workers, double seconds, int roll, double *conn_rate, double *reading_rate, long *failed) {
+    char count[16];
+    snprintf(count, sizeof(count), "%d", workers);
+    setenv("LISTEN_WORKERS", count, 1);
+    fflush(stdout);
+
+    pid_t supervisor = fork();
+    if (supervisor == 0) {
+        freopen("/dev/null", "w", stdout);
+        exit(run_server());
+    }
+    // Wait until the port answers
+    for (int tries = 0; tries < 200; tries++) {
+        SOCKET s = socket(AF_INET, SOCK_STREAM, 0);
+        struct sockaddr_in address = {0};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(BENCH_PORT);
+        int ok = connect(s, (struct sockaddr *)&address, sizeof(address)) == 0;
+        closesocket(s);
+        if (ok) break;
+        struct timespec ts = {0, 10000000L};
+        nanosleep(&ts, NULL);
+    }
+
+    pthread_t threads[BENCH_CLIENTS];
+    ClientStats stats[BENCH_CLIENTS];
+    memset(stats, 0, sizeof(stats));
+    atomic_store(&stop_clients, 0);
+    double start = now_seconds();
+    for (int t = 0; t < BENCH_CLIENTS; t++) pthread_create(&threads[t], NULL, client, &stats[t]);
+    if (roll) {
+        struct timespec ts = {0, 500000000L};
+        nanosleep(&ts, NULL);
+        kill(supervisor, SIGHUP);
+    }
+    while (now_seconds() - start < seconds) {
+        struct timespec ts = {0, 50000000L};
+        nanosleep(&ts, NULL);
+    }
+    atomic_store(&stop_clients, 1);
+    long connected = 0, readings = 0;
+    *failed = 0;
+    for (int t = 0; t < BENCH_CLIENTS; t++) {
+        pthread_join(threads[t], NULL);
+        connected += stats[t].connected;
+        readings += stats[t].readings;
+        *failed += stats[t].failed;
+    }
+    double elapsed = now_seconds() - start;
+    *conn_rate = connected / elapsed;
+    *reading_rate = readings / elapsed;
+
+    kill(supervisor, SIGTERM);
+    waitpid(supervisor, NULL, 0);
+}
+
+int main() {
+    int counts[] = {1, 2, 4, 8};
+    double base = 0.0, conns, readings;
+    long failed;
+    FILE *migrate = fopen("/proc/sys/net/ipv4/tcp_migrate_req", "r");
+    int migrate_req = migrate != NULL && fgetc(migrate) == '1';
+    if (migrate) fclose(migrate);
+
+    signal(SIGPIPE, SIG_IGN);
+    printf("Smart Suit - SO_REUSEPORT Listener Benchmark\n");
+    printf("--------------------------------------------\n");
+    printf("%ld CPU(s), %d clients, %d us CPU + %d us control round trip per reading\n",
+           sysconf(_SC_NPROCESSORS_ONLN), BENCH_CLIENTS, BENCH_CPU_US, BENCH_ROUNDTRIP_US);
+
+    for (int i = 0; i < 4; i++) {
+        run(counts[i], BENCH_SECONDS, 0, &conns, &readings, &failed);
+        if (i == 0) base = readings;
+        printf("%d worker(s): %8.0f connections/s, %8.0f readings/s (%.2fx), %ld failed\n",
+               counts[i], conns, readings, readings / base, failed);
+    }
+
+    printf("Rolling restart under load (tcp_migrate_req=%d):\n", migrate_req);
+    for (int workers = 1; workers <= 4; workers *= 4) {
+        run(workers, BENCH_ROLL_SECONDS, 1, &conns, &readings, &failed);
+        printf("%d worker(s): %8.0f readings/s during the roll, %ld failed connection(s)\n", workers, readings, failed);
+    }
+    return 0;
+}
+#else
+int main() {
+    printf("SO_REUSEPORT listener workers need Linux\n");
+    return 0;
+}
+#endif
@@ -0,0 +1,295 @@
+#ifndef LISTEN_WORKERS_H
+#define LISTEN_WORKERS_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef __linux__
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#endif
+#include "net_compat.h"
+
+// Multi-process listener scaling (Linux only).
+// With LISTEN_WORKERS=N the module's process becomes a supervisor that forks N
+// workers. Every worker binds the same port with SO_REUSEPORT and the kernel
+// spreads incoming connections across their listening sockets.
+// LISTEN_PIN_CPUS=1 pins worker i to CPU i % online CPUs.
+//
+// Signals to the supervisor:
+//   SIGHUP   rolling restart, one worker at a time: drain it, start its
+//            replacement, wait until that is listening, then move on
+//   SIGTERM  drain all workers and exit
+// A draining worker stops taking new connections, finishes the ones it has
+// accepted and exits. With net.ipv4.tcp_migrate_req=1 the connections still
+// queued on its socket move to a sibling when it closes; without it they are
+// accepted first, leaving only the instant between the last accept and close.
+// No listener is ever missing with two or more workers, so rolls refuse nothing.
+//
+// Each worker keeps its own per-suit state, metrics (served on the module's
+// metrics port + LISTEN_METRICS_STRIDE * worker) and, in control, its own WAL.
+// The kernel does not know suits, so a module whose state must see all of a
+// suit's traffic caps the workers at one.
+#define LISTEN_MAX_WORKERS 64
+#define LISTEN_BACKLOG 128  // Queued connections per listening socket
+#define LISTEN_METRICS_STRIDE 100
+#define LISTEN_READY_TIMEOUT_MS 10000  // Replacement must be listening within this
+#define LISTEN_POLL_MS 500  // Bounds how long a drain request can go unnoticed
+#define LISTEN_RESPAWN_DELAY_S 1  // Before restarting a worker that crashed
+
+typedef struct {
+    int count;  // Workers, 0 = plain single process
+    int index;  // This worker, 0 in a plain process
+    int pin;
+    int ready_fd;  // Write end of the readiness pipe, -1 once reported
+    volatile sig_atomic_t draining;
+    int drained;
+    int drain_on_signal;  // Plain process that drains on SIGINT/SIGTERM like a worker
+} ListenWorkers;
+
+ListenWorkers listen_workers = {0, 0, 0, -1, 0, 0, 0};
+
+#ifdef __linux__
+static volatile sig_atomic_t listen_roll_requested = 0;
+static volatile sig_atomic_t listen_stop_requested = 0;
+
+static void listen_on_drain(int sig) {
+    (void)sig;
+    listen_workers.draining = 1;
+}
+
+static void listen_on_roll(int sig) {
+    (void)sig;
+    listen_roll_requested = 1;
+}
+
+static void listen_on_stop(int sig) {
+    (void)sig;
+    listen_stop_requested = 1;
+}
+
+static void listen_on_child(int sig) {
+    (void)sig;  // Only here to interrupt pause()
+}
+
+static void listen_signal(int sig, void (*handler)(int), int flags) {
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = handler;
+    sa.sa_flags = flags;
+    sigemptyset(&sa.sa_mask);
+    sigaction(sig, &sa, NULL);
+}
+
+// Fork worker `index`. In the child this returns 0; in the supervisor the pid,
+// once the worker reports it is listening (or -1 if it never does).
+static pid_t listen_spawn(int index, int *is_child) {
+    int ready[2];
+    if (pipe(ready) != 0) return -1;
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(ready[0]);
+        *is_child = 1;
+        listen_workers.index = index;
+        listen_workers.ready_fd = ready[1];
+        prctl(PR_SET_PDEATHSIG, SIGTERM);  // Drain if the supervisor dies
+        listen_signal(SIGTERM, listen_on_drain, SA_RESTART);
+        listen_signal(SIGINT, listen_on_drain, SA_RESTART);
+        listen_signal(SIGHUP, SIG_IGN, 0);
+        listen_signal(SIGCHLD, SIG_DFL, 0);
+        if (listen_workers.pin) {
+            // Raw mask through the syscall, cpu_set_t needs _GNU_SOURCE before every include
+            unsigned long long mask = 1ULL << (index % sysconf(_SC_NPROCESSORS_ONLN));  // index < 64
+            syscall(SYS_sched_setaffinity, 0, sizeof(mask), &mask);
+        }
+        return 0;
+    }
+    close(ready[1]);
+    if (pid < 0) {
+        close(ready[0]);
+        return -1;
+    }
+
+    struct pollfd p = {ready[0], POLLIN, 0};
+    char byte;
+    int ok = 0;
+    while (poll(&p, 1, LISTEN_READY_TIMEOUT_MS) < 0 && errno == EINTR) {}
+    if ((p.revents & POLLIN) && read(ready[0], &byte, 1) == 1) ok = 1;
+    close(ready[0]);
+    if (!ok) {
+        printf("Worker %d (pid %d) failed to start listening\n", index, (int)pid);
+        return -1;
+    }
+    return pid;
+}
+
+static int listen_worker_of(pid_t *pids, pid_t pid) {
+    for (int i = 0; i < listen_workers.count; i++) {
+        if (pids[i] == pid) return i;
+    }
+    return -1;
+}
+
+// Drain worker i and wait for it to exit
+static void listen_retire(pid_t *pids, int i) {
+    if (pids[i] <= 0) return;
+    kill(pids[i], SIGTERM);
+    while (waitpid(pids[i], NULL, 0) < 0 && errno == EINTR) {}
+    pids[i] = -1;
+}
+
+// Supervisor loop, returns only inside a newly forked worker
+static int listen_supervise(const char *module) {
+    pid_t pids[LISTEN_MAX_WORKERS];
+    int is_child = 0;
+
+    listen_signal(SIGHUP, listen_on_roll, 0);
+    listen_signal(SIGTERM, listen_on_stop, 0);
+    listen_signal(SIGINT, listen_on_stop, 0);
+    listen_signal(SIGCHLD, listen_on_child, 0);
+
+    for (int i = 0; i < listen_workers.count; i++) {
+        pids[i] = listen_spawn(i, &is_child);
+        if (is_child) return i;
+    }
+    printf("%s supervisor %d: %d worker(s) sharing the port with SO_REUSEPORT%s\n", module, (int)getpid(),
+           listen_workers.count, listen_workers.pin ? ", pinned to CPUs" : "");
+
+    while (!listen_stop_requested) {
+        if (listen_roll_requested) {
+            listen_roll_requested = 0;
+            if (listen_workers.count == 1) {
+                printf("Rolling restart with a single worker can refuse connections while it restarts\n");
+            }
+            for (int i = 0; i < listen_workers.count && !listen_stop_requested; i++) {
+                listen_retire(pids, i);
+                pids[i] = listen_spawn(i, &is_child);
+                if (is_child) return i;
+            }
+            printf("%s workers restarted\n", module);
+        }
+
+        // Replace workers that died on their own
+        int status;
+        pid_t pid;
+        while ((pid = waitpid(-1, &status, WNOHANG)) > 0) {
+            int i = listen_worker_of(pids, pid);
+            if (i < 0) continue;
+            printf("%s worker %d (pid %d) exited with status %d, restarting\n", module, i, (int)pid,
+                   WIFEXITED(status) ? WEXITSTATUS(status) : -WTERMSIG(status));
+            sleep(LISTEN_RESPAWN_DELAY_S);
+            pids[i] = listen_spawn(i, &is_child);
+            if (is_child) return i;
+        }
+        if (!listen_roll_requested && !listen_stop_requested) pause();
+    }
+
+    for (int i = 0; i < listen_workers.count; i++) {
+        if (pids[i] > 0) kill(pids[i], SIGTERM);
+    }
+    for (int i = 0; i < listen_workers.count; i++) {
+        if (pids[i] > 0) while (waitpid(pids[i], NULL, 0) < 0 && errno == EINTR) {}
+    }
+    printf("%s workers drained, supervisor exiting\n", module);
+    exit(0);
+}
+#endif
+
+// Call first thing in main. Without LISTEN_WORKERS it returns at once; otherwise
+// the calling process supervises and this returns only in the forked workers.
+// LISTEN_WORKERS above max_workers is reduced to it.
+int listen_workers_start(const char *module, int max_workers) {
+    const char *workers = getenv("LISTEN_WORKERS");
+    const char *pin = getenv("LISTEN_PIN_CPUS");
+    if (workers == NULL || atoi(workers) <= 0) return 0;
+#ifdef __linux__
+    listen_workers.count = atoi(workers) > max_workers ? max_workers : atoi(workers);
+    if (atoi(workers) > max_workers) {
+        printf("%s runs at most %d listener worker(s), LISTEN_WORKERS=%d reduced\n", module, max_workers, atoi(workers));
+    }
+    listen_workers.pin = pin != NULL && atoi(pin) != 0;
+    setvbuf(stdout, NULL, _IOLBF, 0);  // Keep the workers' lines whole in a shared log
+    return listen_supervise(module);
+#else
+    (void)pin;
+    printf("LISTEN_WORKERS needs Linux SO_REUSEPORT, %s runs as a single process\n", module);
+    return 0;
+#endif
+}
+
+// Apply to the listening socket before bind
+int listen_workers_configure(SOCKET server_fd) {
+#ifdef __linux__
+    if (listen_workers.count > 0) {
+        int opt = 1;
+        if (setsockopt(server_fd, SOL_SOCKET, SO_REUSEPORT, (char*)&opt, sizeof(opt)) == SOCKET_ERROR) return -1;
+        // Accept waits in poll() instead, which a drain signal always interrupts
+        fcntl(server_fd, F_SETFL, fcntl(server_fd, F_GETFL, 0) | O_NONBLOCK);
+    }
+#else
+    (void)server_fd;
+#endif
+    return 0;
+}
+
+// Call once listen() succeeded, the supervisor waits for this before rolling on
+void listen_workers_ready() {
+#ifdef __linux__
+    if (listen_workers.ready_fd >= 0) {
+        char byte = 1;
+        if (write(listen_workers.ready_fd, &byte, 1) != 1) perror("Ready notification");
+        close(listen_workers.ready_fd);
+        listen_workers.ready_fd = -1;
+    }
+#endif
+}
+
+// SIGINT and SIGTERM drain a plain process the way they drain a worker, so the
+// module leaves its accept loop and runs its cleanup. Call after listen().
+void listen_workers_drain_on_signal(SOCKET server_fd) {
+#ifdef __linux__
+    if (listen_workers.count == 0) {
+        listen_workers.drain_on_signal = 1;
+        fcntl(server_fd, F_SETFL, fcntl(server_fd, F_GETFL, 0) | O_NONBLOCK);
+        listen_signal(SIGTERM, listen_on_drain, SA_RESTART);
+        listen_signal(SIGINT, listen_on_drain, SA_RESTART);
+    }
+#else
+    (void)server_fd;
+#endif
+}
+
+// accept() that notices drain requests. Once the connections already queued on
+// this worker's socket have been handed out it returns INVALID_SOCKET with
+// listen_workers.drained set; the caller then leaves its loop and closes the socket.
+SOCKET listen_workers_accept(SOCKET server_fd, struct sockaddr *address, socklen_t *addrlen) {
+#ifdef __linux__
+    if (listen_workers.count > 0 || listen_workers.drain_on_signal) {
+        while (1) {
+            SOCKET s = accept(server_fd, address, addrlen);
+            if (s != INVALID_SOCKET) {
+                fcntl(s, F_SETFL, fcntl(s, F_GETFL, 0) & ~O_NONBLOCK);
+                return s;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) return INVALID_SOCKET;
+            if (listen_workers.draining) {
+                listen_workers.drained = 1;
+                return INVALID_SOCKET;
+            }
+            struct pollfd p = {server_fd, POLLIN, 0};
+            poll(&p, 1, LISTEN_POLL_MS);
+        }
+    }
+#endif
+    return accept(server_fd, address, addrlen);
+}
+
+#endif
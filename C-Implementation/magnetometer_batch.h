@@ -0,0 +1,190 @@
+#ifndef MAGNETOMETER_BATCH_H
+#define MAGNETOMETER_BATCH_H
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include "magnetic_sensor.h"
+
+// Batched 3D magnetometer processing over structure-of-arrays x/y/z buffers.
+// One batch is typically one 100 Hz tick across many suits (index = suit slot),
+// so every loop below is a straight-line pass the compiler can vectorize.
+#define MAG_RATE_HZ 100
+#define GAUSS_TO_UT 100.0f  // 1 Gauss = 100 μT
+#define MAG_ROUND_MAGIC 12582912.0f  // 1.5 * 2^23, rounds floats to nearest integer
+
+typedef struct {
+    float *x;
+    float *y;
+    float *z;
+    int count;
+} MagVectors;
+
+// Per-suit hard-iron offset and soft-iron matrix: calibrated = S * (raw - offset)
+typedef struct {
+    float *off_x, *off_y, *off_z;
+    float *s[9];  // Row-major 3x3, one array per element
+    int count;
+} MagCalibration;
+
+typedef struct {
+    float *magnitude;  // Gauss
+    float *heading;  // Degrees from magnetic north, sensor held level
+    int count;
+} MagOutputs;
+
+int mag_vectors_init(MagVectors *v, int count) {
+    v->x = calloc(count, sizeof(float));
+    v->y = calloc(count, sizeof(float));
+    v->z = calloc(count, sizeof(float));
+    v->count = count;
+    return (v->x && v->y && v->z) ? 0 : -1;
+}
+
+void mag_vectors_free(MagVectors *v) {
+    free(v->x);
+    free(v->y);
+    free(v->z);
+    memset(v, 0, sizeof(*v));
+}
+
+// Identity calibration for every suit
+int mag_calibration_init(MagCalibration *cal, int count) {
+    cal->off_x = calloc(count, sizeof(float));
+    cal->off_y = calloc(count, sizeof(float));
+    cal->off_z = calloc(count, sizeof(float));
+    if (!cal->off_x || !cal->off_y || !cal->off_z) return -1;
+    for (int k = 0; k < 9; k++) {
+        cal->s[k] = calloc(count, sizeof(float));
+        if (cal->s[k] == NULL) return -1;
+    }
+    for (int i = 0; i < count; i++) {
+        cal->s[0][i] = cal->s[4][i] = cal->s[8][i] = 1.0f;
+    }
+    cal->count = count;
+    return 0;
+}
+
+void mag_calibration_free(MagCalibration *cal) {
+    free(cal->off_x);
+    free(cal->off_y);
+    free(cal->off_z);
+    for (int k = 0; k < 9; k++) free(cal->s[k]);
+    memset(cal, 0, sizeof(*cal));
+}
+
+void mag_calibration_set(MagCalibration *cal, int i, const float offset[3], const float soft[9]) {
+    cal->off_x[i] = offset[0];
+    cal->off_y[i] = offset[1];
+    cal->off_z[i] = offset[2];
+    for (int k = 0; k < 9; k++) cal->s[k][i] = soft[k];
+}
+
+int mag_outputs_init(MagOutputs *out, int count) {
+    out->magnitude = calloc(count, sizeof(float));
+    out->heading = calloc(count, sizeof(float));
+    out->count = count;
+    return (out->magnitude && out->heading) ? 0 : -1;
+}
+
+void mag_outputs_free(MagOutputs *out) {
+    free(out->magnitude);
+    free(out->heading);
+    memset(out, 0, sizeof(*out));
+}
+
+// Counter-based noise in [-1, 1]: no shared rand() state, so lanes are independent
+static inline float mag_noise(uint32_t seed, uint32_t index) {
+    uint32_t h = seed ^ (index * 0x9e3779b9u);
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35u;
+    h ^= h >> 16;
+    return (float)(int32_t)h * (1.0f / 2147483648.0f);
+}
+
+// One axis of read_3d_magnetometer over a whole array
+static inline void mag_measure_axis(const float *restrict actual, float *restrict measured,
+                                    int n, uint32_t seed) {
+    const float step = MAG3D_RESOLUTION / 1000.0f;  // mGauss to Gauss
+    const float inv_step = 1.0f / step;
+    const float error_scale = 0.1f * MAG3D_ACCURACY / 100.0f;
+
+    for (int i = 0; i < n; i++) {
+        float field = fminf(fmaxf(actual[i], -MAG3D_RANGE), MAG3D_RANGE);
+        field += field * mag_noise(seed, (uint32_t)i) * error_scale;
+        // Round to the resolution step without calling round()
+        float steps = (field * inv_step + MAG_ROUND_MAGIC) - MAG_ROUND_MAGIC;
+        measured[i] = steps * step;
+    }
+}
+
+// Range clamping, error injection and quantization for a batch
+void mag_batch_measure(const MagVectors *actual, MagVectors *measured, uint32_t seed) {
+    int n = actual->count;
+    mag_measure_axis(actual->x, measured->x, n, seed * 3u + 0u);
+    mag_measure_axis(actual->y, measured->y, n, seed * 3u + 1u);
+    mag_measure_axis(actual->z, measured->z, n, seed * 3u + 2u);
+}
+
+// Hard/soft-iron correction in place
+void mag_batch_calibrate(MagVectors *v, const MagCalibration *cal) {
+    int n = v->count;
+    float *restrict x = v->x, *restrict y = v->y, *restrict z = v->z;
+
+    for (int i = 0; i < n; i++) {
+        float dx = x[i] - cal->off_x[i];
+        float dy = y[i] - cal->off_y[i];
+        float dz = z[i] - cal->off_z[i];
+        x[i] = cal->s[0][i] * dx + cal->s[1][i] * dy + cal->s[2][i] * dz;
+        y[i] = cal->s[3][i] * dx + cal->s[4][i] * dy + cal->s[5][i] * dz;
+        z[i] = cal->s[6][i] * dx + cal->s[7][i] * dy + cal->s[8][i] * dz;
+    }
+}
+
+// Hard/soft-iron correction in place for a block of samples from one suit: the
+// suit's calibration is loaded once and applied across the whole block
+void mag_block_calibrate(MagVectors *v, const MagCalibration *cal, int suit) {
+    int n = v->count;
+    float *restrict x = v->x, *restrict y = v->y, *restrict z = v->z;
+    const float ox = cal->off_x[suit], oy = cal->off_y[suit], oz = cal->off_z[suit];
+    float s[9];
+
+    for (int k = 0; k < 9; k++) s[k] = cal->s[k][suit];
+    for (int i = 0; i < n; i++) {
+        float dx = x[i] - ox;
+        float dy = y[i] - oy;
+        float dz = z[i] - oz;
+        x[i] = s[0] * dx + s[1] * dy + s[2] * dz;
+        y[i] = s[3] * dx + s[4] * dy + s[5] * dz;
+        z[i] = s[6] * dx + s[7] * dy + s[8] * dz;
+    }
+}
+
+// Field magnitude, and heading when requested (atan2 does not vectorize everywhere)
+void mag_batch_derive(const MagVectors *v, MagOutputs *out, int with_heading) {
+    int n = v->count;
+    const float *restrict x = v->x, *restrict y = v->y, *restrict z = v->z;
+
+    for (int i = 0; i < n; i++) {
+        out->magnitude[i] = sqrtf(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]);
+    }
+    if (with_heading) {
+        for (int i = 0; i < n; i++) {
+            float deg = atan2f(-y[i], x[i]) * (180.0f / (float)M_PI);
+            out->heading[i] = (deg < 0.0f) ? deg + 360.0f : deg;
+        }
+    }
+}
+
+// Full stage for one tick: measure, calibrate, derive
+void mag_batch_process(const MagVectors *actual, MagVectors *measured,
+                       const MagCalibration *cal, MagOutputs *out, uint32_t seed) {
+    mag_batch_measure(actual, measured, seed);
+    mag_batch_calibrate(measured, cal);
+    mag_batch_derive(measured, out, 1);
+}
+
+#endif
@@ -0,0 +1,99 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include "magnetometer_batch.h"
+
+// Benchmark for the batched magnetometer stage: one 100 Hz tick across all
+// suits per batch, against the per-sample read_3d_magnetometer path.
+
+#define BENCH_SUITS 5000
+#define BENCH_TICKS 500  // 5 s at 100 Hz
+
+double now_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Suit i sees a field along its own heading, with a per-suit hard-iron offset
+void fill_fields(MagVectors *actual, MagCalibration *cal) {
+    for (int i = 0; i < actual->count; i++) {
+        float heading = (float)(i % 360) * (float)M_PI / 180.0f;
+        float strength = 0.5f + 0.001f * (i % 1000);  // Gauss
+        float offset[3] = {0.02f * (i % 7), -0.01f * (i % 5), 0.005f * (i % 3)};
+        float soft[9] = {1.02f, 0.01f, 0.0f, 0.01f, 0.98f, 0.0f, 0.0f, 0.0f, 1.0f};
+
+        actual->x[i] = strength * cosf(heading);
+        actual->y[i] = -strength * sinf(heading);
+        actual->z[i] = 0.1f;
+        mag_calibration_set(cal, i, offset, soft);
+    }
+}
+
+double bench_batch(MagVectors *actual, MagCalibration *cal, double *checksum) {
+    MagVectors measured;
+    MagOutputs out;
+    mag_vectors_init(&measured, actual->count);
+    mag_outputs_init(&out, actual->count);
+
+    double start = now_seconds();
+    for (int t = 0; t < BENCH_TICKS; t++) {
+        mag_batch_process(actual, &measured, cal, &out, (uint32_t)t);
+        *checksum += out.magnitude[t % actual->count]
+                     + out.heading[t % actual->count] * (float)M_PI / 180.0f * 1e-6;
+    }
+    double elapsed = now_seconds() - start;
+
+    mag_outputs_free(&out);
+    mag_vectors_free(&measured);
+    return elapsed;
+}
+
+double bench_scalar(MagVectors *actual, MagCalibration *cal, double *checksum) {
+    double start = now_seconds();
+    for (int t = 0; t < BENCH_TICKS; t++) {
+        for (int i = 0; i < actual->count; i++) {
+            double in[3] = {actual->x[i], actual->y[i], actual->z[i]};
+            double m[3];
+            read_3d_magnetometer(in, m);
+            double dx = m[0] - cal->off_x[i], dy = m[1] - cal->off_y[i], dz = m[2] - cal->off_z[i];
+            double x = cal->s[0][i] * dx + cal->s[1][i] * dy + cal->s[2][i] * dz;
+            double y = cal->s[3][i] * dx + cal->s[4][i] * dy + cal->s[5][i] * dz;
+            double z = cal->s[6][i] * dx + cal->s[7][i] * dy + cal->s[8][i] * dz;
+            double magnitude = sqrt(x * x + y * y + z * z);
+            double heading = atan2(-y, x);
+            if (i == t % actual->count) *checksum += magnitude + heading * 1e-6;
+        }
+    }
+    return now_seconds() - start;
+}
+
+int main() {
+    MagVectors actual;
+    MagCalibration cal;
+    double checksum = 0.0;
+
+    mag_vectors_init(&actual, BENCH_SUITS);
+    mag_calibration_init(&cal, BENCH_SUITS);
+    fill_fields(&actual, &cal);
+
+    printf("Smart Suit - Batched Magnetometer Benchmark\n");
+    printf("-------------------------------------------\n");
+    printf("%d suits x %d ticks (%d Hz)\n", BENCH_SUITS, BENCH_TICKS, MAG_RATE_HZ);
+
+    double samples = (double)BENCH_SUITS * BENCH_TICKS;
+    double batch = bench_batch(&actual, &cal, &checksum);
+    double scalar = bench_scalar(&actual, &cal, &checksum);
+
+    printf("Batched SoA: %6.1f ns/sample, %8.0f suits at %d Hz per core\n",
+           batch * 1e9 / samples, samples / batch / MAG_RATE_HZ, MAG_RATE_HZ);
+    printf("Per sample:  %6.1f ns/sample, %8.0f suits at %d Hz per core\n",
+           scalar * 1e9 / samples, samples / scalar / MAG_RATE_HZ, MAG_RATE_HZ);
+    printf("Speedup: %.1fx (checksum %.3f)\n", scalar / batch, checksum);
+
+    mag_calibration_free(&cal);
+    mag_vectors_free(&actual);
+    return 0;
+}
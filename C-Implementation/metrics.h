@@ -0,0 +1,293 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "net_compat.h"
+
+// Low-overhead process metrics served in Prometheus text format.
+// Every thread writes only to its own cache-line aligned shard, so an update is
+// a relaxed load and store with no lock prefix and no shared cache line.
+// Shards are summed only when the endpoint is scraped.
+//
+// Families must be registered before any thread starts updating them.
+#define METRICS_MAX_THREADS 16  // Threads beyond this share one overflow shard
+#define METRICS_MAX_SLOTS 256  // Counter/gauge series and histogram cells per shard
+#define METRICS_MAX_FAMILIES 32
+#define METRICS_PORT_OFFSET 1000  // Modules serve metrics on their own port + this
+#define METRICS_RENDER_SIZE 32768
+#define METRICS_TIMING_SAMPLE 16  // Per-reading latencies are timed on 1 call in this many
+
+typedef enum {
+    METRIC_COUNTER,
+    METRIC_GAUGE,
+    METRIC_HISTOGRAM
+} MetricType;
+
+// Histogram upper bounds in seconds, the last bucket is +Inf
+#define METRICS_BUCKETS 12
+static const double METRICS_BUCKET_BOUNDS[METRICS_BUCKETS] = {
+    0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005,
+    0.01, 0.025, 0.05, 0.1, 0.25, 1.0
+};
+#define METRICS_HIST_SLOTS (METRICS_BUCKETS + 3)  // Buckets, +Inf, sum (ns), count
+
+typedef struct {
+    const char *name;
+    const char *help;
+    const char *label;  // Label name when width > 1, the label value is the index
+    MetricType type;
+    int width;
+    int base;  // First slot in the shard
+} MetricFamily;
+
+typedef struct {
+    _Alignas(64) _Atomic uint64_t slots[METRICS_MAX_SLOTS];
+} MetricsShard;
+
+// Runs on the server thread before each scrape, to set gauges computed on demand
+typedef void (*MetricsCollector)(void);
+
+// Renders an extra plain-text page, returns the length written
+typedef int (*MetricsPage)(char *buf, size_t size);
+
+typedef struct {
+    MetricFamily families[METRICS_MAX_FAMILIES];
+    int family_count;
+    int slots_used;
+    const char *prefix;  // Module name, e.g. "smartsuit_sensor"
+    MetricsShard shards[METRICS_MAX_THREADS + 1];  // Last one is the shared overflow shard
+    atomic_int shard_count;
+    MetricsCollector collector;
+    const char *page_path;  // e.g. "/profile", served by page instead of the metrics
+    MetricsPage page;
+} MetricsRegistry;
+
+MetricsRegistry metrics;
+static _Thread_local MetricsShard *metrics_tls = NULL;
+static _Thread_local unsigned metrics_timing_tick = 0;
+
+void metrics_init(const char *prefix) {
+    memset(&metrics, 0, sizeof(metrics));
+    metrics.prefix = prefix;
+}
+
+void metrics_set_collector(MetricsCollector collector) {
+    metrics.collector = collector;
+}
+
+void metrics_set_page(const char *path, MetricsPage page) {
+    metrics.page_path = path;
+    metrics.page = page;
+}
+
+// Returns the family ID, or -1 when the registry is full
+int metrics_register(const char *name, const char *help, MetricType type, const char *label, int width) {
+    int slots = (type == METRIC_HISTOGRAM) ? METRICS_HIST_SLOTS : width;
+    if (metrics.family_count >= METRICS_MAX_FAMILIES || metrics.slots_used + slots > METRICS_MAX_SLOTS) {
+        return -1;
+    }
+    MetricFamily *f = &metrics.families[metrics.family_count];
+    f->name = name;
+    f->help = help;
+    f->label = label;
+    f->type = type;
+    f->width = (type == METRIC_HISTOGRAM) ? 1 : width;
+    f->base = metrics.slots_used;
+    metrics.slots_used += slots;
+    return metrics.family_count++;
+}
+
+static MetricsShard *metrics_shard() {
+    if (metrics_tls == NULL) {
+        int i = atomic_fetch_add_explicit(&metrics.shard_count, 1, memory_order_relaxed);
+        metrics_tls = &metrics.shards[i < METRICS_MAX_THREADS ? i : METRICS_MAX_THREADS];
+    }
+    return metrics_tls;
+}
+
+static inline void metrics_slot_add(MetricsShard *shard, int slot, uint64_t n) {
+    _Atomic uint64_t *p = &shard->slots[slot];
+    if (shard == &metrics.shards[METRICS_MAX_THREADS]) {
+        atomic_fetch_add_explicit(p, n, memory_order_relaxed);
+    } else {
+        // Single writer: readers only need the store to be untorn
+        atomic_store_explicit(p, atomic_load_explicit(p, memory_order_relaxed) + n, memory_order_relaxed);
+    }
+}
+
+static inline void metric_add(int family, int index, uint64_t n) {
+    if (family < 0) return;
+    const MetricFamily *f = &metrics.families[family];
+    if (index < 0 || index >= f->width) return;
+    metrics_slot_add(metrics_shard(), f->base + index, n);
+}
+
+static inline void metric_inc(int family, int index) {
+    metric_add(family, index, 1);
+}
+
+// Gauges are summed over threads like counters, set them from one thread only
+static inline void metric_set(int family, int index, uint64_t value) {
+    if (family < 0) return;
+    const MetricFamily *f = &metrics.families[family];
+    if (index < 0 || index >= f->width) return;
+    atomic_store_explicit(&metrics_shard()->slots[f->base + index], value, memory_order_relaxed);
+}
+
+static inline void metric_observe(int family, double seconds) {
+    if (family < 0) return;
+    const MetricFamily *f = &metrics.families[family];
+    MetricsShard *shard = metrics_shard();
+    int bucket = 0;
+    while (bucket < METRICS_BUCKETS && seconds > METRICS_BUCKET_BOUNDS[bucket]) bucket++;
+    metrics_slot_add(shard, f->base + bucket, 1);
+    metrics_slot_add(shard, f->base + METRICS_BUCKETS + 1, (uint64_t)(seconds * 1e9));
+    metrics_slot_add(shard, f->base + METRICS_BUCKETS + 2, 1);
+}
+
+// True on 1 call in METRICS_TIMING_SAMPLE per thread. Reading the clock costs
+// more than the update itself, so per-reading histograms are sampled.
+static inline int metrics_sample_timing() {
+    return (metrics_timing_tick++ % METRICS_TIMING_SAMPLE) == 0;
+}
+
+double metrics_now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static uint64_t metrics_sum_slot(int slot) {
+    uint64_t total = 0;
+    for (int s = 0; s <= METRICS_MAX_THREADS; s++) {
+        total += atomic_load_explicit(&metrics.shards[s].slots[slot], memory_order_relaxed);
+    }
+    return total;
+}
+
+// Aggregate all shards into Prometheus text exposition format.
+// Returns the length written, truncated to fit.
+int metrics_render(char *buf, size_t size) {
+    size_t used = 0;
+#define METRICS_APPEND(...) do { \
+        int w = snprintf(buf + used, size - used, __VA_ARGS__); \
+        if (w < 0 || (size_t)w >= size - used) return (int)used; \
+        used += (size_t)w; \
+    } while (0)
+
+    for (int i = 0; i < metrics.family_count; i++) {
+        const MetricFamily *f = &metrics.families[i];
+        const char *type = f->type == METRIC_COUNTER ? "counter" : f->type == METRIC_GAUGE ? "gauge" : "histogram";
+        METRICS_APPEND("# HELP %s_%s %s\n", metrics.prefix, f->name, f->help);
+        METRICS_APPEND("# TYPE %s_%s %s\n", metrics.prefix, f->name, type);
+
+        if (f->type == METRIC_HISTOGRAM) {
+            uint64_t cumulative = 0;
+            for (int b = 0; b <= METRICS_BUCKETS; b++) {
+                cumulative += metrics_sum_slot(f->base + b);
+                if (b < METRICS_BUCKETS) {
+                    METRICS_APPEND("%s_%s_bucket{le=\"%g\"} %llu\n", metrics.prefix, f->name,
+                                   METRICS_BUCKET_BOUNDS[b], (unsigned long long)cumulative);
+                } else {
+                    METRICS_APPEND("%s_%s_bucket{le=\"+Inf\"} %llu\n", metrics.prefix, f->name,
+                                   (unsigned long long)cumulative);
+                }
+            }
+            METRICS_APPEND("%s_%s_sum %.9f\n", metrics.prefix, f->name,
+                           metrics_sum_slot(f->base + METRICS_BUCKETS + 1) / 1e9);
+            METRICS_APPEND("%s_%s_count %llu\n", metrics.prefix, f->name,
+                           (unsigned long long)metrics_sum_slot(f->base + METRICS_BUCKETS + 2));
+        } else if (f->width == 1) {
+            METRICS_APPEND("%s_%s %llu\n", metrics.prefix, f->name,
+                           (unsigned long long)metrics_sum_slot(f->base));
+        } else {
+            // Labelled families only list the values that have been seen
+            for (int k = 0; k < f->width; k++) {
+                uint64_t v = metrics_sum_slot(f->base + k);
+                if (v == 0) continue;
+                METRICS_APPEND("%s_%s{%s=\"%d\"} %llu\n", metrics.prefix, f->name, f->label, k,
+                               (unsigned long long)v);
+            }
+        }
+    }
+#undef METRICS_APPEND
+    return (int)used;
+}
+
+// Does the request line ask for path?
+static int metrics_requested(const char *request, const char *path) {
+    size_t n = strlen(path);
+    return strncmp(request, "GET ", 4) == 0 && strncmp(request + 4, path, n) == 0 &&
+           (request[4 + n] == ' ' || request[4 + n] == '?');
+}
+
+// Minimal HTTP/1.0 server: the extra page at its path, the current metrics for anything else
+static void *metrics_serve(void *arg) {
+    SOCKET server_fd = (SOCKET)(intptr_t)arg;
+    static char body[METRICS_RENDER_SIZE];
+    char request[1024], header[160];
+
+    while (1) {
+        SOCKET client = accept(server_fd, NULL, NULL);
+        if (client == INVALID_SOCKET) continue;
+
+        int got = recv(client, request, sizeof(request) - 1, 0);
+        request[got > 0 ? got : 0] = '\0';
+        int length;
+        if (metrics.page != NULL && metrics_requested(request, metrics.page_path)) {
+            length = metrics.page(body, sizeof(body));
+        } else {
+            if (metrics.collector != NULL) metrics.collector();
+            length = metrics_render(body, sizeof(body));
+        }
+        int h = snprintf(header, sizeof(header),
+                         "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\n"
+                         "Content-Length: %d\r\nConnection: close\r\n\r\n", length);
+        send(client, header, h, 0);
+        send(client, body, length, 0);
+        closesocket(client);
+    }
+    return NULL;
+}
+
+// Serve /metrics on 127.0.0.1:port from a background thread, returns -1 on failure
+int metrics_start_server(int port) {
+    struct sockaddr_in address;
+    SOCKET server_fd;
+    pthread_t thread;
+    int opt = 1;
+
+    if ((server_fd = socket(AF_INET, SOCK_STREAM, 0)) == INVALID_SOCKET) {
+        printf("Metrics socket creation error: %d\n", WSAGetLastError());
+        return -1;
+    }
+    setsockopt(server_fd, SOL_SOCKET, SO_REUSEADDR, (char*)&opt, sizeof(opt));
+
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+
+    if (bind(server_fd, (struct sockaddr *)&address, sizeof(address)) == SOCKET_ERROR ||
+        listen(server_fd, 3) == SOCKET_ERROR) {
+        printf("Metrics endpoint unavailable on port %d: %d\n", port, WSAGetLastError());
+        closesocket(server_fd);
+        return -1;
+    }
+    if (pthread_create(&thread, NULL, metrics_serve, (void *)(intptr_t)server_fd) != 0) {
+        printf("Metrics thread creation failed\n");
+        closesocket(server_fd);
+        return -1;
+    }
+    pthread_detach(thread);
+    printf("Metrics available at http://127.0.0.1:%d/metrics\n", port);
+    return 0;
+}
+
+#endif
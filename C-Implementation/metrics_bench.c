@@ -0,0 +1,146 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include "sensor_filter.h"
+#include "trend_predictor.h"
+#include "metrics.h"
+
+// Benchmark for the metrics layer: raw update cost per thread against a shared
+// atomic counter, and the overhead on the sensor's per-reading path (filter,
+// trend check and CSV log write) with the updates sensor.c performs per reading:
+// one counter increment, and a timed log write on 1 reading in METRICS_TIMING_SAMPLE.
+
+#define BENCH_UPDATES 50000000L
+#define BENCH_THREADS 4
+#define BENCH_SUITS 10000
+#define BENCH_READINGS 20000  // Per variant
+#define BENCH_ROUND 500  // Readings per A/B round
+#define BENCH_LOG_FILE "metrics_bench.csv"
+
+int metric_readings, metric_log_write;
+_Atomic uint64_t shared_counter;
+
+typedef struct {
+    int shared;
+    double elapsed;
+} ThreadArgs;
+
+static void *update_worker(void *arg) {
+    ThreadArgs *args = arg;
+    long n = BENCH_UPDATES / BENCH_THREADS;
+    double start = metrics_now();
+    if (args->shared) {
+        for (long i = 0; i < n; i++) atomic_fetch_add_explicit(&shared_counter, 1, memory_order_relaxed);
+    } else {
+        for (long i = 0; i < n; i++) metric_inc(metric_readings, (int)(i & 7));
+    }
+    args->elapsed = metrics_now() - start;
+    return NULL;
+}
+
+double run_threads(int shared) {
+    pthread_t threads[BENCH_THREADS];
+    ThreadArgs args[BENCH_THREADS];
+    double start = metrics_now();
+    for (int t = 0; t < BENCH_THREADS; t++) {
+        args[t].shared = shared;
+        pthread_create(&threads[t], NULL, update_worker, &args[t]);
+    }
+    for (int t = 0; t < BENCH_THREADS; t++) pthread_join(threads[t], NULL);
+    return (metrics_now() - start) * 1e9 / BENCH_UPDATES;
+}
+
+// What log_data does for every reading: open, append one line, close
+void write_log(int value) {
+    char timestamp[26];
+    time_t now = time(NULL);
+    strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", localtime(&now));
+    FILE *fp = fopen(BENCH_LOG_FILE, "a");
+    if (fp == NULL) return;
+    fprintf(fp, "%s,%d\n", timestamp, value);
+    fclose(fp);
+}
+
+double run_readings(FilterBank *filters, TrendBank *trends, int instrumented, int count, uint32_t *clock_ms) {
+    TrendPrediction prediction;
+    double start = metrics_now();
+    for (int i = 0; i < count; i++) {
+        int suit = rand() % BENCH_SUITS;
+        int value = 20 + rand() % 10;
+        if (instrumented) metric_inc(metric_readings, 1);
+        FilterOutput out = filter_update(filters, suit, 1, value);
+        trend_check_early_warning(trends, suit, 1, (*clock_ms)++, out.value, 40.0, CROSS_ABOVE, &prediction);
+        if (instrumented && metrics_sample_timing()) {
+            double log_start = metrics_now();
+            write_log(value);
+            metric_observe(metric_log_write, metrics_now() - log_start);
+        } else {
+            write_log(value);
+        }
+    }
+    return metrics_now() - start;
+}
+
+int main() {
+    FilterBank filters;
+    TrendBank trends;
+    uint32_t clock_ms = 0;
+    char page[METRICS_RENDER_SIZE];
+
+    metrics_init("smartsuit_bench");
+    metric_readings = metrics_register("readings_total", "Readings", METRIC_COUNTER, "param", 16);
+    metric_log_write = metrics_register("log_write_seconds", "Log write time", METRIC_HISTOGRAM, NULL, 1);
+
+    printf("Smart Suit - Metrics Overhead Benchmark\n");
+    printf("---------------------------------------\n");
+
+    // Raw update costs
+    double start = metrics_now();
+    for (long i = 0; i < BENCH_UPDATES; i++) metric_inc(metric_readings, (int)(i & 7));
+    double inc_ns = (metrics_now() - start) * 1e9 / BENCH_UPDATES;
+    start = metrics_now();
+    for (long i = 0; i < BENCH_UPDATES / 10; i++) metric_observe(metric_log_write, (i & 1023) * 1e-5);
+    double observe_ns = (metrics_now() - start) * 1e9 / (BENCH_UPDATES / 10);
+    start = metrics_now();
+    double sink = 0.0;
+    for (long i = 0; i < BENCH_UPDATES / 10; i++) sink += metrics_now();
+    double clock_ns = (metrics_now() - start) * 1e9 / (BENCH_UPDATES / 10);
+
+    printf("Counter increment: %.2f ns, histogram observe: %.2f ns, clock read: %.2f ns\n",
+           inc_ns, observe_ns, clock_ns);
+    printf("%d threads: per-thread shards %.2f ns/update, one shared atomic %.2f ns/update\n",
+           BENCH_THREADS, run_threads(0), run_threads(1));
+
+    // Per-reading path, alternating rounds so drift in file system cost hits both variants
+    filter_bank_init(&filters, BENCH_SUITS);
+    trend_bank_init(&trends, BENCH_SUITS);
+    srand(3);
+    double plain = 0.0, instrumented = 0.0;
+    for (int done = 0, round = 0; done < BENCH_READINGS; done += BENCH_ROUND, round++) {
+        // Swap the order every round so neither variant always runs first
+        int first = round & 1;
+        double a = run_readings(&filters, &trends, first, BENCH_ROUND, &clock_ms);
+        double b = run_readings(&filters, &trends, !first, BENCH_ROUND, &clock_ms);
+        plain += first ? b : a;
+        instrumented += first ? a : b;
+    }
+    remove(BENCH_LOG_FILE);
+
+    double per_reading_us = plain * 1e6 / BENCH_READINGS;
+    double added_ns = inc_ns + (observe_ns + 2.0 * clock_ns) / METRICS_TIMING_SAMPLE;
+    printf("Reading path: %.2f us plain, %.2f us instrumented (measured difference %+.2f%%)\n",
+           per_reading_us, instrumented * 1e6 / BENCH_READINGS, (instrumented / plain - 1.0) * 100.0);
+    printf("Metric work per reading: %.1f ns = %.3f%% of the reading path (budget 1%%)\n",
+           added_ns, added_ns / (per_reading_us * 1000.0) * 100.0);
+
+    // Lazy aggregation happens only here
+    start = metrics_now();
+    int length = metrics_render(page, sizeof(page));
+    printf("Scrape render: %d bytes in %.1f us (sink %.0f)\n", length, (metrics_now() - start) * 1e6, sink * 0.0);
+
+    trend_bank_free(&trends);
+    filter_bank_free(&filters);
+    return 0;
+}
@@ -0,0 +1,229 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "net_compat.h"
+#include "alarm_multicast.h"
+
+// Benchmark for multicast alarm fan-out, publisher and subscribers on loopback:
+//  1. publisher cost per alarm and time until every subscriber has it, for 1 to
+//     32 subscribers, against a fresh TCP connection per consumer (the unicast
+//     path control and actuator use)
+//  2. recovery under loss: subscribers drop 5% of everything they receive
+//     (alarms, repairs, heartbeats) once joined; every alarm must arrive exactly once
+//  3. a subscriber joining a running stream delivers only what is sent after it
+//     joined, and NACKs nothing
+
+#define BENCH_GROUP "239.255.70.9:9509"
+#define BENCH_TCP_PORT 9600
+#define BENCH_ALARMS 1000
+#define BENCH_MAX_SUBSCRIBERS 32
+#define BENCH_LOSS_SUBSCRIBERS 4
+#define BENCH_LOSS_ALARMS 20000
+#define BENCH_LOSS_BATCH 50
+#define BENCH_LOSS_PER_MILLE 50
+#define BENCH_JOIN_HISTORY 100  // Alarms sent before the late subscriber joins
+
+AlarmPublisher publisher;
+AlarmSubscriber subscribers[BENCH_MAX_SUBSCRIBERS];
+unsigned char seen[BENCH_LOSS_SUBSCRIBERS][BENCH_LOSS_ALARMS + 1];
+
+double now_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int compare_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Per alarm: publisher time, and time until the last subscriber received it
+void bench_multicast(int count, double *publish_us, double *fanout_us) {
+    static double samples[BENCH_ALARMS];
+    AlarmPacket alarm;
+    double publish = 0.0;
+
+    for (int a = 0; a < BENCH_ALARMS; a++) {
+        double start = now_seconds();
+        alarm_publish(&publisher, a, 2, 25);
+        publish += now_seconds() - start;
+        for (int s = 0; s < count; s++) {
+            while (!alarm_subscriber_poll(&subscribers[s], &alarm, 100)) {}
+        }
+        samples[a] = now_seconds() - start;
+    }
+    qsort(samples, BENCH_ALARMS, sizeof(double), compare_double);
+    *publish_us = publish / BENCH_ALARMS * 1e6;
+    *fanout_us = samples[BENCH_ALARMS / 2] * 1e6;
+}
+
+// The same alarm over a new TCP connection to each of count listeners
+void bench_tcp(int count, SOCKET *listeners, double *publish_us, double *fanout_us) {
+    struct sockaddr_in addr;
+    double publish = 0.0, fanout = 0.0;
+    int alarms = BENCH_ALARMS / 10;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    for (int a = 0; a < alarms; a++) {
+        int data[3] = {2, 25, a};
+        double start = now_seconds();
+        for (int s = 0; s < count; s++) {
+            SOCKET sock = socket(AF_INET, SOCK_STREAM, 0);
+            addr.sin_port = htons(BENCH_TCP_PORT + s);
+            if (connect(sock, (struct sockaddr *)&addr, sizeof(addr)) == 0) {
+                send(sock, (char*)data, sizeof(data), 0);
+            }
+            closesocket(sock);
+        }
+        publish += now_seconds() - start;
+        for (int s = 0; s < count; s++) {
+            SOCKET conn = accept(listeners[s], NULL, NULL);
+            if (conn == INVALID_SOCKET) continue;
+            recv(conn, (char*)data, sizeof(data), 0);
+            closesocket(conn);
+        }
+        fanout += now_seconds() - start;
+    }
+    *publish_us = publish / alarms * 1e6;
+    *fanout_us = fanout / alarms * 1e6;
+}
+
+int main() {
+    WSADATA wsaData;
+    SOCKET listeners[BENCH_MAX_SUBSCRIBERS];
+    AlarmPacket alarm;
+
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+        printf("WSAStartup failed: %d\n", WSAGetLastError());
+        return 1;
+    }
+    printf("Smart Suit - Alarm Multicast Benchmark\n");
+    printf("--------------------------------------\n");
+    if (alarm_publisher_open(&publisher, BENCH_GROUP) != 0) {
+        printf("Cannot open the alarm publisher on %s\n", BENCH_GROUP);
+        return 1;
+    }
+    for (int s = 0; s < BENCH_MAX_SUBSCRIBERS; s++) {
+        struct sockaddr_in addr;
+        int opt = 1;
+        if (alarm_subscriber_open(&subscribers[s], BENCH_GROUP) != 0) {
+            printf("Cannot join %s: %d\n", BENCH_GROUP, WSAGetLastError());
+            return 1;
+        }
+        listeners[s] = socket(AF_INET, SOCK_STREAM, 0);
+        setsockopt(listeners[s], SOL_SOCKET, SO_REUSEADDR, (char*)&opt, sizeof(opt));
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(BENCH_TCP_PORT + s);
+        inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+        if (bind(listeners[s], (struct sockaddr *)&addr, sizeof(addr)) == SOCKET_ERROR ||
+            listen(listeners[s], 16) == SOCKET_ERROR) {
+            printf("Cannot listen on port %d: %d\n", BENCH_TCP_PORT + s, WSAGetLastError());
+            return 1;
+        }
+    }
+
+    // 1. Fan-out cost. Every subscriber socket is joined, so the kernel copies
+    // each datagram to all of them; only the first `count` are read.
+    printf("Fan-out, %d alarms (publisher cost per alarm / until all consumers have it, median):\n",
+           BENCH_ALARMS);
+    printf("  consumers   multicast publish   multicast all   TCP publish   TCP all\n");
+    for (int count = 1; count <= BENCH_MAX_SUBSCRIBERS; count *= 2) {
+        double mc_publish, mc_fanout, tcp_publish, tcp_fanout;
+        bench_multicast(count, &mc_publish, &mc_fanout);
+        for (int s = count; s < BENCH_MAX_SUBSCRIBERS; s++) {
+            while (alarm_subscriber_poll(&subscribers[s], &alarm, 0)) {}
+        }
+        bench_tcp(count, listeners, &tcp_publish, &tcp_fanout);
+        printf("  %9d   %14.1f us   %10.1f us   %8.1f us   %6.1f us\n",
+               count, mc_publish, mc_fanout, tcp_publish, tcp_fanout);
+    }
+    for (int s = 0; s < BENCH_MAX_SUBSCRIBERS; s++) {
+        alarm_subscriber_close(&subscribers[s]);
+        closesocket(listeners[s]);
+    }
+    alarm_publisher_close(&publisher);
+
+    // 2. Loss recovery, a fresh publisher stream so the subscribers start clean
+    printf("\nRecovery: %d alarms in batches of %d, %d subscribers dropping %.1f%% of packets\n",
+           BENCH_LOSS_ALARMS, BENCH_LOSS_BATCH, BENCH_LOSS_SUBSCRIBERS, BENCH_LOSS_PER_MILLE / 10.0);
+    srand(5);
+    alarm_publisher_open(&publisher, BENCH_GROUP);
+    for (int s = 0; s < BENCH_LOSS_SUBSCRIBERS; s++) alarm_subscriber_open(&subscribers[s], BENCH_GROUP);
+    // Subscribers pick the stream up at the first alarm they see, so the losses start after it
+    alarm_publish(&publisher, 0, 4, 17);
+    for (int s = 0; s < BENCH_LOSS_SUBSCRIBERS; s++) {
+        while (!alarm_subscriber_poll(&subscribers[s], &alarm, 100)) {}
+        seen[s][alarm.seq]++;
+        subscribers[s].drop_per_mille = BENCH_LOSS_PER_MILLE;
+    }
+    long twice = 0;
+    int published = 1, tail = 0;
+    double start = now_seconds(), quiet_until = 0.0;
+    while (1) {
+        if (published < BENCH_LOSS_ALARMS) {
+            for (int b = 0; b < BENCH_LOSS_BATCH && published < BENCH_LOSS_ALARMS; b++) {
+                alarm_publish(&publisher, published, 4, 17);
+                published++;
+            }
+            quiet_until = now_seconds() + 0.01;
+        } else if (!tail) {
+            // Tail losses only show once a heartbeat goes out
+            quiet_until = now_seconds() + 3.0 * ALARM_HEARTBEAT_MS / 1000.0;
+            tail = 1;
+        } else {
+            break;
+        }
+        int done = 0;
+        while (!done && now_seconds() < quiet_until) {
+            alarm_publisher_service(&publisher);
+            done = (published == BENCH_LOSS_ALARMS);
+            for (int s = 0; s < BENCH_LOSS_SUBSCRIBERS; s++) {
+                while (alarm_subscriber_poll(&subscribers[s], &alarm, 0)) {
+                    if (seen[s][alarm.seq]++) twice++;
+                }
+                if (subscribers[s].delivered + subscribers[s].lost < BENCH_LOSS_ALARMS) done = 0;
+            }
+            struct timespec pause = {0, 200000};
+            nanosleep(&pause, NULL);
+        }
+        if (done) break;
+    }
+    long missing = 0;
+    for (int s = 0; s < BENCH_LOSS_SUBSCRIBERS; s++) {
+        AlarmSubscriber *sub = &subscribers[s];
+        for (int seq = 1; seq <= BENCH_LOSS_ALARMS; seq++) missing += !seen[s][seq];
+        printf("  subscriber %d: %ld delivered (%ld recovered), %ld duplicates dropped, %ld NACKs, %ld lost\n",
+               s, sub->delivered, sub->repaired, sub->duplicates, sub->nacks, sub->lost);
+        alarm_subscriber_close(sub);
+    }
+    printf("  publisher: %ld NACKs answered, %ld repairs sent, %.2f s\n",
+           publisher.nacks, publisher.repaired, now_seconds() - start);
+    printf("  %ld alarm(s) missing, %ld delivered twice\n", missing, twice);
+    alarm_publisher_close(&publisher);
+
+    // 3. Late join, a fresh stream short enough that all of it is still in the ring
+    AlarmSubscriber *late = &subscribers[0];
+    alarm_publisher_open(&publisher, BENCH_GROUP);
+    for (int a = 0; a < BENCH_JOIN_HISTORY; a++) alarm_publish(&publisher, a, 4, 17);
+    alarm_subscriber_open(late, BENCH_GROUP);
+    uint32_t live = alarm_publish(&publisher, BENCH_JOIN_HISTORY, 4, 17);
+    int historical = 0;
+    double until = now_seconds() + 0.2;
+    while (now_seconds() < until) {
+        alarm_publisher_service(&publisher);
+        if (alarm_subscriber_poll(late, &alarm, 10) && alarm.seq != live) historical++;
+    }
+    printf("\nLate join after %d alarms: %ld delivered, %d historical, %ld NACKs\n",
+           BENCH_JOIN_HISTORY, late->delivered, historical, late->nacks);
+    int late_ok = late->delivered == 1 && historical == 0 && late->nacks == 0;
+    if (!late_ok) printf("  FAIL: a late subscriber must only deliver alarms sent after it joined\n");
+    alarm_subscriber_close(late);
+    alarm_publisher_close(&publisher);
+    WSACleanup();
+    return (missing > 0 || twice > 0 || !late_ok) ? 1 : 0;
+}
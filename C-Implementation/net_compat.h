@@ -0,0 +1,57 @@
+#ifndef NET_COMPAT_H
+#define NET_COMPAT_H
+
+// Socket portability for the modules.
+// They are written against winsock; on other systems the handful of winsock names
+// they use map onto BSD sockets, so the same source builds on Windows (MinGW or
+// MSVC) and on Linux, where the listener workers and the stage profiler run.
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <windows.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "ws2_32.lib")
+#endif
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+typedef int SOCKET;
+typedef struct {
+    int unused;
+} WSADATA;
+
+#define INVALID_SOCKET (-1)
+#define SOCKET_ERROR (-1)
+#define SD_SEND SHUT_WR
+#define WSAEWOULDBLOCK EWOULDBLOCK
+#define WSAEINPROGRESS EINPROGRESS
+#define FIONBIO 1  // Only request ioctlsocket knows
+#define MAKEWORD(low, high) ((unsigned short)(((high) << 8) | (low)))
+#define WSAStartup(version, data) ((void)(version), (void)(data), 0)
+#define WSACleanup() ((void)0)
+#define WSAGetLastError() errno
+#define closesocket close
+
+// Only FIONBIO is used: non-zero *arg makes the socket non-blocking
+static inline int ioctlsocket(SOCKET sock, long request, unsigned long *arg) {
+    int flags = fcntl(sock, F_GETFL, 0);
+    if (request != FIONBIO || flags < 0) return SOCKET_ERROR;
+    return fcntl(sock, F_SETFL, *arg ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK));
+}
+
+static inline void Sleep(unsigned long ms) {
+    struct timespec ts = {(time_t)(ms / 1000), (long)(ms % 1000) * 1000000L};
+    nanosleep(&ts, NULL);
+}
+#endif
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef OXYGEN_SENSOR_H
+#define OXYGEN_SENSOR_H
+
+#include <stdlib.h>
+#include <math.h>
+
+// Galvanic oxygen cell constants (lead anode, diffusion-limited membrane).
+// The cell needs no supply: its output follows the O2 partial pressure, so it
+// rises with temperature through the membrane and falls as the anode is used up.
+#define O2_CELL_SENSITIVITY 0.50  // mV per % O2 at the reference conditions (about 10.5 mV in air)
+#define O2_CELL_OFFSET 0.05  // mV output in nitrogen
+#define O2_CELL_TEMP_COEFF 0.025  // Output change per °C, uncompensated
+#define O2_CELL_REFERENCE_TEMP 20.0  // °C
+#define O2_CELL_REFERENCE_PRESSURE 101.325  // kPa
+#define O2_CELL_LIFE_YEARS 2.0  // Years in air until the output reaches the end-of-life level
+#define O2_CELL_END_OF_LIFE 0.7  // Output relative to a new cell at which it is replaced
+#define O2_CELL_RESPONSE_TIME 15  // T90 response time in seconds
+#define O2_CELL_RESOLUTION 0.1  // % by volume
+
+#define O2_AIR_PERCENT 20.9
+
+// Output of an aged cell relative to a new one, the anode is consumed at a steady rate
+double o2_cell_wear(double years_in_service) {
+    double wear = 1.0 - (1.0 - O2_CELL_END_OF_LIFE) * years_in_service / O2_CELL_LIFE_YEARS;
+    return (wear > 0.05) ? wear : 0.05;
+}
+
+// Function to simulate the cell output in mV
+double o2_cell_output(double o2_percent, double temperature, double pressure_kpa, double years_in_service) {
+    double partial = o2_percent * pressure_kpa / O2_CELL_REFERENCE_PRESSURE;
+    double temp_factor = 1.0 + (temperature - O2_CELL_REFERENCE_TEMP) * O2_CELL_TEMP_COEFF;
+    double signal = O2_CELL_SENSITIVITY * partial * temp_factor * o2_cell_wear(years_in_service);
+
+    // Add random noise
+    double noise = ((rand() % 201) - 100) / 100.0 * O2_CELL_SENSITIVITY * O2_CELL_RESOLUTION;
+
+    return O2_CELL_OFFSET + signal + noise;
+}
+
+// Function to convert the cell output back to % O2, compensating temperature, pressure and age
+double o2_cell_percent(double output_mv, double temperature, double pressure_kpa, double years_in_service) {
+    double temp_factor = 1.0 + (temperature - O2_CELL_REFERENCE_TEMP) * O2_CELL_TEMP_COEFF;
+    double span = O2_CELL_SENSITIVITY * temp_factor * o2_cell_wear(years_in_service);
+    double percent = (output_mv - O2_CELL_OFFSET) / span * O2_CELL_REFERENCE_PRESSURE / pressure_kpa;
+
+    // Apply resolution quantization
+    percent = round(percent / O2_CELL_RESOLUTION) * O2_CELL_RESOLUTION;
+
+    // Ensure non-negative result
+    return (percent > 0) ? percent : 0;
+}
+
+// Returns 1 when a cell this old should be replaced
+int o2_cell_expired(double years_in_service) {
+    return o2_cell_wear(years_in_service) <= O2_CELL_END_OF_LIFE;
+}
+
+#endif
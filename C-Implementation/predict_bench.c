@@ -0,0 +1,118 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include "temperature_sensor.h"
+#include "sensor_filter.h"
+#include "trend_predictor.h"
+
+// Replay benchmark for time-to-threshold prediction on temperature traces.
+// Ramping traces cross TEMP_THRESHOLD, steady traces wander below it;
+// reports detection lead time and false-positive rate.
+
+#define TEMPERATURE 1
+#define TEMP_THRESHOLD 40
+#define BENCH_TRACES 2000  // Per class
+#define BENCH_DURATION_S 900
+#define BENCH_SAMPLE_MS 1000
+#define BENCH_AMBIENT_NOISE 0.3  // °C, uniform half-width
+
+double uniform(double lo, double hi) {
+    return lo + (hi - lo) * (rand() / (double)RAND_MAX);
+}
+
+int compare_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Replays one trace; returns the warning time in seconds or -1
+double replay_trace(FilterBank *filters, TrendBank *trends, int suit,
+                    int ramping, double *crossing_s, long *updates) {
+    double base = ramping ? uniform(22.0, 30.0) : uniform(22.0, 36.0);
+    double onset = uniform(60.0, 300.0);
+    // °C/s, at least fast enough to cross a minute before the trace ends
+    double min_rate = (TEMP_THRESHOLD + 1.0 - base) / (BENCH_DURATION_S - 60.0 - onset);
+    double rate = uniform(fmax(0.01, min_rate), 0.1);
+    double wander = uniform(0.5, 2.0), period = uniform(120.0, 600.0);
+    double warned_at = -1.0;
+
+    *crossing_s = -1.0;
+    for (int ms = 0; ms <= BENCH_DURATION_S * 1000; ms += BENCH_SAMPLE_MS) {
+        double t = ms / 1000.0;
+        double actual;
+        if (ramping) {
+            actual = base + ((t > onset) ? rate * (t - onset) : 0.0);
+        } else {
+            // Stay below the threshold even at the top of the wander
+            actual = fmin(base + wander * sin(2.0 * M_PI * t / period), TEMP_THRESHOLD - 0.5);
+        }
+        actual += uniform(-BENCH_AMBIENT_NOISE, BENCH_AMBIENT_NOISE);
+        if (*crossing_s < 0 && actual > TEMP_THRESHOLD) *crossing_s = t;
+
+        double reading = filter_rtd_reading(filters, suit, read_rtd_temperature(actual, 2), 2);
+        FilterOutput filtered = filter_update(filters, suit, TEMPERATURE, reading);
+        TrendPrediction p;
+        if (trend_check_early_warning(trends, suit, TEMPERATURE, (uint32_t)ms,
+                                      filtered.value, TEMP_THRESHOLD, CROSS_ABOVE, &p)
+            && warned_at < 0) {
+            warned_at = t;
+        }
+        (*updates)++;
+        if (*crossing_s >= 0 && t > *crossing_s + 5) break;
+    }
+    return warned_at;
+}
+
+int main() {
+    FilterBank filters;
+    TrendBank trends;
+    static double leads[BENCH_TRACES];
+    int lead_count = 0, missed = 0, false_positives = 0;
+    long updates = 0;
+
+    filter_bank_init(&filters, 2 * BENCH_TRACES);
+    trend_bank_init(&trends, 2 * BENCH_TRACES);
+    srand(1234);
+
+    printf("Smart Suit - Predictive Alert Replay Benchmark\n");
+    printf("----------------------------------------------\n");
+    printf("Lead time setting: %.0f s, tau %.0f s, %d traces per class\n",
+           trends.lead_time_s, PREDICT_TAU_S, BENCH_TRACES);
+
+    clock_t start = clock();
+    for (int i = 0; i < BENCH_TRACES; i++) {
+        double crossing;
+        double warned = replay_trace(&filters, &trends, i, 1, &crossing, &updates);
+        if (warned >= 0 && warned <= crossing) {
+            leads[lead_count++] = crossing - warned;
+        } else {
+            missed++;
+        }
+    }
+    for (int i = 0; i < BENCH_TRACES; i++) {
+        double crossing;
+        if (replay_trace(&filters, &trends, BENCH_TRACES + i, 0, &crossing, &updates) >= 0) {
+            false_positives++;
+        }
+    }
+    double elapsed = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    qsort(leads, lead_count, sizeof(double), compare_double);
+    double sum = 0;
+    for (int i = 0; i < lead_count; i++) sum += leads[i];
+
+    printf("Crossing traces warned in advance: %d/%d\n", lead_count, BENCH_TRACES);
+    if (lead_count > 0) {
+        printf("Lead time: mean %.1f s, median %.1f s, p10 %.1f s, min %.1f s\n",
+               sum / lead_count, leads[lead_count / 2], leads[lead_count / 10], leads[0]);
+    }
+    printf("Missed (no warning before crossing): %d\n", missed);
+    printf("False-positive rate on steady traces: %.2f%%\n", 100.0 * false_positives / BENCH_TRACES);
+    printf("Cost: %.1f ns per sample (model + filter + prediction)\n", elapsed * 1e9 / updates);
+
+    trend_bank_free(&trends);
+    filter_bank_free(&filters);
+    return 0;
+}
@@ -0,0 +1,149 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <math.h>
+#include "stage_profile.h"
+
+// Benchmark and check for the stage profiler (stage_profile.h):
+//  1. the cost of a mark, and what is left of it after subtraction on an empty stage
+//  2. workloads like the ones suspected on the reading path, each charged to its own
+//     stage: rand(), libm, printf formatting and a cache-missing table walk. With
+//     hardware counters the walk must show the most cache misses per reading.
+// Marks are called directly here, the sensor only gets them with -DSTAGE_PROFILE.
+
+#define BENCH_READINGS 200000
+#define BENCH_EMPTY 100000
+#define BENCH_TABLE (16 * 1024 * 1024)  // Entries, 64 MB: far past the last-level cache
+#define BENCH_EMPTY_MAX_NS 20.0  // Left on an empty stage after subtracting the mark cost,
+#define BENCH_EMPTY_MAX_SHARE 0.25  // or this share of the mark cost when reads are system calls
+
+// Workload per stage slot; the profiler's own stage names do not apply here
+static const struct {
+    int stage;
+    const char *name;
+} bench_stages[] = {
+    {PROFILE_LOOKUP, "rand() x8"},
+    {PROFILE_MODEL, "exp/pow/log"},
+    {PROFILE_REPORT, "snprintf"},
+    {PROFILE_STATE, "table walk"},
+};
+#define BENCH_STAGES (int)(sizeof(bench_stages) / sizeof(bench_stages[0]))
+
+uint32_t *table;
+
+double now_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+double cell_average(int code, int stage, int value) {
+    uint64_t readings = atomic_load(&stage_profile.readings[code]);
+    return readings ? (double)atomic_load(&stage_profile.cells[code][stage].total[value]) / readings : 0.0;
+}
+
+int main() {
+    int failures = 0;
+    char line[160];
+    volatile double sink = 0.0;
+    uint32_t at = 0;
+
+    printf("Smart Suit - Stage Profiler Benchmark\n");
+    printf("-------------------------------------\n");
+
+    table = malloc(sizeof(uint32_t) * BENCH_TABLE);
+    if (table == NULL) {
+        printf("Allocation failed\n");
+        return 1;
+    }
+    // One random cycle through the table, so every step is a dependent miss
+    for (uint32_t i = 0; i < BENCH_TABLE; i++) table[i] = i;
+    for (uint32_t i = BENCH_TABLE - 1; i > 0; i--) {
+        uint32_t j = (uint32_t)(((uint64_t)rand() * RAND_MAX + rand()) % i);
+        uint32_t t = table[i];
+        table[i] = table[j];
+        table[j] = t;
+    }
+
+    int events = profile_init();
+    int counted = stage_profile.leader >= 0;
+    if (counted) {
+        printf("%d hardware counter(s) open\n", events);
+    } else {
+        printf("Hardware counters unavailable (no PMU, or perf_event_paranoid), wall time only\n");
+    }
+
+    // 1. Empty stages: what a mark costs and what subtraction leaves of it
+    double start = now_seconds();
+    for (int i = 0; i < BENCH_EMPTY; i++) {
+        profile_start(0);
+        profile_mark(PROFILE_LOOKUP);
+    }
+    double empty = (now_seconds() - start) / BENCH_EMPTY;
+    double left = cell_average(0, PROFILE_LOOKUP, PROFILE_NANOSECONDS);
+    printf("Mark cost %.0f ns per reading of one stage, measured %llu ns per mark; empty stage left at %.1f ns\n",
+           empty * 1e9, (unsigned long long)stage_profile.overhead.value[PROFILE_NANOSECONDS], left);
+    double allowed = fmax(BENCH_EMPTY_MAX_NS, BENCH_EMPTY_MAX_SHARE * stage_profile.overhead.value[PROFILE_NANOSECONDS]);
+    if (left > allowed) {
+        printf("  FAIL: more than %.0f ns left on an empty stage\n", allowed);
+        failures++;
+    }
+
+    // 2. One reading per iteration, four workloads, charged to code 1
+    start = now_seconds();
+    for (int i = 0; i < BENCH_READINGS; i++) {
+        profile_start(1);
+        int r = 0;
+        for (int k = 0; k < 8; k++) r += rand();
+        profile_mark(bench_stages[0].stage);
+        double x = 1.0 + (r % 1000) / 1000.0;
+        sink += exp(-x) + pow(x, 2.5) + log(x);
+        profile_mark(bench_stages[1].stage);
+        snprintf(line, sizeof(line), "RTD Sensor reading: %.2f°C (raw: %d°C), drift compensated: %.2f°C",
+                 x * 20.0, r % 50, x * 19.9);
+        sink += line[20];
+        profile_mark(bench_stages[2].stage);
+        for (int k = 0; k < 8; k++) at = table[at];
+        profile_mark(bench_stages[3].stage);
+    }
+    double elapsed = now_seconds() - start;
+    sink += at;
+
+    printf("\n%d readings, %.0f ns each with marks (checksum %.1f)\n", BENCH_READINGS,
+           elapsed / BENCH_READINGS * 1e9, (double)sink);
+    printf("  %-12s %10s %10s %11s %12s %8s\n", "workload", "cycles", "instr", "cache-miss", "branch-miss", "ns");
+    int most_misses = 0;
+    for (int s = 0; s < BENCH_STAGES; s++) {
+        int stage = bench_stages[s].stage;
+        char column[PROFILE_EVENTS][16];
+        for (int e = 0; e < PROFILE_EVENTS; e++) {
+            if (stage_profile.slot[e] >= 0) {
+                snprintf(column[e], sizeof(column[e]), "%.1f", cell_average(1, stage, e));
+            } else {
+                strcpy(column[e], "-");
+            }
+        }
+        printf("  %-12s %10s %10s %11s %12s %8.0f\n", bench_stages[s].name, column[PROFILE_CYCLES],
+               column[PROFILE_INSTRUCTIONS], column[PROFILE_CACHE_MISSES], column[PROFILE_BRANCH_MISSES],
+               cell_average(1, stage, PROFILE_NANOSECONDS));
+        if (cell_average(1, stage, PROFILE_CACHE_MISSES) >
+            cell_average(1, bench_stages[most_misses].stage, PROFILE_CACHE_MISSES)) {
+            most_misses = s;
+        }
+    }
+    if (counted && stage_profile.slot[PROFILE_CACHE_MISSES] >= 0) {
+        printf("  most cache misses: %s\n", bench_stages[most_misses].name);
+        if (bench_stages[most_misses].stage != PROFILE_STATE) {
+            printf("  FAIL: expected the table walk\n");
+            failures++;
+        }
+    } else {
+        printf("  cache miss check skipped without the counter\n");
+    }
+
+    profile_free();
+    free(table);
+    return (failures > 0) ? 1 : 0;
+}
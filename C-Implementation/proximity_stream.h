@@ -0,0 +1,208 @@
+#ifndef PROXIMITY_STREAM_H
+#define PROXIMITY_STREAM_H
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include "optical_sensor.h"
+
+// High-rate IR proximity stream for collision warning.
+// Blocks of PROX_BLOCK samples arrive per suit at PROX_RATE_HZ. A 3-tap median
+// removes single-sample IR glitches, a gated alpha-beta tracker estimates
+// distance and closing speed, and time-to-contact is checked on every sample.
+#define PROX_RATE_HZ 1000
+#define PROX_BLOCK 4  // Samples per block (4 ms at 1 kHz)
+#define PROX_DT (1.0f / PROX_RATE_HZ)
+#define PROX_ALPHA 0.25f  // Tracker position gain
+#define PROX_BETA 0.02f  // Tracker velocity gain
+#define PROX_GATE_M 0.05f  // Innovation above this (50 m/s at 1 kHz) is treated as a glitch
+#define PROX_GATE_HOLD 3  // Consecutive gated samples before accepting a new object
+#define PROX_AMBIENT_ALPHA 0.05f  // One-pole ambient-light smoothing
+#define PROX_AMBIENT_MAX 50000.0f  // Lux, above this IR readings are unreliable (direct sun)
+#define PROX_TTC_ALERT_S 0.4f  // Alert when contact is this close in time
+#define PROX_MIN_CLOSING 0.2f  // m/s, ignore slower drift
+#define PROX_REARM_FACTOR 2.0f  // Re-arm when TTC grows past this multiple of the alert level
+#define PROX_LATENCY_BUDGET_MS 5.0  // Sample to control message
+
+// Structure-of-arrays tracker state, index = stream (suit slot)
+typedef struct {
+    int count;
+    float *prev1;  // Last two raw distances, for the median window
+    float *prev2;
+    float *distance;  // Tracked distance, m
+    float *rate;  // Tracked rate of change, m/s (negative = approaching)
+    float *ambient;  // Smoothed ambient light, lux
+    uint8_t *primed;
+    uint8_t *armed;  // Alert may fire
+    uint8_t *outliers;  // Consecutive gated samples
+} ProximityBank;
+
+typedef struct {
+    int stream;
+    int sample;  // Index in the block of the sample that triggered
+    float distance;
+    float closing_speed;  // m/s, positive = approaching
+    float time_to_contact;  // s
+} CollisionAlert;
+
+int proximity_bank_init(ProximityBank *bank, int count) {
+    memset(bank, 0, sizeof(*bank));
+    bank->prev1 = calloc(count, sizeof(float));
+    bank->prev2 = calloc(count, sizeof(float));
+    bank->distance = calloc(count, sizeof(float));
+    bank->rate = calloc(count, sizeof(float));
+    bank->ambient = calloc(count, sizeof(float));
+    bank->primed = calloc(count, 1);
+    bank->armed = calloc(count, 1);
+    bank->outliers = calloc(count, 1);
+    bank->count = count;
+    if (!bank->prev1 || !bank->prev2 || !bank->distance || !bank->rate ||
+        !bank->ambient || !bank->primed || !bank->armed || !bank->outliers) {
+        return -1;
+    }
+    return 0;
+}
+
+void proximity_bank_free(ProximityBank *bank) {
+    free(bank->prev1);
+    free(bank->prev2);
+    free(bank->distance);
+    free(bank->rate);
+    free(bank->ambient);
+    free(bank->primed);
+    free(bank->armed);
+    free(bank->outliers);
+    memset(bank, 0, sizeof(*bank));
+}
+
+void proximity_reset_stream(ProximityBank *bank, int i) {
+    bank->prev1[i] = bank->prev2[i] = PROX_MAX_DISTANCE;
+    bank->distance[i] = PROX_MAX_DISTANCE;
+    bank->rate[i] = 0.0f;
+    bank->ambient[i] = 0.0f;
+    bank->primed[i] = 0;
+    bank->armed[i] = 1;
+    bank->outliers[i] = 0;
+}
+
+static inline float median3(float a, float b, float c) {
+    return fmaxf(fminf(a, b), fminf(fmaxf(a, b), c));
+}
+
+// One sample step for streams [0, n): median, gated tracker and ambient IIR.
+// Every stream is independent and the gating is written as selects, so the
+// loop vectorizes across streams.
+static inline void proximity_step(ProximityBank *bank, const float *restrict dist,
+                                  const float *restrict lux, int n) {
+    float *restrict p1 = bank->prev1, *restrict p2 = bank->prev2;
+    float *restrict d = bank->distance, *restrict r = bank->rate;
+    float *restrict amb = bank->ambient;
+    uint8_t *restrict out = bank->outliers;
+
+    for (int i = 0; i < n; i++) {
+        float raw = fminf(fmaxf(dist[i], PROX_MIN_DISTANCE), PROX_MAX_DISTANCE);
+        float m = median3(raw, p1[i], p2[i]);
+        p2[i] = p1[i];
+        p1[i] = raw;
+
+        float predicted = d[i] + r[i] * PROX_DT;
+        float residual = m - predicted;
+        // Physically impossible jumps are held off; if they persist it is a
+        // new object and the tracker restarts on it
+        int gated = fabsf(residual) > PROX_GATE_M;
+        int count = gated ? out[i] + 1 : 0;
+        int reseed = count >= PROX_GATE_HOLD;
+        float gain = gated ? 0.0f : 1.0f;
+        d[i] = reseed ? m : predicted + gain * PROX_ALPHA * residual;
+        r[i] = reseed ? 0.0f : r[i] + gain * (PROX_BETA / PROX_DT) * residual;
+        out[i] = (uint8_t)(reseed ? 0 : count);
+
+        amb[i] += PROX_AMBIENT_ALPHA * (lux[i] - amb[i]);
+    }
+}
+
+// Time-to-contact check for one stream after a step; returns 1 on a new alert
+static inline int proximity_check(ProximityBank *bank, int i, int sample, CollisionAlert *alert) {
+    float closing = -bank->rate[i];
+    float ttc = (closing > PROX_MIN_CLOSING) ? (bank->distance[i] - PROX_MIN_DISTANCE) / closing : INFINITY;
+
+    // Glare saturates the IR receiver, those readings cannot be trusted
+    if (bank->ambient[i] > PROX_AMBIENT_MAX) return 0;
+
+    if (ttc < PROX_TTC_ALERT_S) {
+        if (bank->armed[i]) {
+            bank->armed[i] = 0;
+            alert->stream = i;
+            alert->sample = sample;
+            alert->distance = bank->distance[i];
+            alert->closing_speed = closing;
+            alert->time_to_contact = ttc;
+            return 1;
+        }
+    } else if (ttc > PROX_TTC_ALERT_S * PROX_REARM_FACTOR) {
+        bank->armed[i] = 1;
+    }
+    return 0;
+}
+
+// Seed new streams from their first sample so the tracker does not start at max range
+static inline void proximity_prime(ProximityBank *bank, const float *dist, int n) {
+    for (int i = 0; i < n; i++) {
+        if (!bank->primed[i]) {
+            float raw = fminf(fmaxf(dist[i], PROX_MIN_DISTANCE), PROX_MAX_DISTANCE);
+            bank->prev1[i] = bank->prev2[i] = bank->distance[i] = raw;
+            bank->rate[i] = 0.0f;
+            bank->armed[i] = 1;
+            bank->outliers[i] = 0;
+            bank->primed[i] = 1;
+        }
+    }
+}
+
+// One block for every stream at once. dist/lux are [PROX_BLOCK][count] sample-major.
+// Returns the number of alerts written (at most max_alerts).
+int proximity_process_tick(ProximityBank *bank, const float *dist, const float *lux,
+                           CollisionAlert *alerts, int max_alerts) {
+    int n = bank->count, raised = 0;
+
+    proximity_prime(bank, dist, n);
+    for (int s = 0; s < PROX_BLOCK; s++) {
+        proximity_step(bank, dist + (size_t)s * n, lux + (size_t)s * n, n);
+        for (int i = 0; i < n; i++) {
+            // Cheap vector-friendly pre-test before the full check
+            if (bank->rate[i] < -PROX_MIN_CLOSING && raised < max_alerts &&
+                proximity_check(bank, i, s, &alerts[raised])) {
+                raised++;
+            } else if (bank->rate[i] >= -PROX_MIN_CLOSING) {
+                bank->armed[i] = 1;
+            }
+        }
+    }
+    return raised;
+}
+
+// One stream's block, as the sensor module receives it per suit.
+// Returns 1 and fills alert on the first new alert in the block.
+int proximity_process_stream(ProximityBank *bank, int i, const float *dist, const float *lux,
+                             int samples, CollisionAlert *alert) {
+    ProximityBank one = *bank;
+    int raised = 0;
+
+    // Narrow the bank to a single stream so the same step code runs
+    one.prev1 += i; one.prev2 += i; one.distance += i; one.rate += i;
+    one.ambient += i; one.primed += i; one.armed += i; one.outliers += i;
+    one.count = 1;
+
+    proximity_prime(&one, dist, 1);
+    for (int s = 0; s < samples; s++) {
+        proximity_step(&one, dist + s, lux + s, 1);
+        if (!raised && proximity_check(&one, 0, s, alert)) {
+            alert->stream = i;
+            raised = 1;
+        }
+    }
+    return raised;
+}
+
+#endif
@@ -0,0 +1,280 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "net_compat.h"
+#include "traffic_capture.h"
+
+// Replay of captured module traffic (traffic_capture.h).
+//
+//   replay <capture> [speed] [port]
+//     Sends every captured connection to the module again: speed 1 keeps the
+//     original pacing, 2 plays twice as fast, 0 as fast as possible. The port
+//     defaults to the one the capture was taken on. Reports throughput and
+//     per-connection latency; exits 1 if a connection failed. A sensor started
+//     with REPLAY_CLOCK=<capture> takes its time from the capture, so holds,
+//     trends and deadlines behave as they did when it was recorded.
+//
+//   replay --compare <expected> <actual>
+//     Compares the messages of two captures, timing aside, and exits 1 on the
+//     first difference. Capturing control while replaying into a sensor started
+//     with the original NOISE_SEED gives a regression test of the sensor.
+#define REPLAY_DRAIN_MS 5000  // Wait for the module to answer and close
+#define REPLAY_MAX_DIFFS 10
+
+typedef struct {
+    SOCKET sock;
+    double opened;
+    double *latency;  // Seconds from connect to the module closing, per connection
+    long connections;
+    long capacity;
+    long failures;
+    long bytes;
+    double max_lag;  // Furthest behind the capture's pacing
+} ReplayStats;
+
+double now_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int compare_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+FILE *open_capture(const char *path, CaptureHeader *header) {
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        printf("Cannot open %s\n", path);
+        return NULL;
+    }
+    if (capture_read_header(file, header) != 0) {
+        printf("%s is not a capture file\n", path);
+        fclose(file);
+        return NULL;
+    }
+    return file;
+}
+
+SOCKET connect_module(int port) {
+    struct sockaddr_in serv_addr;
+    SOCKET sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (sock == INVALID_SOCKET) return INVALID_SOCKET;
+    serv_addr.sin_family = AF_INET;
+    serv_addr.sin_port = htons(port);
+    inet_pton(AF_INET, "127.0.0.1", &serv_addr.sin_addr);
+    if (connect(sock, (struct sockaddr *)&serv_addr, sizeof(serv_addr)) < 0) {
+        closesocket(sock);
+        return INVALID_SOCKET;
+    }
+    return sock;
+}
+
+// Signal the end of the message, read whatever the module answers until it closes
+void finish_connection(ReplayStats *stats) {
+    char answer[256];
+    if (stats->sock == INVALID_SOCKET) return;
+    shutdown(stats->sock, SD_SEND);
+    while (1) {
+        fd_set readable;
+        struct timeval wait = {REPLAY_DRAIN_MS / 1000, (REPLAY_DRAIN_MS % 1000) * 1000};
+        FD_ZERO(&readable);
+        FD_SET(stats->sock, &readable);
+        if (select((int)stats->sock + 1, &readable, NULL, NULL, &wait) <= 0) {
+            stats->failures++;  // Module hung on the message
+            break;
+        }
+        if (recv(stats->sock, answer, sizeof(answer), 0) <= 0) break;
+    }
+    closesocket(stats->sock);
+    stats->sock = INVALID_SOCKET;
+
+    if (stats->connections == stats->capacity) {
+        stats->capacity = stats->capacity ? stats->capacity * 2 : 4096;
+        stats->latency = realloc(stats->latency, stats->capacity * sizeof(double));
+    }
+    stats->latency[stats->connections++] = now_seconds() - stats->opened;
+}
+
+int replay(const char *path, double speed, int port) {
+    static char data[UINT16_MAX + 1];
+    CaptureHeader header;
+    CaptureRecord record;
+    ReplayStats stats;
+    int status;
+
+    FILE *file = open_capture(path, &header);
+    if (file == NULL) return 1;
+    if (port <= 0) port = header.port;
+    memset(&stats, 0, sizeof(stats));
+    stats.sock = INVALID_SOCKET;
+
+    printf("Replaying %s to port %d, %s\n", path, port, (speed > 0.0) ? "paced" : "as fast as possible");
+    if (header.start_us != 0) {
+        time_t started = (time_t)(header.start_us / 1000000);
+        char when[32];
+        strftime(when, sizeof(when), "%Y-%m-%d %H:%M:%S", localtime(&started));
+        printf("Captured from %s: start the module with %s=%s for the original timing\n",
+               when, REPLAY_CLOCK_ENV, path);
+    }
+    if (header.seed != 0) printf("Captured with noise seed %u: start the module with %s=%u\n",
+                                 header.seed, NOISE_SEED_ENV, header.seed);
+
+    double start = now_seconds(), schedule = 0.0;
+    int skipping = 0;  // Rest of a connection that could not be opened
+    while ((status = capture_read_record(file, &record, data)) > 0) {
+        if (speed > 0.0) {
+            schedule += record.delta_us / 1e6 / speed;
+            double wait = start + schedule - now_seconds();
+            if (wait > 0.0) {
+                struct timespec pause = {(time_t)wait, (long)((wait - (time_t)wait) * 1e9)};
+                nanosleep(&pause, NULL);
+            } else if (-wait > stats.max_lag) {
+                stats.max_lag = -wait;
+            }
+        }
+        if (record.flags & CAPTURE_FIRST) {
+            finish_connection(&stats);
+            stats.opened = now_seconds();
+            stats.sock = connect_module(port);
+            skipping = (stats.sock == INVALID_SOCKET);
+            if (skipping) stats.failures++;
+        }
+        if (skipping || stats.sock == INVALID_SOCKET) continue;
+        if (send(stats.sock, data, record.length, 0) != record.length) {
+            stats.failures++;
+            closesocket(stats.sock);
+            stats.sock = INVALID_SOCKET;
+            skipping = 1;
+            continue;
+        }
+        stats.bytes += record.length;
+    }
+    finish_connection(&stats);
+    double elapsed = now_seconds() - start;
+    fclose(file);
+    if (status < 0) printf("Capture ends in a torn record, replayed up to it\n");
+
+    printf("%ld connection(s), %ld bytes in %.3f s: %.0f messages/s, %.2f MB/s, %ld failure(s)\n",
+           stats.connections, stats.bytes, elapsed, stats.connections / elapsed,
+           stats.bytes / elapsed / 1e6, stats.failures);
+    if (stats.connections > 0) {
+        qsort(stats.latency, stats.connections, sizeof(double), compare_double);
+        printf("Latency p50 %.3f ms, p99 %.3f ms, max %.3f ms",
+               stats.latency[stats.connections / 2] * 1000.0,
+               stats.latency[stats.connections * 99 / 100] * 1000.0,
+               stats.latency[stats.connections - 1] * 1000.0);
+        if (speed > 0.0) printf(", fell behind the capture by up to %.3f ms", stats.max_lag * 1000.0);
+        printf("\n");
+    }
+    free(stats.latency);
+    return (stats.failures > 0) ? 1 : 0;
+}
+
+// Next whole message (all the records of one connection), its length or -1 at the end
+typedef struct {
+    FILE *file;
+    CaptureRecord record;
+    char data[UINT16_MAX + 1];
+    int have;  // record/data hold the first record of the next message
+    int torn;
+} MessageReader;
+
+long next_message(MessageReader *r, char **message, long *capacity) {
+    long length = 0;
+    if (!r->have) {
+        int status = capture_read_record(r->file, &r->record, r->data);
+        if (status <= 0) {
+            r->torn |= (status < 0);
+            return -1;
+        }
+    }
+    do {
+        if (length + r->record.length > *capacity) {
+            *capacity = (length + r->record.length) * 2;
+            *message = realloc(*message, *capacity);
+        }
+        memcpy(*message + length, r->data, r->record.length);
+        length += r->record.length;
+        int status = capture_read_record(r->file, &r->record, r->data);
+        r->have = (status > 0);
+        r->torn |= (status < 0);
+    } while (r->have && !(r->record.flags & CAPTURE_FIRST));
+    return length;
+}
+
+void print_message(const char *label, const char *message, long length) {
+    printf("  %s (%ld bytes):", label, length);
+    for (long i = 0; i + (long)sizeof(int) <= length && i < 3 * (long)sizeof(int); i += sizeof(int)) {
+        int word;
+        memcpy(&word, message + i, sizeof(word));
+        printf(" %d", word);
+    }
+    printf("%s\n", (length > 3 * (long)sizeof(int)) ? " ..." : "");
+}
+
+int compare(const char *expected_path, const char *actual_path) {
+    static MessageReader expected, actual;
+    CaptureHeader header;
+    char *a = NULL, *b = NULL;
+    long a_capacity = 0, b_capacity = 0, messages = 0, diffs = 0;
+
+    if ((expected.file = open_capture(expected_path, &header)) == NULL) return 1;
+    if ((actual.file = open_capture(actual_path, &header)) == NULL) return 1;
+    while (1) {
+        long a_length = next_message(&expected, &a, &a_capacity);
+        long b_length = next_message(&actual, &b, &b_capacity);
+        if (a_length < 0 && b_length < 0) break;
+        if (a_length < 0 || b_length < 0) {
+            printf("%s has %s messages than %s after message %ld\n", actual_path,
+                   (a_length < 0) ? "more" : "fewer", expected_path, messages);
+            diffs++;
+            break;
+        }
+        if (a_length != b_length || memcmp(a, b, a_length) != 0) {
+            if (diffs < REPLAY_MAX_DIFFS) {
+                printf("Message %ld differs:\n", messages);
+                print_message("expected", a, a_length);
+                print_message("actual  ", b, b_length);
+            }
+            diffs++;
+        }
+        messages++;
+    }
+    if (expected.torn || actual.torn) printf("Torn record at the end of a capture, compared up to it\n");
+    printf("%ld message(s) compared, %ld difference(s)\n", messages, diffs);
+    fclose(expected.file);
+    fclose(actual.file);
+    free(a);
+    free(b);
+    return (diffs > 0) ? 1 : 0;
+}
+
+int main(int argc, char *argv[]) {
+    WSADATA wsaData;
+
+    if (argc == 4 && strcmp(argv[1], "--compare") == 0) {
+        return compare(argv[2], argv[3]);
+    }
+    if (argc < 2) {
+        printf("Usage: replay <capture> [speed, 0 = as fast as possible] [port]\n");
+        printf("       replay --compare <expected capture> <actual capture>\n");
+        return 1;
+    }
+    double speed = (argc > 2) ? atof(argv[2]) : 1.0;
+    int port = (argc > 3) ? atoi(argv[3]) : 0;
+    if (speed < 0.0 || port < 0 || port > 65535) {
+        printf("Invalid speed or port\n");
+        return 1;
+    }
+
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+        printf("WSAStartup failed: %d\n", WSAGetLastError());
+        return 1;
+    }
+    int result = replay(argv[1], speed, port);
+    WSACleanup();
+    return result;
+}
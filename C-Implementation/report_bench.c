@@ -0,0 +1,145 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "report_policy.h"
+#include "sensor_filter.h"
+
+// Benchmark for deadband and adaptive-rate reporting, in simulated time:
+//  1. messages per parameter over a steady shift, full rate versus the policy
+//  2. alarm latency on ramps and steps across each threshold, measured at the
+//     sensor's filter output, full rate versus the policy with held-value replay
+
+#define BENCH_SUITS 1000
+#define BENCH_SHIFT_S 3600
+#define BENCH_TRIALS 200
+#define BENCH_RAMP_S 120  // Nominal to threshold
+#define BENCH_TIMEOUT_MS 120000  // Give up on an alarm after this
+
+const char *names[REPORT_CHANNELS] = {"Temperature", "Radiation", "Chemical", "Oxygen",
+                                      "Noise", "Voltage", "Magnetic", "Proximity"};
+// Same plant levels and sensor noise as the environment's shift simulation
+const double nominal[REPORT_CHANNELS] = {25.0, 1.0, 5.0, 20.9, 70.0, 50.0, 60.0, 200.0};
+const double noise[REPORT_CHANNELS] = {0.3, 1.0, 0.5, 0.2, 2.0, 10.0, 1.4, 1.0};
+
+uint32_t rng = 12345;
+
+double uniform() {
+    rng = rng * 1664525u + 1013904223u;
+    return ((rng >> 8) + 0.5) / 16777216.0;
+}
+
+double gaussian() {
+    return sqrt(-2.0 * log(uniform())) * cos(2.0 * M_PI * uniform());
+}
+
+// True level of a trial: flat at nominal, then a ramp or step that crosses the threshold at cross_ms
+double true_level(int c, int step, uint32_t t_ms, uint32_t cross_ms) {
+    const ReportPolicy *p = &report_policies[c];
+    double target = p->threshold + (p->direction == REPORT_ABOVE ? 1 : -1) * p->approach;
+    if (step) return (t_ms < cross_ms) ? nominal[c] : target;
+    double ramp_start = cross_ms - BENCH_RAMP_S * 1000.0;
+    if (t_ms < ramp_start) return nominal[c];
+    double slope = (p->threshold - nominal[c]) / (BENCH_RAMP_S * 1000.0);
+    double v = nominal[c] + slope * (t_ms - ramp_start);
+    return (p->direction == REPORT_ABOVE) ? fmin(v, target) : fmax(v, target);
+}
+
+int alarmed(const ReportPolicy *p, double filtered) {
+    return (p->direction == REPORT_ABOVE) ? filtered > p->threshold : filtered < p->threshold;
+}
+
+// Milliseconds from the true crossing until the sensor's filtered value alarms. messages
+// counts what was sent from the start of the ramp or step until then, not the run-up.
+double alarm_latency(int c, int step, int use_policy, long *messages) {
+    FilterBank filters;
+    HoldBank holds;
+    ReportChannel channel;
+    const ReportPolicy *p = &report_policies[c];
+    uint32_t cross_ms = 200000 + (uint32_t)(uniform() * 1000.0);  // Phase against the sample clock
+    double latency = -1.0;
+
+    filter_bank_init(&filters, 1);
+    hold_bank_init(&holds, 1);
+    memset(&channel, 0, sizeof(channel));
+    for (uint32_t t = 1000; t < cross_ms + BENCH_TIMEOUT_MS;) {
+        int value = (int)lround(true_level(c, step, t, cross_ms) + noise[c] * gaussian());
+        int report = !use_policy || report_decide(p, &channel, value, t) != REPORT_NONE;
+        if (report) {
+            if (true_level(c, step, t, cross_ms) != nominal[c]) (*messages)++;
+            if (use_policy) {
+                double held;
+                int missed = hold_advance(&holds, 0, c + 1, value, t, &held);
+                if (missed > 0) filter_hold(&filters, 0, c + 1, held, missed);
+            }
+            FilterOutput out = filter_update(&filters, 0, c + 1, value);
+            if (t >= cross_ms && alarmed(p, out.value)) {
+                latency = t - cross_ms;
+                break;
+            }
+        }
+        t += use_policy ? (uint32_t)report_sample_ms(p, value) : REPORT_SAMPLE_MS;
+    }
+    filter_bank_free(&filters);
+    hold_bank_free(&holds);
+    return latency;
+}
+
+int main() {
+    printf("Smart Suit - Deadband Reporting Benchmark\n");
+    printf("-----------------------------------------\n");
+    printf("Sampling every %d ms (%d ms near thresholds), heartbeat %d s\n",
+           REPORT_SAMPLE_MS, REPORT_FAST_SAMPLE_MS, REPORT_MAX_SILENCE_MS / 1000);
+
+    // Steady shift
+    printf("\nSteady state: %d suits, %d s, messages per suit and hour\n", BENCH_SUITS, BENCH_SHIFT_S);
+    long full_total = 0, sent_total = 0;
+    for (int c = 0; c < REPORT_CHANNELS; c++) {
+        long full = 0, sent = 0, heartbeats = 0;
+        for (int s = 0; s < BENCH_SUITS; s++) {
+            ReportChannel channel;
+            double level = nominal[c];
+            memset(&channel, 0, sizeof(channel));
+            for (uint32_t t = 1000; t < 1000 + BENCH_SHIFT_S * 1000u;) {
+                level += noise[c] * 0.05 * gaussian() - 0.01 * (level - nominal[c]);
+                int value = (int)lround(level + noise[c] * gaussian());
+                ReportReason reason = report_decide(&report_policies[c], &channel, value, t);
+                if (reason != REPORT_NONE) sent++;
+                if (reason == REPORT_HEARTBEAT) heartbeats++;
+                full++;
+                t += report_sample_ms(&report_policies[c], value);
+            }
+        }
+        full_total += full;
+        sent_total += sent;
+        printf("  %-12s full rate %6.0f, deadband %6.1f (%4.1f heartbeats), %5.1fx fewer\n", names[c],
+               (double)full / BENCH_SUITS, (double)sent / BENCH_SUITS, (double)heartbeats / BENCH_SUITS,
+               (double)full / sent);
+    }
+    printf("  All          %.1fx fewer messages and readings processed\n", (double)full_total / sent_total);
+
+    // Alarm latency
+    for (int step = 0; step <= 1; step++) {
+        printf("\nAlarm latency, %s, mean of %d trials (ms after the true crossing)\n",
+               step ? "step past the threshold" : "120 s ramp to the threshold", BENCH_TRIALS);
+        for (int c = 0; c < REPORT_CHANNELS; c++) {
+            double full_sum = 0.0, policy_sum = 0.0;
+            long full_messages = 0, policy_messages = 0, missed = 0;
+            for (int i = 0; i < BENCH_TRIALS; i++) {
+                double full = alarm_latency(c, step, 0, &full_messages);
+                double policy = alarm_latency(c, step, 1, &policy_messages);
+                if (full < 0.0 || policy < 0.0) {
+                    missed++;
+                    continue;
+                }
+                full_sum += full;
+                policy_sum += policy;
+            }
+            int counted = BENCH_TRIALS - (int)missed;
+            printf("  %-12s full rate %7.0f, deadband %7.0f, %ld missed; messages until the alarm %5.1f vs %5.1f\n",
+                   names[c], counted ? full_sum / counted : 0.0, counted ? policy_sum / counted : 0.0, missed,
+                   (double)full_messages / BENCH_TRIALS, (double)policy_messages / BENCH_TRIALS);
+        }
+    }
+    return 0;
+}
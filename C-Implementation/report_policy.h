@@ -0,0 +1,170 @@
+#ifndef REPORT_POLICY_H
+#define REPORT_POLICY_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+// Deadband and adaptive-rate reporting between suits and the sensor module.
+//
+// Suit side: each parameter is sampled every REPORT_SAMPLE_MS but only reported
+// when it has moved more than its deadband since the last report, or when
+// REPORT_MAX_SILENCE_MS passed without one (heartbeat). Within the approach band
+// of the alarm threshold, or past it, the suit samples every REPORT_FAST_SAMPLE_MS
+// and reports every sample, so alarms are seen at least as soon as with full-rate
+// reporting. A suit that has sent nothing for REPORT_KEEPALIVE_MS sends a
+// heartbeat, so the sensor can tell a quiet suit from one that went silent.
+//
+// Sensor side: the last report holds until the next one. When a report arrives
+// after a gap, the held value is replayed for the sample periods in between so
+// the per-suit filter ends up where full-rate reporting would have left it.
+#define REPORT_CHANNELS 8  // Parameter codes 1-8
+#define REPORT_SAMPLE_MS 1000  // Suit sampling period away from thresholds
+#define REPORT_FAST_SAMPLE_MS 250  // Within the approach band
+#define REPORT_MAX_SILENCE_MS 30000  // Heartbeat, must stay below the sensor's silent-suit limit
+#define REPORT_KEEPALIVE_MS 1500  // Suit heartbeat while none of its parameters is reported
+#define REPORT_DEADMAN_MS 5000  // Silence after which the sensor raises man-down for the suit
+#define REPORT_MAX_REPLAY (REPORT_MAX_SILENCE_MS / REPORT_SAMPLE_MS)  // Held samples replayed at most
+#define REPORT_DEADBAND_ENV "REPORT_DEADBAND"  // Overrides, e.g. "1:0.5,4:0.2" (code:deadband)
+
+#define REPORT_ABOVE 0  // Alarm when the value exceeds the threshold
+#define REPORT_BELOW 1  // Alarm when the value falls under it
+
+// Why a sample was reported
+typedef enum {
+    REPORT_NONE,
+    REPORT_FIRST,
+    REPORT_CHANGED,  // Moved past the deadband
+    REPORT_HEARTBEAT,  // Max silence reached
+    REPORT_APPROACH,  // In the approach band or beyond the threshold
+    REPORT_REASONS
+} ReportReason;
+
+typedef struct {
+    double deadband;  // Same units as the reading; 0 reports every sample
+    double threshold;  // Alarm threshold, mirrors the sensor module
+    int direction;
+    double approach;  // Band before the threshold with fast sampling and no deadband
+} ReportPolicy;
+
+// Deadbands are about three times each sensor's noise (sqrt of the filter's
+// measurement noise), so noise alone rarely triggers a report.
+ReportPolicy report_policies[REPORT_CHANNELS] = {
+    {1.0, 40.0, REPORT_ABOVE, 4.0},  // Temperature, °C
+    {6.0, 20.0, REPORT_ABOVE, 8.0},  // Radiation, μSv/h
+    {2.0, 50.0, REPORT_ABOVE, 10.0},  // Chemical, ppm
+    {0.5, 19.0, REPORT_BELOW, 1.0},  // Oxygen, %
+    {6.0, 85.0, REPORT_ABOVE, 8.0},  // Noise, dB
+    {30.0, 500.0, REPORT_ABOVE, 100.0},  // Voltage, V/m
+    {5.0, 500.0, REPORT_ABOVE, 50.0},  // Magnetic, μT
+    {3.0, 50.0, REPORT_BELOW, 30.0}  // Proximity, cm
+};
+
+// Suit-side state of one parameter
+typedef struct {
+    double last_value;  // Last value reported
+    uint32_t last_ms;  // When it was reported
+    int started;
+} ReportChannel;
+
+// Apply REPORT_DEADBAND overrides; returns how many were applied, or -1 on a malformed entry
+int report_policy_configure(const char *spec) {
+    int applied = 0;
+    if (spec == NULL) return 0;
+    while (*spec) {
+        char *end;
+        long code = strtol(spec, &end, 10);
+        if (end == spec || *end != ':' || code < 1 || code > REPORT_CHANNELS) return -1;
+        spec = end + 1;
+        double deadband = strtod(spec, &end);
+        if (end == spec || deadband < 0.0) return -1;
+        report_policies[code - 1].deadband = deadband;
+        applied++;
+        spec = end;
+        if (*spec == ',') spec++;
+    }
+    return applied;
+}
+
+// Distance left before the alarm threshold, negative once past it
+static inline double report_margin(const ReportPolicy *p, double value) {
+    return (p->direction == REPORT_ABOVE) ? p->threshold - value : value - p->threshold;
+}
+
+// Sampling period for the next sample of this parameter
+int report_sample_ms(const ReportPolicy *p, double value) {
+    return (report_margin(p, value) <= p->approach) ? REPORT_FAST_SAMPLE_MS : REPORT_SAMPLE_MS;
+}
+
+// Decide whether a sample is reported, and if so make it the new held value
+ReportReason report_decide(const ReportPolicy *p, ReportChannel *c, double value, uint32_t now_ms) {
+    ReportReason reason = REPORT_NONE;
+    if (!c->started) {
+        reason = REPORT_FIRST;
+    } else if (report_margin(p, value) <= p->approach || report_margin(p, c->last_value) <= 0.0) {
+        // Near or past the threshold, and once more on the way back so the alarm clears
+        reason = REPORT_APPROACH;
+    } else if (fabs(value - c->last_value) > p->deadband) {
+        reason = REPORT_CHANGED;
+    } else if ((uint32_t)(now_ms - c->last_ms) >= REPORT_MAX_SILENCE_MS) {
+        reason = REPORT_HEARTBEAT;
+    }
+    if (reason != REPORT_NONE) {
+        c->last_value = value;
+        c->last_ms = now_ms;
+        c->started = 1;
+    }
+    return reason;
+}
+
+// ---- Sensor side: held values between reports ----
+
+// Processed value of the latest report, 8 bytes
+typedef struct {
+    float value;
+    uint32_t reported_ms;  // 0 = nothing held yet
+} HeldValue;
+
+typedef struct {
+    HeldValue channel[REPORT_CHANNELS];
+} SuitHolds;
+
+typedef struct {
+    SuitHolds *suits;  // Indexed by suit ID
+    int suit_count;
+} HoldBank;
+
+int hold_bank_init(HoldBank *bank, int suit_count) {
+    bank->suits = calloc((size_t)suit_count, sizeof(SuitHolds));
+    bank->suit_count = (bank->suits != NULL) ? suit_count : 0;
+    return (bank->suits != NULL) ? 0 : -1;
+}
+
+void hold_bank_free(HoldBank *bank) {
+    free(bank->suits);
+    bank->suits = NULL;
+    bank->suit_count = 0;
+}
+
+// Record a report. Returns how many sample periods the previous value was held
+// for before it (0 when reports arrive at the sampling rate), with that value in *held.
+int hold_advance(HoldBank *bank, int suit_id, int param_code, double value, uint32_t now_ms, double *held) {
+    if (suit_id < 0 || suit_id >= bank->suit_count) return 0;
+    if (param_code < 1 || param_code > REPORT_CHANNELS) return 0;
+    HeldValue *h = &bank->suits[suit_id].channel[param_code - 1];
+    int missed = 0;
+    if (h->reported_ms != 0) {
+        uint32_t gap = now_ms - h->reported_ms;
+        missed = (int)((gap + REPORT_SAMPLE_MS / 2) / REPORT_SAMPLE_MS) - 1;
+        if (missed < 0) missed = 0;
+        if (missed > REPORT_MAX_REPLAY) missed = REPORT_MAX_REPLAY;
+        *held = h->value;
+    }
+    h->value = (float)value;
+    h->reported_ms = now_ms ? now_ms : 1;
+    return missed;
+}
+
+#endif
@@ -1,360 +1,1710 @@
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include <time.h>
-#include <winsock2.h>
-#include <ws2tcpip.h>
-#include "temperature_sensor.h"
-#include "optical_sensor.h"
-#include "electrical_sensor.h"
-#include "magnetic_sensor.h"
-#include "acoustic_sensor.h"
-#include "radiation_sensor.h"
-#include "chemical_sensor.h"
-
-#pragma comment(lib, "ws2_32.lib")
-
-#define PORT_SENSOR 8080
-#define PORT_CONTROL 8081
-#define BUFFER_SIZE 1024
-
-// Parameter codes
-#define TEMPERATURE 1
-#define RADIATION 2
-#define CHEMICAL 3
-#define OXYGEN 4
-#define NOISE 5
-#define VOLTAGE 6
-
-// Threshold values for alerts
-#define TEMP_THRESHOLD 40      // °C
-#define RADIATION_THRESHOLD 20 // μSv/h
-#define CHEMICAL_THRESHOLD 50  // ppm
-#define OXYGEN_MIN_THRESHOLD 19 // % (below this is dangerous)
-#define NOISE_THRESHOLD 85     // dB
-#define VOLTAGE_THRESHOLD 500  // V/m
-
-// Function to calculate electric field strength
-double calculate_efield_strength(double voltage, double distance_m) {
-    // Simple electric field calculation (V/m)
-    return voltage / distance_m;
-}
-
-// Function to determine voltage safety level
-int get_voltage_safety_level(double voltage) {
-    if (voltage < 50.0) return 0;      // Safe
-    if (voltage < 500.0) return 1;     // Low hazard
-    if (voltage < 1000.0) return 2;    // Medium hazard
-    return 3;                          // High hazard
-}
-
-void log_data(int param_code, int value) {
-    time_t now;
-    struct tm *local_time;
-    char timestamp[26];
-    char filename[20];
-    FILE *fp;
-    
-    // Get current time
-    time(&now);
-    local_time = localtime(&now);
-    strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", local_time);
-    
-    // Determine filename based on parameter code
-    switch(param_code) {
-        case TEMPERATURE:
-            strcpy(filename, "temp.csv");
-            break;
-        case RADIATION:
-            strcpy(filename, "radiation.csv");
-            break;
-        case CHEMICAL:
-            strcpy(filename, "chemical.csv");
-            break;
-        case OXYGEN:
-            strcpy(filename, "oxygen.csv");
-            break;
-        case NOISE:
-            strcpy(filename, "noise.csv");
-            break;
-        case VOLTAGE:
-            strcpy(filename, "voltage.csv");
-            break;
-        default:
-            strcpy(filename, "unknown.csv");
-    }
-    
-    // Check if file exists to write headers
-    fp = fopen(filename, "r");
-    if (fp == NULL) {
-        fp = fopen(filename, "w");
-        fprintf(fp, "Timestamp,Value\n");
-    } else {
-        fclose(fp);
-        fp = fopen(filename, "a");
-    }
-    
-    // Log data
-    fprintf(fp, "%s,%d\n", timestamp, value);
-    fclose(fp);
-    
-    printf("Logged %d to %s at %s\n", value, filename, timestamp);
-}
-
-void send_alert_to_control(int param_code, int value) {
-    SOCKET sock = INVALID_SOCKET;
-    struct sockaddr_in serv_addr;
-    
-    // Create socket
-    if ((sock = socket(AF_INET, SOCK_STREAM, 0)) == INVALID_SOCKET) {
-        printf("Socket creation error: %d\n", WSAGetLastError());
-        return;
-    }
-    
-    serv_addr.sin_family = AF_INET;
-    serv_addr.sin_port = htons(PORT_CONTROL);
-    
-    // Convert IPv4 address from text to binary form
-    if (inet_pton(AF_INET, "127.0.0.1", &serv_addr.sin_addr) <= 0) {
-        printf("Invalid address/ Address not supported\n");
-        closesocket(sock);
-        return;
-    }
-    
-    if (connect(sock, (struct sockaddr *)&serv_addr, sizeof(serv_addr)) < 0) {
-        printf("Connection Failed to Control Module: %d\n", WSAGetLastError());
-        closesocket(sock);
-        return;
-    }
-    
-    // Send data as integers
-    int data[2] = {param_code, value};
-    send(sock, (char*)data, sizeof(data), 0);
-    printf("Alert sent to control: Parameter Code %d, Value %d\n", param_code, value);
-    
-    closesocket(sock);
-}
-
-void check_threshold(int param_code, int value) {
-    int alert = 0;
-    
-    switch(param_code) {
-        case TEMPERATURE:
-            if (value > TEMP_THRESHOLD) alert = 1;
-            break;
-        case RADIATION:
-            if (value > RADIATION_THRESHOLD) alert = 1;
-            break;
-        case CHEMICAL:
-            if (value > CHEMICAL_THRESHOLD) alert = 1;
-            break;
-        case OXYGEN:
-            if (value < OXYGEN_MIN_THRESHOLD) alert = 1;
-            break;
-        case NOISE:
-            if (value > NOISE_THRESHOLD) alert = 1;
-            break;
-        case VOLTAGE:
-            if (value > VOLTAGE_THRESHOLD) alert = 1;
-            break;
-    }
-    
-    if (alert) {
-        printf("ALERT: Parameter %d exceeded threshold with value %d\n", param_code, value);
-        send_alert_to_control(param_code, value);
-    }
-}
-
-// Process sensor readings with appropriate sensor models
-// Process sensor readings with appropriate sensor models
-double process_sensor_reading(int param_code, int raw_value) {
-    double processed_value = raw_value;
-    
-    switch(param_code) {
-        case TEMPERATURE: {
-            // Use RTD sensor model for temperature
-            double rtd_reading = read_rtd_temperature((double)raw_value, 2); // Assuming 2 years in service
-            double resistance = calculate_rtd_resistance((double)raw_value);
-            printf("RTD Sensor reading: %.2f°C (raw: %d°C)\n", rtd_reading, raw_value);
-            printf("RTD Resistance: %.2f ohms\n", resistance);
-            processed_value = rtd_reading;
-            break;
-        }
-        case RADIATION: {
-            // Simulate radiation counts for the given level
-            int counts = simulate_radiation_counts((double)raw_value, 10.0); // 10-second integration
-            int detection = detect_radiation((double)raw_value);
-            printf("Radiation detector: %d counts in 10s, Detection: %s\n", 
-                   counts, detection ? "POSITIVE" : "NEGATIVE");
-            printf("Radiation sensitivity: %.1f counts per μSv\n", RAD_SENSITIVITY);
-            
-            // Create a simple spectrum for demonstration
-            int spectrum[128] = {0};
-            for (int i = 0; i < 128; i++) {
-                spectrum[i] = (int)(counts * exp(-(pow(i - raw_value/2, 2) / 200.0)));
-            }
-            
-            int isotope = identify_isotope(spectrum, 128);
-            if (isotope > 0) {
-                printf("Isotope identification: Type %d detected\n", isotope);
-            }
-            
-            processed_value = raw_value;
-            break;
-        }
-        case CHEMICAL: {
-            // Simulate electrochemical sensor for CO gas
-            double interfering_conc[7] = {0}; // No interfering gases in this simulation
-            double sensor_current = ec_sensor_current(GAS_CO, (double)raw_value, interfering_conc);
-            double corrected_conc = current_to_concentration(sensor_current, GAS_CO);
-            
-            // Apply temperature effect (assuming 25°C)
-            corrected_conc = apply_temperature_effect(corrected_conc, 25.0);
-            
-            printf("Chemical sensor: %.2f ppm CO (raw: %d ppm)\n", corrected_conc, raw_value);
-            printf("Sensor current: %.2f nA, Zero current: %.2f nA\n", sensor_current, EC_ZERO_CURRENT);
-            printf("Sensitivity: %.2f nA/ppm\n", EC_SENSITIVITY);
-            processed_value = corrected_conc;
-            break;
-        }
-        case NOISE: {
-            // Convert dB to Pascal for acoustic sensor
-            double pascal_value = dbspl_to_pascal((double)raw_value);
-            double mic_voltage = mic_output_voltage(pascal_value);
-            
-            // Apply frequency response (assuming 1kHz noise)
-            double freq_adjusted = apply_frequency_response(mic_voltage, 1000.0);
-            
-            printf("Acoustic sensor: %.2f dB SPL (raw: %d dB), Mic output: %.6f V\n", 
-                   raw_value, raw_value, freq_adjusted);
-            processed_value = raw_value;
-            break;
-        }
-        case VOLTAGE: {
-            // Use Hall effect sensor for voltage/field measurement
-            double field_strength = calculate_efield_strength((double)raw_value, 1.0); // Assuming 1m distance
-            int safety_level = get_voltage_safety_level((double)raw_value);
-            
-            printf("Voltage sensor: %d V\n", raw_value);
-            printf("Electric field strength: %.2f V/m\n", field_strength);
-            printf("Safety level: %d\n", safety_level);
-            
-            // Simulate Hall effect sensor output
-            double magnetic_field = raw_value / 100.0; // Simplified conversion
-            double hall_output = hall_effect_output(magnetic_field);
-            printf("Hall sensor output: %.3f V (for %.2f mT)\n", hall_output, magnetic_field);
-            
-            // Simulate proximity detection
-            int voltage_detected = detect_voltage_presence((double)raw_value, 0.5); // 0.5m distance
-            if (voltage_detected) {
-                printf("WARNING: Live voltage detected in proximity!\n");
-            }
-            
-            processed_value = raw_value;
-            break;
-        }
-    }
-    
-    return processed_value;
-}
-
-const char* get_param_name(int code) {
-    switch(code) {
-        case TEMPERATURE: return "Temperature";
-        case RADIATION: return "Radiation";
-        case CHEMICAL: return "Chemical";
-        case OXYGEN: return "Oxygen";
-        case NOISE: return "Noise";
-        case VOLTAGE: return "Voltage";
-        default: return "Unknown";
-    }
-}
-
-int main() {
-    WSADATA wsaData;
-    SOCKET server_fd = INVALID_SOCKET, new_socket = INVALID_SOCKET;
-    struct sockaddr_in address;
-    int addrlen = sizeof(address);
-    
-    // Initialize Winsock
-    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
-        printf("WSAStartup failed: %d\n", WSAGetLastError());
-        return 1;
-    }
-    
-    // Creating socket
-    if ((server_fd = socket(AF_INET, SOCK_STREAM, 0)) == INVALID_SOCKET) {
-        printf("Socket creation error: %d\n", WSAGetLastError());
-        WSACleanup();
-        return 1;
-    }
-    
-    // Setup socket options to allow address reuse
-    int opt = 1;
-    if (setsockopt(server_fd, SOL_SOCKET, SO_REUSEADDR, (char*)&opt, sizeof(opt)) == SOCKET_ERROR) {
-        printf("Setsockopt error: %d\n", WSAGetLastError());
-        closesocket(server_fd);
-        WSACleanup();
-        return 1;
-    }
-    
-    address.sin_family = AF_INET;
-    address.sin_addr.s_addr = INADDR_ANY;
-    address.sin_port = htons(PORT_SENSOR);
-    
-    // Bind the socket to the port
-    if (bind(server_fd, (struct sockaddr *)&address, sizeof(address)) == SOCKET_ERROR) {
-        printf("Bind failed: %d\n", WSAGetLastError());
-        closesocket(server_fd);
-        WSACleanup();
-        return 1;
-    }
-    
-    if (listen(server_fd, 3) == SOCKET_ERROR) {
-        printf("Listen error: %d\n", WSAGetLastError());
-        closesocket(server_fd);
-        WSACleanup();
-        return 1;
-    }
-    
-    printf("Sensor module started. Listening on port %d...\n", PORT_SENSOR);
-    printf("Date: March 01, 2025, 10:30 PM IST\n");
-    printf("Smart Suit for Industrial Workers - Sensor Module\n");
-    printf("------------------------------------------------\n");
-    
-    // Initialize random seed for sensor simulation
-    srand((unsigned int)time(NULL));
-    
-    while (1) {
-        if ((new_socket = accept(server_fd, (struct sockaddr *)&address, &addrlen)) == INVALID_SOCKET) {
-            printf("Accept error: %d\n", WSAGetLastError());
-            continue;
-        }
-        
-        int data[2];
-        int valread = recv(new_socket, (char*)data, sizeof(data), 0);
-        
-        if (valread > 0) {
-            int param_code = data[0];
-            int value = data[1];
-            
-            printf("\nReceived from environment: Parameter Code %d (%s), Value %d\n", 
-                   param_code, get_param_name(param_code), value);
-            
-            // Process sensor reading with appropriate sensor model
-            double processed_value = process_sensor_reading(param_code, value);
-            
-            // Log data to CSV (using the original value for consistency)
-            log_data(param_code, value);
-            
-            // Check if value exceeds threshold
-            check_threshold(param_code, value);
-        }
-        
-        closesocket(new_socket);
-    }
-    
-    closesocket(server_fd);
-    WSACleanup();
-    return 0;
-}
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "net_compat.h"
+#include "temperature_sensor.h"
+#include "optical_sensor.h"
+#include "electrical_sensor.h"
+#include "magnetic_sensor.h"
+#include "acoustic_sensor.h"
+#include "radiation_sensor.h"
+#include "chemical_sensor.h"
+#include "oxygen_sensor.h"
+#include "shard_ring.h"
+#include "alert_queue.h"
+#include "suit_state.h"
+#include "sensor_filter.h"
+#include "trend_predictor.h"
+#include "hazard_index.h"
+#include "acoustic_stream.h"
+#include "magnetometer_batch.h"
+#include "proximity_stream.h"
+#include "current_waveform.h"
+#include "metrics.h"
+#include "listen_workers.h"
+#include "sensor_models.h"
+#include "calibration.h"
+#include "report_policy.h"
+#include "timer_wheel.h"
+#include "traffic_capture.h"
+#include "alarm_multicast.h"
+#include "ingest_memory.h"
+#include "stage_profile.h"
+
+#ifdef SENSOR_FIXED_POINT
+// The suit firmware's arithmetic for the models outside the device tables too
+#define simulate_radiation_counts fixed_radiation_counts
+#define dbspl_to_pascal fixed_dbspl_to_pascal
+#define apply_temperature_effect fixed_temperature_effect
+#endif
+
+#define PORT_SENSOR 8080
+#define PORT_CONTROL 8081
+#define BUFFER_SIZE 1024
+
+// Parameter codes
+#define TEMPERATURE 1
+#define RADIATION 2
+#define CHEMICAL 3
+#define OXYGEN 4
+#define NOISE 5
+#define VOLTAGE 6
+#define MAGNETIC 7
+#define PROXIMITY 8
+
+// Alert-only codes raised by the current waveform stage
+#define ARC_FLASH 9
+#define OVERCURRENT 10
+
+// Sent once by a suit when it connects: value is its packed device profile (sensor_models.h)
+#define DEVICE_PROFILE 11
+
+// Suit keepalive: value is the silence in ms after which the suit counts as down, 0 signs off
+#define HEARTBEAT 12
+
+// Alert for a suit that stopped transmitting, the value is the seconds since it was last heard
+#define MAN_DOWN 13
+
+// Filtered suit temperature for the control module's thermal loop, in hundredths of a °C.
+// Sent with SAMPLE_BLOCK_FLAG as a batch: the value is the sample count and the header is
+// followed by that many (suit ID, hundredths of a °C) pairs
+#define THERMAL_SAMPLE 14
+
+// Combined hazard index of a suit changed severity, the value is the new level (hazard_index.h)
+#define HAZARD_INDEX 15
+
+// Threshold values for alerts
+#define TEMP_THRESHOLD 40      // °C
+#define RADIATION_THRESHOLD 20 // μSv/h
+#define CHEMICAL_THRESHOLD 50  // ppm
+#define OXYGEN_MIN_THRESHOLD 19 // % (below this is dangerous)
+#define NOISE_THRESHOLD 85     // dB
+#define VOLTAGE_THRESHOLD 500  // V/m
+#define MAGNETIC_THRESHOLD 500 // μT (5 G, implant safety limit)
+#define PROXIMITY_THRESHOLD 50 // cm (below this is dangerous)
+
+// Set on the parameter code of a predicted (not yet crossed) threshold alert,
+// the value then carries the seconds until the crossing
+#define EARLY_WARNING_FLAG 0x100
+
+// Set when a block of raw samples follows the header, the value is the frame count.
+// NOISE: 16-bit 48 kHz mic PCM. PROXIMITY: int32 pairs of distance (mm) and ambient light (lux).
+// MAGNETIC: int32 x, y, z triples in nT from the suit's 3D magnetometer at 100 Hz.
+// VOLTAGE: 16-bit Hall current-sensor ADC samples at the suit's ADC rate (device profile).
+#define SAMPLE_BLOCK_FLAG 0x200
+
+// Set on TEMPERATURE while the suit sits at a known reference temperature (dock or
+// bath), the value is that temperature. It refines the RTD drift estimate only.
+#define REFERENCE_FLAG 0x400
+#define NOISE_PEAK_THRESHOLD 135  // dB(C) peak
+#define ACOUSTIC_STREAMS 64  // Suits with live acoustic filter state
+#define PROXIMITY_STREAMS 256  // Suits with live collision tracking
+#define PROXIMITY_MAX_FRAMES 64
+#define MAG_MAX_FRAMES MAG_RATE_HZ  // 1 s of 3D samples
+#define NT_PER_GAUSS 100000.0f
+#define WAVEFORM_STREAMS 64  // Suits with live current waveform state
+#define WAVEFORM_MAX_FRAMES 5000  // 0.1 s at 50 kHz, the highest ADC rate
+
+// Per-connection memory (ingest_memory.h), sized for the largest 16-bit sample block
+#define SENSOR_HEADER_BYTES (3 * (int)sizeof(int))
+#define SENSOR_RECEIVE_BUFFERS 4
+#define SENSOR_MAX_BLOCK_FRAMES (WAVEFORM_MAX_FRAMES > PCM_MAX_BLOCK ? WAVEFORM_MAX_FRAMES : PCM_MAX_BLOCK)
+#define SENSOR_RECEIVE_BYTES (SENSOR_HEADER_BYTES + SENSOR_MAX_BLOCK_FRAMES * (int)sizeof(int16_t))
+#define SENSOR_ARENA_BYTES (64 * 1024)
+
+// CSV logs, one per parameter code plus unknown, open for the life of the module
+#define LOG_FILES (PROXIMITY + 1)
+#define LOG_BUFFER_SIZE 4096
+#define LOG_FLUSH_MS 1000  // A logged reading reaches its file at most this late, or when the buffer fills
+
+#define DEFAULT_YEARS_IN_SERVICE 2  // RTD age used as the drift prior when the install date is unknown
+#define DEFAULT_AMBIENT_TEMP 25.0  // °C, for EC compensation until the suit reports a temperature
+
+// Receive buffers and per-connection scratch, so handling a reading never touches the heap
+IngestMemory ingest;
+
+// Per-parameter CSV logs with their write buffers, index 0 is unknown codes
+FILE *log_files[LOG_FILES];
+char log_buffers[LOG_FILES][LOG_BUFFER_SIZE];
+int logs_unflushed;  // Lines written since the last timed flush
+uint32_t log_flush_due_ms;
+
+// Per-suit filter state for all channels
+FilterBank suit_filters;
+
+// Value of each suit's latest report, held until the next one (suits report on change)
+HoldBank suit_holds;
+
+// Sensor hardware variant fitted to each suit
+DeviceRegistry suit_devices;
+
+// Per-suit, per-channel calibration, reloaded when the file changes
+CalibrationRegistry suit_calibration;
+
+// Last value, last-seen time and alarm flags of every monitored suit.
+// The reading loop is the single writer of all shards; the metrics thread reads snapshots.
+#define SUIT_STATE_SUITS 100000
+#define SUIT_SILENT_MS (2 * REPORT_MAX_SILENCE_MS)  // Two missed heartbeats, the suit counts as silent
+SuitStateTable suit_states;
+
+// Man-down detection: a deadline per suit that signed on with a heartbeat, pushed
+// out by everything the suit sends
+#define DEADMAN_MAX_SUITS 100000
+#define DEADMAN_MIN_MS 500
+#define DEADMAN_MAX_MS 60000
+#define DEADMAN_POLL_MS (2 * TIMER_TICK_MS)  // Deadline checks while no reading arrives
+TimerWheel suit_deadlines;
+uint16_t deadman_timeout_ms[DEADMAN_MAX_SUITS];  // 0 = not watched
+uint8_t deadman_down[DEADMAN_MAX_SUITS];  // Man-down alert sent, cleared when the suit is heard again
+
+// Per-suit trend state for time-to-threshold prediction
+TrendBank suit_trends;
+
+// Combined hazard index of every suit, from its temperature, oxygen, gas and dose rate
+HazardBank suit_hazards;
+
+// Acoustic filter state, one channel slot per suit (direct mapped by suit ID)
+AcousticBank noise_streams;
+int noise_stream_owner[ACOUSTIC_STREAMS];
+
+// Hard/soft-iron calibration of each suit's magnetometer, from the calibration file
+#define MAG_CAL_SUITS 100000
+// Double-buffered: a reload is written into the spare table and published by pointer,
+// so a block being calibrated never sees a table half rewritten
+MagCalibration suit_mag_tables[2];
+_Atomic(MagCalibration *) suit_mag_cal;
+uint32_t mag_cal_generation = UINT32_MAX;  // Registry generation suit_mag_cal was built from
+
+// Collision tracking, one stream slot per suit (direct mapped by suit ID)
+ProximityBank proximity_streams;
+int proximity_owner[PROXIMITY_STREAMS];
+double proximity_worst_latency_ms = 0.0;
+long proximity_budget_misses = 0;
+
+// Current waveform analysis, one channel slot per suit (direct mapped by suit ID)
+WaveformChannel waveform_streams[WAVEFORM_STREAMS];
+int waveform_owner[WAVEFORM_STREAMS];
+
+// Control shards, suits are routed by consistent hashing of the suit ID
+ShardRing control_ring;
+
+// Outbound alerts and circuit breaker per control shard (indexed by ring slot)
+#define ALERT_CONNECT_TIMEOUT_MS 200  // A dead shard costs at most this per attempt
+#define ALERT_FLUSH_BUDGET_MS ALERT_CONNECT_TIMEOUT_MS  // No new connection after this long in one flush
+#define ALERT_RETRY_POLL_MS 100  // Queued alerts are retried this often while no reading arrives
+AlertQueue control_queues[SHARD_MAX];
+
+// Filtered temperatures for each shard's thermal loops, sent as one batch message rather
+// than as alerts. A batch goes out when full or when its oldest sample is half a loop tick old.
+#define THERMAL_BATCH_MAX 256
+#define THERMAL_BATCH_MS 50
+typedef struct {
+    int header[3];  // THERMAL_SAMPLE | SAMPLE_BLOCK_FLAG, sample count, 0
+    int32_t samples[THERMAL_BATCH_MAX][2];  // Suit ID, hundredths of a °C
+    int count;
+    uint32_t first_ms;  // When the oldest sample was queued
+} ThermalBatch;
+ThermalBatch thermal_batches[SHARD_MAX];
+
+// Metric family IDs, labelled by parameter code where it applies
+int metric_readings, metric_sample_blocks, metric_alerts, metric_early_warnings, metric_truncated_headers;
+int metric_connect_failures, metric_alert_send, metric_log_write;
+int metric_alert_queue, metric_alerts_dropped, metric_alerts_merged, metric_breaker_opened;
+int metric_suits_tracked, metric_suits_in_alarm, metric_suits_silent, metric_suit_alarms;
+int metric_man_down, metric_suits_watched;
+int metric_alarms_published, metric_alarm_repairs, metric_alarm_nacks;
+int metric_hazard_changes, metric_suits_by_hazard;
+int metric_heap_allocations, metric_receive_exhausted, metric_arena_overflows, metric_arena_high_water;
+int metric_thermal_sent, metric_thermal_dropped;
+
+uint32_t monotonic_ms() {
+    if (replay_clock.active) return replay_clock_ms();
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+typedef struct {
+    uint32_t now_ms;
+    long in_alarm;
+    long silent;
+    long alarms[SUIT_STATE_PARAMS + 1];
+} SuitCensus;
+
+static int count_suit(const SuitSnapshot *suit, void *arg) {
+    SuitCensus *census = arg;
+    if (suit->alarm_flags) census->in_alarm++;
+    if (census->now_ms - suit->last_seen_ms > SUIT_SILENT_MS) census->silent++;
+    for (int p = 0; p < SUIT_STATE_PARAMS; p++) {
+        if (suit->alarm_flags & (1u << p)) census->alarms[p + 1]++;
+    }
+    return 0;
+}
+
+// Scrape-time census of the suit table, from lock-free snapshots
+void collect_suit_metrics() {
+    SuitCensus census;
+    memset(&census, 0, sizeof(census));
+    census.now_ms = monotonic_ms();
+    long tracked = suit_state_scan(&suit_states, count_suit, &census);
+    metric_set(metric_suits_tracked, 0, (uint64_t)tracked);
+    metric_set(metric_suits_in_alarm, 0, (uint64_t)census.in_alarm);
+    metric_set(metric_suits_silent, 0, (uint64_t)census.silent);
+    for (int code = 1; code <= SUIT_STATE_PARAMS; code++) {
+        metric_set(metric_suit_alarms, code, (uint64_t)census.alarms[code]);
+    }
+}
+
+// The timer wheel and hazard counts belong to the reading loop, which publishes them
+// through its own metrics shard; the metrics thread never reads them directly
+void publish_hazard_census() {
+    for (int level = 0; level < HAZARD_LEVELS; level++) {
+        metric_set(metric_suits_by_hazard, level, (uint64_t)suit_hazards.at_severity[level]);
+    }
+}
+
+void init_metrics() {
+    metrics_init("smartsuit_sensor");
+    metric_readings = metrics_register("readings_total", "Readings received from the environment",
+                                       METRIC_COUNTER, "param", 16);
+    metric_sample_blocks = metrics_register("sample_blocks_total", "Raw sample blocks received",
+                                            METRIC_COUNTER, "param", 16);
+    metric_truncated_headers = metrics_register("truncated_headers_total",
+                                                "Connections dropped before a full reading header arrived",
+                                                METRIC_COUNTER, NULL, 1);
+    metric_alerts = metrics_register("alerts_sent_total", "Threshold alerts sent to control",
+                                     METRIC_COUNTER, "param", 16);
+    metric_early_warnings = metrics_register("early_warnings_sent_total", "Predicted crossings sent to control",
+                                             METRIC_COUNTER, "param", 16);
+    metric_connect_failures = metrics_register("control_connect_failures_total",
+                                               "Failed connections or sends to a control shard", METRIC_COUNTER, NULL, 1);
+    metric_alert_send = metrics_register("alert_send_seconds", "Connect and send time for one alert",
+                                         METRIC_HISTOGRAM, NULL, 1);
+    metric_log_write = metrics_register("log_write_seconds", "CSV log write time, sampled 1 in 16 readings",
+                                        METRIC_HISTOGRAM, NULL, 1);
+    metric_alert_queue = metrics_register("alert_queue_depth", "Alerts waiting for a control shard",
+                                          METRIC_GAUGE, "shard", SHARD_MAX);
+    metric_alerts_dropped = metrics_register("alerts_dropped_total", "Alerts shed from a full queue",
+                                             METRIC_COUNTER, "priority", ALERT_PRIORITIES);
+    metric_thermal_sent = metrics_register("thermal_samples_sent_total",
+                                           "Filtered temperatures sent to the control shards' thermal loops",
+                                           METRIC_COUNTER, NULL, 1);
+    metric_thermal_dropped = metrics_register("thermal_samples_dropped_total",
+                                              "Thermal samples dropped because their shard was unreachable",
+                                              METRIC_COUNTER, NULL, 1);
+    metric_alerts_merged = metrics_register("alerts_merged_total", "Alerts folded into one already queued",
+                                            METRIC_COUNTER, NULL, 1);
+    metric_breaker_opened = metrics_register("control_breaker_opened_total",
+                                             "Times a shard's circuit breaker opened", METRIC_COUNTER, "shard", SHARD_MAX);
+    metric_suits_tracked = metrics_register("suits_tracked", "Suits with state in the suit table",
+                                            METRIC_GAUGE, NULL, 1);
+    metric_suits_in_alarm = metrics_register("suits_in_alarm", "Suits with at least one parameter in alarm",
+                                             METRIC_GAUGE, NULL, 1);
+    metric_suits_silent = metrics_register("suits_silent", "Suits with no reading in the last 60 s",
+                                           METRIC_GAUGE, NULL, 1);
+    metric_suit_alarms = metrics_register("suit_alarms", "Suits in alarm per parameter",
+                                          METRIC_GAUGE, "param", SUIT_STATE_PARAMS + 1);
+    metric_man_down = metrics_register("man_down_alerts_total", "Suits that stopped transmitting before their deadline",
+                                       METRIC_COUNTER, NULL, 1);
+    metric_suits_watched = metrics_register("suits_watched", "Suits with a man-down deadline armed",
+                                            METRIC_GAUGE, NULL, 1);
+    metric_alarms_published = metrics_register("alarms_multicast_total", "Critical alerts published to the alarm group",
+                                               METRIC_COUNTER, "param", 16);
+    metric_alarm_repairs = metrics_register("alarm_repairs_total", "Alarms resent to subscribers that missed them",
+                                            METRIC_COUNTER, NULL, 1);
+    metric_alarm_nacks = metrics_register("alarm_nacks_total", "Gap reports received from alarm subscribers",
+                                          METRIC_COUNTER, NULL, 1);
+    metric_hazard_changes = metrics_register("hazard_severity_changes_total",
+                                             "Combined hazard index changes sent to control, by new severity",
+                                             METRIC_COUNTER, "severity", HAZARD_LEVELS);
+    metric_suits_by_hazard = metrics_register("suits_by_hazard_severity", "Suits per combined hazard severity",
+                                              METRIC_GAUGE, "severity", HAZARD_LEVELS);
+    metric_heap_allocations = metrics_register("ingest_heap_allocations_total",
+                                               "Heap allocations made while handling connections (counted with INGEST_ALLOC_TRACKING)",
+                                               METRIC_COUNTER, NULL, 1);
+    metric_receive_exhausted = metrics_register("receive_buffers_exhausted_total",
+                                                "Connections dropped with every receive buffer in use",
+                                                METRIC_COUNTER, NULL, 1);
+    metric_arena_overflows = metrics_register("batch_arena_overflows_total", "Scratch requests refused by a full arena",
+                                              METRIC_COUNTER, NULL, 1);
+    metric_arena_high_water = metrics_register("batch_arena_high_water_bytes", "Most arena scratch used by one connection",
+                                               METRIC_GAUGE, NULL, 1);
+    metrics_set_collector(collect_suit_metrics);
+}
+
+void init_control_ring(int argc, char *argv[]) {
+    const char *spec = (argc > 1) ? argv[1] : getenv(SHARD_ENV);
+    
+    ring_init(&control_ring);
+    for (int i = 0; i < SHARD_MAX; i++) alert_queue_init(&control_queues[i]);
+    if (spec != NULL && ring_load_from_string(&control_ring, spec) > 0) {
+        return;
+    }
+    
+    // Default: a single control module on the local machine
+    ring_add_shard(&control_ring, "127.0.0.1", PORT_CONTROL);
+}
+
+// Function to calculate electric field strength
+double calculate_efield_strength(double voltage, double distance_m) {
+    // Simple electric field calculation (V/m)
+    return voltage / distance_m;
+}
+
+// Function to determine voltage safety level
+int get_voltage_safety_level(double voltage) {
+    if (voltage < 50.0) return 0;      // Safe
+    if (voltage < 500.0) return 1;     // Low hazard
+    if (voltage < 1000.0) return 2;    // Medium hazard
+    return 3;                          // High hazard
+}
+
+const char* log_file_name(int param_code) {
+    switch(param_code) {
+        case TEMPERATURE: return "temp.csv";
+        case RADIATION: return "radiation.csv";
+        case CHEMICAL: return "chemical.csv";
+        case OXYGEN: return "oxygen.csv";
+        case NOISE: return "noise.csv";
+        case VOLTAGE: return "voltage.csv";
+        case MAGNETIC: return "magnetic.csv";
+        case PROXIMITY: return "proximity.csv";
+        default: return "unknown.csv";
+    }
+}
+
+// Open every CSV log once, with a header for new files. A log that cannot be
+// opened is retried on each reading for it.
+void open_logs() {
+    for (int code = 0; code < LOG_FILES; code++) {
+        const char *filename = log_file_name(code);
+        
+        // Check if file exists to write headers
+        FILE *fp = fopen(filename, "r");
+        int exists = (fp != NULL);
+        if (exists) fclose(fp);
+        
+        log_files[code] = fopen(filename, "a");
+        if (log_files[code] == NULL) {
+            printf("Cannot open log %s\n", filename);
+            continue;
+        }
+        setvbuf(log_files[code], log_buffers[code], _IOFBF, LOG_BUFFER_SIZE);
+        if (!exists) fprintf(log_files[code], "Timestamp,Value\n");
+        fflush(log_files[code]);
+    }
+}
+
+// Timed flush of the CSV logs, once LOG_FLUSH_MS has passed since the first unflushed line
+void flush_logs_if_due() {
+    if (!logs_unflushed || (int32_t)(monotonic_ms() - log_flush_due_ms) < 0) return;
+    for (int code = 0; code < LOG_FILES; code++) {
+        if (log_files[code] != NULL) fflush(log_files[code]);
+    }
+    logs_unflushed = 0;
+}
+
+void close_logs() {
+    for (int code = 0; code < LOG_FILES; code++) {
+        if (log_files[code] != NULL) fclose(log_files[code]);
+        log_files[code] = NULL;
+    }
+}
+
+void log_data(int param_code, int value) {
+    time_t now;
+    struct tm local_time;
+    char timestamp[26];
+    int code = (param_code > 0 && param_code < LOG_FILES) ? param_code : 0;
+    
+    // Get current time; glibc's localtime re-reads the time zone, allocating, on every call
+    time(&now);
+#ifdef _WIN32
+    localtime_s(&local_time, &now);
+#else
+    localtime_r(&now, &local_time);
+#endif
+    strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", &local_time);
+    
+    if (log_files[code] == NULL) {
+        printf("Log %s is not open, %d not logged\n", log_file_name(code), value);
+        return;
+    }
+    
+    // Log data; the buffer goes to the file when it fills or at the next timed flush
+    fprintf(log_files[code], "%s,%d\n", timestamp, value);
+    if (!logs_unflushed) {
+        logs_unflushed = 1;
+        log_flush_due_ms = monotonic_ms() + LOG_FLUSH_MS;
+    }
+    
+    printf("Logged %d to %s at %s\n", value, log_file_name(code), timestamp);
+}
+
+// Life-critical parameters are the last to be shed
+int alert_priority(int param_code) {
+    int early = param_code & EARLY_WARNING_FLAG;
+    switch (param_code & ~EARLY_WARNING_FLAG) {
+        case OXYGEN:
+        case RADIATION:
+        case CHEMICAL:
+        case ARC_FLASH:
+        case MAN_DOWN:
+            return early ? ALERT_ELEVATED : ALERT_CRITICAL;
+        case VOLTAGE:
+        case OVERCURRENT:
+        case MAGNETIC:
+        case PROXIMITY:
+        case HAZARD_INDEX:  // Its components alarm on their own at their thresholds
+            return ALERT_ELEVATED;
+        default:
+            return ALERT_ROUTINE;
+    }
+}
+
+// Connect without blocking past ALERT_CONNECT_TIMEOUT_MS, returns INVALID_SOCKET on failure
+SOCKET connect_to_shard(const ControlShard *target) {
+    SOCKET sock;
+    struct sockaddr_in serv_addr;
+    unsigned long nonblocking = 1, blocking = 0;
+    
+    if ((sock = socket(AF_INET, SOCK_STREAM, 0)) == INVALID_SOCKET) {
+        printf("Socket creation error: %d\n", WSAGetLastError());
+        return INVALID_SOCKET;
+    }
+    
+    serv_addr.sin_family = AF_INET;
+    serv_addr.sin_port = htons(target->port);
+    
+    // Convert IPv4 address from text to binary form
+    if (inet_pton(AF_INET, target->host, &serv_addr.sin_addr) <= 0) {
+        printf("Invalid address/ Address not supported\n");
+        closesocket(sock);
+        return INVALID_SOCKET;
+    }
+    
+    ioctlsocket(sock, FIONBIO, &nonblocking);
+    if (connect(sock, (struct sockaddr *)&serv_addr, sizeof(serv_addr)) < 0) {
+        int error = WSAGetLastError();
+        if (error != WSAEWOULDBLOCK && error != WSAEINPROGRESS) {
+            closesocket(sock);
+            return INVALID_SOCKET;
+        }
+        
+        // Wait for the handshake, then ask the socket how it went
+        fd_set writable, failed;
+        struct timeval timeout = {0, ALERT_CONNECT_TIMEOUT_MS * 1000};
+        int so_error = 0;
+        socklen_t length = sizeof(so_error);
+        FD_ZERO(&writable);
+        FD_ZERO(&failed);
+        FD_SET(sock, &writable);
+        FD_SET(sock, &failed);
+        if (select((int)sock + 1, NULL, &writable, &failed, &timeout) <= 0 || !FD_ISSET(sock, &writable) ||
+            getsockopt(sock, SOL_SOCKET, SO_ERROR, (char*)&so_error, &length) != 0 || so_error != 0) {
+            closesocket(sock);
+            return INVALID_SOCKET;
+        }
+    }
+    ioctlsocket(sock, FIONBIO, &blocking);
+    return sock;
+}
+
+// Send queued alerts to one shard while its breaker allows. No connection is started
+// once ALERT_FLUSH_BUDGET_MS has passed; what is left waits for the next flush.
+void flush_control_queue(int shard) {
+    AlertQueue *q = &control_queues[shard];
+    const ControlShard *target = &control_ring.shards[shard];
+    uint32_t now = monotonic_ms();
+    uint32_t stop = now + ALERT_FLUSH_BUDGET_MS;
+    
+    while (q->count > 0 && breaker_allow(q, now) && (int32_t)(stop - now) > 0) {
+        QueuedAlert *alert = alert_queue_next(q);
+        double start = metrics_now();
+        SOCKET sock = connect_to_shard(target);
+        
+        // Send data as integers; the alert stays queued unless all of it went out
+        int data[3] = {alert->param_code, alert->value, alert->suit_id};
+        int sent = (sock != INVALID_SOCKET) ? send(sock, (char*)data, sizeof(data), 0) : SOCKET_ERROR;
+        if (sock != INVALID_SOCKET) closesocket(sock);
+        if (sent != (int)sizeof(data)) {
+            metric_inc(metric_connect_failures, 0);
+            if (breaker_failure(q, monotonic_ms())) {
+                metric_inc(metric_breaker_opened, shard);
+                printf("Control shard %s:%d unreachable, holding %d alert(s), retry in %u ms\n",
+                       target->host, target->port, q->count, q->backoff_ms);
+            }
+            break;
+        }
+        breaker_success(q);
+        printf("Alert sent to control shard %d (port %d): Suit %d, Parameter Code %d, Value %d",
+               shard, target->port, alert->suit_id, alert->param_code, alert->value);
+        if (alert->merged > 0) printf(" (%d repeat(s) merged)", alert->merged);
+        printf("\n");
+        
+        metric_observe(metric_alert_send, metrics_now() - start);
+        if (alert->param_code & EARLY_WARNING_FLAG) {
+            metric_inc(metric_early_warnings, alert->param_code & ~EARLY_WARNING_FLAG);
+        } else {
+            metric_inc(metric_alerts, alert->param_code);
+        }
+        alert_queue_remove(q, alert);
+        now = monotonic_ms();
+    }
+    metric_set(metric_alert_queue, shard, q->count);
+}
+
+// Send one shard's thermal samples in a single message. A sample is only worth its
+// freshness, so a batch that cannot go out now is dropped rather than held.
+void flush_thermal_batch(int shard) {
+    ThermalBatch *batch = &thermal_batches[shard];
+    AlertQueue *q = &control_queues[shard];
+    const ControlShard *target = &control_ring.shards[shard];
+    int length = (int)sizeof(batch->header) + batch->count * (int)sizeof(batch->samples[0]);
+    int sent = SOCKET_ERROR;
+    
+    if (batch->count == 0) return;
+    if (breaker_allow(q, monotonic_ms())) {
+        SOCKET sock = connect_to_shard(target);
+        if (sock != INVALID_SOCKET) {
+            batch->header[0] = THERMAL_SAMPLE | SAMPLE_BLOCK_FLAG;
+            batch->header[1] = batch->count;
+            batch->header[2] = 0;
+            sent = send(sock, (char*)batch->header, length, 0);
+            closesocket(sock);
+        }
+        if (sent == length) {
+            breaker_success(q);
+        } else {
+            metric_inc(metric_connect_failures, 0);
+            if (breaker_failure(q, monotonic_ms())) {
+                metric_inc(metric_breaker_opened, shard);
+                printf("Control shard %s:%d unreachable, retry in %u ms\n",
+                       target->host, target->port, q->backoff_ms);
+            }
+        }
+    }
+    metric_add(sent == length ? metric_thermal_sent : metric_thermal_dropped, 0, (uint64_t)batch->count);
+    batch->count = 0;
+}
+
+// Queue a filtered temperature for the suit's thermal loop; a full batch goes out at once
+void queue_thermal_sample(int suit_id, double celsius) {
+    int shard = ring_lookup(&control_ring, (uint32_t)suit_id);
+    if (shard < 0) return;
+    
+    ThermalBatch *batch = &thermal_batches[shard];
+    if (batch->count == 0) batch->first_ms = monotonic_ms();
+    batch->samples[batch->count][0] = suit_id;
+    batch->samples[batch->count][1] = (int32_t)lround(celsius * 100.0);
+    if (++batch->count == THERMAL_BATCH_MAX) flush_thermal_batch(shard);
+}
+
+int thermal_pending() {
+    for (int s = 0; s < SHARD_MAX; s++) {
+        if (control_ring.active[s] && thermal_batches[s].count > 0) return 1;
+    }
+    return 0;
+}
+
+// Send the batches whose oldest sample has waited THERMAL_BATCH_MS
+void flush_due_thermal_batches() {
+    uint32_t now = monotonic_ms();
+    for (int s = 0; s < SHARD_MAX; s++) {
+        if (control_ring.active[s] && thermal_batches[s].count > 0 &&
+            (int32_t)(now - thermal_batches[s].first_ms) >= THERMAL_BATCH_MS) {
+            flush_thermal_batch(s);
+        }
+    }
+}
+
+// Critical alerts for the alarm subscribers, one multicast whatever their number
+AlarmPublisher alarm_publisher = {INVALID_SOCKET};
+
+void service_alarm_publisher() {
+    long repaired = alarm_publisher.repaired, nacks = alarm_publisher.nacks;
+    alarm_publisher_service(&alarm_publisher);
+    metric_add(metric_alarm_repairs, 0, (uint64_t)(alarm_publisher.repaired - repaired));
+    metric_add(metric_alarm_nacks, 0, (uint64_t)(alarm_publisher.nacks - nacks));
+}
+
+int alerts_pending() {
+    for (int s = 0; s < SHARD_MAX; s++) {
+        if (control_ring.active[s] && control_queues[s].count > 0) return 1;
+    }
+    return 0;
+}
+
+void flush_control_queues() {
+    for (int s = 0; s < SHARD_MAX; s++) {
+        if (control_ring.active[s] && control_queues[s].count > 0) flush_control_queue(s);
+    }
+}
+
+// Queue the alert for the suit's shard and send what the shard will take now.
+// A flush starts no connection after ALERT_FLUSH_BUDGET_MS and each connect gives up
+// after ALERT_CONNECT_TIMEOUT_MS, so a slow or dead shard holds the caller for at most
+// the sum of the two.
+void send_alert_to_control(int suit_id, int param_code, int value) {
+    // Standby controllers, sirens and consoles hear critical alerts at once, whatever the shards do
+    if (alarm_publisher.sock != INVALID_SOCKET && alert_priority(param_code) == ALERT_CRITICAL) {
+        alarm_publish(&alarm_publisher, suit_id, param_code, value);
+        metric_inc(metric_alarms_published, param_code);
+    }
+    
+    // Pick the shard that owns this suit
+    int shard = ring_lookup(&control_ring, (uint32_t)suit_id);
+    if (shard < 0) {
+        printf("No control shard configured\n");
+        return;
+    }
+    
+    AlertQueue *q = &control_queues[shard];
+    long dropped[ALERT_PRIORITIES];
+    memcpy(dropped, q->dropped, sizeof(dropped));
+    switch (alert_queue_push(q, suit_id, param_code, value, alert_priority(param_code), monotonic_ms())) {
+        case ALERT_MERGED:
+            metric_inc(metric_alerts_merged, 0);
+            break;
+        case ALERT_EVICTED:
+            printf("Alert queue for control shard %d full, dropped a less important alert\n", shard);
+            break;
+        case ALERT_DROPPED:
+            printf("Alert queue for control shard %d backed up, shed alert: Suit %d, Parameter Code %d\n",
+                   shard, suit_id, param_code);
+            break;
+        default:
+            break;
+    }
+    for (int p = 0; p < ALERT_PRIORITIES; p++) {
+        metric_add(metric_alerts_dropped, p, (uint64_t)(q->dropped[p] - dropped[p]));
+    }
+    flush_control_queue(shard);
+}
+
+// Backpressure for the sender of a reading, from the queue of the suit's shard
+QueuePressure alert_pressure(int suit_id) {
+    int shard = ring_lookup(&control_ring, (uint32_t)suit_id);
+    return shard < 0 ? PRESSURE_OK : alert_queue_pressure(&control_queues[shard]);
+}
+
+// True when a connection arrives within timeout_ms.
+// NACKs from alarm subscribers wake the wait too; they are answered and 0 returned.
+int connection_waiting(SOCKET server_fd, int timeout_ms) {
+    fd_set readable;
+    struct timeval timeout = {timeout_ms / 1000, (timeout_ms % 1000) * 1000};
+    SOCKET highest = server_fd;
+    FD_ZERO(&readable);
+    FD_SET(server_fd, &readable);
+    if (alarm_publisher.sock != INVALID_SOCKET) {
+        FD_SET(alarm_publisher.sock, &readable);
+        if (alarm_publisher.sock > highest) highest = alarm_publisher.sock;
+    }
+    if (select((int)highest + 1, &readable, NULL, NULL, &timeout) <= 0) return 0;
+    if (alarm_publisher.sock != INVALID_SOCKET && FD_ISSET(alarm_publisher.sock, &readable)) {
+        service_alarm_publisher();
+    }
+    return FD_ISSET(server_fd, &readable);
+}
+
+// How long to wait for a reading before the idle work is due again
+int idle_poll_ms() {
+    if (suit_deadlines.armed > 0) return DEADMAN_POLL_MS;
+    if (thermal_pending()) return THERMAL_BATCH_MS / 2;
+    if (alerts_pending()) return ALERT_RETRY_POLL_MS;
+    if (logs_unflushed) return LOG_FLUSH_MS / 2;
+    return ALARM_HEARTBEAT_MS;
+}
+
+static void suit_went_silent(int suit_id, uint32_t deadline_ms, void *arg) {
+    (void)arg;
+    uint32_t silent_ms = monotonic_ms() - (deadline_ms - deadman_timeout_ms[suit_id]);
+    printf("\nMAN DOWN: Suit %d silent for %.1f s\n", suit_id, silent_ms / 1000.0);
+    deadman_down[suit_id] = 1;
+    metric_inc(metric_man_down, 0);
+    send_alert_to_control(suit_id, MAN_DOWN, (int)(silent_ms / 1000));
+}
+
+// Fire the deadlines that passed. Runs with nothing armed too: that only moves
+// the wheel's clock up, so the next deadline is armed from the present.
+void check_deadlines() {
+    if (suit_deadlines.timers != NULL) timer_advance(&suit_deadlines, monotonic_ms(), suit_went_silent, NULL);
+    metric_set(metric_suits_watched, 0, (uint64_t)suit_deadlines.armed);
+}
+
+// Anything from a watched suit pushes its deadline out
+void suit_heard(int suit_id) {
+    if (suit_id < 0 || suit_id >= DEADMAN_MAX_SUITS || deadman_timeout_ms[suit_id] == 0) return;
+    if (deadman_down[suit_id]) {
+        printf("Suit %d transmitting again\n", suit_id);
+        deadman_down[suit_id] = 0;
+    }
+    timer_arm(&suit_deadlines, suit_id, monotonic_ms() + deadman_timeout_ms[suit_id]);
+}
+
+// Heartbeat from a suit: sign on or off for man-down detection
+void suit_heartbeat(int suit_id, int timeout_ms) {
+    if (suit_id < 0 || suit_id >= DEADMAN_MAX_SUITS || suit_deadlines.timers == NULL) return;
+    if (timeout_ms <= 0) {
+        if (deadman_timeout_ms[suit_id] != 0) printf("\nSuit %d signed off\n", suit_id);
+        timer_cancel(&suit_deadlines, suit_id);
+        deadman_timeout_ms[suit_id] = 0;
+        deadman_down[suit_id] = 0;
+        return;
+    }
+    if (timeout_ms < DEADMAN_MIN_MS) timeout_ms = DEADMAN_MIN_MS;
+    if (timeout_ms > DEADMAN_MAX_MS) timeout_ms = DEADMAN_MAX_MS;
+    if (deadman_timeout_ms[suit_id] != timeout_ms) {
+        printf("\nSuit %d watched for man-down, deadline %d ms\n", suit_id, timeout_ms);
+        timer_cancel(&suit_deadlines, suit_id);  // A shorter deadline must be refiled
+        deadman_timeout_ms[suit_id] = (uint16_t)timeout_ms;
+    }
+    suit_heard(suit_id);
+}
+
+// Returns 1 when the value is beyond the parameter's threshold
+int check_threshold(int suit_id, int param_code, int value) {
+    int alert = 0;
+    
+    switch(param_code) {
+        case TEMPERATURE:
+            if (value > TEMP_THRESHOLD) alert = 1;
+            break;
+        case RADIATION:
+            if (value > RADIATION_THRESHOLD) alert = 1;
+            break;
+        case CHEMICAL:
+            if (value > CHEMICAL_THRESHOLD) alert = 1;
+            break;
+        case OXYGEN:
+            if (value < OXYGEN_MIN_THRESHOLD) alert = 1;
+            break;
+        case NOISE:
+            if (value > NOISE_THRESHOLD) alert = 1;
+            break;
+        case VOLTAGE:
+            if (value > VOLTAGE_THRESHOLD) alert = 1;
+            break;
+        case MAGNETIC:
+            if (value > MAGNETIC_THRESHOLD) alert = 1;
+            break;
+        case PROXIMITY:
+            if (value < PROXIMITY_THRESHOLD) alert = 1;
+            break;
+    }
+    
+    if (alert) {
+        printf("ALERT: Parameter %d exceeded threshold with value %d\n", param_code, value);
+        send_alert_to_control(suit_id, param_code, value);
+    }
+    return alert;
+}
+
+// Threshold and crossing direction for a parameter, returns 0 if it has none
+int get_threshold(int param_code, double *threshold, int *direction) {
+    *direction = CROSS_ABOVE;
+    switch(param_code) {
+        case TEMPERATURE: *threshold = TEMP_THRESHOLD; return 1;
+        case RADIATION: *threshold = RADIATION_THRESHOLD; return 1;
+        case CHEMICAL: *threshold = CHEMICAL_THRESHOLD; return 1;
+        case OXYGEN: *threshold = OXYGEN_MIN_THRESHOLD; *direction = CROSS_BELOW; return 1;
+        case NOISE: *threshold = NOISE_THRESHOLD; return 1;
+        case VOLTAGE: *threshold = VOLTAGE_THRESHOLD; return 1;
+        case MAGNETIC: *threshold = MAGNETIC_THRESHOLD; return 1;
+        case PROXIMITY: *threshold = PROXIMITY_THRESHOLD; *direction = CROSS_BELOW; return 1;
+        default: return 0;
+    }
+}
+
+// Warn control early when the trend will cross the threshold within the lead time
+void check_trend(int suit_id, int param_code, double value) {
+    double threshold;
+    int direction;
+    TrendPrediction prediction;
+    
+    if (!get_threshold(param_code, &threshold, &direction)) return;
+    
+    if (trend_check_early_warning(&suit_trends, suit_id, param_code, monotonic_ms(),
+                                  value, threshold, direction, &prediction)) {
+        int seconds = (int)ceil(prediction.time_to_threshold);
+        printf("EARLY WARNING: Parameter %d trending at %.3f/s, threshold in %d s\n",
+               param_code, prediction.slope, seconds);
+        send_alert_to_control(suit_id, param_code | EARLY_WARNING_FLAG, seconds);
+        suit_state_set_warning(&suit_states, suit_id, param_code);
+    }
+}
+
+// Fold a reading into the suit's combined hazard index; control hears only severity changes
+void check_hazard_index(int suit_id, int param_code, double value) {
+    int component;
+    HazardChange change;
+    
+    switch (param_code) {
+        case TEMPERATURE: component = HAZARD_HEAT; break;
+        case OXYGEN: component = HAZARD_OXYGEN; break;
+        case CHEMICAL: component = HAZARD_TOXIC; break;
+        case RADIATION: component = HAZARD_DOSE; break;
+        default: return;
+    }
+    if (!hazard_update(&suit_hazards, suit_id, component, value, &change)) return;
+    
+    printf("Suit %d combined hazard index %.2f, mostly %s: %s -> %s\n", suit_id, change.index / 1000.0,
+           hazard_component_name(change.dominant), hazard_severity_name(change.previous),
+           hazard_severity_name(change.severity));
+    metric_inc(metric_hazard_changes, change.severity);
+    publish_hazard_census();
+    send_alert_to_control(suit_id, HAZARD_INDEX, change.severity);
+}
+
+int recv_all(SOCKET sock, char *buffer, int length) {
+    int received = 0;
+    while (received < length) {
+        int n = recv(sock, buffer + received, length - received, 0);
+        capture_received(sock, buffer + received, n);
+        if (n <= 0) return -1;
+        received += n;
+    }
+    return received;
+}
+
+// Read a reading header: two ints, then the suit ID if the sender has one.
+// Returns the bytes read (8 for older senders that close after two ints, 12
+// otherwise) or -1 if the header was cut short
+int recv_header(SOCKET sock, int *data) {
+    char *bytes = (char *)data;
+    if (recv_all(sock, bytes, 2 * (int)sizeof(int)) < 0) {
+        return -1;
+    }
+    int received = 2 * (int)sizeof(int);
+    while (received < SENSOR_HEADER_BYTES) {
+        int n = recv(sock, bytes + received, SENSOR_HEADER_BYTES - received, 0);
+        capture_received(sock, bytes + received, n);
+        if (n == 0 && received == 2 * (int)sizeof(int)) {
+            return received;  // Two-int sender closed, no suit ID
+        }
+        if (n <= 0) return -1;
+        received += n;
+    }
+    return received;
+}
+
+// Run a PCM block, read into pcm, through the A/C-weighting stage; returns LAeq in dB or -1
+int process_pcm_block(SOCKET sock, int suit_id, int frames, int16_t *pcm) {
+    if (frames <= 0 || frames > PCM_MAX_BLOCK) {
+        printf("Invalid PCM block size: %d frames\n", frames);
+        return -1;
+    }
+    if (recv_all(sock, (char*)pcm, frames * (int)sizeof(int16_t)) < 0) {
+        printf("PCM block truncated: %d\n", WSAGetLastError());
+        return -1;
+    }
+    
+    int slot = (int)((unsigned)suit_id % ACOUSTIC_STREAMS);
+    if (noise_stream_owner[slot] != suit_id) {
+        // Slot taken over by another suit, start its filters from rest
+        acoustic_reset_channel(&noise_streams, slot);
+        noise_stream_owner[slot] = suit_id;
+    }
+    
+    acoustic_process_channel(&noise_streams, slot, pcm, frames);
+    AcousticLevels levels = acoustic_read_levels(&noise_streams, slot, 1);
+    printf("Acoustic block: %d frames, LAeq %.1f dB(A), LCeq %.1f dB(C), LCpeak %.1f dB(C)\n",
+           frames, levels.leq_a, levels.leq_c, levels.peak_c);
+    
+    if (levels.peak_c > NOISE_PEAK_THRESHOLD) {
+        printf("ALERT: Impulse noise peak %.1f dB(C)\n", levels.peak_c);
+        send_alert_to_control(suit_id, NOISE, (int)lround(levels.peak_c));
+    }
+    
+    return (int)lround(levels.leq_a);
+}
+
+// Bring the magnetometer table in line with the calibration file after a reload
+void refresh_mag_calibration() {
+    static const float identity[9] = {1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f};
+    static const float zero[3] = {0.0f, 0.0f, 0.0f};
+    
+    // Generation before table: a swap in between only means one more refresh
+    uint32_t generation = atomic_load_explicit(&suit_calibration.generation, memory_order_acquire);
+    MagCalibration *active = atomic_load_explicit(&suit_mag_cal, memory_order_acquire);
+    if (generation == mag_cal_generation || active == NULL) return;
+    MagCalibration *spare = (active == &suit_mag_tables[0]) ? &suit_mag_tables[1] : &suit_mag_tables[0];
+    
+    // The registry table is held for this one pass, like a lookup: the one it replaces
+    // is only freed on the swap after, CAL_RELOAD_SECONDS or more later
+    CalibrationTable *table = atomic_load_explicit(&suit_calibration.current, memory_order_acquire);
+    for (int i = 0; i < spare->count; i++) mag_calibration_set(spare, i, zero, identity);
+    int applied = 0;
+    for (uint32_t i = 0; table != NULL && i < table->magnetometer_count; i++) {
+        const MagnetometerEntry *m = &table->magnetometers[i];
+        if (m->suit_id < spare->count) {
+            mag_calibration_set(spare, m->suit_id, m->offset, m->soft);
+            applied++;
+        }
+    }
+    atomic_store_explicit(&suit_mag_cal, spare, memory_order_release);
+    mag_cal_generation = generation;
+    printf("Magnetometer calibration: %d suit(s)\n", applied);
+}
+
+// Calibrate a block of 3D samples, read into raw as x/y/z triples, and take the heading
+// from it; returns the mean field magnitude in μT or -1
+int process_magnetometer_block(SOCKET sock, int suit_id, int frames, int32_t *raw) {
+    if (frames <= 0 || frames > MAG_MAX_FRAMES) {
+        printf("Invalid magnetometer block size: %d frames\n", frames);
+        return -1;
+    }
+    if (recv_all(sock, (char*)raw, frames * 3 * (int)sizeof(int32_t)) < 0) {
+        printf("Magnetometer block truncated: %d\n", WSAGetLastError());
+        return -1;
+    }
+    float *axes = batch_arena_alloc(&ingest.arena, (size_t)frames * 5 * sizeof(float));
+    if (axes == NULL) {
+        printf("No scratch for the magnetometer block, %d frames skipped\n", frames);
+        return -1;
+    }
+    MagVectors v = {axes, axes + frames, axes + 2 * frames, frames};
+    MagOutputs out = {axes + 3 * frames, axes + 4 * frames, frames};
+    for (int i = 0; i < frames; i++) {
+        v.x[i] = raw[3 * i] / NT_PER_GAUSS;
+        v.y[i] = raw[3 * i + 1] / NT_PER_GAUSS;
+        v.z[i] = raw[3 * i + 2] / NT_PER_GAUSS;
+    }
+    
+    refresh_mag_calibration();
+    const MagCalibration *cal = atomic_load_explicit(&suit_mag_cal, memory_order_acquire);
+    if (cal != NULL && suit_id >= 0 && suit_id < cal->count) {
+        mag_block_calibrate(&v, cal, suit_id);
+    }
+    mag_batch_derive(&v, &out, 1);
+    
+    float mean = 0.0f;
+    for (int i = 0; i < frames; i++) mean += out.magnitude[i];
+    mean = mean / frames * GAUSS_TO_UT;
+    printf("Magnetometer block: %d frames, mean %.1f μT, heading %.1f°\n", frames, mean, out.heading[frames - 1]);
+    return (int)lroundf(mean);
+}
+
+double elapsed_ms(struct timespec *since) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - since->tv_sec) * 1000.0 + (now.tv_nsec - since->tv_nsec) / 1e6;
+}
+
+// Run a block of 1 kHz proximity samples, read into raw as pairs, through the collision tracker
+void process_proximity_block(SOCKET sock, int suit_id, int frames, int32_t *raw) {
+    struct timespec received;
+    CollisionAlert alert;
+    
+    clock_gettime(CLOCK_MONOTONIC, &received);
+    if (frames <= 0 || frames > PROXIMITY_MAX_FRAMES) {
+        printf("Invalid proximity block size: %d frames\n", frames);
+        return;
+    }
+    if (recv_all(sock, (char*)raw, frames * 2 * (int)sizeof(int32_t)) < 0) {
+        printf("Proximity block truncated: %d\n", WSAGetLastError());
+        return;
+    }
+    float *distance = batch_arena_alloc(&ingest.arena, frames * sizeof(float));
+    float *ambient = batch_arena_alloc(&ingest.arena, frames * sizeof(float));
+    if (distance == NULL || ambient == NULL) {
+        printf("No scratch for the proximity block, %d frames skipped\n", frames);
+        return;
+    }
+    for (int i = 0; i < frames; i++) {
+        distance[i] = raw[2 * i] / 1000.0f;
+        ambient[i] = (float)raw[2 * i + 1];
+    }
+    
+    int slot = (int)((unsigned)suit_id % PROXIMITY_STREAMS);
+    if (proximity_owner[slot] != suit_id) {
+        proximity_reset_stream(&proximity_streams, slot);
+        proximity_owner[slot] = suit_id;
+    }
+    
+    if (!proximity_process_stream(&proximity_streams, slot, distance, ambient, frames, &alert)) {
+        return;
+    }
+    
+    int distance_cm = (int)lroundf(alert.distance * 100.0f);
+    printf("COLLISION WARNING: Suit %d, object at %d cm closing at %.2f m/s, contact in %.0f ms\n",
+           suit_id, distance_cm, alert.closing_speed, alert.time_to_contact * 1000.0f);
+    printf("Ambient light: %.0f lux, photodiode current: %.2f nA\n", proximity_streams.ambient[slot],
+           photodiode_current(proximity_streams.ambient[slot]) * 1e9);
+    send_alert_to_control(suit_id, PROXIMITY, distance_cm);
+    
+    // Samples after the trigger had to wait for the block to fill on the suit
+    double latency = elapsed_ms(&received) + (frames - 1 - alert.sample) * 1000.0 / PROX_RATE_HZ;
+    if (latency > proximity_worst_latency_ms) proximity_worst_latency_ms = latency;
+    if (latency > PROX_LATENCY_BUDGET_MS) proximity_budget_misses++;
+    printf("Collision alert latency: %.2f ms (worst %.2f ms, %ld over the %.0f ms budget)\n",
+           latency, proximity_worst_latency_ms, proximity_budget_misses, PROX_LATENCY_BUDGET_MS);
+}
+
+// Run a block of Hall current samples, read into adc, through the per-cycle waveform stage
+void process_current_block(SOCKET sock, int suit_id, int frames, int16_t *adc) {
+    int max_cycles = WAVEFORM_MAX_FRAMES / 100;  // One per half cycle at 10 kHz and up
+    
+    if (frames <= 0 || frames > WAVEFORM_MAX_FRAMES) {
+        printf("Invalid current block size: %d frames\n", frames);
+        return;
+    }
+    if (recv_all(sock, (char*)adc, frames * (int)sizeof(int16_t)) < 0) {
+        printf("Current block truncated: %d\n", WSAGetLastError());
+        return;
+    }
+    CycleReport *cycles = batch_arena_alloc(&ingest.arena, max_cycles * sizeof(CycleReport));
+    if (cycles == NULL) {
+        printf("No scratch for the current block, %d frames skipped\n", frames);
+        return;
+    }
+    
+    // Started over when the suit announces a different ADC rate
+    int slot = (int)((unsigned)suit_id % WAVEFORM_STREAMS);
+    double rate = device_models(&suit_devices, suit_id).current_rate;
+    if (waveform_owner[slot] != suit_id || waveform_streams[slot].sample_rate != rate) {
+        waveform_init(&waveform_streams[slot], rate);
+        waveform_owner[slot] = suit_id;
+    }
+    
+    int done = waveform_process(&waveform_streams[slot], adc, frames, cycles, max_cycles);
+    int arc_sent = 0, overcurrent_sent = 0;
+    for (int c = 0; c < done; c++) {
+        CycleReport *r = &cycles[c];
+        // One alert of each kind per block is enough for the control module
+        if (r->arc && !arc_sent) {
+            printf("ARC FLASH: Suit %d, %.1f A RMS, peak %.1f A, crest %.2f, di/dt %.0f A/ms, %d spikes\n",
+                   suit_id, r->rms, r->peak, r->crest, r->max_didt / 1000.0, r->spikes);
+            send_alert_to_control(suit_id, ARC_FLASH, (int)lround(r->peak));
+            arc_sent = 1;
+        }
+        if (r->overcurrent && !overcurrent_sent) {
+            printf("OVERCURRENT: Suit %d, %.1f A RMS (limit %.0f A)\n", suit_id, r->rms, OVERCURRENT_RMS_A);
+            send_alert_to_control(suit_id, OVERCURRENT, (int)lround(r->rms));
+            overcurrent_sent = 1;
+        }
+    }
+    if (done > 0) {
+        CycleReport *last = &cycles[done - 1];
+        printf("Current waveform: %d half cycles, last cycle %.2f A RMS, crest %.2f, peak di/dt %.0f A/ms\n",
+               done, last->rms, last->crest, last->max_didt / 1000.0);
+    }
+}
+
+const char* get_param_name(int code) {
+    switch(code) {
+        case TEMPERATURE: return "Temperature";
+        case RADIATION: return "Radiation";
+        case CHEMICAL: return "Chemical";
+        case OXYGEN: return "Oxygen";
+        case NOISE: return "Noise";
+        case VOLTAGE: return "Voltage";
+        case MAGNETIC: return "Magnetic";
+        case PROXIMITY: return "Proximity";
+        case ARC_FLASH: return "Arc Flash";
+        case OVERCURRENT: return "Overcurrent";
+        case DEVICE_PROFILE: return "Device Profile";
+        case HEARTBEAT: return "Heartbeat";
+        case MAN_DOWN: return "Man Down";
+        case THERMAL_SAMPLE: return "Thermal Sample";
+        case HAZARD_INDEX: return "Hazard Index";
+        default: return "Unknown";
+    }
+}
+
+// RTD reading at a known temperature: what the probe reads there is its drift
+void process_rtd_reference(int suit_id, int reference_temp) {
+    const RtdModel *rtd = device_models(&suit_devices, suit_id).rtd;
+    CalibrationEntry cal;
+    calibration_lookup(&suit_calibration, suit_id, TEMPERATURE, &cal);
+    double age = calibration_years(cal.install_day, calibration_today());
+    int years_in_service = (age >= 0) ? (int)lround(age) : DEFAULT_YEARS_IN_SERVICE;
+    
+    double rtd_reading = rtd->read((double)reference_temp, years_in_service);
+    double drift = filter_rtd_reference(&suit_filters, suit_id, rtd_reading, reference_temp,
+                                        rtd->drift_rate, years_in_service, cal.install_day);
+    printf("\nSuit %d RTD reference check at %d°C: read %.2f°C, drift estimate %.3f%%\n",
+           suit_id, reference_temp, rtd_reading, drift * 100.0);
+}
+
+// Process sensor readings with appropriate sensor models, then filter per suit and channel
+double process_sensor_reading(int suit_id, int param_code, int raw_value) {
+    double processed_value = raw_value;
+    SuitDevices devices = device_models(&suit_devices, suit_id);
+    CalibrationEntry cal;
+    calibration_lookup(&suit_calibration, suit_id, param_code, &cal);
+    int32_t today = calibration_today();
+    PROFILE_MARK(PROFILE_LOOKUP);
+    
+    switch(param_code) {
+        case TEMPERATURE: {
+            // Use the suit's RTD model for temperature, aged from its install date
+            const RtdModel *rtd = devices.rtd;
+            double age = calibration_years(cal.install_day, today);
+            int years_in_service = (age >= 0) ? (int)lround(age) : DEFAULT_YEARS_IN_SERVICE;
+            double rtd_reading = rtd->read((double)raw_value, years_in_service);
+            double resistance = rtd->resistance((double)raw_value);
+            double drift = filter_rtd_drift(&suit_filters, suit_id, rtd->drift_rate, years_in_service, cal.install_day);
+            double compensated = rtd->compensate(rtd_reading, drift);
+            PROFILE_MARK(PROFILE_MODEL);
+            printf("RTD Sensor (%s) reading: %.2f°C (raw: %d°C), drift compensated: %.2f°C\n",
+                   rtd->name, rtd_reading, raw_value, compensated);
+            printf("RTD Resistance: %.2f ohms\n", resistance);
+            PROFILE_MARK(PROFILE_REPORT);
+            processed_value = compensated;
+            break;
+        }
+        case RADIATION: {
+            // Simulate radiation counts for the given level
+            int counts = simulate_radiation_counts((double)raw_value, 10.0); // 10-second integration
+            int detection = detect_radiation((double)raw_value);
+            PROFILE_MARK(PROFILE_MODEL);
+            printf("Radiation detector: %d counts in 10s, Detection: %s\n", 
+                   counts, detection ? "POSITIVE" : "NEGATIVE");
+            printf("Radiation sensitivity: %.1f counts per μSv\n", RAD_SENSITIVITY);
+            PROFILE_MARK(PROFILE_REPORT);
+            
+            // Create a simple spectrum for demonstration
+            int *spectrum = batch_arena_alloc(&ingest.arena, 128 * sizeof(int));
+            int isotope = 0;
+            if (spectrum != NULL) {
+                for (int i = 0; i < 128; i++) {
+                    spectrum[i] = (int)(counts * exp(-(pow(i - raw_value/2, 2) / 200.0)));
+                }
+                isotope = identify_isotope(spectrum, 128);
+            }
+            PROFILE_MARK(PROFILE_MODEL);
+            if (isotope > 0) {
+                printf("Isotope identification: Type %d detected\n", isotope);
+            }
+            PROFILE_MARK(PROFILE_REPORT);
+            
+            processed_value = raw_value;
+            break;
+        }
+        case CHEMICAL: {
+            // Simulate electrochemical sensor for CO gas
+            double interfering_conc[7] = {0}; // No interfering gases in this simulation
+            const EcModel *ec = devices.ec;
+            double sensor_current = ec->current(GAS_CO, (double)raw_value, interfering_conc);
+            double corrected_conc = ec->concentration(sensor_current, GAS_CO);
+            
+            // Compensate for sensitivity lost with cell age
+            double cell_years = calibration_years(cal.cell_day, today);
+            if (cell_years > 0) {
+                corrected_conc /= fmax(1.0 - CAL_CELL_SENSITIVITY_LOSS * cell_years, 0.5);
+            }
+            
+            // Apply temperature effect at the suit's own filtered temperature
+            ChannelFilter *ambient = filter_channel(&suit_filters, suit_id, TEMPERATURE);
+            double ambient_temp = (ambient != NULL && ambient->variance > 0.0f)
+                ? ambient->estimate : DEFAULT_AMBIENT_TEMP;
+            corrected_conc = apply_temperature_effect(corrected_conc, ambient_temp);
+            PROFILE_MARK(PROFILE_MODEL);
+            
+            if (cal.bump_day && today - cal.bump_day > CAL_BUMP_INTERVAL_DAYS) {
+                printf("Chemical sensor bump test overdue: last tested %d days ago\n", today - cal.bump_day);
+            }
+            
+            printf("Chemical sensor: %.2f ppm CO (raw: %d ppm) at %.1f°C\n", corrected_conc, raw_value, ambient_temp);
+            printf("Sensor current: %.2f nA, Zero current: %.2f nA\n", sensor_current, ec->zero_current);
+            printf("Sensitivity: %.2f nA/ppm (%s)\n", ec->sensitivity, ec->name);
+            PROFILE_MARK(PROFILE_REPORT);
+            processed_value = corrected_conc;
+            break;
+        }
+        case OXYGEN: {
+            // Galvanic cell at the suit's own filtered temperature, aged from its fitting date
+            ChannelFilter *ambient = filter_channel(&suit_filters, suit_id, TEMPERATURE);
+            double ambient_temp = (ambient != NULL && ambient->variance > 0.0f)
+                ? ambient->estimate : DEFAULT_AMBIENT_TEMP;
+            double cell_years = calibration_years(cal.cell_day, today);
+            if (cell_years < 0) cell_years = 0;
+            
+            double cell_output = o2_cell_output((double)raw_value, ambient_temp, O2_CELL_REFERENCE_PRESSURE, cell_years);
+            double o2_percent = o2_cell_percent(cell_output, ambient_temp, O2_CELL_REFERENCE_PRESSURE, cell_years);
+            PROFILE_MARK(PROFILE_MODEL);
+            
+            if (o2_cell_expired(cell_years)) {
+                printf("Oxygen cell past its service life: %.1f years in service, output %.0f%% of a new cell\n",
+                       cell_years, o2_cell_wear(cell_years) * 100.0);
+            }
+            
+            printf("Oxygen sensor: %.1f%% O2 (raw: %d%%) at %.1f°C\n", o2_percent, raw_value, ambient_temp);
+            printf("Galvanic cell output: %.2f mV (%.2f mV in air when new)\n", cell_output,
+                   O2_CELL_OFFSET + O2_CELL_SENSITIVITY * O2_AIR_PERCENT);
+            PROFILE_MARK(PROFILE_REPORT);
+            processed_value = o2_percent;
+            break;
+        }
+        case NOISE: {
+            // Convert dB to Pascal for acoustic sensor
+            double pascal_value = dbspl_to_pascal((double)raw_value);
+            double mic_voltage = devices.mic->output(pascal_value);
+            
+            // Apply frequency response (assuming 1kHz noise)
+            double freq_adjusted = devices.mic->frequency_response(mic_voltage, 1000.0);
+            PROFILE_MARK(PROFILE_MODEL);
+            
+            printf("Acoustic sensor: %.2f dB SPL (raw: %d dB), Mic output: %.6f V\n", 
+                   (double)raw_value, raw_value, freq_adjusted);
+            PROFILE_MARK(PROFILE_REPORT);
+            processed_value = raw_value;
+            break;
+        }
+        case VOLTAGE: {
+            // Use Hall effect sensor for voltage/field measurement
+            double field_strength = calculate_efield_strength((double)raw_value, 1.0); // Assuming 1m distance
+            int safety_level = get_voltage_safety_level((double)raw_value);
+            
+            // Simulate Hall effect sensor output
+            double magnetic_field = raw_value / 100.0; // Simplified conversion
+            double hall_output = devices.hall->output(magnetic_field);
+            
+            // Simulate proximity detection
+            int voltage_detected = detect_voltage_presence((double)raw_value, 0.5); // 0.5m distance
+            PROFILE_MARK(PROFILE_MODEL);
+            
+            printf("Voltage sensor: %d V\n", raw_value);
+            printf("Electric field strength: %.2f V/m\n", field_strength);
+            printf("Safety level: %d\n", safety_level);
+            printf("Hall sensor (%s) output: %.3f V (for %.2f mT)\n", devices.hall->name, hall_output, magnetic_field);
+            if (voltage_detected) {
+                printf("WARNING: Live voltage detected in proximity!\n");
+            }
+            PROFILE_MARK(PROFILE_REPORT);
+            
+            processed_value = raw_value;
+            break;
+        }
+        case MAGNETIC: {
+            // Field magnitude arrives in μT, already reduced from the suit's three axes
+            // (and calibrated, when it came from a sample block); it is taken as measured.
+            // Magnetoresistive sensor as a cross-check (mT, 5 V supply)
+            double mr_output = magnetoresistive_output(raw_value / 1000.0, 5.0);
+            PROFILE_MARK(PROFILE_MODEL);
+            
+            printf("3D magnetometer: %d μT\n", raw_value);
+            printf("Magnetoresistive output: %.4f V\n", mr_output);
+            PROFILE_MARK(PROFILE_REPORT);
+            processed_value = raw_value;
+            break;
+        }
+        case PROXIMITY: {
+            // Single IR proximity reading in cm
+            double measured = read_proximity(raw_value / 100.0) * 100.0;
+            PROFILE_MARK(PROFILE_MODEL);
+            printf("IR proximity: %.1f cm (raw: %d cm)\n", measured, raw_value);
+            PROFILE_MARK(PROFILE_REPORT);
+            processed_value = measured;
+            break;
+        }
+    }
+    
+    // Per-device offset and gain, identity when the suit has no calibration entry
+    processed_value = calibration_apply(&cal, processed_value);
+    
+    // The previous report held for the samples the suit did not send
+    double held;
+    int held_samples = hold_advance(&suit_holds, suit_id, param_code, processed_value, monotonic_ms(), &held);
+    if (held_samples > 0) filter_hold(&suit_filters, suit_id, param_code, held, held_samples);
+    PROFILE_MARK(PROFILE_CALIBRATE);
+    
+    // Smooth single-sample spikes before the threshold check
+    FilterOutput filtered = filter_update(&suit_filters, suit_id, param_code, processed_value);
+    PROFILE_MARK(PROFILE_FILTER);
+    printf("Filtered %s: %.2f (variance %.3f)\n",
+           get_param_name(param_code), filtered.value, filtered.variance);
+    PROFILE_MARK(PROFILE_REPORT);
+    
+    return filtered.value;
+}
+
+// The /profile page: stage breakdown labelled with parameter names
+int render_stage_profile(char *buf, size_t size) {
+    return profile_render(buf, size, get_param_name);
+}
+
+// Close the connection's batch and account for its memory use
+void end_ingest_batch() {
+    long overflows = ingest.arena.overflows;
+    int allocations = ingest_batch_end(&ingest);
+    if (allocations > 0) {
+        printf("Connection made %d heap allocation(s) on the reading path\n", allocations);
+        metric_add(metric_heap_allocations, 0, (uint64_t)allocations);
+    }
+    metric_add(metric_arena_overflows, 0, (uint64_t)(ingest.arena.overflows - overflows));
+    metric_set(metric_arena_high_water, 0, (uint64_t)ingest.arena.high_water);
+}
+
+// One accepted connection: the header and any sample block are read into the
+// connection's receive buffer, scratch comes from the batch arena
+void handle_connection(SOCKET sock, char *buffer) {
+    int *data = (int *)buffer;
+    char *payload = buffer + SENSOR_HEADER_BYTES;
+    capture_begin(sock);
+    
+    // Suit ID is optional on the wire, older senders only send two integers
+    int valread = recv_header(sock, data);
+    
+    if (valread >= 0) {
+        int param_code = data[0];
+        int value = data[1];
+        int suit_id = (valread == SENSOR_HEADER_BYTES) ? data[2] : 0;
+        
+        if (param_code & SAMPLE_BLOCK_FLAG) {
+            metric_inc(metric_sample_blocks, param_code & ~SAMPLE_BLOCK_FLAG);
+        } else {
+            metric_inc(metric_readings, param_code & ~REFERENCE_FLAG);
+        }
+        
+        suit_heard(suit_id);
+        
+        // Backpressure: tell the sender how far alerts are backed up, older senders just close
+        if (!(param_code & (SAMPLE_BLOCK_FLAG | REFERENCE_FLAG)) && param_code != DEVICE_PROFILE &&
+            param_code != HEARTBEAT) {
+            int pressure = alert_pressure(suit_id);
+            send(sock, (char*)&pressure, sizeof(pressure), 0);
+        }
+        
+        // Suits announce their sensor hardware once, on connection
+        if (param_code == DEVICE_PROFILE) {
+            char models[64];
+            if (device_profile_set(&suit_devices, suit_id, value) == 0) {
+                device_profile_describe(value, models, sizeof(models));
+                printf("\nSuit %d device profile: %s\n", suit_id, models);
+            } else {
+                printf("\nSuit %d sent an invalid device profile 0x%x\n", suit_id, value);
+            }
+            return;
+        }
+        
+        if (param_code == HEARTBEAT) {
+            suit_heartbeat(suit_id, value);
+            return;
+        }
+        
+        if (param_code == (TEMPERATURE | REFERENCE_FLAG)) {
+            process_rtd_reference(suit_id, value);
+            return;
+        }
+        
+        // Collision stream blocks bypass the per-reading pipeline
+        if (param_code == (PROXIMITY | SAMPLE_BLOCK_FLAG)) {
+            process_proximity_block(sock, suit_id, value, (int32_t *)payload);
+            return;
+        }
+        
+        // Hall current waveforms raise their own arc-flash and overcurrent alerts
+        if (param_code == (VOLTAGE | SAMPLE_BLOCK_FLAG)) {
+            process_current_block(sock, suit_id, value, (int16_t *)payload);
+            return;
+        }
+        
+        // 3D magnetometer samples: the calibrated mean magnitude becomes the magnetic reading
+        if (param_code == (MAGNETIC | SAMPLE_BLOCK_FLAG)) {
+            param_code = MAGNETIC;
+            value = process_magnetometer_block(sock, suit_id, value, (int32_t *)payload);
+            if (value < 0) {
+                return;
+            }
+        }
+        
+        // Raw mic PCM: the level from the block becomes the noise reading
+        if (param_code == (NOISE | SAMPLE_BLOCK_FLAG)) {
+            param_code = NOISE;
+            value = process_pcm_block(sock, suit_id, value, (int16_t *)payload);
+            if (value < 0) {
+                return;
+            }
+        }
+        
+        PROFILE_START(param_code);
+        printf("\nReceived from environment: Suit %d, Parameter Code %d (%s), Value %d\n", 
+               suit_id, param_code, get_param_name(param_code), value);
+        PROFILE_MARK(PROFILE_REPORT);
+        
+        // Process sensor reading with appropriate sensor model
+        double processed_value = process_sensor_reading(suit_id, param_code, value);
+        
+        // Log data to CSV (using the original value for consistency)
+        if (metrics_sample_timing()) {
+            double log_start = metrics_now();
+            log_data(param_code, value);
+            metric_observe(metric_log_write, metrics_now() - log_start);
+        } else {
+            log_data(param_code, value);
+        }
+        PROFILE_MARK(PROFILE_LOG);
+        
+        // Check if the filtered value exceeds threshold
+        int alarm = check_threshold(suit_id, param_code, (int)lround(processed_value));
+        
+        // Every filtered temperature feeds the suit's control loop, batched per shard
+        if (param_code == TEMPERATURE) {
+            queue_thermal_sample(suit_id, processed_value);
+        }
+        PROFILE_MARK(PROFILE_THRESHOLD);
+        
+        // Keep the suit's state; the alarm flag follows the filtered value
+        switch (suit_state_update(&suit_states, suit_id, param_code, processed_value, monotonic_ms(), alarm)) {
+            case 1:
+                printf("Suit %d: %s alarm raised\n", suit_id, get_param_name(param_code));
+                break;
+            case -1:
+                printf("Suit %d: %s back within threshold\n", suit_id, get_param_name(param_code));
+                break;
+            case -2:
+                printf("Suit table full, suit %d is not tracked\n", suit_id);
+                break;
+        }
+        PROFILE_MARK(PROFILE_STATE);
+        
+        // Predict crossings before they happen
+        check_trend(suit_id, param_code, processed_value);
+        PROFILE_MARK(PROFILE_TREND);
+        
+        // Hazards that are each below their threshold can still add up
+        check_hazard_index(suit_id, param_code, processed_value);
+        PROFILE_MARK(PROFILE_HAZARD);
+    } else {
+        printf("Dropping connection with a truncated reading header\n");
+        metric_inc(metric_truncated_headers, 0);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    WSADATA wsaData;
+    SOCKET server_fd = INVALID_SOCKET, new_socket = INVALID_SOCKET;
+    struct sockaddr_in address;
+    socklen_t addrlen = sizeof(address);
+    
+    // With LISTEN_WORKERS set this process only supervises, workers continue from here.
+    // Filters, trends, holds, suit state and deadlines need every reading of a suit, and
+    // SO_REUSEPORT spreads a suit's connections over all workers, so there is only one.
+    listen_workers_start("Sensor", 1);
+    
+    // REPLAY_CLOCK: module time follows the capture being replayed into this sensor
+    if (replay_clock_open() != 0) {
+        printf("Replay clock %s is not a readable capture\n", getenv(REPLAY_CLOCK_ENV));
+        return 1;
+    }
+    if (replay_clock.active) printf("Module time taken from capture %s\n", getenv(REPLAY_CLOCK_ENV));
+    
+    // Initialize Winsock
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+        printf("WSAStartup failed: %d\n", WSAGetLastError());
+        return 1;
+    }
+    
+    // Creating socket
+    if ((server_fd = socket(AF_INET, SOCK_STREAM, 0)) == INVALID_SOCKET) {
+        printf("Socket creation error: %d\n", WSAGetLastError());
+        WSACleanup();
+        return 1;
+    }
+    
+    // Setup socket options to allow address reuse
+    int opt = 1;
+    if (setsockopt(server_fd, SOL_SOCKET, SO_REUSEADDR, (char*)&opt, sizeof(opt)) == SOCKET_ERROR) {
+        printf("Setsockopt error: %d\n", WSAGetLastError());
+        closesocket(server_fd);
+        WSACleanup();
+        return 1;
+    }
+    
+    // Workers share the port, the kernel balances connections between them
+    if (listen_workers_configure(server_fd) != 0) {
+        printf("SO_REUSEPORT error: %d\n", WSAGetLastError());
+        closesocket(server_fd);
+        WSACleanup();
+        return 1;
+    }
+    
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = INADDR_ANY;
+    address.sin_port = htons(PORT_SENSOR);
+    
+    // Bind the socket to the port
+    if (bind(server_fd, (struct sockaddr *)&address, sizeof(address)) == SOCKET_ERROR) {
+        printf("Bind failed: %d\n", WSAGetLastError());
+        closesocket(server_fd);
+        WSACleanup();
+        return 1;
+    }
+    
+    if (listen(server_fd, LISTEN_BACKLOG) == SOCKET_ERROR) {
+        printf("Listen error: %d\n", WSAGetLastError());
+        closesocket(server_fd);
+        WSACleanup();
+        return 1;
+    }
+    
+    printf("Sensor module started. Listening on port %d...\n", PORT_SENSOR);
+    printf("Date: March 01, 2025, 10:30 PM IST\n");
+    printf("Smart Suit for Industrial Workers - Sensor Module\n");
+    printf("------------------------------------------------\n");
+    
+    init_control_ring(argc, argv);
+    if (suit_state_init(&suit_states, SUIT_STATE_SUITS) != 0) {
+        printf("Suit state allocation failed\n");
+        return 1;
+    }
+    init_metrics();
+    metrics_start_server(PORT_SENSOR + METRICS_PORT_OFFSET + listen_workers.index * LISTEN_METRICS_STRIDE);
+    if (filter_bank_init(&suit_filters, FILTER_MAX_SUITS) != 0) {
+        printf("Filter state allocation failed, readings will not be filtered\n");
+    }
+    if (ingest_memory_init(&ingest, SENSOR_RECEIVE_BUFFERS, SENSOR_RECEIVE_BYTES, SENSOR_ARENA_BYTES) != 0) {
+        printf("Receive buffer allocation failed\n");
+        return 1;
+    }
+    if (ingest_alloc_tracking()) printf("Counting heap allocations on the reading path\n");
+    
+    // Everything the reading path opens is opened now: the logs, and the time zone for their timestamps
+    open_logs();
+    tzset();
+    if (hold_bank_init(&suit_holds, FILTER_MAX_SUITS) != 0) {
+        printf("Held value allocation failed, readings are filtered as if sent at full rate\n");
+    }
+    const char *calibration_file = getenv("CALIBRATION_FILE");
+    calibration_registry_init(&suit_calibration, calibration_file ? calibration_file : CAL_DEFAULT_FILE);
+    CalibrationTable *calibrated = atomic_load(&suit_calibration.current);
+    printf("Calibration: %u entries from %s\n", calibrated ? calibrated->count : 0, suit_calibration.path);
+    if (calibration_start_reloader(&suit_calibration) != 0) {
+        printf("Calibration reloader failed to start, edits need a restart\n");
+    }
+    if (device_registry_init(&suit_devices, FILTER_MAX_SUITS) != 0) {
+        printf("Device profile allocation failed, all suits use the default sensors\n");
+    }
+    if (trend_bank_init(&suit_trends, PREDICT_MAX_SUITS) != 0) {
+        printf("Trend state allocation failed, early warnings disabled\n");
+    }
+    printf("Early warning lead time: %.0f s\n", suit_trends.lead_time_s);
+    if (hazard_bank_init(&suit_hazards, HAZARD_MAX_SUITS) != 0) {
+        printf("Hazard index allocation failed, combined hazard severity disabled\n");
+    }
+    publish_hazard_census();
+    if (acoustic_bank_init(&noise_streams, ACOUSTIC_STREAMS, PCM_SAMPLE_RATE) != 0) {
+        printf("Acoustic state allocation failed\n");
+        return 1;
+    }
+    for (int i = 0; i < ACOUSTIC_STREAMS; i++) noise_stream_owner[i] = -1;
+    if (mag_calibration_init(&suit_mag_tables[0], MAG_CAL_SUITS) != 0 ||
+        mag_calibration_init(&suit_mag_tables[1], MAG_CAL_SUITS) != 0) {
+        printf("Magnetometer calibration allocation failed\n");
+        return 1;
+    }
+    atomic_store(&suit_mag_cal, &suit_mag_tables[0]);
+    refresh_mag_calibration();
+    if (proximity_bank_init(&proximity_streams, PROXIMITY_STREAMS) != 0) {
+        printf("Proximity state allocation failed\n");
+        return 1;
+    }
+    for (int i = 0; i < PROXIMITY_STREAMS; i++) proximity_owner[i] = -1;
+    for (int i = 0; i < WAVEFORM_STREAMS; i++) waveform_owner[i] = -1;
+    printf("Routing alerts to %d control shard(s)\n", control_ring.shard_count);
+    const char *alarm_group = getenv(ALARM_MULTICAST_ENV);
+    if (alarm_group != NULL && *alarm_group != '\0') {
+        if (alarm_publisher_open(&alarm_publisher, alarm_group) != 0) {
+            printf("Invalid alarm multicast group %s, critical alerts go to control only\n", alarm_group);
+        } else {
+            printf("Publishing critical alerts to multicast group %s\n", alarm_group);
+        }
+    }
+    if (timer_wheel_init(&suit_deadlines, DEADMAN_MAX_SUITS, monotonic_ms()) != 0) {
+        printf("Deadline timer allocation failed, man-down detection disabled\n");
+    }
+    
+    // Initialize random seed for sensor simulation, NOISE_SEED makes a replay draw the same noise
+    uint32_t seed = noise_seed();
+    srand(seed);
+    if (capture_open(PORT_SENSOR, listen_workers.count > 0 ? listen_workers.index : -1, seed) != 0) {
+        printf("Capture file %s cannot be written\n", capture.path);
+        closesocket(server_fd);
+        WSACleanup();
+        return 1;
+    }
+    if (capture.file != NULL) printf("Capturing received traffic to %s (noise seed %u)\n", capture.path, seed);
+    
+#ifdef STAGE_PROFILE
+    // Breakdown on demand from the metrics port, and at exit once a stop signal drains the loop
+    int profile_events = profile_init();
+    if (profile_events > 0) {
+        printf("Stage profiling with %d hardware counter(s), breakdown at /profile\n", profile_events);
+    } else {
+        printf("Hardware counters unavailable, stage profiling by wall time only, breakdown at /profile\n");
+    }
+    metrics_set_page("/profile", render_stage_profile);
+    listen_workers_drain_on_signal(server_fd);
+#endif
+    
+    listen_workers_ready();
+    while (1) {
+        // Keep retrying held alerts, watching deadlines and answering alarm NACKs while no reading is waiting
+        while ((alerts_pending() || thermal_pending() || logs_unflushed || suit_deadlines.armed > 0 ||
+                alarm_publisher.sock != INVALID_SOCKET) &&
+               !listen_workers.draining && !connection_waiting(server_fd, idle_poll_ms())) {
+            check_deadlines();
+            flush_control_queues();
+            flush_due_thermal_batches();
+            flush_logs_if_due();
+            service_alarm_publisher();
+        }
+        check_deadlines();
+        
+        if ((new_socket = listen_workers_accept(server_fd, (struct sockaddr *)&address, &addrlen)) == INVALID_SOCKET) {
+            if (listen_workers.drained) break;  // Drain requested and the queue is empty
+            printf("Accept error: %d\n", WSAGetLastError());
+            continue;
+        }
+        // Under a replay clock, the deadline checks the idle loop made while the captured
+        // connection was on its way
+        if (replay_clock_next()) {
+            while (replay_clock_step(idle_poll_ms())) check_deadlines();
+        }
+        
+        // A batch is one connection, handled in its own receive buffer
+        char *buffer = buffer_pool_acquire(&ingest.receive);
+        if (buffer == NULL) {
+            printf("No receive buffer free, connection dropped\n");
+            metric_inc(metric_receive_exhausted, 0);
+            closesocket(new_socket);
+            continue;
+        }
+        ingest_batch_begin(&ingest);
+        handle_connection(new_socket, buffer);
+        closesocket(new_socket);
+        end_ingest_batch();
+        buffer_pool_release(&ingest.receive, buffer);
+        flush_due_thermal_batches();
+        flush_logs_if_due();
+    }
+    
+    proximity_bank_free(&proximity_streams);
+    atomic_store(&suit_mag_cal, NULL);
+    mag_calibration_free(&suit_mag_tables[0]);
+    mag_calibration_free(&suit_mag_tables[1]);
+    acoustic_bank_free(&noise_streams);
+    hazard_bank_free(&suit_hazards);
+    trend_bank_free(&suit_trends);
+    device_registry_free(&suit_devices);
+    suit_state_free(&suit_states);
+    timer_wheel_free(&suit_deadlines);
+    calibration_registry_free(&suit_calibration);
+    hold_bank_free(&suit_holds);
+    filter_bank_free(&suit_filters);
+    capture_close();
+    replay_clock_close();
+    close_logs();
+    ingest_memory_free(&ingest);
+#ifdef STAGE_PROFILE
+    profile_dump(stdout, get_param_name);
+    profile_free();
+#endif
+    alarm_publisher_close(&alarm_publisher);
+    closesocket(server_fd);
+    WSACleanup();
+    return 0;
+}
@@ -0,0 +1,225 @@
+#ifndef SENSOR_FILTER_H
+#define SENSOR_FILTER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include "temperature_sensor.h"
+
+// Per-suit, per-channel Kalman filtering of processed sensor values
+#define FILTER_MAX_SUITS 100000  // Suits with their own filter state
+#define FILTER_CHANNELS 8  // One per parameter code (code - 1)
+#define FILTER_DRIFT_VARIANCE 1e-4  // Prior uncertainty of the RTD drift factor
+#define FILTER_REFERENCE_VARIANCE 1e-6  // Noise of a drift estimate from a reference reading
+#define FILTER_DRIFT_WALK 1e-6  // Drift variance added between reference readings, the probe keeps ageing
+
+// One filter channel, 8 bytes so a suit's channels fill one cache line
+typedef struct {
+    float estimate;  // Filtered value
+    float variance;  // Error variance of the estimate, 0 = not started
+} ChannelFilter;
+
+typedef struct {
+    ChannelFilter channel[FILTER_CHANNELS];
+} SuitFilters;
+
+// RTD drift estimate of a suit's temperature probe, kept beside the channel filters
+// since only the temperature channel has one
+typedef struct {
+    float drift;  // Estimated multiplicative drift
+    float drift_variance;  // 0 = not seeded
+    int32_t install_day;  // Install day the prior was seeded from
+} RtdDrift;
+
+typedef struct {
+    SuitFilters *suits;  // Indexed by suit ID
+    RtdDrift *rtd;  // Indexed by suit ID
+    int suit_count;
+} FilterBank;
+
+typedef struct {
+    double value;
+    double variance;
+} FilterOutput;
+
+// Process noise (random walk per sample) and measurement noise per channel,
+// derived from the sensor model error terms
+const double FILTER_PROCESS_NOISE[FILTER_CHANNELS] = {
+    0.05,  // Temperature, °C²
+    0.5,   // Radiation, (μSv/h)²
+    0.5,   // Chemical, ppm²
+    0.01,  // Oxygen, %²
+    1.0,   // Noise, dB²
+    25.0,  // Voltage, V²
+    25.0,  // Magnetic, μT²
+    4.0    // Proximity, cm²
+};
+
+const double FILTER_MEASUREMENT_NOISE[FILTER_CHANNELS] = {
+    0.09,  // TEMP_ACCURACY²
+    4.0,   // Poisson spread at the alert threshold
+    0.25,  // EC noise plus EC_RESOLUTION
+    0.04,  // Oxygen
+    4.0,   // Noise
+    100.0, // Voltage
+    2.0,   // Magnetic, MAG3D_ACCURACY error at the alert threshold
+    1.0    // Proximity, PROX_ACCURACY noise at the alert threshold
+};
+
+int filter_bank_init(FilterBank *bank, int suit_count) {
+    // Aligned to a cache line so a suit never straddles more lines than needed
+    size_t bytes = (size_t)suit_count * sizeof(SuitFilters);
+#ifdef _WIN32
+    bank->suits = _aligned_malloc(bytes, 64);
+#else
+    bank->suits = aligned_alloc(64, (bytes + 63) & ~(size_t)63);
+#endif
+    bank->rtd = calloc((size_t)suit_count, sizeof(RtdDrift));
+    if (bank->suits == NULL || bank->rtd == NULL) {
+#ifdef _WIN32
+        _aligned_free(bank->suits);
+#else
+        free(bank->suits);
+#endif
+        free(bank->rtd);
+        bank->suits = NULL;
+        bank->rtd = NULL;
+        bank->suit_count = 0;
+        return -1;
+    }
+    memset(bank->suits, 0, bytes);
+    bank->suit_count = suit_count;
+    return 0;
+}
+
+void filter_bank_free(FilterBank *bank) {
+#ifdef _WIN32
+    _aligned_free(bank->suits);
+#else
+    free(bank->suits);
+#endif
+    free(bank->rtd);
+    bank->suits = NULL;
+    bank->rtd = NULL;
+    bank->suit_count = 0;
+}
+
+ChannelFilter *filter_channel(FilterBank *bank, int suit_id, int param_code) {
+    if (suit_id < 0 || suit_id >= bank->suit_count) return NULL;
+    if (param_code < 1 || param_code > FILTER_CHANNELS) return NULL;
+    return &bank->suits[suit_id].channel[param_code - 1];
+}
+
+// Constant-time scalar Kalman update with a random-walk process model
+FilterOutput filter_update(FilterBank *bank, int suit_id, int param_code, double measurement) {
+    FilterOutput out = {measurement, 0.0};
+    ChannelFilter *f = filter_channel(bank, suit_id, param_code);
+    if (f == NULL) {
+        // No state for this suit, pass the reading through
+        out.variance = (param_code >= 1 && param_code <= FILTER_CHANNELS)
+            ? FILTER_MEASUREMENT_NOISE[param_code - 1] : 0.0;
+        return out;
+    }
+
+    double r = FILTER_MEASUREMENT_NOISE[param_code - 1];
+    if (f->variance <= 0.0f) {
+        // First sample seeds the filter
+        f->estimate = (float)measurement;
+        f->variance = (float)r;
+    } else {
+        double p = f->variance + FILTER_PROCESS_NOISE[param_code - 1];  // Predict
+        double gain = p / (p + r);
+        f->estimate = (float)(f->estimate + gain * (measurement - f->estimate));
+        f->variance = (float)((1.0 - gain) * p);
+    }
+
+    out.value = f->estimate;
+    out.variance = f->variance;
+    return out;
+}
+
+// Feed a value held between deadband reports as `samples` repeated measurements, in
+// closed form. The variance step P' = r(P + q) / (P + q + r) is a Mobius map, so n steps
+// are the matrix power M^n with M = [[r, rq], [1, q + r]] applied to (P, 1); the estimate
+// closes on the held value by r^n / v_n, where v_n is the second component. Both come
+// from the eigenvalues of M (their product is r^2) without overflow for any n.
+void filter_hold(FilterBank *bank, int suit_id, int param_code, double held, int samples) {
+    ChannelFilter *f = filter_channel(bank, suit_id, param_code);
+    if (f == NULL || f->variance <= 0.0f || samples <= 0) return;
+
+    double q = FILTER_PROCESS_NOISE[param_code - 1];  // Positive on every channel
+    double r = FILTER_MEASUREMENT_NOISE[param_code - 1];
+    double root = sqrt(q * q + 4.0 * q * r);
+    double high = (2.0 * r + q + root) / 2.0, low = (2.0 * r + q - root) / 2.0;
+    double ratio = pow(low / high, samples);
+
+    // M^n / high^n = ((M - low I) - ratio (M - high I)) / (high - low)
+    double u = ((r - low) - ratio * (r - high)) * f->variance + r * q * (1.0 - ratio);
+    double v = (1.0 - ratio) * f->variance + ((q + r - low) - ratio * (q + r - high));
+    u /= root;
+    v /= root;
+    f->estimate = (float)(held + (f->estimate - held) * sqrt(ratio) / v);
+    f->variance = (float)(u / v);
+}
+
+// Seed the RTD drift estimate from the service-age model if not yet known
+void filter_init_drift_rate(RtdDrift *d, double drift_rate, int years_in_service) {
+    if (d->drift_variance <= 0.0f) {
+        d->drift = (float)(drift_rate * years_in_service);
+        d->drift_variance = (float)FILTER_DRIFT_VARIANCE;
+    }
+}
+
+// A suit's RTD drift state with its prior in place. A new install day means a new
+// probe: what was learned about the old one is dropped and the prior seeded again.
+static RtdDrift *filter_rtd_state(FilterBank *bank, int suit_id, double drift_rate,
+                                  int years_in_service, int32_t install_day) {
+    if (suit_id < 0 || suit_id >= bank->suit_count) return NULL;
+    RtdDrift *d = &bank->rtd[suit_id];
+    if (d->install_day != install_day) {
+        d->install_day = install_day;
+        d->drift_variance = 0.0f;
+    }
+    filter_init_drift_rate(d, drift_rate, years_in_service);
+    return d;
+}
+
+// Current drift estimate of a suit's RTD; drift_rate * years_in_service is only the prior,
+// reference readings (filter_rtd_reference) refine it. install_day is 0 when unknown.
+double filter_rtd_drift(FilterBank *bank, int suit_id, double drift_rate, int years_in_service,
+                        int32_t install_day) {
+    RtdDrift *d = filter_rtd_state(bank, suit_id, drift_rate, years_in_service, install_day);
+    return (d != NULL) ? d->drift : drift_rate * years_in_service;
+}
+
+// Undo multiplicative drift on an RTD reading:
+// T_meas = T * (1 + k) + k / ALPHA, so T = (T_meas - k / ALPHA) / (1 + k)
+double compensate_rtd_drift(double measured_temp, double drift) {
+    return (measured_temp - drift / ALPHA) / (1.0 + drift);
+}
+
+// RTD reading with drift compensation; years_in_service is only the prior
+double filter_rtd_reading(FilterBank *bank, int suit_id, double rtd_reading, int years_in_service) {
+    return compensate_rtd_drift(rtd_reading, filter_rtd_drift(bank, suit_id, DRIFT_RATE, years_in_service, 0));
+}
+
+// Refine the drift estimate from a reading taken at a known reference temperature
+// (e.g. a dock or bump test), solving T_meas = T_ref * (1 + k) + k / ALPHA for k.
+// The drift is a random walk between references, so the estimate follows an ageing
+// probe. Returns the updated estimate.
+double filter_rtd_reference(FilterBank *bank, int suit_id, double rtd_reading, double reference_temp,
+                            double drift_rate, int years_in_service, int32_t install_day) {
+    RtdDrift *d = filter_rtd_state(bank, suit_id, drift_rate, years_in_service, install_day);
+    if (d == NULL) return drift_rate * years_in_service;
+
+    double observed = (rtd_reading - reference_temp) / (reference_temp + 1.0 / ALPHA);
+    double p = d->drift_variance + FILTER_DRIFT_WALK;  // Predict
+    double gain = p / (p + FILTER_REFERENCE_VARIANCE);
+    d->drift = (float)(d->drift + gain * (observed - d->drift));
+    d->drift_variance = (float)((1.0 - gain) * p);
+    return d->drift;
+}
+
+#endif
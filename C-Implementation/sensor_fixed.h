@@ -0,0 +1,326 @@
+#ifndef SENSOR_FIXED_H
+#define SENSOR_FIXED_H
+
+#include <stdlib.h>
+#include <stdint.h>
+
+// Fixed-point sensor models for the suit microcontroller (AVR, no FPU).
+// The same RTD, electrochemical, microphone, Hall and radiation models as the
+// double versions, in Q-format integers with precomputed tables and no libm.
+// Per-model constants are built by the FX_* initializers from the model's
+// literals, so the compiler folds them and no floating point is left at run time.
+// Every model draws the same rand() % 201 noise as its double counterpart, so the
+// two can be compared draw for draw (fixed_bench.c).
+//
+// Formats, by quantity:
+//   Q16.16  temperature °C, resistance Ω, concentration ppm, field mT, Hall V, μSv/h
+//   Q20.12  cell current nA
+//   Q10.22  sound pressure Pa (up to 148 dB SPL)
+//   Q4.28   microphone V (up to 8 V, beyond the microphones' overload point)
+//   Q8.24   small constants
+//   Q5.27   gains from dB
+//   Q0.32   reciprocals of the larger constants
+typedef int32_t q16_t;
+typedef int32_t q12_t;
+typedef int32_t q22_t;
+typedef int32_t q24_t;
+typedef int32_t q28_t;
+typedef int32_t q27_t;
+
+#define FX_Q(x, bits) ((int32_t)((x) * (double)(1LL << (bits)) + ((x) >= 0 ? 0.5 : -0.5)))
+#define FX_Q16(x) FX_Q(x, 16)
+#define FX_Q24(x) FX_Q(x, 24)
+#define FX_Q27(x) FX_Q(x, 27)
+#define FX_Q32(x) FX_Q(x, 32)  // Only for 0 <= x < 0.5
+#define FX_ONE(bits) ((int32_t)1 << (bits))
+
+// Operation counts for cycle estimates, compiled in with FX_COUNT_OPS
+#ifdef FX_COUNT_OPS
+typedef struct {
+    long mul;  // 32 x 32 -> 64 bit multiply and shift
+    long lookup;  // Table read from program memory
+    long sqrt;  // 32-bit integer square root
+} FxOps;
+FxOps fx_ops;
+#define FX_COUNT(op) (fx_ops.op++)
+#else
+#define FX_COUNT(op) ((void)0)
+#endif
+
+// Rounded (a * b) >> shift
+static inline int32_t fx_mul(int32_t a, int32_t b, int shift) {
+    FX_COUNT(mul);
+    return (int32_t)(((int64_t)a * b + ((int64_t)1 << (shift - 1))) >> shift);
+}
+
+static inline int fx_noise_draw(void) {
+    return (rand() % 201) - 100;
+}
+
+// floor(sqrt(x)), bit by bit
+static uint32_t fx_isqrt(uint32_t x) {
+    uint32_t root = 0, bit = 1u << 30;
+    FX_COUNT(sqrt);
+    while (bit > x) bit >>= 2;
+    while (bit != 0) {
+        if (x >= root + bit) {
+            x -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return root;
+}
+
+// ---- Tables ----
+
+// 10^(i/20), one step per dB within a decade of 20 dB, Q5.27
+static const q27_t FX_DB_STEP[20] = {
+    134217728, 150594768, 168970108, 189587580, 212720763, 238676622, 267799575,
+    300476065, 337139690, 378276954, 424433723, 476222470, 534330399, 599528569,
+    672682118, 754761750, 846856612, 950188747, 1066129310, 1196216760
+};
+
+// 10^-k, k = 0..5, Q5.27 (gains down to -120 dB)
+static const q27_t FX_DECADE_DOWN[6] = {134217728, 13421773, 1342177, 134218, 13422, 1342};
+
+// 20 μPa * 10^k, k = 0..7, Pa in Q.30
+static const int64_t FX_PA_DECADE[8] = {
+    21475LL, 214748LL, 2147484LL, 21474836LL, 214748365LL, 2147483648LL,
+    21474836480LL, 214748364800LL
+};
+
+// 2^(-i/64), i = 0..64, Q8.24
+static const q24_t FX_EXP2_NEG[65] = {
+    16777216, 16596492, 16417715, 16240863, 16065917, 15892855, 15721658, 15552304,
+    15384775, 15219050, 15055111, 14892937, 14732511, 14573813, 14416824, 14261526,
+    14107901, 13955931, 13805598, 13656884, 13509772, 13364245, 13220286, 13077877,
+    12937002, 12797645, 12659789, 12523418, 12388516, 12255067, 12123055, 11992466,
+    11863283, 11735492, 11609078, 11484025, 11360319, 11237946, 11116891, 10997140,
+    10878679, 10761494, 10645571, 10530897, 10417458, 10305242, 10194234, 10084422,
+    9975792, 9868333, 9762032, 9656875, 9552851, 9449948, 9348154, 9247455,
+    9147842, 9049301, 8951823, 8855394, 8760003, 8665641, 8572295, 8479954,
+    8388608
+};
+
+// Cross-sensitivity matrix of chemical_sensor.h, Q16.16
+static const q16_t FX_CROSS_SENSITIVITY[7][7] = {
+    {FX_Q16(1.00), FX_Q16(0.05), FX_Q16(0.00), FX_Q16(-0.10), FX_Q16(0.00), FX_Q16(0.00), FX_Q16(0.00)},
+    {FX_Q16(0.00), FX_Q16(1.00), FX_Q16(0.10), FX_Q16(0.00), FX_Q16(-0.20), FX_Q16(0.00), FX_Q16(0.00)},
+    {FX_Q16(0.00), FX_Q16(0.00), FX_Q16(1.00), FX_Q16(0.15), FX_Q16(0.00), FX_Q16(0.00), FX_Q16(0.00)},
+    {FX_Q16(-0.05), FX_Q16(0.00), FX_Q16(0.00), FX_Q16(1.00), FX_Q16(0.00), FX_Q16(0.00), FX_Q16(0.00)},
+    {FX_Q16(0.00), FX_Q16(-0.10), FX_Q16(0.00), FX_Q16(0.00), FX_Q16(1.00), FX_Q16(0.00), FX_Q16(0.00)},
+    {FX_Q16(0.00), FX_Q16(0.00), FX_Q16(0.00), FX_Q16(0.00), FX_Q16(0.00), FX_Q16(1.00), FX_Q16(0.00)},
+    {FX_Q16(0.00), FX_Q16(0.00), FX_Q16(0.00), FX_Q16(0.00), FX_Q16(0.00), FX_Q16(0.00), FX_Q16(1.00)}
+};
+
+// ---- Transcendental functions ----
+
+// 10^(f/20) for f in [0, 1) dB as e^x, x = f * ln(10) / 20 <= 0.116,
+// by its cubic Taylor polynomial (relative error below 1e-5)
+static q27_t fx_db_fraction(q16_t f) {
+    q27_t x = fx_mul(f, FX_Q27(0.11512925464970229), 16);
+    q27_t x2 = fx_mul(x, x, 27);
+    q27_t x3 = fx_mul(x2, x, 27);
+    return FX_ONE(27) + x + (x2 >> 1) + fx_mul(x3, FX_Q27(1.0 / 6.0), 27);
+}
+
+// 10^(db/20) for db in [-120, 24), Q5.27; saturates above
+q27_t fx_db_gain(q16_t db) {
+    int n = db >> 16;  // Floor
+    int decade = (n >= 0) ? n / 20 : -((19 - n) / 20);
+    if (decade > 0) return INT32_MAX;
+    if (-decade >= 6) return 0;
+    FX_COUNT(lookup);
+    q27_t gain = fx_mul(FX_DB_STEP[n - 20 * decade], fx_db_fraction(db & 0xffff), 27);
+    if (decade < 0) {
+        FX_COUNT(lookup);
+        gain = fx_mul(gain, FX_DECADE_DOWN[-decade], 27);
+    }
+    return gain;
+}
+
+// e^-x for x >= 0 as 2^-(x log2 e), interpolated between 64 steps per octave, Q8.24
+q24_t fx_exp_neg(q16_t x) {
+    q16_t t = fx_mul(x, FX_Q24(1.4426950408889634), 24);
+    int octave = t >> 16;
+    if (octave >= 24) return 0;
+    int index = (t >> 10) & 63;
+    int32_t rest = t & 0x3ff;
+    FX_COUNT(lookup);
+    q24_t v = FX_EXP2_NEG[index] - (((FX_EXP2_NEG[index] - FX_EXP2_NEG[index + 1]) * rest) >> 10);
+    return v >> octave;
+}
+
+// ---- RTD temperature probes ----
+typedef struct {
+    q16_t r0;  // Ω
+    q24_t r0_alpha;  // Ω/°C
+    q24_t drift_rate;  // Per year
+    q24_t noise_step;  // Ω per noise draw unit
+    q24_t inv_r0_alpha;  // °C/Ω
+    q16_t inv_alpha;  // °C
+} FxRtd;
+
+#define FX_RTD(r0, alpha, drift_rate, error)                                            \
+    {FX_Q16(r0), FX_Q24((r0) * (alpha)), FX_Q24(drift_rate), FX_Q24((error) / 1000.0), \
+     FX_Q24(1.0 / ((r0) * (alpha))), FX_Q16(1.0 / (alpha))}
+
+q16_t fx_rtd_resistance(const FxRtd *m, q16_t temperature) {
+    return m->r0 + fx_mul(m->r0_alpha, temperature, 24);
+}
+
+q16_t fx_rtd_read(const FxRtd *m, q16_t actual_temp, int years_in_service) {
+    q16_t ideal_resistance = fx_rtd_resistance(m, actual_temp);
+    q24_t drift_factor = FX_ONE(24) + m->drift_rate * years_in_service;
+    q16_t noise = fx_mul(fx_noise_draw(), m->noise_step, 8);
+    q16_t measured_resistance = fx_mul(ideal_resistance, drift_factor, 24) + noise;
+    return fx_mul(measured_resistance - m->r0, m->inv_r0_alpha, 24);
+}
+
+// (T - k / alpha) / (1 + k), with 1 / (1 + k) as 1 - k + k² - k³ + k⁴ (within 1e-5 for k <= 0.1)
+q16_t fx_rtd_compensate(const FxRtd *m, q16_t measured_temp, q24_t drift) {
+    q24_t k2 = fx_mul(drift, drift, 24);
+    q24_t k3 = fx_mul(k2, drift, 24);
+    q24_t k4 = fx_mul(k3, drift, 24);
+    q24_t reciprocal = FX_ONE(24) - drift + k2 - k3 + k4;
+    return fx_mul(measured_temp - fx_mul(drift, m->inv_alpha, 24), reciprocal, 24);
+}
+
+// ---- Electrochemical gas cells ----
+typedef struct {
+    q12_t zero_current;  // nA
+    q16_t sensitivity;  // nA/ppm
+    q12_t noise_step;  // nA per noise draw unit
+    q24_t inv_step;  // Resolution steps per nA
+    q24_t resolution;  // ppm
+} FxEc;
+
+#define FX_EC(sensitivity, zero_current, resolution)                                \
+    {FX_Q(zero_current, 12), FX_Q16(sensitivity), FX_Q((sensitivity) * (resolution) / 100.0, 12), \
+     FX_Q24(1.0 / ((sensitivity) * (resolution))), FX_Q24(resolution)}
+
+q12_t fx_ec_current(const FxEc *m, int gas_type, q16_t concentration, const q16_t interfering_conc[]) {
+    q12_t current = m->zero_current + fx_mul(concentration, m->sensitivity, 20);
+    for (int i = 0; i < 7; i++) {
+        if (i != gas_type - 1 && interfering_conc[i] != 0) {
+            q16_t effective = fx_mul(interfering_conc[i], FX_CROSS_SENSITIVITY[gas_type - 1][i], 16);
+            current += fx_mul(effective, m->sensitivity, 20);
+        }
+    }
+    return current + fx_noise_draw() * m->noise_step;
+}
+
+// Whole resolution steps, then back to ppm
+q16_t fx_ec_concentration(const FxEc *m, q12_t current) {
+    int32_t steps = fx_mul(current - m->zero_current, m->inv_step, 36);
+    return (steps > 0) ? fx_mul(steps, m->resolution, 8) : 0;
+}
+
+// 0.2% per °C from 20 °C
+q16_t fx_temperature_effect(q16_t concentration, q16_t temperature) {
+    q24_t factor = FX_ONE(24) + fx_mul(temperature - FX_Q16(20.0), FX_Q24(0.002), 16);
+    return fx_mul(concentration, factor, 24);
+}
+
+// ---- Microphones ----
+typedef struct {
+    q16_t sensitivity;  // dBV/Pa
+    q16_t snr;  // dB
+    int32_t low_freq, high_freq, resonant_freq;  // Hz
+    int32_t inv_low;  // Q0.32, 1 / low_freq
+    int32_t half_inv_rise;  // Q0.32, 0.5 / (resonant_freq - high_freq)
+} FxMic;
+
+#define FX_MIC(sensitivity, snr, low_freq, high_freq, resonant_freq)                     \
+    {FX_Q16(sensitivity), FX_Q16(snr), (int32_t)(low_freq), (int32_t)(high_freq),          \
+     (int32_t)(resonant_freq), FX_Q32(1.0 / (low_freq)), FX_Q32(0.5 / ((resonant_freq) - (high_freq)))}
+
+// 20 μPa * 10^(dB/20) for 0 to 148 dB SPL, Pa in Q10.22
+q22_t fx_dbspl_to_pascal(q16_t db_spl) {
+    if (db_spl < 0) db_spl = 0;
+    if (db_spl > FX_Q16(148.0)) db_spl = FX_Q16(148.0);
+    int n = db_spl >> 16;
+    FX_COUNT(lookup);
+    q27_t gain = fx_mul(FX_DB_STEP[n % 20], fx_db_fraction(db_spl & 0xffff), 27);
+    FX_COUNT(mul);
+    return (q22_t)(((int64_t)(gain >> 8) * FX_PA_DECADE[n / 20] + ((int64_t)1 << 26)) >> 27);
+}
+
+q28_t fx_mic_output(const FxMic *m, q22_t sound_pressure) {
+    q28_t output = fx_mul(sound_pressure, fx_db_gain(m->sensitivity), 21);
+    q28_t noise_voltage = fx_mul(output, fx_db_gain(-m->snr), 27);
+    return output + fx_mul(fx_noise_draw() * noise_voltage, FX_Q32(0.01), 32);
+}
+
+q28_t fx_mic_frequency_response(const FxMic *m, q28_t signal_amplitude, int32_t frequency) {
+    q24_t normalized_output = FX_ONE(24);
+    if (frequency < m->low_freq) {
+        normalized_output = fx_mul(frequency, m->inv_low, 8);
+    } else if (frequency > m->high_freq) {
+        if (frequency < m->resonant_freq) {
+            normalized_output = FX_ONE(24) + fx_mul(frequency - m->high_freq, m->half_inv_rise, 8);
+        } else {
+            q16_t x = fx_mul(frequency - m->resonant_freq, FX_Q32(1.0 / 1000.0), 16);
+            normalized_output = fx_mul(FX_Q24(1.5), fx_exp_neg(x), 24);
+        }
+    }
+    return fx_mul(signal_amplitude, normalized_output, 24);
+}
+
+// ---- Hall effect sensors ----
+typedef struct {
+    q16_t offset;  // V
+    q24_t volts_per_mt;
+    q16_t max_field;  // mT
+} FxHall;
+
+#define FX_HALL(sensitivity, offset, max_field) \
+    {FX_Q16(offset), FX_Q24((sensitivity) / 1000.0), FX_Q16(max_field)}
+
+q16_t fx_hall_output(const FxHall *m, q16_t magnetic_field) {
+    if (magnetic_field > m->max_field) magnetic_field = m->max_field;
+    q16_t output = m->offset + fx_mul(magnetic_field, m->volts_per_mt, 24);
+    return output + fx_mul(fx_noise_draw(), FX_Q24(0.0001), 8);  // ±0.01 V
+}
+
+// ---- Radiation detector ----
+
+// Counts over integration_s seconds, with the same normal approximation of the Poisson spread
+int fx_radiation_counts(q16_t radiation_level, int integration_s) {
+    q16_t expected = fx_mul(radiation_level, FX_Q32(150.0 / 3600.0), 32) * integration_s;  // RAD_SENSITIVITY
+    if (expected < 0) expected = 0;
+    q16_t std_dev = (q16_t)(fx_isqrt((uint32_t)expected) << 8);
+    q16_t variation = fx_mul(fx_noise_draw() * std_dev, FX_Q32(0.01), 32);
+    int counts = (expected + variation + FX_Q16(0.5)) >> 16;
+    return (counts > 0) ? counts : 0;
+}
+
+// ---- Host build ----
+// Double in and out around the fixed-point models, for the host build with
+// SENSOR_FIXED_POINT. Not for the firmware, which keeps its values in Q format.
+
+static inline int32_t fx_from_double(double x, int bits) {
+    return (int32_t)(x * (double)(1LL << bits) + (x >= 0 ? 0.5 : -0.5));
+}
+
+static inline double fx_to_double(int32_t v, int bits) {
+    return v / (double)(1LL << bits);
+}
+
+int fixed_radiation_counts(double radiation_level_usvh, double integration_time_s) {
+    return fx_radiation_counts(fx_from_double(radiation_level_usvh, 16), (int)(integration_time_s + 0.5));
+}
+
+double fixed_dbspl_to_pascal(double db_spl) {
+    return fx_to_double(fx_dbspl_to_pascal(fx_from_double(db_spl, 16)), 22);
+}
+
+double fixed_temperature_effect(double concentration, double temperature) {
+    return fx_to_double(fx_temperature_effect(fx_from_double(concentration, 16),
+                                              fx_from_double(temperature, 16)), 16);
+}
+
+#endif
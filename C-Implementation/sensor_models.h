@@ -0,0 +1,346 @@
+#ifndef SENSOR_MODELS_H
+#define SENSOR_MODELS_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include "temperature_sensor.h"
+#include "chemical_sensor.h"
+#include "acoustic_sensor.h"
+#include "electrical_sensor.h"
+#include "sensor_fixed.h"
+
+// Sensor models specialized per hardware variant.
+// Each DEFINE_*_MODEL expands the model functions with the variant's constants
+// written in as literals, so they fold at compile time exactly like the #defines
+// in the base headers; there is no branching on device type inside a model.
+// The generated functions are reached through a per-kind table of function
+// pointers, and every suit selects one entry of each kind (its device profile).
+// Index 0 of every kind uses the base header's constants, so the default profile
+// behaves like the original functions, which remain available unchanged.
+
+// With SENSOR_FIXED_POINT the model functions run the suit firmware's fixed-point
+// arithmetic (sensor_fixed.h) between double conversions; without it they are the
+// double models. Either way every model carries its fixed-point constants.
+
+// ---- RTD temperature probes ----
+typedef struct {
+    const char *name;
+    double r0;  // Ohms at 0°C
+    double alpha;
+    double drift_rate;  // Per year
+    double (*resistance)(double temperature);
+    double (*read)(double actual_temp, int years_in_service);
+    double (*compensate)(double measured_temp, double drift);
+    const FxRtd *fixed;
+} RtdModel;
+
+#ifdef SENSOR_FIXED_POINT
+#define RTD_MODEL_FUNCTIONS(id, r0, alpha, drift_rate, error)                              \
+    static double rtd_##id##_resistance(double temperature) {                               \
+        return fx_to_double(fx_rtd_resistance(&rtd_##id##_fixed,                            \
+                                              fx_from_double(temperature, 16)), 16);        \
+    }                                                                                       \
+    static double rtd_##id##_read(double actual_temp, int years_in_service) {               \
+        return fx_to_double(fx_rtd_read(&rtd_##id##_fixed, fx_from_double(actual_temp, 16), \
+                                        years_in_service), 16);                             \
+    }                                                                                       \
+    static double rtd_##id##_compensate(double measured_temp, double drift) {               \
+        return fx_to_double(fx_rtd_compensate(&rtd_##id##_fixed, fx_from_double(measured_temp, 16), \
+                                              fx_from_double(drift, 24)), 16);              \
+    }
+#else
+#define RTD_MODEL_FUNCTIONS(id, r0, alpha, drift_rate, error)                              \
+    static double rtd_##id##_resistance(double temperature) {                               \
+        return (r0) * (1 + (alpha) * temperature);                                          \
+    }                                                                                       \
+    static double rtd_##id##_read(double actual_temp, int years_in_service) {               \
+        double ideal_resistance = rtd_##id##_resistance(actual_temp);                       \
+        double drift_factor = 1 + ((drift_rate) * years_in_service);                        \
+        double noise = ((rand() % 201) - 100) / 1000.0 * (error);                           \
+        double measured_resistance = ideal_resistance * drift_factor + noise;               \
+        return (measured_resistance / (r0) - 1) / (alpha);                                  \
+    }                                                                                       \
+    static double rtd_##id##_compensate(double measured_temp, double drift) {               \
+        return (measured_temp - drift / (alpha)) / (1.0 + drift);                           \
+    }
+#endif
+
+#define DEFINE_RTD_MODEL(id, label, r0, alpha, drift_rate, error)                          \
+    static const FxRtd rtd_##id##_fixed = FX_RTD(r0, alpha, drift_rate, error);             \
+    RTD_MODEL_FUNCTIONS(id, r0, alpha, drift_rate, error)                                   \
+    static const RtdModel rtd_##id = {label, r0, alpha, drift_rate, rtd_##id##_resistance,  \
+                                      rtd_##id##_read, rtd_##id##_compensate, &rtd_##id##_fixed};
+
+// ---- Electrochemical gas cells ----
+typedef struct {
+    const char *name;
+    double sensitivity;  // nA/ppm
+    double zero_current;  // nA
+    double resolution;  // ppm
+    double (*current)(int gas_type, double concentration, double interfering_conc[]);
+    double (*concentration)(double current, int gas_type);
+    const FxEc *fixed;
+} EcModel;
+
+#ifdef SENSOR_FIXED_POINT
+#define EC_MODEL_FUNCTIONS(id, sensitivity, zero_current, resolution)                      \
+    static double ec_##id##_current(int gas_type, double concentration,                    \
+                                    double interfering_conc[]) {                            \
+        q16_t interfering[7];                                                               \
+        for (int i = 0; i < 7; i++) interfering[i] = fx_from_double(interfering_conc[i], 16); \
+        return fx_to_double(fx_ec_current(&ec_##id##_fixed, gas_type,                       \
+                                          fx_from_double(concentration, 16), interfering), 12); \
+    }                                                                                       \
+    static double ec_##id##_concentration(double current, int gas_type) {                  \
+        (void)gas_type;                                                                     \
+        return fx_to_double(fx_ec_concentration(&ec_##id##_fixed, fx_from_double(current, 12)), 16); \
+    }
+#else
+#define EC_MODEL_FUNCTIONS(id, sensitivity, zero_current, resolution)                      \
+    static double ec_##id##_current(int gas_type, double concentration,                    \
+                                    double interfering_conc[]) {                            \
+        double current = (zero_current) + (concentration * (sensitivity));                 \
+        for (int i = 0; i < 7; i++) {                                                       \
+            if (i != gas_type - 1) {                                                        \
+                current += interfering_conc[i] * (sensitivity) *                            \
+                           CROSS_SENSITIVITY[gas_type - 1][i];                              \
+            }                                                                               \
+        }                                                                                   \
+        double noise = ((rand() % 201) - 100) / 100.0 * (sensitivity) * (resolution);       \
+        return current + noise;                                                             \
+    }                                                                                       \
+    static double ec_##id##_concentration(double current, int gas_type) {                  \
+        (void)gas_type;                                                                     \
+        double concentration = (current - (zero_current)) / (sensitivity);                 \
+        concentration = round(concentration / (resolution)) * (resolution);                \
+        return (concentration > 0) ? concentration : 0;                                     \
+    }
+#endif
+
+#define DEFINE_EC_MODEL(id, label, sensitivity, zero_current, resolution)                  \
+    static const FxEc ec_##id##_fixed = FX_EC(sensitivity, zero_current, resolution);       \
+    EC_MODEL_FUNCTIONS(id, sensitivity, zero_current, resolution)                           \
+    static const EcModel ec_##id = {label, sensitivity, zero_current, resolution,          \
+                                    ec_##id##_current, ec_##id##_concentration, &ec_##id##_fixed};
+
+// ---- Microphones ----
+typedef struct {
+    const char *name;
+    double sensitivity;  // dBV/Pa
+    double snr;  // dB
+    double (*output)(double sound_pressure_pa);
+    double (*frequency_response)(double signal_amplitude, double frequency);
+    const FxMic *fixed;
+} MicModel;
+
+#ifdef SENSOR_FIXED_POINT
+#define MIC_MODEL_FUNCTIONS(id, sensitivity, snr, low_freq, high_freq, resonant_freq)      \
+    static double mic_##id##_output(double sound_pressure_pa) {                             \
+        return fx_to_double(fx_mic_output(&mic_##id##_fixed,                                \
+                                          fx_from_double(sound_pressure_pa, 22)), 28);      \
+    }                                                                                       \
+    static double mic_##id##_frequency_response(double signal_amplitude, double frequency) {\
+        return fx_to_double(fx_mic_frequency_response(&mic_##id##_fixed,                    \
+                                                      fx_from_double(signal_amplitude, 28), \
+                                                      (int32_t)(frequency + 0.5)), 28);     \
+    }
+#else
+#define MIC_MODEL_FUNCTIONS(id, sensitivity, snr, low_freq, high_freq, resonant_freq)      \
+    static double mic_##id##_output(double sound_pressure_pa) {                             \
+        double output = sound_pressure_pa * pow(10, (sensitivity) / 20.0);                  \
+        double noise_voltage = output / pow(10, (snr) / 20.0);                              \
+        double noise = ((rand() % 201) - 100) / 100.0 * noise_voltage;                      \
+        return output + noise;                                                              \
+    }                                                                                       \
+    static double mic_##id##_frequency_response(double signal_amplitude, double frequency) {\
+        double normalized_output = 1.0;                                                     \
+        if (frequency < (low_freq)) {                                                       \
+            normalized_output = frequency / (low_freq);                                     \
+        } else if (frequency > (high_freq)) {                                               \
+            if (frequency < (resonant_freq)) {                                              \
+                normalized_output = 1.0 + 0.5 * (frequency - (high_freq)) /                 \
+                                    ((resonant_freq) - (high_freq));                        \
+            } else {                                                                        \
+                normalized_output = 1.5 * exp(-(frequency - (resonant_freq)) / 1000.0);     \
+            }                                                                               \
+        }                                                                                   \
+        return signal_amplitude * normalized_output;                                        \
+    }
+#endif
+
+#define DEFINE_MIC_MODEL(id, label, sensitivity, snr, low_freq, high_freq, resonant_freq)   \
+    static const FxMic mic_##id##_fixed = FX_MIC(sensitivity, snr, low_freq, high_freq,     \
+                                                 resonant_freq);                            \
+    MIC_MODEL_FUNCTIONS(id, sensitivity, snr, low_freq, high_freq, resonant_freq)           \
+    static const MicModel mic_##id = {label, sensitivity, snr, mic_##id##_output,          \
+                                      mic_##id##_frequency_response, &mic_##id##_fixed};
+
+// ---- Hall effect sensors ----
+typedef struct {
+    const char *name;
+    double sensitivity;  // mV/mT
+    double max_field;  // mT
+    double (*output)(double magnetic_field_mT);
+    const FxHall *fixed;
+} HallModel;
+
+#ifdef SENSOR_FIXED_POINT
+#define HALL_MODEL_FUNCTIONS(id, sensitivity, offset, max_field)                           \
+    static double hall_##id##_output(double magnetic_field_mT) {                            \
+        return fx_to_double(fx_hall_output(&hall_##id##_fixed,                              \
+                                           fx_from_double(magnetic_field_mT, 16)), 16);     \
+    }
+#else
+#define HALL_MODEL_FUNCTIONS(id, sensitivity, offset, max_field)                           \
+    static double hall_##id##_output(double magnetic_field_mT) {                            \
+        if (magnetic_field_mT > (max_field)) magnetic_field_mT = (max_field);               \
+        double output = (offset) + ((sensitivity) * magnetic_field_mT / 1000.0);            \
+        double noise = ((rand() % 201) - 100) / 10000.0;                                    \
+        return output + noise;                                                              \
+    }
+#endif
+
+#define DEFINE_HALL_MODEL(id, label, sensitivity, offset, max_field)                       \
+    static const FxHall hall_##id##_fixed = FX_HALL(sensitivity, offset, max_field);        \
+    HALL_MODEL_FUNCTIONS(id, sensitivity, offset, max_field)                                \
+    static const HallModel hall_##id = {label, sensitivity, max_field, hall_##id##_output,  \
+                                        &hall_##id##_fixed};
+
+// Fleet variants. The first of each kind is the base header's device.
+DEFINE_RTD_MODEL(pt100, "pt100", RO, ALPHA, DRIFT_RATE, SENSOR_ERROR)
+DEFINE_RTD_MODEL(pt1000, "pt1000", 1000.0, 0.00385, 0.002, SENSOR_ERROR * 10.0)  // Thin film, drifts less
+
+DEFINE_EC_MODEL(ec20, "ec20", EC_SENSITIVITY, EC_ZERO_CURRENT, EC_RESOLUTION)
+DEFINE_EC_MODEL(ec70, "ec70", 70.0, 1.0, 0.1)  // High-sensitivity CO cell
+DEFINE_EC_MODEL(ec4, "ec4", 4.0, 10.0, 1.0)  // High-range cell, coarse resolution
+
+DEFINE_MIC_MODEL(mems38, "mems38", MIC_SENSITIVITY, MIC_SNR, MIC_LOW_FREQ, MIC_HIGH_FREQ, MIC_RESONANT_FREQ)
+DEFINE_MIC_MODEL(mems26, "mems26", -26.0, 64.0, 80.0, 12000.0, 20000.0)
+
+DEFINE_HALL_MODEL(hall5, "hall5", HALL_SENSITIVITY, HALL_OFFSET, HALL_MAX_FIELD)
+DEFINE_HALL_MODEL(hall50, "hall50", 50.0, HALL_OFFSET, 40.0)  // Low-field, high-gain part
+
+// ---- Current waveform ADC rates ----
+// What a suit samples its Hall current sensor at (current_waveform.h, 10-50 kHz).
+// The first is CURRENT_SAMPLE_RATE.
+typedef struct {
+    const char *name;
+    double rate;  // Hz
+} AdcRate;
+
+static const AdcRate ADC_RATES[] = {
+    {"adc20k", 20000.0}, {"adc10k", 10000.0}, {"adc25k", 25000.0}, {"adc40k", 40000.0}, {"adc50k", 50000.0},
+};
+
+static const RtdModel *const RTD_MODELS[] = {&rtd_pt100, &rtd_pt1000};
+static const EcModel *const EC_MODELS[] = {&ec_ec20, &ec_ec70, &ec_ec4};
+static const MicModel *const MIC_MODELS[] = {&mic_mems38, &mic_mems26};
+static const HallModel *const HALL_MODELS[] = {&hall_hall5, &hall_hall50};
+#define MODEL_COUNT(table) ((int)(sizeof(table) / sizeof(table[0])))
+
+// Device profile: one 4-bit model index per kind, 0 = default device
+#define DEVICE_PROFILE_DEFAULT 0
+#define DEVICE_PROFILE_MAX 0xfffff
+#define PROFILE_RTD(p) ((p) & 0xf)
+#define PROFILE_EC(p) (((p) >> 4) & 0xf)
+#define PROFILE_MIC(p) (((p) >> 8) & 0xf)
+#define PROFILE_HALL(p) (((p) >> 12) & 0xf)
+#define PROFILE_ADC(p) (((p) >> 16) & 0xf)
+
+typedef struct {
+    const RtdModel *rtd;
+    const EcModel *ec;
+    const MicModel *mic;
+    const HallModel *hall;
+    double current_rate;  // Hz
+} SuitDevices;
+
+// Per-suit device profiles, index = suit ID
+typedef struct {
+    uint32_t *profiles;
+    int count;
+} DeviceRegistry;
+
+int device_registry_init(DeviceRegistry *reg, int count) {
+    reg->profiles = calloc(count, sizeof(uint32_t));
+    reg->count = reg->profiles ? count : 0;
+    return reg->profiles ? 0 : -1;
+}
+
+void device_registry_free(DeviceRegistry *reg) {
+    free(reg->profiles);
+    reg->profiles = NULL;
+    reg->count = 0;
+}
+
+int device_profile_valid(int profile) {
+    return profile >= 0 && profile <= DEVICE_PROFILE_MAX &&
+           PROFILE_RTD(profile) < MODEL_COUNT(RTD_MODELS) &&
+           PROFILE_EC(profile) < MODEL_COUNT(EC_MODELS) &&
+           PROFILE_MIC(profile) < MODEL_COUNT(MIC_MODELS) &&
+           PROFILE_HALL(profile) < MODEL_COUNT(HALL_MODELS) &&
+           PROFILE_ADC(profile) < MODEL_COUNT(ADC_RATES);
+}
+
+// Returns 0, or -1 for an unknown suit or an invalid profile
+int device_profile_set(DeviceRegistry *reg, int suit_id, int profile) {
+    if (suit_id < 0 || suit_id >= reg->count || !device_profile_valid(profile)) return -1;
+    reg->profiles[suit_id] = (uint32_t)profile;
+    return 0;
+}
+
+SuitDevices device_models(const DeviceRegistry *reg, int suit_id) {
+    int p = (suit_id >= 0 && suit_id < reg->count) ? reg->profiles[suit_id] : DEVICE_PROFILE_DEFAULT;
+    SuitDevices d = {RTD_MODELS[PROFILE_RTD(p)], EC_MODELS[PROFILE_EC(p)],
+                     MIC_MODELS[PROFILE_MIC(p)], HALL_MODELS[PROFILE_HALL(p)], ADC_RATES[PROFILE_ADC(p)].rate};
+    return d;
+}
+
+// Parse a comma-separated list of model names, e.g. "pt1000,ec70,mems26,adc50k".
+// Kinds not named keep their default. Returns the profile or -1 on an unknown name.
+int device_profile_parse(const char *spec) {
+    char name[32];
+    int profile = DEVICE_PROFILE_DEFAULT;
+
+    while (*spec) {
+        size_t len = strcspn(spec, ",");
+        if (len == 0 || len >= sizeof(name)) return -1;
+        memcpy(name, spec, len);
+        name[len] = '\0';
+        spec += len + (spec[len] == ',');
+
+        int found = 0;
+        for (int i = 0; i < MODEL_COUNT(RTD_MODELS) && !found; i++) {
+            if (strcmp(name, RTD_MODELS[i]->name) == 0) { profile = (profile & ~0xf) | i; found = 1; }
+        }
+        for (int i = 0; i < MODEL_COUNT(EC_MODELS) && !found; i++) {
+            if (strcmp(name, EC_MODELS[i]->name) == 0) { profile = (profile & ~0xf0) | (i << 4); found = 1; }
+        }
+        for (int i = 0; i < MODEL_COUNT(MIC_MODELS) && !found; i++) {
+            if (strcmp(name, MIC_MODELS[i]->name) == 0) { profile = (profile & ~0xf00) | (i << 8); found = 1; }
+        }
+        for (int i = 0; i < MODEL_COUNT(HALL_MODELS) && !found; i++) {
+            if (strcmp(name, HALL_MODELS[i]->name) == 0) { profile = (profile & ~0xf000) | (i << 12); found = 1; }
+        }
+        for (int i = 0; i < MODEL_COUNT(ADC_RATES) && !found; i++) {
+            if (strcmp(name, ADC_RATES[i].name) == 0) { profile = (profile & ~0xf0000) | (i << 16); found = 1; }
+        }
+        if (!found) return -1;
+    }
+    return profile;
+}
+
+void device_profile_describe(int profile, char *buf, size_t size) {
+    if (!device_profile_valid(profile)) {
+        snprintf(buf, size, "invalid");
+        return;
+    }
+    snprintf(buf, size, "%s,%s,%s,%s,%s", RTD_MODELS[PROFILE_RTD(profile)]->name,
+             EC_MODELS[PROFILE_EC(profile)]->name, MIC_MODELS[PROFILE_MIC(profile)]->name,
+             HALL_MODELS[PROFILE_HALL(profile)]->name, ADC_RATES[PROFILE_ADC(profile)].name);
+}
+
+#endif
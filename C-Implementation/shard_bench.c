@@ -0,0 +1,187 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "shard_ring.h"
+
+// Benchmark for the sharded control tier:
+//  1. how many suits move when shards are added or removed
+//  2. duplicate shard addresses are rejected
+//  3. a dispatch model: how evenly ring_lookup spreads alerts over 1, 4 and 8
+//     shards. The shards are in-process threads that only wait out a fixed
+//     round trip, so the rates are a model bound, not a measurement of control.c
+
+#define BENCH_SUITS 100000
+#define BENCH_ALERTS 50000
+#define BENCH_QUEUE_SIZE 4096  // Per-shard queue, power of two
+#define BENCH_ROUNDTRIP_US 100  // Modelled service time per alert
+
+typedef struct {
+    int suit_id;
+    int param_code;
+    int value;
+} BenchAlert;
+
+// Single-producer single-consumer queue feeding one shard
+typedef struct {
+    BenchAlert items[BENCH_QUEUE_SIZE];
+    atomic_uint head;
+    atomic_uint tail;
+    atomic_int done;
+    long processed;
+} ShardQueue;
+
+double now_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// The actuator round trip is network wait, not CPU, so the shard sleeps
+void wait_round_trip_us(int us) {
+    struct timespec ts = {0, us * 1000L};
+    nanosleep(&ts, NULL);
+}
+
+int queue_push(ShardQueue *q, BenchAlert alert) {
+    unsigned tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+    unsigned head = atomic_load_explicit(&q->head, memory_order_acquire);
+    if (tail - head == BENCH_QUEUE_SIZE) return 0;  // Full
+    q->items[tail & (BENCH_QUEUE_SIZE - 1)] = alert;
+    atomic_store_explicit(&q->tail, tail + 1, memory_order_release);
+    return 1;
+}
+
+int queue_pop(ShardQueue *q, BenchAlert *alert) {
+    unsigned head = atomic_load_explicit(&q->head, memory_order_relaxed);
+    unsigned tail = atomic_load_explicit(&q->tail, memory_order_acquire);
+    if (head == tail) return 0;  // Empty
+    *alert = q->items[head & (BENCH_QUEUE_SIZE - 1)];
+    atomic_store_explicit(&q->head, head + 1, memory_order_release);
+    return 1;
+}
+
+// Modelled shard: each alert costs a fixed service time and nothing else
+void *shard_worker(void *arg) {
+    ShardQueue *q = (ShardQueue *)arg;
+    BenchAlert alert;
+
+    while (1) {
+        if (!queue_pop(q, &alert)) {
+            int done = atomic_load_explicit(&q->done, memory_order_acquire);
+            // Re-check after seeing the flag so late pushes are not lost
+            if (!queue_pop(q, &alert)) {
+                if (done) break;
+                continue;
+            }
+        }
+        wait_round_trip_us(BENCH_ROUNDTRIP_US);
+        q->processed++;
+    }
+    return NULL;
+}
+
+void build_ring(ShardRing *ring, int shards) {
+    ring_init(ring);
+    for (int i = 0; i < shards; i++) {
+        ring_add_shard(ring, "127.0.0.1", 8081 + 10 * i);
+    }
+}
+
+void bench_rebalance() {
+    static int before[BENCH_SUITS];
+    ShardRing ring;
+    int moved;
+
+    build_ring(&ring, 4);
+    for (int s = 0; s < BENCH_SUITS; s++) before[s] = ring_lookup(&ring, (uint32_t)s);
+
+    ring_add_shard(&ring, "127.0.0.1", 8081 + 10 * 4);
+    moved = 0;
+    for (int s = 0; s < BENCH_SUITS; s++) {
+        int after = ring_lookup(&ring, (uint32_t)s);
+        if (after != before[s]) moved++;
+        before[s] = after;
+    }
+    printf("Add shard 4 -> 5:    %5.2f%% of suits moved (ideal %.2f%%)\n",
+           100.0 * moved / BENCH_SUITS, 100.0 / 5);
+
+    ring_remove_shard(&ring, 1);
+    moved = 0;
+    for (int s = 0; s < BENCH_SUITS; s++) {
+        if (ring_lookup(&ring, (uint32_t)s) != before[s]) moved++;
+    }
+    printf("Remove shard 5 -> 4: %5.2f%% of suits moved (ideal %.2f%%)\n",
+           100.0 * moved / BENCH_SUITS, 100.0 / 5);
+}
+
+void bench_throughput(int shards) {
+    ShardRing ring;
+    ShardQueue *queues = calloc(shards, sizeof(ShardQueue));
+    pthread_t threads[SHARD_MAX];
+
+    build_ring(&ring, shards);
+    for (int i = 0; i < shards; i++) {
+        pthread_create(&threads[i], NULL, shard_worker, &queues[i]);
+    }
+
+    srand(42);
+    double start = now_seconds();
+    for (int i = 0; i < BENCH_ALERTS; i++) {
+        BenchAlert alert = {rand() % BENCH_SUITS, 1 + rand() % 6, rand() % 100};
+        int shard = ring_lookup(&ring, (uint32_t)alert.suit_id);
+        while (!queue_push(&queues[shard], alert)) {
+            // Shard is saturated, wait for it
+        }
+    }
+    for (int i = 0; i < shards; i++) {
+        atomic_store_explicit(&queues[i].done, 1, memory_order_release);
+    }
+    long max_load = 0;
+    for (int i = 0; i < shards; i++) {
+        pthread_join(threads[i], NULL);
+        if (queues[i].processed > max_load) max_load = queues[i].processed;
+    }
+    double elapsed = now_seconds() - start;
+
+    printf("%d shard(s): busiest shard %.1f%% of ideal share, model %9.0f alerts/s\n",
+           shards, 100.0 * max_load * shards / BENCH_ALERTS, BENCH_ALERTS / elapsed);
+    free(queues);
+}
+
+int bench_duplicates() {
+    ShardRing ring;
+    int failures = 0;
+
+    build_ring(&ring, 2);
+    if (ring_add_shard(&ring, "127.0.0.1", 8081) != -1) {
+        printf("FAIL: duplicate 127.0.0.1:8081 was added\n");
+        failures++;
+    }
+    ring_init(&ring);
+    int added = ring_load_from_string(&ring, "127.0.0.1:8081,127.0.0.1:8091,127.0.0.1:8081");
+    if (added != 2 || ring.shard_count != 2) {
+        printf("FAIL: list with a repeated entry gave %d shards, expected 2\n", ring.shard_count);
+        failures++;
+    }
+    if (failures == 0) printf("Duplicate shard addresses rejected\n");
+    return failures;
+}
+
+int main() {
+    printf("Smart Suit - Control Shard Benchmark\n");
+    printf("------------------------------------\n");
+    bench_rebalance();
+    int failures = bench_duplicates();
+
+    printf("\nDispatch model: %d alerts, in-process shards, %d us fixed service time each\n",
+           BENCH_ALERTS, BENCH_ROUNDTRIP_US);
+    printf("(rates are the model's bound, not measured control.c throughput)\n");
+    int shard_counts[] = {1, 4, 8};
+    for (int i = 0; i < 3; i++) {
+        bench_throughput(shard_counts[i]);
+    }
+    return failures ? 1 : 0;
+}
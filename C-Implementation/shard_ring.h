@@ -0,0 +1,173 @@
+#ifndef SHARD_RING_H
+#define SHARD_RING_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+// Consistent hashing of suits onto control shards
+#define SHARD_MAX 16  // Maximum number of control shards
+#define SHARD_VNODES 128  // Virtual nodes per shard on the ring
+#define SHARD_HOST_LEN 64
+#define SHARD_ENV "CONTROL_SHARDS"  // e.g. "127.0.0.1:8081,127.0.0.1:8091"
+
+typedef struct {
+    char host[SHARD_HOST_LEN];
+    int port;
+} ControlShard;
+
+typedef struct {
+    uint32_t hash;
+    int shard;  // Index into ShardRing.shards
+} RingPoint;
+
+typedef struct {
+    ControlShard shards[SHARD_MAX];
+    int active[SHARD_MAX];  // Slot in use
+    int shard_count;
+    RingPoint points[SHARD_MAX * SHARD_VNODES];
+    int point_count;
+} ShardRing;
+
+// FNV-1a over a byte string, used to place virtual nodes
+uint32_t shard_hash_bytes(const char *data, size_t len) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+        h ^= (unsigned char)data[i];
+        h *= 16777619u;
+    }
+    // Final avalanche so nearby strings spread over the whole ring
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35u;
+    h ^= h >> 16;
+    return h;
+}
+
+// Integer mix for suit IDs (murmur3 finalizer)
+uint32_t shard_hash_suit(uint32_t suit_id) {
+    uint32_t h = suit_id;
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35u;
+    h ^= h >> 16;
+    return h;
+}
+
+static int ring_point_cmp(const void *a, const void *b) {
+    uint32_t ha = ((const RingPoint *)a)->hash;
+    uint32_t hb = ((const RingPoint *)b)->hash;
+    return (ha > hb) - (ha < hb);
+}
+
+// Rebuild the sorted point array from the active shards
+void ring_rebuild(ShardRing *ring) {
+    char key[SHARD_HOST_LEN + 32];
+    ring->point_count = 0;
+
+    for (int s = 0; s < SHARD_MAX; s++) {
+        if (!ring->active[s]) continue;
+        for (int v = 0; v < SHARD_VNODES; v++) {
+            // Points depend only on the shard address, so a shard keeps its
+            // arcs when others join or leave
+            int len = snprintf(key, sizeof(key), "%s:%d#%d",
+                               ring->shards[s].host, ring->shards[s].port, v);
+            ring->points[ring->point_count].hash = shard_hash_bytes(key, (size_t)len);
+            ring->points[ring->point_count].shard = s;
+            ring->point_count++;
+        }
+    }
+
+    qsort(ring->points, ring->point_count, sizeof(RingPoint), ring_point_cmp);
+}
+
+void ring_init(ShardRing *ring) {
+    memset(ring, 0, sizeof(*ring));
+}
+
+// Find the active slot serving host:port, or -1 if it is not on the ring
+int ring_find_shard(const ShardRing *ring, const char *host, int port) {
+    for (int s = 0; s < SHARD_MAX; s++) {
+        if (ring->active[s] && ring->shards[s].port == port &&
+            strncmp(ring->shards[s].host, host, SHARD_HOST_LEN - 1) == 0) {
+            return s;
+        }
+    }
+    return -1;
+}
+
+// Add a shard; returns its slot index, or -1 if the ring is full or the
+// address is already on it (a duplicate would get a second set of points)
+int ring_add_shard(ShardRing *ring, const char *host, int port) {
+    if (ring_find_shard(ring, host, port) >= 0) return -1;
+    for (int s = 0; s < SHARD_MAX; s++) {
+        if (!ring->active[s]) {
+            strncpy(ring->shards[s].host, host, SHARD_HOST_LEN - 1);
+            ring->shards[s].host[SHARD_HOST_LEN - 1] = '\0';
+            ring->shards[s].port = port;
+            ring->active[s] = 1;
+            ring->shard_count++;
+            ring_rebuild(ring);
+            return s;
+        }
+    }
+    return -1;
+}
+
+// Remove a shard; only suits owned by it move to other shards
+int ring_remove_shard(ShardRing *ring, int slot) {
+    if (slot < 0 || slot >= SHARD_MAX || !ring->active[slot]) return -1;
+    ring->active[slot] = 0;
+    ring->shard_count--;
+    ring_rebuild(ring);
+    return 0;
+}
+
+// Find the shard owning a suit: first point clockwise from its hash
+int ring_lookup(const ShardRing *ring, uint32_t suit_id) {
+    if (ring->point_count == 0) return -1;
+
+    uint32_t h = shard_hash_suit(suit_id);
+    int lo = 0, hi = ring->point_count;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (ring->points[mid].hash < h) lo = mid + 1;
+        else hi = mid;
+    }
+    if (lo == ring->point_count) lo = 0;  // Wrap around
+    return ring->points[lo].shard;
+}
+
+// Parse "host:port,host:port,..." into the ring; returns shards added
+int ring_load_from_string(ShardRing *ring, const char *spec) {
+    char buffer[SHARD_MAX * (SHARD_HOST_LEN + 8)];
+    int added = 0;
+
+    strncpy(buffer, spec, sizeof(buffer) - 1);
+    buffer[sizeof(buffer) - 1] = '\0';
+
+    for (char *entry = strtok(buffer, ","); entry != NULL; entry = strtok(NULL, ",")) {
+        char *colon = strrchr(entry, ':');
+        if (colon == NULL) {
+            printf("Ignoring shard entry without port: %s\n", entry);
+            continue;
+        }
+        *colon = '\0';
+        int port = atoi(colon + 1);
+        if (port <= 0 || port > 65535) {
+            printf("Ignoring shard entry with invalid port: %s\n", colon + 1);
+            continue;
+        }
+        if (ring_find_shard(ring, entry, port) >= 0) {
+            printf("Ignoring duplicate shard entry: %s:%d\n", entry, port);
+            continue;
+        }
+        if (ring_add_shard(ring, entry, port) >= 0) added++;
+    }
+    return added;
+}
+
+#endif
@@ -0,0 +1,275 @@
+#ifndef STAGE_PROFILE_H
+#define STAGE_PROFILE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <stdatomic.h>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Where the cycles of a reading go, stage by stage, without an external profiler.
+// Built with -DSTAGE_PROFILE, the reading path is cut into consecutive stages by
+// PROFILE_MARK: each mark reads the hardware counters once and charges everything
+// since the previous mark to the stage it names, under the reading's parameter
+// code. On Linux the counters are cycles, instructions, cache misses and branch
+// misses from one perf_event_open group, counted in user space only; wall time is
+// kept everywhere and also covers the kernel (socket sends, console writes). The
+// cost of a mark itself is measured at start and subtracted.
+//
+// Without STAGE_PROFILE the marks compile to nothing.
+#define PROFILE_CODES 16  // Parameter codes 0-15, anything else is charged to 0
+#define PROFILE_CALIBRATION_MARKS 1000
+#define PROFILE_RENDER_SIZE 16384
+
+typedef enum {
+    PROFILE_LOOKUP,  // Device models and calibration entry
+    PROFILE_MODEL,  // Sensor model calls, libm and rand() included
+    PROFILE_REPORT,  // printf formatting and console output
+    PROFILE_CALIBRATE,  // Offset/gain and sample hold
+    PROFILE_FILTER,
+    PROFILE_LOG,  // CSV sample log
+    PROFILE_THRESHOLD,  // Threshold check and alerts to control
+    PROFILE_STATE,  // Per-suit state table
+    PROFILE_TREND,
+    PROFILE_HAZARD,
+    PROFILE_STAGES
+} ProfileStage;
+
+typedef enum {
+    PROFILE_CYCLES,
+    PROFILE_INSTRUCTIONS,
+    PROFILE_CACHE_MISSES,
+    PROFILE_BRANCH_MISSES,
+    PROFILE_NANOSECONDS,
+    PROFILE_VALUES
+} ProfileValue;
+#define PROFILE_EVENTS PROFILE_NANOSECONDS  // Values read from the counter group
+
+typedef struct {
+    uint64_t value[PROFILE_VALUES];
+} ProfileSample;
+
+typedef struct {
+    _Atomic uint64_t marks;
+    _Atomic uint64_t total[PROFILE_VALUES];
+} ProfileCell;
+
+typedef struct {
+    int leader;  // Group leader fd, -1 when no hardware counters are open
+    int fds[PROFILE_EVENTS];
+    int slot[PROFILE_EVENTS];  // Position of each event in a group read, -1 if it did not open
+    int events_open;
+    ProfileSample last;  // At the previous mark
+    ProfileSample overhead;  // Cost of one mark, subtracted from each
+    int code;  // Parameter code of the reading being profiled
+    _Atomic uint64_t readings[PROFILE_CODES];
+    ProfileCell cells[PROFILE_CODES][PROFILE_STAGES];
+} StageProfile;
+
+// Written by the thread handling readings only, read by the metrics server thread
+StageProfile stage_profile = {.leader = -1};
+
+static const char *const profile_stage_names[PROFILE_STAGES] = {
+    "lookup", "model", "report", "calibrate", "filter", "log", "threshold", "state", "trend", "hazard"
+};
+
+#ifdef __linux__
+static const uint64_t profile_event_configs[PROFILE_EVENTS] = {
+    PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+};
+
+static int profile_open_event(uint64_t config, int group) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.disabled = (group == -1);  // The group starts as one once every member is in
+    attr.exclude_kernel = 1;  // Allowed at the default perf_event_paranoid level
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, group, 0);
+}
+#endif
+
+static inline void profile_read(ProfileSample *sample) {
+    struct timespec ts;
+    if (stage_profile.leader < 0) memset(sample, 0, sizeof(*sample));
+#ifdef __linux__
+    if (stage_profile.leader >= 0) {
+        uint64_t group[1 + PROFILE_EVENTS];  // Member count, then values in the order they joined
+        if (read(stage_profile.leader, group, sizeof(group)) > 0) {
+            for (int e = 0; e < PROFILE_EVENTS; e++) {
+                sample->value[e] = (stage_profile.slot[e] >= 0) ? group[1 + stage_profile.slot[e]] : 0;
+            }
+        }
+    }
+#endif
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    sample->value[PROFILE_NANOSECONDS] = (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// Start a reading: later marks are charged to its parameter code
+static inline void profile_start(int param_code) {
+    stage_profile.code = (param_code >= 0 && param_code < PROFILE_CODES) ? param_code : 0;
+    _Atomic uint64_t *readings = &stage_profile.readings[stage_profile.code];
+    atomic_store_explicit(readings, atomic_load_explicit(readings, memory_order_relaxed) + 1, memory_order_relaxed);
+    profile_read(&stage_profile.last);
+}
+
+// Charge everything since the previous mark to stage
+static inline void profile_mark(int stage) {
+    ProfileSample now;
+    profile_read(&now);
+    ProfileCell *cell = &stage_profile.cells[stage_profile.code][stage];
+    for (int v = 0; v < PROFILE_VALUES; v++) {
+        uint64_t delta = now.value[v] - stage_profile.last.value[v];
+        delta = (delta > stage_profile.overhead.value[v]) ? delta - stage_profile.overhead.value[v] : 0;
+        // Single writer: a plain load and store, no lock prefix
+        uint64_t total = atomic_load_explicit(&cell->total[v], memory_order_relaxed);
+        atomic_store_explicit(&cell->total[v], total + delta, memory_order_relaxed);
+    }
+    atomic_store_explicit(&cell->marks, atomic_load_explicit(&cell->marks, memory_order_relaxed) + 1,
+                          memory_order_relaxed);
+    stage_profile.last = now;
+}
+
+static int profile_compare(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+// Open the counters and measure the cost of a mark. Returns the number of
+// hardware events counted, 0 when only wall time is available.
+int profile_init() {
+    for (int e = 0; e < PROFILE_EVENTS; e++) {
+        stage_profile.fds[e] = -1;
+        stage_profile.slot[e] = -1;
+    }
+    stage_profile.leader = -1;
+#ifdef __linux__
+    for (int e = 0; e < PROFILE_EVENTS; e++) {
+        int fd = profile_open_event(profile_event_configs[e], stage_profile.leader);
+        if (fd < 0) {
+            if (e == PROFILE_CYCLES) break;  // No cycle counter, no group
+            continue;
+        }
+        if (stage_profile.leader < 0) stage_profile.leader = fd;
+        stage_profile.fds[e] = fd;
+        stage_profile.slot[e] = stage_profile.events_open++;
+    }
+    if (stage_profile.leader >= 0) {
+        ioctl(stage_profile.leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(stage_profile.leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+#endif
+
+    // Back-to-back reads: the median delta is what a mark costs. The minimum would
+    // undercount when reads are system calls and vary from one to the next.
+    static uint64_t deltas[PROFILE_VALUES][PROFILE_CALIBRATION_MARKS];
+    ProfileSample a, b;
+    profile_read(&a);
+    for (int i = 0; i < PROFILE_CALIBRATION_MARKS; i++) {
+        profile_read(&b);
+        for (int v = 0; v < PROFILE_VALUES; v++) deltas[v][i] = b.value[v] - a.value[v];
+        a = b;
+    }
+    for (int v = 0; v < PROFILE_VALUES; v++) {
+        qsort(deltas[v], PROFILE_CALIBRATION_MARKS, sizeof(uint64_t), profile_compare);
+        stage_profile.overhead.value[v] = deltas[v][PROFILE_CALIBRATION_MARKS / 2];
+    }
+    return stage_profile.events_open;
+}
+
+void profile_free() {
+    for (int e = 0; e < PROFILE_EVENTS; e++) {
+#ifdef __linux__
+        if (stage_profile.fds[e] >= 0) close(stage_profile.fds[e]);
+#endif
+        stage_profile.fds[e] = -1;
+    }
+    stage_profile.leader = -1;
+    stage_profile.events_open = 0;
+}
+
+// Per-reading averages by parameter code and stage. name maps a code to its label.
+// Returns the length written, truncated to fit.
+int profile_render(char *buf, size_t size, const char *(*name)(int code)) {
+    size_t used = 0;
+#define PROFILE_APPEND(...) do { \
+        int w = snprintf(buf + used, size - used, __VA_ARGS__); \
+        if (w < 0 || (size_t)w >= size - used) return (int)used; \
+        used += (size_t)w; \
+    } while (0)
+
+    int counted = stage_profile.leader >= 0;
+    PROFILE_APPEND("Stage profile, averages per reading (%s; mark cost %llu ns subtracted)\n",
+                   counted ? "user-space counters" : "no hardware counters, wall time only",
+                   (unsigned long long)stage_profile.overhead.value[PROFILE_NANOSECONDS]);
+    for (int code = 0; code < PROFILE_CODES; code++) {
+        uint64_t readings = atomic_load_explicit(&stage_profile.readings[code], memory_order_relaxed);
+        if (readings == 0) continue;
+        PROFILE_APPEND("\n%s (code %d), %llu readings\n", name(code), code, (unsigned long long)readings);
+        PROFILE_APPEND("  %-10s %10s %10s %6s %11s %12s %10s\n",
+                       "stage", "cycles", "instr", "IPC", "cache-miss", "branch-miss", "ns");
+
+        uint64_t sum[PROFILE_VALUES] = {0};
+        for (int stage = 0; stage <= PROFILE_STAGES; stage++) {
+            double avg[PROFILE_VALUES];
+            for (int v = 0; v < PROFILE_VALUES; v++) {
+                uint64_t total = (stage < PROFILE_STAGES)
+                    ? atomic_load_explicit(&stage_profile.cells[code][stage].total[v], memory_order_relaxed)
+                    : sum[v];
+                if (stage < PROFILE_STAGES) sum[v] += total;
+                avg[v] = (double)total / readings;
+            }
+            if (stage < PROFILE_STAGES &&
+                atomic_load_explicit(&stage_profile.cells[code][stage].marks, memory_order_relaxed) == 0) {
+                continue;
+            }
+            const char *label = (stage < PROFILE_STAGES) ? profile_stage_names[stage] : "total";
+            if (!counted) {
+                PROFILE_APPEND("  %-10s %10s %10s %6s %11s %12s %10.0f\n", label, "-", "-", "-", "-", "-",
+                               avg[PROFILE_NANOSECONDS]);
+                continue;
+            }
+            char cache[16] = "-", branch[16] = "-";
+            if (stage_profile.slot[PROFILE_CACHE_MISSES] >= 0) {
+                snprintf(cache, sizeof(cache), "%.1f", avg[PROFILE_CACHE_MISSES]);
+            }
+            if (stage_profile.slot[PROFILE_BRANCH_MISSES] >= 0) {
+                snprintf(branch, sizeof(branch), "%.1f", avg[PROFILE_BRANCH_MISSES]);
+            }
+            double ipc = (avg[PROFILE_CYCLES] > 0) ? avg[PROFILE_INSTRUCTIONS] / avg[PROFILE_CYCLES] : 0.0;
+            PROFILE_APPEND("  %-10s %10.0f %10.0f %6.2f %11s %12s %10.0f\n", label, avg[PROFILE_CYCLES],
+                           avg[PROFILE_INSTRUCTIONS], ipc, cache, branch, avg[PROFILE_NANOSECONDS]);
+        }
+    }
+#undef PROFILE_APPEND
+    return (int)used;
+}
+
+// Write the breakdown to a stream
+void profile_dump(FILE *out, const char *(*name)(int code)) {
+    static char text[PROFILE_RENDER_SIZE];
+    profile_render(text, sizeof(text), name);
+    fputs(text, out);
+    fflush(out);
+}
+
+#ifdef STAGE_PROFILE
+#define PROFILE_START(param_code) profile_start(param_code)
+#define PROFILE_MARK(stage) profile_mark(stage)
+#else
+#define PROFILE_START(param_code) ((void)0)
+#define PROFILE_MARK(stage) ((void)0)
+#endif
+
+#endif
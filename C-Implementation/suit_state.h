@@ -0,0 +1,239 @@
+#ifndef SUIT_STATE_H
+#define SUIT_STATE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+// Central per-suit state: last value, last-seen time and alarm flags per parameter.
+// A flat open-addressing table keyed by suit ID with one 128-byte entry per suit,
+// aligned to a cache line, split into shards by hash. Each shard has a single writer (the thread
+// that ingests that shard's suits) and never shares a slot with another shard, so
+// writers need no locks. Readers take lock-free snapshots of an entry through a
+// per-entry sequence counter and retry if a write overlapped.
+//
+// Entries are never removed; the table is sized for the fleet at init.
+#define SUIT_STATE_PARAMS 8  // Parameter codes 1-8
+#define SUIT_STATE_SHARDS 8  // Power of two
+#define SUIT_STATE_LOAD_PERCENT 50  // Slots per shard are sized to stay under this load
+
+typedef struct {
+    _Alignas(64) _Atomic uint32_t key;  // suit_id + 1, 0 = empty slot, published last
+    _Atomic uint32_t version;  // Odd while the writer is updating the entry
+    uint32_t last_seen_ms;  // Latest reading of any parameter
+    uint16_t alarm_flags;  // Bit (code - 1): parameter is beyond its threshold
+    uint16_t warning_flags;  // Bit (code - 1): crossing predicted
+    uint32_t readings;
+    float value[SUIT_STATE_PARAMS];
+    uint32_t seen_ms[SUIT_STATE_PARAMS];
+    uint32_t alarm_since_ms[SUIT_STATE_PARAMS];  // When the current alarm started
+} SuitState;
+
+typedef struct {
+    SuitState *slots;
+    uint32_t mask;
+    uint32_t count;  // Written by the shard's writer only
+    _Atomic uint32_t published;  // Count as seen by readers
+} SuitStateShard;
+
+typedef struct {
+    SuitStateShard shards[SUIT_STATE_SHARDS];
+} SuitStateTable;
+
+// Plain copy of an entry taken by suit_state_snapshot
+typedef struct {
+    int suit_id;
+    uint32_t last_seen_ms;
+    uint16_t alarm_flags;
+    uint16_t warning_flags;
+    uint32_t readings;
+    float value[SUIT_STATE_PARAMS];
+    uint32_t seen_ms[SUIT_STATE_PARAMS];
+    uint32_t alarm_since_ms[SUIT_STATE_PARAMS];
+} SuitSnapshot;
+
+static inline uint32_t suit_state_hash(int suit_id) {
+    uint32_t h = (uint32_t)suit_id * 2654435761u;
+    return h ^ (h >> 16);
+}
+
+// Shard a suit belongs to, so ingestion can route it to that shard's writer
+static inline int suit_state_shard(int suit_id) {
+    return (int)(suit_state_hash(suit_id) & (SUIT_STATE_SHARDS - 1));
+}
+
+// Returns 0, or -1 when allocation fails
+int suit_state_init(SuitStateTable *table, int expected_suits) {
+    uint32_t per_shard = (uint32_t)expected_suits / SUIT_STATE_SHARDS + 1;
+    uint32_t capacity = 64;
+    while ((uint64_t)capacity * SUIT_STATE_LOAD_PERCENT / 100 < per_shard) capacity <<= 1;
+
+    memset(table, 0, sizeof(*table));
+    for (int s = 0; s < SUIT_STATE_SHARDS; s++) {
+        size_t bytes = (size_t)capacity * sizeof(SuitState);
+#ifdef _WIN32
+        table->shards[s].slots = _aligned_malloc(bytes, 64);
+#else
+        table->shards[s].slots = aligned_alloc(64, bytes);
+#endif
+        if (table->shards[s].slots == NULL) return -1;
+        memset(table->shards[s].slots, 0, bytes);
+        table->shards[s].mask = capacity - 1;
+    }
+    return 0;
+}
+
+void suit_state_free(SuitStateTable *table) {
+    for (int s = 0; s < SUIT_STATE_SHARDS; s++) {
+#ifdef _WIN32
+        _aligned_free(table->shards[s].slots);
+#else
+        free(table->shards[s].slots);
+#endif
+        table->shards[s].slots = NULL;
+    }
+}
+
+// Slot of a suit, or NULL. Safe from any thread.
+static inline SuitState *suit_state_find(SuitStateTable *table, int suit_id) {
+    uint32_t h = suit_state_hash(suit_id);
+    SuitStateShard *shard = &table->shards[h & (SUIT_STATE_SHARDS - 1)];
+    uint32_t key = (uint32_t)suit_id + 1;
+    if (shard->slots == NULL) return NULL;
+    for (uint32_t i = (h >> 3) & shard->mask, n = 0; n <= shard->mask; i = (i + 1) & shard->mask, n++) {
+        uint32_t k = atomic_load_explicit(&shard->slots[i].key, memory_order_acquire);
+        if (k == key) return &shard->slots[i];
+        if (k == 0) return NULL;
+    }
+    return NULL;
+}
+
+// Writer side: find or insert a suit. Only the shard's writer may call this.
+// Returns NULL when the shard is full.
+SuitState *suit_state_claim(SuitStateTable *table, int suit_id) {
+    uint32_t h = suit_state_hash(suit_id);
+    SuitStateShard *shard = &table->shards[h & (SUIT_STATE_SHARDS - 1)];
+    uint32_t key = (uint32_t)suit_id + 1;
+    if (shard->slots == NULL) return NULL;
+    for (uint32_t i = (h >> 3) & shard->mask, n = 0; n <= shard->mask; i = (i + 1) & shard->mask, n++) {
+        SuitState *e = &shard->slots[i];
+        uint32_t k = atomic_load_explicit(&e->key, memory_order_relaxed);
+        if (k == key) return e;
+        if (k == 0) {
+            if (shard->count >= shard->mask) return NULL;  // Keep one empty slot to end probes
+            // The entry is still zero from init; publishing the key makes it visible
+            atomic_store_explicit(&e->key, key, memory_order_release);
+            shard->count++;
+            atomic_store_explicit(&shard->published, shard->count, memory_order_relaxed);
+            return e;
+        }
+    }
+    return NULL;
+}
+
+static inline void suit_state_write_begin(SuitState *e) {
+    atomic_store_explicit(&e->version, atomic_load_explicit(&e->version, memory_order_relaxed) + 1,
+                          memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+}
+
+static inline void suit_state_write_end(SuitState *e) {
+    atomic_store_explicit(&e->version, atomic_load_explicit(&e->version, memory_order_relaxed) + 1,
+                          memory_order_release);
+}
+
+// Record a reading. alarm: 1 beyond threshold, 0 within, -1 leave the flag as it is.
+// Returns the parameter's alarm flag change: 1 raised, -1 cleared, 0 none (or -2 if the shard is full).
+int suit_state_update(SuitStateTable *table, int suit_id, int param_code, double value, uint32_t now_ms, int alarm) {
+    if (param_code < 1 || param_code > SUIT_STATE_PARAMS) return 0;
+    SuitState *e = suit_state_claim(table, suit_id);
+    if (e == NULL) return -2;
+
+    int p = param_code - 1;
+    uint16_t bit = (uint16_t)(1u << p);
+    int was = (e->alarm_flags & bit) != 0;
+    int change = 0;
+
+    suit_state_write_begin(e);
+    e->value[p] = (float)value;
+    e->seen_ms[p] = now_ms;
+    e->last_seen_ms = now_ms;
+    e->readings++;
+    if (alarm == 1 && !was) {
+        e->alarm_flags |= bit;
+        e->alarm_since_ms[p] = now_ms;
+        change = 1;
+    } else if (alarm == 0 && was) {
+        e->alarm_flags &= (uint16_t)~bit;
+        e->warning_flags &= (uint16_t)~bit;
+        change = -1;
+    }
+    suit_state_write_end(e);
+    return change;
+}
+
+void suit_state_set_warning(SuitStateTable *table, int suit_id, int param_code) {
+    if (param_code < 1 || param_code > SUIT_STATE_PARAMS) return;
+    SuitState *e = suit_state_claim(table, suit_id);
+    if (e == NULL) return;
+    suit_state_write_begin(e);
+    e->warning_flags |= (uint16_t)(1u << (param_code - 1));
+    suit_state_write_end(e);
+}
+
+// Lock-free consistent copy of one entry, retried while a write overlaps.
+// Returns 0 for an empty slot.
+static inline int suit_state_snapshot(SuitState *e, SuitSnapshot *out) {
+    while (1) {
+        uint32_t key = atomic_load_explicit(&e->key, memory_order_acquire);
+        if (key == 0) return 0;
+        uint32_t before = atomic_load_explicit(&e->version, memory_order_acquire);
+        if (before & 1) continue;  // Writer in progress
+
+        out->suit_id = (int)(key - 1);
+        out->last_seen_ms = e->last_seen_ms;
+        out->alarm_flags = e->alarm_flags;
+        out->warning_flags = e->warning_flags;
+        out->readings = e->readings;
+        memcpy(out->value, e->value, sizeof(out->value));
+        memcpy(out->seen_ms, e->seen_ms, sizeof(out->seen_ms));
+        memcpy(out->alarm_since_ms, e->alarm_since_ms, sizeof(out->alarm_since_ms));
+
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&e->version, memory_order_relaxed) == before) return 1;
+    }
+}
+
+int suit_state_get(SuitStateTable *table, int suit_id, SuitSnapshot *out) {
+    SuitState *e = suit_state_find(table, suit_id);
+    return e != NULL && suit_state_snapshot(e, out);
+}
+
+// Visit a snapshot of every suit; the callback returns nonzero to stop early.
+// Runs alongside the writers, each suit is consistent on its own.
+long suit_state_scan(SuitStateTable *table, int (*visit)(const SuitSnapshot *suit, void *arg), void *arg) {
+    SuitSnapshot snap;
+    long visited = 0;
+    for (int s = 0; s < SUIT_STATE_SHARDS; s++) {
+        SuitStateShard *shard = &table->shards[s];
+        if (shard->slots == NULL) continue;
+        for (uint32_t i = 0; i <= shard->mask; i++) {
+            if (!suit_state_snapshot(&shard->slots[i], &snap)) continue;
+            visited++;
+            if (visit(&snap, arg)) return visited;
+        }
+    }
+    return visited;
+}
+
+long suit_state_count(SuitStateTable *table) {
+    long total = 0;
+    for (int s = 0; s < SUIT_STATE_SHARDS; s++) {
+        total += atomic_load_explicit(&table->shards[s].published, memory_order_relaxed);
+    }
+    return total;
+}
+
+#endif
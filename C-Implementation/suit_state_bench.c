@@ -0,0 +1,178 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include "suit_state.h"
+
+// Benchmark for the per-suit state table at fleet size:
+//  1. insert of 100k suits
+//  2. reading updates with one writer, then one writer per shard
+//  3. full snapshot scans, alone and while the writers run, checking that no
+//     snapshot mixes two updates (each update writes a matching value/time pair).
+//     The idle scan runs over a known state and must count exactly its alarms.
+// Exits non-zero when a check fails.
+
+#define BENCH_SUITS 100000
+#define BENCH_UPDATES 20000000L
+#define BENCH_SCANS 20
+#define BENCH_ALARM_EVERY 10  // Idle scan fixture: every 10th suit in alarm on one parameter
+
+SuitStateTable table;
+int *shard_suits[SUIT_STATE_SHARDS + 1];  // Suit IDs owned by each shard, the last list has all
+int shard_sizes[SUIT_STATE_SHARDS + 1];
+atomic_int stop_writers;
+
+double now_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Suit IDs are spread out like badge numbers rather than dense
+int suit_id_of(int i) {
+    return 1000 + i * 7;
+}
+
+typedef struct {
+    int shard;
+    long updates;
+    double elapsed;
+} WriterArgs;
+
+static void *writer(void *arg) {
+    WriterArgs *args = arg;
+    int *suits = shard_suits[args->shard];
+    int n = shard_sizes[args->shard];
+    uint32_t seed = 17 + args->shard, tick = 0;
+    double start = now_seconds();
+    long done = 0;
+    while (!atomic_load_explicit(&stop_writers, memory_order_relaxed) && done < args->updates) {
+        for (int i = 0; i < 1024; i++) {
+            seed = seed * 1664525u + 1013904223u;
+            tick = (tick + 1) & 0xffffff;  // Exact in a float
+            suit_state_update(&table, suits[(seed >> 8) % n], 1 + (seed & 7), (double)tick, tick, (seed >> 4) & 1);
+        }
+        done += 1024;
+    }
+    args->updates = done;
+    args->elapsed = now_seconds() - start;
+    return NULL;
+}
+
+typedef struct {
+    long alarms;
+    long torn;
+} ScanCheck;
+
+static int check_suit(const SuitSnapshot *suit, void *arg) {
+    ScanCheck *check = arg;
+    if (suit->alarm_flags) check->alarms++;
+    for (int p = 0; p < SUIT_STATE_PARAMS; p++) {
+        if (suit->seen_ms[p] != 0 && suit->value[p] != (float)suit->seen_ms[p]) check->torn++;
+    }
+    return 0;
+}
+
+double scan_ms(int scans, ScanCheck *check) {
+    memset(check, 0, sizeof(*check));
+    double start = now_seconds();
+    for (int i = 0; i < scans; i++) suit_state_scan(&table, check_suit, check);
+    return (now_seconds() - start) * 1000.0 / scans;
+}
+
+// One thread writing every shard, or one thread per shard
+double run_writers(int threads, long updates_per_thread) {
+    pthread_t ids[SUIT_STATE_SHARDS];
+    WriterArgs args[SUIT_STATE_SHARDS];
+    double start = now_seconds();
+    for (int t = 0; t < threads; t++) {
+        args[t].shard = (threads == 1) ? SUIT_STATE_SHARDS : t;
+        args[t].updates = updates_per_thread;
+        pthread_create(&ids[t], NULL, writer, &args[t]);
+    }
+    long total = 0;
+    for (int t = 0; t < threads; t++) {
+        pthread_join(ids[t], NULL);
+        total += args[t].updates;
+    }
+    return total / (now_seconds() - start);
+}
+
+int main() {
+    printf("Smart Suit - Suit State Table Benchmark\n");
+    printf("---------------------------------------\n");
+    printf("Entry %d bytes, %d shards\n", (int)sizeof(SuitState), SUIT_STATE_SHARDS);
+
+    if (suit_state_init(&table, BENCH_SUITS) != 0) {
+        printf("Allocation failed\n");
+        return 1;
+    }
+    for (int s = 0; s <= SUIT_STATE_SHARDS; s++) shard_suits[s] = malloc(sizeof(int) * BENCH_SUITS);
+    for (int i = 0; i < BENCH_SUITS; i++) {
+        int id = suit_id_of(i), s = suit_state_shard(id);
+        shard_suits[s][shard_sizes[s]++] = id;
+        shard_suits[SUIT_STATE_SHARDS][shard_sizes[SUIT_STATE_SHARDS]++] = id;
+    }
+
+    // Insert
+    double start = now_seconds();
+    for (int i = 0; i < BENCH_SUITS; i++) suit_state_update(&table, suit_id_of(i), 1, 0.0, 0, 0);
+    double insert_ns = (now_seconds() - start) * 1e9 / BENCH_SUITS;
+    printf("Insert: %d suits at %.1f ns each, %ld tracked\n", BENCH_SUITS, insert_ns, suit_state_count(&table));
+
+    // Updates: every shard from one thread, then a writer per shard
+    double one = run_writers(1, BENCH_UPDATES);
+    printf("Update, 1 writer (all shards): %6.1f M updates/s\n", one / 1e6);
+    double all = run_writers(SUIT_STATE_SHARDS, BENCH_UPDATES / SUIT_STATE_SHARDS);
+    printf("Update, %d writers (1/shard):   %6.1f M updates/s on %ld CPU(s)\n", SUIT_STATE_SHARDS, all / 1e6,
+           sysconf(_SC_NPROCESSORS_ONLN));
+
+    // Scans. The random writers leave nearly every suit with some parameter in alarm,
+    // so the idle scan first puts the table in a known state
+    int failures = 0;
+    long expected_alarms = 0;
+    for (int i = 0; i < BENCH_SUITS; i++) {
+        int in_alarm = (i % BENCH_ALARM_EVERY == 0);
+        for (int p = 1; p <= SUIT_STATE_PARAMS; p++) {
+            suit_state_update(&table, suit_id_of(i), p, 1.0, 1, in_alarm && p == 1);
+        }
+        expected_alarms += in_alarm;
+    }
+    ScanCheck check;
+    double idle = scan_ms(BENCH_SCANS, &check);
+    printf("Scan, idle:          %6.2f ms for %d suits, %ld in alarm (expected %ld), %ld torn\n", idle, BENCH_SUITS,
+           check.alarms / BENCH_SCANS, expected_alarms, check.torn);
+    if (check.alarms != expected_alarms * BENCH_SCANS || check.torn != 0) {
+        printf("FAIL: idle scan does not match the table\n");
+        failures++;
+    }
+
+    pthread_t ids[SUIT_STATE_SHARDS];
+    WriterArgs args[SUIT_STATE_SHARDS];
+    atomic_store(&stop_writers, 0);
+    for (int t = 0; t < SUIT_STATE_SHARDS; t++) {
+        args[t].shard = t;
+        args[t].updates = BENCH_UPDATES * 100;
+        pthread_create(&ids[t], NULL, writer, &args[t]);
+    }
+    double busy = scan_ms(BENCH_SCANS, &check);
+    atomic_store(&stop_writers, 1);
+    long total = 0;
+    for (int t = 0; t < SUIT_STATE_SHARDS; t++) {
+        pthread_join(ids[t], NULL);
+        total += args[t].updates;
+    }
+    printf("Scan, with writers:  %6.2f ms for %d suits, %ld torn snapshots (%ld updates ran alongside)\n",
+           busy, BENCH_SUITS, check.torn, total);
+    if (check.torn != 0) {
+        printf("FAIL: torn snapshots\n");
+        failures++;
+    }
+
+    for (int s = 0; s <= SUIT_STATE_SHARDS; s++) free(shard_suits[s]);
+    suit_state_free(&table);
+    return failures ? 1 : 0;
+}
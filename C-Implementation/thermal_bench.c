@@ -0,0 +1,242 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include "thermal_control.h"
+
+// Benchmark for the fixed-rate thermal control loops:
+//  1. control quality on a simulated suit population over an hour: the old
+//     on/off response to every temperature reading against the PI loops, in
+//     actuator commands per suit and hour and RMS distance from the setpoint
+//  2. tick compute cost with 10k and 100k suits under control
+//  3. tick jitter and deadline misses in real time, sleeping until each tick
+//     is due the way the control module waits on its listening socket
+//  4. suits going stale together with a command buffer too small for all of
+//     their switch-off commands: every suit must still be sent duty 0
+
+#define BENCH_PLANT_SUITS 1000
+#define BENCH_PLANT_S 3600
+#define BENCH_SAMPLE_MS 1000  // One temperature reading per suit per second
+#define BENCH_TAU_S 600.0  // Suit temperature follows the ambient with this time constant
+#define BENCH_FULL_POWER 0.05  // °C/s the cooling or heating moves the suit at 100% duty
+#define BENCH_NOISE 0.1  // Filtered reading noise, ± °C
+#define BENCH_COST_TICKS 100
+#define BENCH_REAL_SUITS 10000
+#define BENCH_REAL_S 5
+#define BENCH_STALE_SUITS 100
+#define BENCH_STALE_OUT 16  // Command slots per tick, fewer than the suits going stale
+
+ThermalScheduler scheduler;
+ThermalCommand commands[THERMAL_MAX_SUITS];
+uint32_t rng = 2024;
+
+double now_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+uint32_t next_random() {
+    rng = rng * 1664525u + 1013904223u;
+    return rng >> 8;
+}
+
+double uniform(double low, double high) {
+    return low + (high - low) * (next_random() / 16777216.0);
+}
+
+static int compare_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+typedef struct {
+    double temperature[BENCH_PLANT_SUITS];
+    double ambient[BENCH_PLANT_SUITS];
+    double duty[BENCH_PLANT_SUITS];  // Applied, -100..100
+    long commands;
+    double squared_error;
+    long error_samples;
+} Plant;
+
+// Ambient drifts between 15 and 45 °C, suits start where their ambient is
+static void plant_init(Plant *p) {
+    memset(p, 0, sizeof(*p));
+    rng = 2024;
+    for (int i = 0; i < BENCH_PLANT_SUITS; i++) {
+        p->ambient[i] = uniform(15.0, 45.0);
+        p->temperature[i] = p->ambient[i];
+    }
+}
+
+static void plant_step(Plant *p, double dt) {
+    for (int i = 0; i < BENCH_PLANT_SUITS; i++) {
+        p->ambient[i] += uniform(-0.01, 0.01) * dt;
+        if (p->ambient[i] < 15.0) p->ambient[i] = 15.0;
+        if (p->ambient[i] > 45.0) p->ambient[i] = 45.0;
+        p->temperature[i] += ((p->ambient[i] - p->temperature[i]) / BENCH_TAU_S -
+                              BENCH_FULL_POWER * p->duty[i] / 100.0) * dt;
+    }
+}
+
+static double plant_reading(const Plant *p, int i) {
+    return p->temperature[i] + uniform(-BENCH_NOISE, BENCH_NOISE);
+}
+
+// Errors count after the first 10 minutes, once both schemes have pulled the suits in
+static void plant_score(Plant *p, uint32_t t_ms) {
+    if (t_ms < 600000) return;
+    for (int i = 0; i < BENCH_PLANT_SUITS; i++) {
+        double error = p->temperature[i] - THERMAL_SETPOINT;
+        p->squared_error += error * error;
+        p->error_samples++;
+    }
+}
+
+static void report_plant(const char *name, const Plant *p) {
+    printf("  %-22s %8.0f commands/suit/h  RMS error %.2f °C\n", name,
+           p->commands / (double)BENCH_PLANT_SUITS * 3600.0 / BENCH_PLANT_S,
+           sqrt(p->squared_error / p->error_samples));
+}
+
+int main() {
+    static Plant plant;
+
+    printf("Smart Suit - Thermal Control Benchmark\n");
+    printf("--------------------------------------\n");
+    printf("PI loops at %d Hz, setpoint %.1f °C, Kp %.1f, Ki %.2f, %d bytes per loop\n",
+           1000 / THERMAL_TICK_MS, THERMAL_SETPOINT, THERMAL_KP, THERMAL_KI, (int)sizeof(ThermalLoop));
+
+    // 1. On/off against PI on the same suits and ambient drift
+    printf("\n%d suits, %d s simulated, one reading per suit per second:\n", BENCH_PLANT_SUITS, BENCH_PLANT_S);
+    plant_init(&plant);
+    for (uint32_t t = THERMAL_TICK_MS; t <= BENCH_PLANT_S * 1000u; t += THERMAL_TICK_MS) {
+        plant_step(&plant, THERMAL_TICK_MS / 1000.0);
+        if (t % BENCH_SAMPLE_MS == 0) {
+            // Every reading is answered with cooling or heating at full power
+            for (int i = 0; i < BENCH_PLANT_SUITS; i++) {
+                plant.duty[i] = (plant_reading(&plant, i) > THERMAL_SETPOINT) ? 100.0 : -100.0;
+                plant.commands++;
+            }
+            plant_score(&plant, t);
+        }
+    }
+    report_plant("on/off per reading", &plant);
+
+    plant_init(&plant);
+    if (thermal_init(&scheduler, BENCH_PLANT_SUITS, 0.0) != 0) {
+        printf("Allocation failed\n");
+        return 1;
+    }
+    for (uint32_t t = THERMAL_TICK_MS; t <= BENCH_PLANT_S * 1000u; t += THERMAL_TICK_MS) {
+        ThermalTick tick;
+        plant_step(&plant, THERMAL_TICK_MS / 1000.0);
+        if (t % BENCH_SAMPLE_MS == 0) {
+            for (int i = 0; i < BENCH_PLANT_SUITS; i++) thermal_sample(&scheduler, i, plant_reading(&plant, i), t);
+            plant_score(&plant, t);
+        }
+        if (thermal_poll(&scheduler, t / 1000.0, t, commands, BENCH_PLANT_SUITS, &tick)) {
+            for (int c = 0; c < tick.commands; c++) plant.duty[commands[c].suit_id] = commands[c].duty;
+            plant.commands += tick.commands;
+        }
+    }
+    report_plant("PI at 10 Hz", &plant);
+    thermal_free(&scheduler);
+
+    // 2. Compute cost of one tick over every loop
+    printf("\nTick cost, every suit under control:\n");
+    int populations[] = {10000, THERMAL_MAX_SUITS};
+    for (int n = 0; n < 2; n++) {
+        int suits = populations[n];
+        if (thermal_init(&scheduler, suits, 0.0) != 0) {
+            printf("Allocation failed\n");
+            return 1;
+        }
+        double total = 0.0, worst = 0.0;
+        long sent = 0;
+        for (int k = 1; k <= BENCH_COST_TICKS; k++) {
+            uint32_t t = k * THERMAL_TICK_MS;
+            ThermalTick tick;
+            // A tenth of the suits report between two ticks
+            for (int i = k % 10; i < suits; i += 10) thermal_sample(&scheduler, i, uniform(25.0, 35.0), t);
+            if (k == 1) {
+                for (int i = 0; i < suits; i++) thermal_sample(&scheduler, i, uniform(25.0, 35.0), t);
+            }
+            double start = now_seconds();
+            thermal_poll(&scheduler, t / 1000.0, t, commands, suits, &tick);
+            double elapsed = now_seconds() - start;
+            total += elapsed;
+            if (elapsed > worst) worst = elapsed;
+            sent += tick.commands;
+        }
+        printf("  %6d suits: %8.1f us mean, %8.1f us worst (%.2f%% of the period), %.1f ns per loop, "
+               "%.1f commands per tick\n",
+               suits, total / BENCH_COST_TICKS * 1e6, worst * 1e6,
+               worst * 100.0 / (THERMAL_TICK_MS / 1000.0),
+               total / BENCH_COST_TICKS / suits * 1e9, (double)sent / BENCH_COST_TICKS);
+        thermal_free(&scheduler);
+    }
+
+    // 3. Real-time jitter: sleep until due, feed samples in between like incoming alerts
+    printf("\n%d suits in real time for %d s:\n", BENCH_REAL_SUITS, BENCH_REAL_S);
+    int max_ticks = BENCH_REAL_S * 1000 / THERMAL_TICK_MS + 16;
+    double *lateness_ms = malloc(max_ticks * sizeof(double));
+    double origin = now_seconds();
+    if (lateness_ms == NULL || thermal_init(&scheduler, BENCH_REAL_SUITS, 0.0) != 0) {
+        printf("Allocation failed\n");
+        return 1;
+    }
+    for (int i = 0; i < BENCH_REAL_SUITS; i++) thermal_sample(&scheduler, i, uniform(25.0, 35.0), 0);
+    int ticks = 0, cursor = 0;
+    while (ticks < max_ticks) {
+        double now = now_seconds() - origin;
+        if (now >= BENCH_REAL_S) break;
+        int wait_ms = thermal_wait_ms(&scheduler, now);
+        if (wait_ms > 0) {
+            struct timespec pause = {wait_ms / 1000, (wait_ms % 1000) * 1000000L};
+            nanosleep(&pause, NULL);
+            now = now_seconds() - origin;
+        }
+        ThermalTick tick;
+        if (thermal_poll(&scheduler, now, (uint32_t)(now * 1000.0), commands, BENCH_REAL_SUITS, &tick)) {
+            lateness_ms[ticks++] = tick.lateness * 1000.0;
+        }
+        // A tenth of the suits report per tick
+        for (int i = 0; i < BENCH_REAL_SUITS / 10; i++) {
+            thermal_sample(&scheduler, cursor, uniform(25.0, 35.0), (uint32_t)(now * 1000.0));
+            cursor = (cursor + 1) % BENCH_REAL_SUITS;
+        }
+    }
+    qsort(lateness_ms, ticks, sizeof(double), compare_double);
+    printf("  %d ticks, lateness p50 %.3f ms, p99 %.3f ms, max %.3f ms, %ld deadline miss(es)\n",
+           ticks, lateness_ms[ticks / 2], lateness_ms[ticks * 99 / 100], lateness_ms[ticks - 1],
+           scheduler.missed);
+    thermal_free(&scheduler);
+    free(lateness_ms);
+
+    // 4. Every suit heating at full power, then silence
+    int failures = 0;
+    printf("\n%d suits going stale with %d command slots per tick:\n", BENCH_STALE_SUITS, BENCH_STALE_OUT);
+    if (thermal_init(&scheduler, BENCH_STALE_SUITS, 0.0) != 0) {
+        printf("Allocation failed\n");
+        return 1;
+    }
+    for (int i = 0; i < BENCH_STALE_SUITS; i++) thermal_sample(&scheduler, i, 10.0, 0);
+    int switched_off = 0, released = 0, stale_ticks = 0;
+    for (uint32_t t = THERMAL_TICK_MS; t <= THERMAL_STALE_MS + 100u * THERMAL_TICK_MS; t += THERMAL_TICK_MS) {
+        ThermalTick tick;
+        if (!thermal_poll(&scheduler, t / 1000.0, t, commands, BENCH_STALE_OUT, &tick)) continue;
+        for (int c = 0; c < tick.commands; c++) switched_off += (commands[c].duty == 0);
+        released += tick.released;
+        stale_ticks += (tick.released > 0);
+    }
+    printf("  %d switch-off command(s), %d suit(s) released over %d tick(s), %d still under control\n",
+           switched_off, released, stale_ticks, scheduler.count);
+    if (switched_off != BENCH_STALE_SUITS || released != BENCH_STALE_SUITS) {
+        printf("  FAIL: every stale suit must be switched off before it is released\n");
+        failures++;
+    }
+    thermal_free(&scheduler);
+    return (failures > 0) ? 1 : 0;
+}
@@ -0,0 +1,197 @@
+#ifndef THERMAL_CONTROL_H
+#define THERMAL_CONTROL_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+// Fixed-rate closed-loop thermal control, one PI loop per suit.
+// Sensors forward each suit's filtered temperature; every tick the scheduler runs
+// the PI step of every suit under control and emits a duty-cycle command only
+// when the output moved by THERMAL_DUTY_STEP or reached off or full power.
+//
+// Ticks are due at fixed multiples of the period from the start, not a period
+// after the last run, so lateness does not accumulate. A tick that runs a whole
+// period or more late skips the ticks it missed (counted as deadline misses)
+// instead of running them back to back, and its PI step integrates over the
+// actual time since the previous one.
+#define THERMAL_MAX_SUITS 100000
+#define THERMAL_TICK_MS 100  // 10 Hz
+#define THERMAL_SETPOINT 30.0  // °C
+#define THERMAL_KP 20.0  // % duty per °C
+#define THERMAL_KI 0.5  // % duty per °C and second
+#define THERMAL_DUTY_STEP 5  // Smallest change worth a command, % points
+#define THERMAL_STALE_MS 60000  // A loop without a sample for this long lets go (duty 0)
+
+// 16 bytes per suit
+typedef struct {
+    float temperature;  // Latest filtered temperature
+    float integral;  // Integral term, % duty
+    uint32_t sample_ms;
+    int16_t duty;  // Last duty sent, % of full power: > 0 cooling, < 0 heating
+} ThermalLoop;
+
+typedef struct {
+    int suit_id;
+    int duty;
+} ThermalCommand;
+
+typedef struct {
+    double lateness;  // Seconds after its due time the tick ran
+    int missed;  // Ticks skipped because this one ran a period or more late
+    int commands;
+    int released;  // Loops let go for lack of samples
+} ThermalTick;
+
+typedef struct {
+    ThermalLoop *loops;  // Indexed by suit ID
+    int32_t *slot;  // Position in active, -1 = not under control
+    int32_t *active;  // Suit IDs under control, dense
+    int capacity;
+    int count;
+    double period;
+    double next_due;  // Monotonic seconds
+    double last_run;
+    long ticks;
+    long missed;
+    int idle;  // No suit was under control, ticks falling due meanwhile were not missed
+} ThermalScheduler;
+
+int thermal_init(ThermalScheduler *s, int capacity, double now) {
+    memset(s, 0, sizeof(*s));
+    s->loops = calloc((size_t)capacity, sizeof(ThermalLoop));
+    s->slot = malloc((size_t)capacity * sizeof(int32_t));
+    s->active = malloc((size_t)capacity * sizeof(int32_t));
+    if (s->loops == NULL || s->slot == NULL || s->active == NULL) {
+        free(s->loops);
+        free(s->slot);
+        free(s->active);
+        s->loops = NULL;
+        return -1;
+    }
+    for (int i = 0; i < capacity; i++) s->slot[i] = -1;
+    s->capacity = capacity;
+    s->period = THERMAL_TICK_MS / 1000.0;
+    s->next_due = now + s->period;
+    s->last_run = now;
+    return 0;
+}
+
+void thermal_free(ThermalScheduler *s) {
+    free(s->loops);
+    free(s->slot);
+    free(s->active);
+    s->loops = NULL;
+    s->capacity = 0;
+    s->count = 0;
+}
+
+static inline int thermal_active(const ThermalScheduler *s, int suit_id) {
+    return s->loops != NULL && suit_id >= 0 && suit_id < s->capacity && s->slot[suit_id] >= 0;
+}
+
+// Latest filtered temperature of a suit; the first one puts the suit under control
+void thermal_sample(ThermalScheduler *s, int suit_id, double temperature, uint32_t now_ms) {
+    if (s->loops == NULL || suit_id < 0 || suit_id >= s->capacity) return;
+    ThermalLoop *loop = &s->loops[suit_id];
+    if (s->slot[suit_id] < 0) {
+        if (s->count == 0) s->idle = 1;
+        memset(loop, 0, sizeof(*loop));
+        s->slot[suit_id] = s->count;
+        s->active[s->count++] = suit_id;
+    }
+    loop->temperature = (float)temperature;
+    loop->sample_ms = now_ms;
+}
+
+static void thermal_release(ThermalScheduler *s, int suit_id) {
+    int32_t at = s->slot[suit_id];
+    int32_t last = s->active[--s->count];
+    s->active[at] = last;
+    s->slot[last] = at;
+    s->slot[suit_id] = -1;
+}
+
+// Milliseconds until the next tick is due, 0 when it is due now
+int thermal_wait_ms(const ThermalScheduler *s, double now) {
+    double wait = s->next_due - now;
+    return (wait > 0.0) ? (int)ceil(wait * 1000.0) : 0;
+}
+
+// One PI step, returns the duty in % of full power
+static int thermal_step(ThermalLoop *loop, double dt) {
+    double error = loop->temperature - THERMAL_SETPOINT;  // Too hot is positive, calls for cooling
+    double integral = loop->integral + THERMAL_KI * error * dt;
+    double output = THERMAL_KP * error + integral;
+    // Anti-windup: stop integrating while saturated in the direction of the error
+    if ((output > 100.0 && error > 0.0) || (output < -100.0 && error < 0.0)) {
+        output = THERMAL_KP * error + loop->integral;
+    } else {
+        loop->integral = (float)integral;
+    }
+    if (output > 100.0) output = 100.0;
+    if (output < -100.0) output = -100.0;
+    int duty = (int)lround(output);
+    return (abs(duty) < THERMAL_DUTY_STEP) ? 0 : duty;
+}
+
+static int thermal_worth_sending(int duty, int sent) {
+    if (duty == sent) return 0;
+    return abs(duty - sent) >= THERMAL_DUTY_STEP || duty == 0 || abs(duty) == 100;
+}
+
+// Run the tick if it is due. Commands go to out, up to max_out; loops whose command
+// did not fit keep their old duty and try again next tick. A stale loop still
+// driving the suit stays under control until its switch-off command fits.
+// Returns 1 when a tick ran, 0 when the next one is not due yet.
+int thermal_poll(ThermalScheduler *s, double now, uint32_t now_ms,
+                 ThermalCommand *out, int max_out, ThermalTick *tick) {
+    memset(tick, 0, sizeof(*tick));
+    if (now < s->next_due) return 0;
+
+    double lateness = now - s->next_due;
+    int skipped = (int)(lateness / s->period);
+    double dt = now - s->last_run;
+    s->next_due += (skipped + 1) * s->period;
+    if (s->idle || s->count == 0) {
+        // Back from idle: only the lateness within the current period counts
+        s->idle = 0;
+        tick->lateness = lateness - skipped * s->period;
+        dt = s->period;
+    } else {
+        tick->lateness = lateness;
+        tick->missed = skipped;
+        s->missed += skipped;
+    }
+    s->ticks++;
+    s->last_run = now;
+
+    for (int i = 0; i < s->count;) {
+        int suit_id = s->active[i];
+        ThermalLoop *loop = &s->loops[suit_id];
+        if ((int32_t)(now_ms - loop->sample_ms) > THERMAL_STALE_MS) {
+            // No news from the suit: hand it back switched off
+            if (loop->duty != 0) {
+                if (tick->commands >= max_out) {
+                    i++;
+                    continue;
+                }
+                out[tick->commands++] = (ThermalCommand){suit_id, 0};
+            }
+            thermal_release(s, suit_id);
+            tick->released++;
+            continue;  // The last active suit moved into slot i
+        }
+        int duty = thermal_step(loop, dt);
+        if (thermal_worth_sending(duty, loop->duty) && tick->commands < max_out) {
+            out[tick->commands++] = (ThermalCommand){suit_id, duty};
+            loop->duty = (int16_t)duty;
+        }
+        i++;
+    }
+    return 1;
+}
+
+#endif
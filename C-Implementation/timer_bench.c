@@ -0,0 +1,189 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "timer_wheel.h"
+
+// Benchmark for man-down deadlines in the hierarchical timer wheel:
+//  1. maintenance cost at 100k suits with 1-5 s deadlines and about one reading
+//     per suit per second: rearm per reading and wheel advance per tick, against
+//     scanning every deadline each tick
+//  2. expiry-detection jitter in real time: 1% of the suits go silent while the
+//     rest keep reporting, fired deadlines are compared with the true ones
+//  3. a deadline armed after the wheel sat empty for longer than its whole span
+//     must fire on time, not at once
+
+#define BENCH_SUITS 100000
+#define BENCH_SIM_S 60
+#define BENCH_REAL_S 8
+#define BENCH_POLL_MS (2 * TIMER_TICK_MS)  // Sensor's idle deadline check
+#define BENCH_SILENT_PER_MILLE 10
+#define BENCH_IDLE_MS (8u * 24 * 3600 * 1000)  // Empty wheel for 8 days, past its 2^26 ticks
+#define BENCH_IDLE_DEADLINE_MS 2000
+
+TimerWheel wheel;
+uint32_t timeout_ms[BENCH_SUITS];
+uint32_t last_heard_ms[BENCH_SUITS];
+double last_heard_s[BENCH_SUITS];
+unsigned char silent[BENCH_SUITS];
+uint32_t rng = 2024;
+
+double now_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+uint32_t next_random() {
+    rng = rng * 1664525u + 1013904223u;
+    return rng >> 8;
+}
+
+typedef struct {
+    long fired;
+    long false_alarms;
+    double *jitter_ms;  // Fire time minus true deadline, silent suits only
+} FireLog;
+
+static void on_expired(int id, uint32_t deadline_ms, void *arg) {
+    FireLog *log = arg;
+    (void)deadline_ms;
+    log->fired++;
+    if (!silent[id]) {
+        log->false_alarms++;
+        return;
+    }
+    double deadline_s = last_heard_s[id] + timeout_ms[id] / 1000.0;
+    log->jitter_ms[log->fired - log->false_alarms - 1] = (now_seconds() - deadline_s) * 1000.0;
+}
+
+static void count_expired(int id, uint32_t deadline_ms, void *arg) {
+    (void)id;
+    (void)deadline_ms;
+    (*(long *)arg)++;
+}
+
+static int compare_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+int main() {
+    printf("Smart Suit - Man-Down Timer Wheel Benchmark\n");
+    printf("-------------------------------------------\n");
+    printf("%d suits, deadlines 1-5 s, %d ms ticks, %d bytes per timer\n",
+           BENCH_SUITS, TIMER_TICK_MS, (int)sizeof(WheelTimer));
+
+    // 1. Maintenance cost in simulated time, readings spread evenly over each second
+    if (timer_wheel_init(&wheel, BENCH_SUITS, 0) != 0) {
+        printf("Allocation failed\n");
+        return 1;
+    }
+    for (int i = 0; i < BENCH_SUITS; i++) {
+        timeout_ms[i] = 1000 + next_random() % 4001;
+        timer_arm(&wheel, i, timeout_ms[i]);
+    }
+    FireLog sim_log = {0, 0, NULL};
+    double arm_s = 0.0, advance_s = 0.0, scan_s = 0.0;
+    long readings = 0, ticks = 0, scan_due = 0;
+    int per_tick = BENCH_SUITS / (1000 / TIMER_TICK_MS);
+    int cursor = 0;
+    for (uint32_t t = TIMER_TICK_MS; t <= BENCH_SIM_S * 1000u; t += TIMER_TICK_MS) {
+        double start = now_seconds();
+        for (int i = 0; i < per_tick; i++) {
+            int id = cursor;
+            cursor = (cursor + 1) % BENCH_SUITS;
+            timer_arm(&wheel, id, t + timeout_ms[id]);
+            last_heard_ms[id] = t;
+        }
+        double armed = now_seconds();
+        timer_advance(&wheel, t, on_expired, &sim_log);
+        double advanced = now_seconds();
+        // What a plain deadline array costs: look at every suit each tick
+        for (int i = 0; i < BENCH_SUITS; i++) {
+            if ((int32_t)(t - (last_heard_ms[i] + timeout_ms[i])) >= 0) scan_due++;
+        }
+        scan_s += now_seconds() - advanced;
+        arm_s += armed - start;
+        advance_s += advanced - armed;
+        readings += per_tick;
+        ticks++;
+    }
+    printf("\nMaintenance, %d s simulated, %ld readings:\n", BENCH_SIM_S, readings);
+    printf("  Rearm:   %6.1f ns per reading\n", arm_s * 1e9 / readings);
+    printf("  Advance: %6.2f us per tick, %.0f refiles/s (%.1f ns per reading all in)\n",
+           advance_s * 1e6 / ticks, wheel.refiled / (double)BENCH_SIM_S, (arm_s + advance_s) * 1e9 / readings);
+    printf("  Full deadline scan instead: %.1f us per tick\n", scan_s * 1e6 / ticks);
+    printf("  Expired: wheel %ld, scan %ld (expected 0, every suit reports within its deadline)\n",
+           sim_log.fired, scan_due);
+    timer_wheel_free(&wheel);
+
+    // 2. Jitter in real time
+    double origin = now_seconds();
+    if (timer_wheel_init(&wheel, BENCH_SUITS, 1) != 0) return 1;
+    int silent_count = 0;
+    for (int i = 0; i < BENCH_SUITS; i++) {
+        silent[i] = next_random() % 1000 < BENCH_SILENT_PER_MILLE;
+        silent_count += silent[i];
+        last_heard_s[i] = origin;
+        timer_arm(&wheel, i, 1 + timeout_ms[i]);
+    }
+    FireLog log = {0, 0, malloc(sizeof(double) * (size_t)silent_count)};
+    double silence_starts = origin + 1.0;  // Silent suits stop after their first second
+    cursor = 0;
+    double next_poll = origin;
+    long real_readings = 0;
+    while (now_seconds() - origin < BENCH_REAL_S) {
+        double now = now_seconds();
+        uint32_t now_ms = 1 + (uint32_t)((now - origin) * 1000.0);
+        // Readings due by now, about one per suit per second
+        long due = (long)((now - origin) * BENCH_SUITS) - real_readings;
+        for (long i = 0; i < due; i++) {
+            int id = cursor;
+            cursor = (cursor + 1) % BENCH_SUITS;
+            real_readings++;
+            if (silent[id] && now >= silence_starts) continue;
+            last_heard_s[id] = now;
+            timer_arm(&wheel, id, now_ms + timeout_ms[id]);
+        }
+        if (now >= next_poll) {
+            timer_advance(&wheel, now_ms, on_expired, &log);
+            next_poll = now + BENCH_POLL_MS / 1000.0;
+        }
+        struct timespec pause = {0, 200000L};
+        nanosleep(&pause, NULL);
+    }
+    long detected = log.fired - log.false_alarms;
+    qsort(log.jitter_ms, (size_t)detected, sizeof(double), compare_double);
+    printf("\nExpiry detection, %d s real time, %d silent suits, checked every %d ms:\n",
+           BENCH_REAL_S, silent_count, BENCH_POLL_MS);
+    if (detected > 0) {
+        printf("  Detected %ld/%d, late by p50 %.1f ms, p99 %.1f ms, max %.1f ms, min %.1f ms\n", detected,
+               silent_count, log.jitter_ms[detected / 2], log.jitter_ms[detected * 99 / 100],
+               log.jitter_ms[detected - 1], log.jitter_ms[0]);
+    }
+    printf("  False alarms among reporting suits: %ld\n", log.false_alarms);
+    free(log.jitter_ms);
+    timer_wheel_free(&wheel);
+
+    // 3. Long idle spell, then one suit signs on
+    int failures = 0;
+    long fired = 0;
+    if (timer_wheel_init(&wheel, BENCH_SUITS, 0) != 0) return 1;
+    double start = now_seconds();
+    timer_advance(&wheel, BENCH_IDLE_MS, count_expired, &fired);
+    double caught_up = now_seconds() - start;
+    timer_arm(&wheel, 0, BENCH_IDLE_MS + BENCH_IDLE_DEADLINE_MS);
+    timer_advance(&wheel, BENCH_IDLE_MS + BENCH_IDLE_DEADLINE_MS / 2, count_expired, &fired);
+    long early = fired;
+    timer_advance(&wheel, BENCH_IDLE_MS + BENCH_IDLE_DEADLINE_MS + TIMER_TICK_MS, count_expired, &fired);
+    printf("\nAfter %u days with nothing armed (caught up in %.1f us): %ld early, %ld on time\n",
+           BENCH_IDLE_MS / (24 * 3600 * 1000), caught_up * 1e6, early, fired - early);
+    if (early != 0 || fired != 1) {
+        printf("  FAIL: a %d ms deadline must fire once, after %d ms\n", BENCH_IDLE_DEADLINE_MS,
+               BENCH_IDLE_DEADLINE_MS);
+        failures++;
+    }
+    timer_wheel_free(&wheel);
+    return (failures > 0) ? 1 : 0;
+}
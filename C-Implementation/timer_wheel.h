@@ -0,0 +1,197 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+// Hierarchical hashed timer wheel for per-suit deadlines.
+// One timer per ID (suit ID), stored in a flat array and linked into wheel slots
+// by index. Level 0 has one slot per tick; each higher level covers the whole
+// level below per slot and cascades down when the level below wraps.
+//
+// Rearming to a later deadline only stores the new expiry: the timer stays in
+// its slot and is refiled when that slot comes due. A suit that keeps reporting
+// therefore costs one store per reading and one refile per deadline period,
+// and arm, cancel and expiry are all O(1).
+//
+// Deadlines are measured from the last tick processed, so the caller keeps
+// advancing while nothing is armed. An empty wheel jumps to the present in one
+// step, however long it sat idle.
+#define TIMER_TICK_MS 10
+#define TIMER_LEVELS 4
+#define TIMER_LEVEL0_BITS 8  // 256 ticks, 2.56 s
+#define TIMER_LEVEL_BITS 6  // 64 slots per higher level, 2^26 ticks (7.8 days) in total
+#define TIMER_LEVEL0_SLOTS (1 << TIMER_LEVEL0_BITS)
+#define TIMER_LEVEL_SLOTS (1 << TIMER_LEVEL_BITS)
+#define TIMER_SLOTS (TIMER_LEVEL0_SLOTS + (TIMER_LEVELS - 1) * TIMER_LEVEL_SLOTS)
+#define TIMER_MAX_TICKS ((1u << (TIMER_LEVEL0_BITS + (TIMER_LEVELS - 1) * TIMER_LEVEL_BITS)) - 1)
+
+// 20 bytes per timer
+typedef struct {
+    int32_t next, prev;  // Slot list links, -1 = none
+    uint32_t expires;  // Tick the timer is due
+    uint32_t filed;  // Expiry its slot was chosen for, the slot comes due no later
+    int32_t slot;  // -1 = not armed
+} WheelTimer;
+
+typedef struct {
+    WheelTimer *timers;  // Indexed by ID
+    int capacity;
+    int armed;
+    uint32_t now;  // Last tick processed
+    uint32_t now_ms;  // Time of that tick
+    int32_t heads[TIMER_SLOTS];
+    long refiled;  // Timers moved because their deadline was pushed out or cascaded
+} TimerWheel;
+
+// Called for each expired timer, which is disarmed first and may be armed again
+typedef void (*TimerExpired)(int id, uint32_t deadline_ms, void *arg);
+
+int timer_wheel_init(TimerWheel *w, int capacity, uint32_t now_ms) {
+    memset(w, 0, sizeof(*w));
+    w->timers = malloc((size_t)capacity * sizeof(WheelTimer));
+    if (w->timers == NULL) return -1;
+    for (int i = 0; i < capacity; i++) {
+        w->timers[i].next = w->timers[i].prev = -1;
+        w->timers[i].slot = -1;
+    }
+    for (int s = 0; s < TIMER_SLOTS; s++) w->heads[s] = -1;
+    w->capacity = capacity;
+    w->now_ms = now_ms;
+    return 0;
+}
+
+void timer_wheel_free(TimerWheel *w) {
+    free(w->timers);
+    w->timers = NULL;
+    w->capacity = 0;
+    w->armed = 0;
+}
+
+static void timer_link(TimerWheel *w, int id) {
+    WheelTimer *t = &w->timers[id];
+    uint32_t delta = t->expires - w->now;
+    int slot;
+    if ((int32_t)delta <= 0) {
+        t->expires = w->now + 1;  // Overdue timers fire on the next tick
+        delta = 1;
+    }
+    if (delta > TIMER_MAX_TICKS) {
+        t->expires = w->now + TIMER_MAX_TICKS;
+        delta = TIMER_MAX_TICKS;
+    }
+    if (delta < TIMER_LEVEL0_SLOTS) {
+        slot = (int)(t->expires & (TIMER_LEVEL0_SLOTS - 1));
+    } else {
+        int level = 1;
+        while (level < TIMER_LEVELS - 1 &&
+               delta >= (1u << (TIMER_LEVEL0_BITS + level * TIMER_LEVEL_BITS))) level++;
+        int shift = TIMER_LEVEL0_BITS + (level - 1) * TIMER_LEVEL_BITS;
+        slot = TIMER_LEVEL0_SLOTS + (level - 1) * TIMER_LEVEL_SLOTS +
+               (int)((t->expires >> shift) & (TIMER_LEVEL_SLOTS - 1));
+    }
+    t->filed = t->expires;
+    t->slot = slot;
+    t->prev = -1;
+    t->next = w->heads[slot];
+    if (t->next >= 0) w->timers[t->next].prev = id;
+    w->heads[slot] = id;
+}
+
+static void timer_unlink(TimerWheel *w, int id) {
+    WheelTimer *t = &w->timers[id];
+    if (t->prev >= 0) w->timers[t->prev].next = t->next;
+    else w->heads[t->slot] = t->next;
+    if (t->next >= 0) w->timers[t->next].prev = t->prev;
+    t->next = t->prev = -1;
+    t->slot = -1;
+}
+
+// Arm or rearm a timer to fire once deadline_ms has passed
+void timer_arm(TimerWheel *w, int id, uint32_t deadline_ms) {
+    if (id < 0 || id >= w->capacity) return;
+    WheelTimer *t = &w->timers[id];
+    int32_t ahead = (int32_t)(deadline_ms - w->now_ms);
+    uint32_t expires = w->now + (ahead > 0 ? (uint32_t)(ahead + TIMER_TICK_MS - 1) / TIMER_TICK_MS : 0);
+    if (t->slot >= 0) {
+        if ((int32_t)(expires - t->filed) >= 0) {
+            t->expires = expires;  // Later than filed, picked up when the slot comes due
+            return;
+        }
+        timer_unlink(w, id);
+        w->armed--;
+    }
+    t->expires = expires;
+    timer_link(w, id);
+    w->armed++;
+}
+
+void timer_cancel(TimerWheel *w, int id) {
+    if (id < 0 || id >= w->capacity || w->timers[id].slot < 0) return;
+    timer_unlink(w, id);
+    w->armed--;
+}
+
+static inline int timer_armed(const TimerWheel *w, int id) {
+    return id >= 0 && id < w->capacity && w->timers[id].slot >= 0;
+}
+
+// Refile every timer of a higher-level slot into the levels below
+static void timer_cascade(TimerWheel *w, int slot) {
+    int id = w->heads[slot];
+    w->heads[slot] = -1;
+    while (id >= 0) {
+        int next = w->timers[id].next;
+        timer_link(w, id);
+        w->refiled++;
+        id = next;
+    }
+}
+
+// Process every tick up to now_ms; returns the number of timers that fired
+int timer_advance(TimerWheel *w, uint32_t now_ms, TimerExpired fire, void *arg) {
+    int fired = 0;
+    if (w->armed == 0) {
+        // No slot to visit, keep tick alignment and skip the idle time in one step
+        uint32_t ticks = (now_ms - w->now_ms) / TIMER_TICK_MS;
+        w->now += ticks;
+        w->now_ms += ticks * TIMER_TICK_MS;
+        return 0;
+    }
+    while ((int32_t)(now_ms - w->now_ms) >= TIMER_TICK_MS) {
+        w->now++;
+        w->now_ms += TIMER_TICK_MS;
+
+        // Level 0 wrapped: bring the next slot of each higher level down
+        uint32_t index = w->now & (TIMER_LEVEL0_SLOTS - 1);
+        for (int level = 1; level < TIMER_LEVELS && index == 0; level++) {
+            int shift = TIMER_LEVEL0_BITS + (level - 1) * TIMER_LEVEL_BITS;
+            index = (w->now >> shift) & (TIMER_LEVEL_SLOTS - 1);
+            timer_cascade(w, TIMER_LEVEL0_SLOTS + (level - 1) * TIMER_LEVEL_SLOTS + (int)index);
+        }
+
+        int slot = (int)(w->now & (TIMER_LEVEL0_SLOTS - 1));
+        int id = w->heads[slot];
+        w->heads[slot] = -1;
+        while (id >= 0) {
+            WheelTimer *t = &w->timers[id];
+            int next = t->next;
+            t->next = t->prev = -1;
+            if ((int32_t)(t->expires - w->now) > 0) {
+                timer_link(w, id);  // Rearmed since it was filed
+                w->refiled++;
+            } else {
+                t->slot = -1;
+                w->armed--;
+                fired++;
+                fire(id, w->now_ms - (w->now - t->expires) * TIMER_TICK_MS, arg);
+            }
+            id = next;
+        }
+    }
+    return fired;
+}
+
+#endif
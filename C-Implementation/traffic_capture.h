@@ -0,0 +1,255 @@
+#ifndef TRAFFIC_CAPTURE_H
+#define TRAFFIC_CAPTURE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+#include "net_compat.h"
+
+// Capture of the traffic a module receives, for replay (replay.c).
+// With CAPTURE_FILE set, every chunk read from an accepted connection is
+// appended to a binary file with the time since the previous chunk; the first
+// chunk of a connection is flagged so replay can rebuild the connections. The
+// file header keeps the seed the module gave rand(), so a replay against a
+// module started with NOISE_SEED set to it draws the same model noise.
+//
+// Each chunk is flushed as it is recorded, so the capture of a module that
+// crashes ends with the message it crashed on.
+//
+// A module started with REPLAY_CLOCK naming the capture being replayed into it
+// takes its time from the capture instead of the system clock: accepting its
+// n-th connection moves the clock to when the n-th captured connection arrived,
+// in steps as long as the module's idle polls so deadlines fall due when they
+// did, and the clock stands still in between. Holds, trends and deadlines then
+// see the original timing whatever the replay speed. After the last captured
+// connection the clock runs on in real time, so what was still pending can
+// fall due.
+#define CAPTURE_ENV "CAPTURE_FILE"
+#define NOISE_SEED_ENV "NOISE_SEED"
+#define REPLAY_CLOCK_ENV "REPLAY_CLOCK"
+#define REPLAY_CLOCK_ORIGIN_MS 1000  // Module time of the first captured connection
+#define CAPTURE_MAGIC 0x50414353u  // "SCAP"
+#define CAPTURE_VERSION 1
+#define CAPTURE_PATH_LEN 256
+#define CAPTURE_FIRST 1  // Record starts a new connection
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t port;  // Port the module listened on
+    uint32_t seed;  // rand() seed of the module
+    uint32_t pad;
+    int64_t start_us;  // Wall clock of the first record, 0 while there is none
+} CaptureHeader;
+
+// 8 bytes, followed by `length` payload bytes
+typedef struct {
+    uint32_t delta_us;  // Since the previous record, gaps beyond 71 min are shortened
+    uint16_t length;
+    uint8_t flags;
+    uint8_t pad;
+} CaptureRecord;
+
+typedef struct {
+    FILE *file;
+    char path[CAPTURE_PATH_LEN];
+    SOCKET sock;  // Connection being captured
+    int first;  // Next record is the first of the connection
+    double last;  // Monotonic seconds of the previous record
+    long records;
+    long bytes;
+} TrafficCapture;
+
+TrafficCapture capture = {NULL, "", INVALID_SOCKET, 0, 0.0, 0, 0};
+
+typedef struct {
+    FILE *file;  // Capture being replayed, NULL once used up
+    int active;
+    uint64_t at_us;  // Module time, capture microseconds since the first record
+    uint64_t target_us;  // When the connection being accepted arrived
+    double ended;  // Monotonic seconds when the last captured connection was reached
+} ReplayClock;
+
+ReplayClock replay_clock = {NULL, 0, 0, 0, 0.0};
+
+static double capture_now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int64_t capture_wall_us() {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+// Seed for the model noise: NOISE_SEED when set, otherwise the clock
+uint32_t noise_seed() {
+    const char *seed = getenv(NOISE_SEED_ENV);
+    if (seed != NULL && *seed != '\0') return (uint32_t)strtoul(seed, NULL, 0);
+    return (uint32_t)time(NULL);
+}
+
+// Start capturing if CAPTURE_FILE is set. Listener workers each write their own
+// file (worker >= 0 adds a ".w<worker>" suffix). Returns -1 if the file cannot be created.
+int capture_open(int port, int worker, uint32_t seed) {
+    const char *path = getenv(CAPTURE_ENV);
+    if (path == NULL || *path == '\0') return 0;
+    if (worker >= 0) {
+        snprintf(capture.path, sizeof(capture.path), "%s.w%d", path, worker);
+    } else {
+        snprintf(capture.path, sizeof(capture.path), "%s", path);
+    }
+    capture.file = fopen(capture.path, "wb");
+    if (capture.file == NULL) return -1;
+
+    // start_us is filled in by the first record
+    CaptureHeader header = {CAPTURE_MAGIC, CAPTURE_VERSION, (uint16_t)port, seed, 0, 0};
+    fwrite(&header, sizeof(header), 1, capture.file);
+    fflush(capture.file);
+    capture.records = 0;
+    return 0;
+}
+
+// A connection was accepted; what is read from it until the next one is captured
+static inline void capture_begin(SOCKET sock) {
+    capture.sock = sock;
+    capture.first = 1;
+}
+
+// Record bytes read from the captured connection, n as returned by recv
+void capture_received(SOCKET sock, const void *data, int n) {
+    if (capture.file == NULL || sock != capture.sock || n <= 0) return;
+    double now = capture_now();
+    double delta = (capture.records > 0) ? (now - capture.last) * 1e6 : 0.0;
+    const char *bytes = data;
+
+    if (capture.records == 0) {
+        int64_t start_us = capture_wall_us();
+        fseek(capture.file, (long)offsetof(CaptureHeader, start_us), SEEK_SET);
+        fwrite(&start_us, sizeof(start_us), 1, capture.file);
+        fseek(capture.file, 0, SEEK_END);
+    }
+
+    while (n > 0) {
+        int chunk = (n > UINT16_MAX) ? UINT16_MAX : n;
+        CaptureRecord record = {(delta < UINT32_MAX) ? (uint32_t)delta : UINT32_MAX, (uint16_t)chunk,
+                                (uint8_t)(capture.first ? CAPTURE_FIRST : 0), 0};
+        fwrite(&record, sizeof(record), 1, capture.file);
+        fwrite(bytes, 1, (size_t)chunk, capture.file);
+        capture.records++;
+        capture.bytes += chunk;
+        capture.first = 0;
+        delta = 0.0;
+        bytes += chunk;
+        n -= chunk;
+    }
+    capture.last = now;
+    fflush(capture.file);
+}
+
+void capture_close() {
+    if (capture.file == NULL) return;
+    fclose(capture.file);
+    capture.file = NULL;
+}
+
+// Reading side, for replay. Returns -1 if the file is not a capture.
+int capture_read_header(FILE *file, CaptureHeader *header) {
+    if (fread(header, sizeof(*header), 1, file) != 1) return -1;
+    if (header->magic != CAPTURE_MAGIC || header->version != CAPTURE_VERSION) return -1;
+    return 0;
+}
+
+// Next record into data (at least UINT16_MAX bytes); returns 0 at the end, -1 on a torn record
+int capture_read_record(FILE *file, CaptureRecord *record, char *data) {
+    if (fread(record, sizeof(*record), 1, file) != 1) return 0;
+    if (record->length > 0 && fread(data, 1, record->length, file) != record->length) return -1;
+    return 1;
+}
+
+// Take module time from the capture named by REPLAY_CLOCK, if set.
+// Returns -1 if it is set but not a readable capture.
+int replay_clock_open() {
+    const char *path = getenv(REPLAY_CLOCK_ENV);
+    CaptureHeader header;
+    if (path == NULL || *path == '\0') return 0;
+    replay_clock.file = fopen(path, "rb");
+    if (replay_clock.file == NULL || capture_read_header(replay_clock.file, &header) != 0) {
+        if (replay_clock.file != NULL) fclose(replay_clock.file);
+        replay_clock.file = NULL;
+        return -1;
+    }
+    replay_clock.active = 1;
+    replay_clock.at_us = 0;
+    replay_clock.target_us = 0;
+    replay_clock.ended = capture_now();
+    return 0;
+}
+
+// Skip to the first record of the next captured connection, adding up the time
+// on the way. Returns 0 at the end of the capture.
+static int replay_clock_seek(uint64_t *elapsed_us) {
+    CaptureRecord record;
+    while (fread(&record, sizeof(record), 1, replay_clock.file) == 1 &&
+           fseek(replay_clock.file, record.length, SEEK_CUR) == 0) {
+        *elapsed_us += record.delta_us;
+        if (record.flags & CAPTURE_FIRST) return 1;
+    }
+    return 0;
+}
+
+// A connection was accepted: aim the clock at when its captured counterpart
+// arrived, replay_clock_step gets it there. Returns 1 while the capture lasts.
+int replay_clock_next() {
+    uint64_t ahead = 0;
+    if (replay_clock.file == NULL) return 0;
+    replay_clock.at_us = replay_clock.target_us;
+    if (!replay_clock_seek(&replay_clock.target_us)) {
+        fclose(replay_clock.file);
+        replay_clock.file = NULL;
+        return 0;
+    }
+    // Look for a connection after this one; without one the clock runs on from here
+    long at = ftell(replay_clock.file);
+    if (!replay_clock_seek(&ahead)) {
+        fclose(replay_clock.file);
+        replay_clock.file = NULL;
+    } else {
+        fseek(replay_clock.file, at, SEEK_SET);
+    }
+    return 1;
+}
+
+// Move the clock up to step_ms towards the accepted connection.
+// Returns 0 once it is there.
+int replay_clock_step(int step_ms) {
+    if (replay_clock.at_us >= replay_clock.target_us) {
+        replay_clock.ended = capture_now();
+        return 0;
+    }
+    replay_clock.at_us += (uint64_t)step_ms * 1000;
+    if (replay_clock.at_us > replay_clock.target_us) replay_clock.at_us = replay_clock.target_us;
+    return 1;
+}
+
+// Module time in milliseconds while replay_clock.active
+uint32_t replay_clock_ms() {
+    uint64_t ms = REPLAY_CLOCK_ORIGIN_MS + replay_clock.at_us / 1000;
+    if (replay_clock.file == NULL && replay_clock.at_us >= replay_clock.target_us) {
+        ms += (uint64_t)((capture_now() - replay_clock.ended) * 1000.0);
+    }
+    return (uint32_t)ms;
+}
+
+void replay_clock_close() {
+    if (replay_clock.file != NULL) fclose(replay_clock.file);
+    replay_clock.file = NULL;
+    replay_clock.active = 0;
+}
+
+#endif
@@ -0,0 +1,145 @@
+#ifndef TREND_PREDICTOR_H
+#define TREND_PREDICTOR_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+// Exponentially weighted online linear regression per suit and parameter
+#define PREDICT_MAX_SUITS 100000
+#define PREDICT_CHANNELS 8  // Parameter code - 1
+#define PREDICT_TAU_S 30.0  // Time constant of the sample weights in seconds
+#define PREDICT_LEAD_TIME_S 60.0  // Default early-warning lead time
+#define PREDICT_LEAD_ENV "PREDICT_LEAD_TIME"
+#define PREDICT_MIN_WEIGHT 2.5  // Effective samples needed before predicting
+#define PREDICT_HYSTERESIS 1.5  // Re-arm once the prediction moves this far past the lead time
+
+// Threshold direction
+#define CROSS_ABOVE 0
+#define CROSS_BELOW 1
+
+// Weighted sums with the time origin kept at the latest sample, 32 bytes
+typedef struct {
+    float s0;  // Sum of weights
+    float st;  // Sum of w * t
+    float stt;  // Sum of w * t²
+    float sx;  // Sum of w * x
+    float stx;  // Sum of w * t * x
+    uint32_t last_ms;  // Time of the latest sample
+    uint32_t started;
+    uint32_t warned;  // Early warning already sent for this crossing
+} TrendState;
+
+typedef struct {
+    TrendState channel[PREDICT_CHANNELS];
+} SuitTrends;
+
+typedef struct {
+    SuitTrends *suits;  // Indexed by suit ID
+    int suit_count;
+    double lead_time_s;
+} TrendBank;
+
+typedef struct {
+    double level;  // Fitted value now
+    double slope;  // Units per second
+    double time_to_threshold;  // Seconds, negative if not approaching
+} TrendPrediction;
+
+int trend_bank_init(TrendBank *bank, int suit_count) {
+    bank->suits = calloc((size_t)suit_count, sizeof(SuitTrends));
+    bank->suit_count = (bank->suits != NULL) ? suit_count : 0;
+
+    const char *lead = getenv(PREDICT_LEAD_ENV);
+    bank->lead_time_s = (lead != NULL && atof(lead) > 0) ? atof(lead) : PREDICT_LEAD_TIME_S;
+    return (bank->suits != NULL) ? 0 : -1;
+}
+
+void trend_bank_free(TrendBank *bank) {
+    free(bank->suits);
+    bank->suits = NULL;
+    bank->suit_count = 0;
+}
+
+TrendState *trend_channel(TrendBank *bank, int suit_id, int param_code) {
+    if (suit_id < 0 || suit_id >= bank->suit_count) return NULL;
+    if (param_code < 1 || param_code > PREDICT_CHANNELS) return NULL;
+    return &bank->suits[suit_id].channel[param_code - 1];
+}
+
+// O(1) update: move the time origin to the new sample, decay, then add it
+void trend_update(TrendState *s, uint32_t now_ms, double value) {
+    if (!s->started) {
+        memset(s, 0, sizeof(*s));
+        s->started = 1;
+    } else {
+        double dt = (uint32_t)(now_ms - s->last_ms) / 1000.0;
+        double w = exp(-dt / PREDICT_TAU_S);
+        // Old times become t - dt relative to the new origin
+        double st = s->st - dt * s->s0;
+        double stt = s->stt - 2.0 * dt * s->st + dt * dt * s->s0;
+        double stx = s->stx - dt * s->sx;
+        s->s0 = (float)(w * s->s0);
+        s->st = (float)(w * st);
+        s->stt = (float)(w * stt);
+        s->sx = (float)(w * s->sx);
+        s->stx = (float)(w * stx);
+    }
+
+    // New sample sits at t = 0, so it only adds to s0 and sx
+    s->s0 += 1.0f;
+    s->sx += (float)value;
+    s->last_ms = now_ms;
+}
+
+// Fit the weighted line and extrapolate to the threshold
+TrendPrediction trend_predict(const TrendState *s, double threshold, int direction) {
+    TrendPrediction p = {0.0, 0.0, -1.0};
+    if (!s->started || s->s0 <= 0.0f) return p;
+
+    double denom = (double)s->s0 * s->stt - (double)s->st * s->st;
+    p.level = s->sx / s->s0;
+    if (s->s0 < PREDICT_MIN_WEIGHT || fabs(denom) < 1e-9) return p;
+
+    p.slope = ((double)s->s0 * s->stx - (double)s->st * s->sx) / denom;
+    p.level = (s->sx - p.slope * s->st) / s->s0;  // Intercept at t = 0 (now)
+
+    double gap = (direction == CROSS_ABOVE) ? threshold - p.level : p.level - threshold;
+    double rate = (direction == CROSS_ABOVE) ? p.slope : -p.slope;
+    if (gap <= 0.0) {
+        p.time_to_threshold = 0.0;  // Already past the threshold
+    } else if (rate > 0.0) {
+        p.time_to_threshold = gap / rate;
+    }
+    return p;
+}
+
+// Update and decide whether to raise an early warning; returns 1 once per approach
+int trend_check_early_warning(TrendBank *bank, int suit_id, int param_code, uint32_t now_ms,
+                              double value, double threshold, int direction,
+                              TrendPrediction *out) {
+    TrendState *s = trend_channel(bank, suit_id, param_code);
+    if (s == NULL) return 0;
+
+    trend_update(s, now_ms, value);
+    TrendPrediction p = trend_predict(s, threshold, direction);
+    if (out != NULL) *out = p;
+
+    // Already across: the regular threshold alert takes over
+    if (p.time_to_threshold == 0.0) return 0;
+
+    if (p.time_to_threshold > 0.0 && p.time_to_threshold < bank->lead_time_s) {
+        if (!s->warned) {
+            s->warned = 1;
+            return 1;
+        }
+    } else if (p.time_to_threshold < 0.0 ||
+               p.time_to_threshold > bank->lead_time_s * PREDICT_HYSTERESIS) {
+        s->warned = 0;  // Trend receded, re-arm
+    }
+    return 0;
+}
+
+#endif
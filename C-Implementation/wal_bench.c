@@ -0,0 +1,205 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "control_wal.h"
+
+// Benchmark for the control write-ahead log: cost of a sync per alert against
+// group commit, then a full shift of traffic with a crash part-way through a
+// record, and the time to recover from snapshot + log against replaying
+// everything. Checks that recovery rebuilds the same alarms as the live table,
+// that the table grows to a full fleet of suits, that quiet unacknowledged
+// alarms expire and that a command is resent at most WAL_COMMAND_RETRIES times.
+
+#define BENCH_SYNC_ALERTS 2000
+#define BENCH_GROUP 64
+#define BENCH_SHIFT_HOURS 8
+#define BENCH_ALERT_RATE 10  // Alerts per second at one control shard
+#define BENCH_SUITS 1000
+#define BENCH_PARAMS 8
+#define BENCH_ACK_PERCENT 98  // Some commands never get acknowledged
+#define BENCH_FLEET 100000  // Suits for the table growth check, two open alarms each
+
+ControlWal live, recovered;
+
+double now_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+void one_alert(ControlWal *wal) {
+    int suit = rand() % BENCH_SUITS;
+    int param = 1 + rand() % BENCH_PARAMS;
+    int value = rand() % 1000;
+    wal_log(wal, WAL_RECORD_ALERT, suit, param, value, 0, 0);
+    uint64_t seq = wal_log(wal, WAL_RECORD_COMMAND, suit, param, value, param * 100 + 1, 0);
+    if (rand() % 100 < BENCH_ACK_PERCENT) {
+        wal_log(wal, WAL_RECORD_ACK, suit, param, value, param * 100 + 1, seq);
+    }
+}
+
+double bench_commit(int group) {
+    WalRecovery recovery;
+    remove("bench_commit.wal");
+    remove("bench_commit.snap");
+    wal_open(&live, "bench_commit", &recovery);
+    double start = now_seconds();
+    for (int i = 0; i < BENCH_SYNC_ALERTS; i++) {
+        one_alert(&live);
+        if ((i + 1) % group == 0) wal_commit(&live);
+    }
+    wal_commit(&live);
+    double elapsed = now_seconds() - start;
+    wal_close(&live);
+    remove("bench_commit.wal");
+    remove("bench_commit.snap");
+    return BENCH_SYNC_ALERTS / elapsed;
+}
+
+// Run a shift, then stop with half a record written, as if the process died mid-append
+long run_shift(const char *name, int snapshots) {
+    WalRecovery recovery;
+    char path[64];
+    long alerts = (long)BENCH_SHIFT_HOURS * 3600 * BENCH_ALERT_RATE;
+
+    snprintf(path, sizeof(path), "%s.wal", name);
+    remove(path);
+    snprintf(path, sizeof(path), "%s.snap", name);
+    remove(path);
+    wal_open(&live, name, &recovery);
+
+    srand(5);
+    for (long i = 0; i < alerts; i++) {
+        one_alert(&live);
+        if ((i + 1) % BENCH_GROUP == 0) {
+            wal_commit(&live);
+            if (snapshots && live.since_snapshot >= WAL_SNAPSHOT_RECORDS) wal_snapshot(&live);
+        }
+    }
+    wal_commit(&live);
+    WalRecord torn;
+    memset(&torn, 0x5a, sizeof(torn));
+    fwrite(&torn, sizeof(torn) / 2, 1, live.log);
+    fclose(live.log);
+    live.log = NULL;
+    return alerts;
+}
+
+int same_alarms(ControlWal *a, ControlWal *b) {
+    if (a->alarm_count != b->alarm_count) return 0;
+    for (uint32_t i = 0; i < a->capacity; i++) {
+        ActiveAlarm *x = &a->alarms[i];
+        if (x->param_code == 0) continue;
+        ActiveAlarm *y = wal_alarm_slot(b, x->suit_id, x->param_code);
+        if (y->param_code == 0 || y->value != x->value || y->command_seq != x->command_seq ||
+            y->acked != x->acked || y->response_code != x->response_code) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int bench_recovery(const char *name, int snapshots) {
+    WalRecovery recovery;
+    long alerts = run_shift(name, snapshots);
+
+    double start = now_seconds();
+    wal_open(&recovered, name, &recovery);
+    double elapsed = now_seconds() - start;
+    int match = same_alarms(&live, &recovered);
+    wal_close(&recovered);
+
+    // Recovering again from the state the first recovery left must give the same table
+    WalRecovery again;
+    wal_open(&recovered, name, &again);
+    int idempotent = same_alarms(&live, &recovered) && again.pending == recovery.pending;
+    wal_close(&recovered);
+
+    printf("%-18s %ld alerts, %ld records replayed, %d alarms (%d pending), %s%.1f ms, state %s, %s\n",
+           snapshots ? "Snapshot + tail:" : "Full replay:", alerts, recovery.records, recovery.alarms,
+           recovery.pending, recovery.torn_tail ? "torn tail dropped, " : "", elapsed * 1000.0,
+           match ? "matches" : "DIFFERS", idempotent ? "idempotent" : "NOT idempotent");
+
+    char path[64];
+    snprintf(path, sizeof(path), "%s.wal", name);
+    remove(path);
+    snprintf(path, sizeof(path), "%s.snap", name);
+    remove(path);
+    wal_close(&live);
+    return (match && idempotent) ? 0 : 1;
+}
+
+// A fleet's worth of unacknowledged alarms, then expiry and the resend limit
+int bench_limits() {
+    WalRecovery recovery;
+    int failures = 0;
+
+    remove("bench_limits.wal");
+    remove("bench_limits.snap");
+    wal_open(&live, "bench_limits", &recovery);
+    double start = now_seconds();
+    for (int suit = 0; suit < BENCH_FLEET; suit++) {
+        for (int param = 1; param <= 2; param++) {
+            wal_log(&live, WAL_RECORD_ALERT, suit, param, 1, 0, 0);
+            wal_log(&live, WAL_RECORD_COMMAND, suit, param, 1, param * 100 + 1, 0);
+        }
+    }
+    double elapsed = now_seconds() - start;
+    printf("%d suits x 2 alarms: table grew %u -> %u slots in %.1f ms, %d alarms, %ld untracked\n",
+           BENCH_FLEET, WAL_INITIAL_ALARMS, live.capacity, elapsed * 1000.0, live.alarm_count, live.untracked);
+    if (live.alarm_count != 2 * BENCH_FLEET || live.untracked != 0) {
+        printf("  FAIL: every alarm must be tracked\n");
+        failures++;
+    }
+
+    wal_expire(&live, wal_time_ms() + WAL_ALARM_HOLD_MS + 1000);
+    int held = live.alarm_count;
+    wal_expire(&live, wal_time_ms() + WAL_ALARM_STALE_MS + 1000);
+    printf("Expiry: %d unacknowledged alarms kept past the hold time, %d left and %ld abandoned past %d min\n",
+           held, live.alarm_count, live.abandoned, WAL_ALARM_STALE_MS / 60000);
+    if (held != 2 * BENCH_FLEET || live.alarm_count != 0 || live.abandoned != 2 * BENCH_FLEET) {
+        printf("  FAIL: unacknowledged alarms must outlive the hold time and expire when stale\n");
+        failures++;
+    }
+
+    // One command the actuator never acknowledges, and a restart after every resend
+    wal_snapshot(&live);
+    wal_log(&live, WAL_RECORD_ALERT, 7, 4, 1, 0, 0);
+    uint64_t seq = wal_log(&live, WAL_RECORD_COMMAND, 7, 4, 1, 401, 0);
+    wal_close(&live);
+    int restarts = 0, resends = 0;
+    for (; restarts <= WAL_COMMAND_RETRIES + 1; restarts++) {
+        wal_open(&live, "bench_limits", &recovery);
+        if (recovery.pending == 0) break;
+        wal_log(&live, WAL_RECORD_RETRY, 7, 4, 1, 401, seq);
+        resends++;
+        wal_close(&live);
+    }
+    wal_close(&live);
+    printf("Unacknowledged command resent %d time(s) over %d restart(s)\n", resends, restarts);
+    if (resends != WAL_COMMAND_RETRIES) {
+        printf("  FAIL: expected %d resends\n", WAL_COMMAND_RETRIES);
+        failures++;
+    }
+
+    remove("bench_limits.wal");
+    remove("bench_limits.snap");
+    return failures;
+}
+
+int main() {
+    printf("Smart Suit - Control Write-Ahead Log Benchmark\n");
+    printf("----------------------------------------------\n");
+
+    double per_alert = bench_commit(1);
+    double grouped = bench_commit(BENCH_GROUP);
+    printf("Sync per alert: %8.0f alerts/s\n", per_alert);
+    printf("Group of %d:    %8.0f alerts/s (%.1fx)\n", BENCH_GROUP, grouped, grouped / per_alert);
+
+    printf("%d h shift at %d alerts/s, crash mid-record:\n", BENCH_SHIFT_HOURS, BENCH_ALERT_RATE);
+    int failures = bench_recovery("bench_shift_snap", 1);
+    failures += bench_recovery("bench_shift_full", 0);
+    failures += bench_limits();
+    return (failures > 0) ? 1 : 0;
+}